@@ -0,0 +1,60 @@
+/*
+ * File      : bench.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.org/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       helpers shared by the simulator benchmarks
+ */
+
+#include <rtthread.h>
+#include <time.h>
+
+#include "bench.h"
+
+static rt_uint32_t bench_seed;
+
+/* the same seed gives the same trace on every build */
+void bench_srand(rt_uint32_t seed)
+{
+    bench_seed = seed;
+}
+
+rt_uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245UL + 12345UL;
+
+    return (bench_seed >> 8) & 0xffffff;
+}
+
+/* the host clock, in ns */
+uint64_t bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void bench_account(struct bench_stat *stat, uint64_t start)
+{
+    uint64_t ns = bench_now() - start;
+
+    stat->count++;
+    stat->total_ns += ns;
+    if (ns > stat->max_ns)
+        stat->max_ns = ns;
+}
+
+void bench_report(const char *name, struct bench_stat *stat)
+{
+    rt_kprintf("%-8s %7d %7d %7d\n", name, stat->count,
+               stat->count ? (int)(stat->total_ns / stat->count) : 0,
+               (int)stat->max_ns);
+}
@@ -0,0 +1,35 @@
+/*
+ * File      : bench.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.org/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       helpers shared by the simulator benchmarks
+ */
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <rtthread.h>
+#include <stdint.h>
+
+/* the count, the total and the worst time of one kind of call */
+struct bench_stat
+{
+    rt_uint32_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+};
+
+void bench_srand(rt_uint32_t seed);
+rt_uint32_t bench_rand(void);
+
+uint64_t bench_now(void);
+void bench_account(struct bench_stat *stat, uint64_t start);
+void bench_report(const char *name, struct bench_stat *stat);
+
+#endif /* __BENCH_H__ */
@@ -0,0 +1,201 @@
+/*
+ * File      : heap_bench.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.org/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       heap latency and fragmentation benchmark
+ * 2026-10-17     aclean       take the helpers from bench.c
+ */
+
+/*
+ * heap_bench(seed, ops) replays the same pseudo random trace of rt_malloc,
+ * rt_realloc and rt_free on whichever system heap the simulator is built
+ * with, RT_USING_SMALL_MEM or RT_USING_TLSF in rtconfig.h, so two builds
+ * give comparable numbers. The sizes follow the firmware: thread stacks
+ * and control blocks, frame buffers and small objects.
+ *
+ * It reports the mean and the worst time of each call in the host clock,
+ * taken with the tick held off so that only the allocator is measured,
+ * and how fragmented the heap is after half of the trace blocks are freed:
+ * the largest block rt_malloc() still gives, against the free memory.
+ * The rest of the simulated heap is held in chunks for the run, so that the
+ * trace works in about BENCH_ARENA bytes like on the board.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#include "bench.h"
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+#define BENCH_SLOTS     64
+/* the heap left to the trace, about what the board has */
+#define BENCH_ARENA     (32 * 1024)
+#define BENCH_CHUNK     (4 * 1024)
+
+static rt_size_t bench_size(void)
+{
+    rt_uint32_t r = bench_rand() % 100;
+
+    if (r < 10)
+        return 256 + (bench_rand() % 4) * 256;  /* thread stacks */
+    if (r < 30)
+        return 64 + bench_rand() % 192;         /* control blocks, frames */
+
+    return 4 + bench_rand() % 60;               /* small objects */
+}
+
+/* take the heap but BENCH_ARENA bytes, the chunks are chained by their first word */
+static void *bench_hold(void)
+{
+    void *list = RT_NULL, *chunk;
+    int i;
+
+    while ((chunk = rt_malloc(BENCH_CHUNK)) != RT_NULL)
+    {
+        *(void **)chunk = list;
+        list = chunk;
+    }
+
+    /* the last ones taken are next to each other */
+    for (i = 0; i < BENCH_ARENA / BENCH_CHUNK && list != RT_NULL; i++)
+    {
+        chunk = *(void **)list;
+        rt_free(list);
+        list = chunk;
+    }
+
+    return list;
+}
+
+static void bench_release(void *list)
+{
+    void *chunk;
+
+    while (list != RT_NULL)
+    {
+        chunk = *(void **)list;
+        rt_free(list);
+        list = chunk;
+    }
+}
+
+/* the largest block rt_malloc() gives now */
+static rt_size_t bench_largest(rt_size_t limit)
+{
+    rt_size_t low = 0, high = limit, mid;
+    void *ptr;
+
+    while (low < high)
+    {
+        mid = (low + high + 1) / 2;
+        ptr = rt_malloc(mid);
+        if (ptr != RT_NULL)
+        {
+            rt_free(ptr);
+            low = mid;
+        }
+        else
+            high = mid - 1;
+    }
+
+    return low;
+}
+
+void heap_bench(int seed, int ops)
+{
+    static void *slot[BENCH_SLOTS];
+    struct bench_stat malloc_stat = {0}, realloc_stat = {0}, free_stat = {0};
+    rt_uint32_t total, used, max_used, failed = 0;
+    uint64_t start;
+    rt_base_t level;
+    rt_size_t largest;
+    void *ptr, *held;
+    int i, n;
+
+    bench_srand(seed);
+    if (ops <= 0)
+        ops = 20000;
+
+    held = bench_hold();
+
+    for (i = 0; i < ops; i++)
+    {
+        n = bench_rand() % BENCH_SLOTS;
+        if (slot[n] == RT_NULL)
+        {
+            rt_size_t size = bench_size();
+
+            level = rt_hw_interrupt_disable();
+            start = bench_now();
+            slot[n] = rt_malloc(size);
+            bench_account(&malloc_stat, start);
+            rt_hw_interrupt_enable(level);
+            if (slot[n] == RT_NULL)
+                failed++;
+        }
+        else if (bench_rand() % 8 == 0)
+        {
+            rt_size_t size = bench_size();
+
+            level = rt_hw_interrupt_disable();
+            start = bench_now();
+            ptr = rt_realloc(slot[n], size);
+            bench_account(&realloc_stat, start);
+            rt_hw_interrupt_enable(level);
+            if (ptr != RT_NULL)
+                slot[n] = ptr;
+            else
+                failed++;
+        }
+        else
+        {
+            level = rt_hw_interrupt_disable();
+            start = bench_now();
+            rt_free(slot[n]);
+            bench_account(&free_stat, start);
+            rt_hw_interrupt_enable(level);
+            slot[n] = RT_NULL;
+        }
+    }
+
+    /* leave every other block in place and see what the holes are good for */
+    for (n = 0; n < BENCH_SLOTS; n += 2)
+    {
+        rt_free(slot[n]);
+        slot[n] = RT_NULL;
+    }
+    rt_memory_info(&total, &used, &max_used);
+    largest = bench_largest(total - used);
+
+#ifdef RT_USING_TLSF
+    rt_kprintf("heap: tlsf, seed %d, %d ops, %d failed\n", seed, ops, failed);
+#else
+    rt_kprintf("heap: small mem, seed %d, %d ops, %d failed\n", seed, ops, failed);
+#endif
+    rt_kprintf("call       count mean ns  max ns\n");
+    rt_kprintf("-------- ------- ------- -------\n");
+    bench_report("malloc", &malloc_stat);
+    bench_report("realloc", &realloc_stat);
+    bench_report("free", &free_stat);
+    rt_kprintf("free %d bytes, largest block %d, fragmentation %d%%\n",
+               total - used, largest,
+               total - used ? (int)(100 - largest * 100 / (total - used)) : 0);
+
+    for (n = 1; n < BENCH_SLOTS; n += 2)
+    {
+        rt_free(slot[n]);
+        slot[n] = RT_NULL;
+    }
+    bench_release(held);
+}
+FINSH_FUNCTION_EXPORT(heap_bench, replay a heap trace and report latency and fragmentation)
+#endif
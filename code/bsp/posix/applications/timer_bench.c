@@ -0,0 +1,167 @@
+/*
+ * File      : timer_bench.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.org/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       hard timer latency benchmark
+ * 2026-10-17     aclean       take the helpers from bench.c
+ */
+
+/*
+ * timer_bench(n, ops) arms n periodic hard timers with pseudo random periods
+ * and then, ops times, moves the tick on by one and checks the timers, and
+ * restarts or stops one of them. The same trace runs on the sorted timer
+ * list or on the timing wheel, RT_USING_TIMER_WHEEL in rtconfig.h.
+ *
+ * It reports the mean and the worst time of rt_timer_start, rt_timer_stop
+ * and rt_timer_check in the host clock. Each call is made with the
+ * interrupts off, as the kernel keeps them off for about all of the call,
+ * so the worst time is the worst interrupt latency the timers add. It also
+ * counts the timeouts that came late or out of order, which must be none.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#include "bench.h"
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+/* the periods, up to 10 s at 1000 ticks per second */
+#define BENCH_PERIOD_MAX    10000
+
+struct bench_timer
+{
+    struct rt_timer timer;
+    /* when it was started, for the order of the timers of one tick */
+    rt_uint32_t seq;
+};
+
+static rt_uint32_t bench_seq;
+static rt_uint32_t bench_fired, bench_late, bench_disorder;
+static rt_tick_t   bench_last_tick;
+static rt_uint32_t bench_last_seq;
+
+static void bench_timeout(void *parameter)
+{
+    struct bench_timer *bt = (struct bench_timer *)parameter;
+    rt_tick_t tick = bt->timer.timeout_tick;
+
+    bench_fired++;
+    if (tick != rt_tick_get())
+        bench_late++;
+
+    /* earlier timeout ticks first, the timers of one tick as started */
+    if ((tick - bench_last_tick) >= RT_TICK_MAX / 2 ||
+        (tick == bench_last_tick && bt->seq < bench_last_seq))
+        bench_disorder++;
+    bench_last_tick = tick;
+    bench_last_seq  = bt->seq;
+
+    /* the timer is started again right after */
+    bt->seq = ++bench_seq;
+}
+
+static void bench_start(struct bench_timer *bt, struct bench_stat *stat)
+{
+    rt_base_t level;
+    uint64_t start;
+
+    level = rt_hw_interrupt_disable();
+    bt->seq = ++bench_seq;
+    start = bench_now();
+    rt_timer_start(&bt->timer);
+    bench_account(stat, start);
+    rt_hw_interrupt_enable(level);
+}
+
+void timer_bench(int n, int ops)
+{
+    struct bench_stat start_stat = {0}, stop_stat = {0}, check_stat = {0};
+    struct bench_timer *timers;
+    struct bench_timer *bt;
+    rt_base_t level;
+    uint64_t start;
+    int i;
+
+    if (n <= 0)
+        n = 64;
+    if (ops <= 0)
+        ops = 20000;
+
+    timers = rt_malloc(n * sizeof(struct bench_timer));
+    if (timers == RT_NULL)
+    {
+        rt_kprintf("no memory for %d timers\n", n);
+        return;
+    }
+
+    bench_srand(n);
+    bench_fired = bench_late = bench_disorder = 0;
+    bench_last_tick = rt_tick_get();
+    bench_last_seq  = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        rt_timer_init(&timers[i].timer, "tbench", bench_timeout, &timers[i],
+                      1 + bench_rand() % BENCH_PERIOD_MAX, RT_TIMER_FLAG_PERIODIC);
+        bench_start(&timers[i], &start_stat);
+    }
+
+    for (i = 0; i < ops; i++)
+    {
+        /* one tick, as the tick interrupt does it */
+        level = rt_hw_interrupt_disable();
+        rt_tick_set(rt_tick_get() + 1);
+        start = bench_now();
+        rt_timer_check();
+        bench_account(&check_stat, start);
+        rt_hw_interrupt_enable(level);
+
+        bt = &timers[bench_rand() % n];
+        switch (bench_rand() % 8)
+        {
+        case 0:
+        case 1:
+            bench_start(bt, &start_stat);
+            break;
+
+        case 2:
+            if (!(bt->timer.parent.flag & RT_TIMER_FLAG_ACTIVATED))
+                break;
+
+            level = rt_hw_interrupt_disable();
+            start = bench_now();
+            rt_timer_stop(&bt->timer);
+            bench_account(&stop_stat, start);
+            rt_hw_interrupt_enable(level);
+            break;
+        }
+    }
+
+    for (i = 0; i < n; i++)
+        rt_timer_detach(&timers[i].timer);
+    rt_free(timers);
+
+#ifdef RT_USING_TIMER_WHEEL
+    rt_kprintf("timers: wheel, %d timers, %d ticks\n", n, ops);
+#else
+    rt_kprintf("timers: list, %d timers, %d ticks\n", n, ops);
+#endif
+    rt_kprintf("call       count mean ns  max ns\n");
+    rt_kprintf("-------- ------- ------- -------\n");
+    bench_report("start", &start_stat);
+    bench_report("stop", &stop_stat);
+    bench_report("check", &check_stat);
+    rt_kprintf("%d timeouts, %d late, %d out of order\n",
+               bench_fired, bench_late, bench_disorder);
+}
+FINSH_FUNCTION_EXPORT(timer_bench, arm timers and report start stop and check latency)
+#endif
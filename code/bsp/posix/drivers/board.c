@@ -0,0 +1,73 @@
+/*
+ * File      : board.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2009 RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rt-thread.org/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       host simulator board
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "usart.h"
+
+#ifdef  RT_USING_COMPONENTS_INIT
+#include <components.h>
+#endif  /* RT_USING_COMPONENTS_INIT */
+
+/**
+ * This is the timer interrupt service routine, SIGALRM of the process.
+ */
+static void rt_hw_timer_isr(int vector, void *param)
+{
+    rt_tick_increase();
+}
+
+static void rt_hw_timer_init(void)
+{
+    struct itimerval timer;
+
+    rt_hw_interrupt_install(SIGALRM, rt_hw_timer_isr, RT_NULL, "tick");
+
+    timer.it_interval.tv_sec  = 0;
+    timer.it_interval.tv_usec = 1000000 / RT_TICK_PER_SECOND;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, RT_NULL);
+}
+
+/**
+ * This function will initial the simulated board.
+ */
+void rt_hw_board_init(void)
+{
+    rt_hw_interrupt_init();
+
+    rt_hw_timer_init();
+
+    rt_hw_usart_init();
+#ifdef RT_USING_CONSOLE
+    rt_console_set_device(RT_CONSOLE_DEVICE_NAME);
+#endif
+
+#ifdef RT_USING_COMPONENTS_INIT
+    rt_components_board_init();
+#endif
+}
+
+/* output before the console device exists */
+void rt_hw_console_output(const char *str)
+{
+    write(STDOUT_FILENO, str, strlen(str));
+}
@@ -0,0 +1,23 @@
+/*
+ * File      : board.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2009, RT-Thread Development Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rt-thread.org/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       host simulator board
+ */
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+#include "stm32f10x.h"
+#include "bsp.h"
+
+void rt_hw_board_init(void);
+void rt_hw_serial_init(void);
+
+#endif /* __BOARD_H__ */
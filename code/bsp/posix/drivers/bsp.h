@@ -0,0 +1,37 @@
+/*
+ * File      : bsp.h
+ * board definitions of the host simulator, mirrors bsp/stm32f10x
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#ifndef  BSP_PRESENT
+#define  BSP_PRESENT
+
+#include <stm32f10x_conf.h>
+
+/* RT_USING_UART, each one is a pseudo-terminal */
+#define RT_USING_UART2
+#define RT_USING_UART1
+#define RT_USING_UART4
+#define RT_UART_RX_BUFFER_SIZE	64
+
+enum {
+	/* modbus slave 485 receive and transmit control pin index */
+	MODBUS_SLAVE_RT_CONTROL_PIN_INDEX = 0,
+	/* modbus master 485 receive and transmit control pin index */
+	MODBUS_MASTER_RT_CONTROL_PIN_INDEX = 1,
+	MODBUS_MASTER_RT_CONTROL_PIN_INDEX_2,
+};
+
+#define LED_LED1_ON                GPIO_SetBits  (GPIOA,GPIO_Pin_11)
+#define LED_LED1_OFF               GPIO_ResetBits(GPIOA,GPIO_Pin_11)
+#define LED_LED2_ON                GPIO_SetBits  (GPIOA,GPIO_Pin_12)
+#define LED_LED2_OFF               GPIO_ResetBits(GPIOA,GPIO_Pin_12)
+
+void rt_hw_board_init(void);
+void IWDG_Configuration(void);
+void IWDG_Feed(void);
+
+#endif
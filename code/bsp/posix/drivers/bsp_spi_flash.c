@@ -0,0 +1,183 @@
+/*
+ * File      : bsp_spi_flash.c
+ * SPI NOR flash of the host simulator
+ *
+ * The flash content is a file. NOR rules are kept so the flash users see
+ * what they would on the board: a program only clears bits, an erase sets
+ * a whole 4KB sector back to 0xFF.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ * 2026-10-17     aclean       lock the flash around each transaction
+ */
+
+#include <rtthread.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bsp_spi_flash.h"
+
+static int flash_fd = -1;
+static rt_uint32_t flash_erase_count, flash_program_count;
+/* taken around every transaction, as on the board */
+static struct rt_mutex flash_lock;
+
+static void flash_fill(u32 addr, u32 size)
+{
+    u8 buf[SPI_FLASH_SECTOR_SIZE];
+    u32 length;
+
+    memset(buf, 0xFF, sizeof(buf));
+    while (size)
+    {
+        length = size > sizeof(buf) ? sizeof(buf) : size;
+        pwrite(flash_fd, buf, length, addr);
+        addr += length;
+        size -= length;
+    }
+}
+
+void SPI_FLASH_Init(void)
+{
+    const char *path;
+    off_t size;
+
+    if (flash_fd >= 0)
+        return;
+
+    rt_mutex_init(&flash_lock, "spiflash", RT_IPC_FLAG_FIFO);
+
+    path = getenv("RTT_SPI_FLASH");
+    if (path == RT_NULL)
+        path = SPI_FLASH_FILE;
+
+    flash_fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (flash_fd < 0)
+    {
+        rt_kprintf("spi flash: can't open %s\n", path);
+        return;
+    }
+
+    /* a new file is a blank chip */
+    size = lseek(flash_fd, 0, SEEK_END);
+    if (size < SPI_FLASH_SIZE)
+        flash_fill(size, SPI_FLASH_SIZE - size);
+}
+
+void SPI_FLASH_SectorErase(u32 SectorAddr)
+{
+    if (flash_fd < 0)
+        return;
+
+    rt_mutex_take(&flash_lock, RT_WAITING_FOREVER);
+    flash_erase_count++;
+    SectorAddr &= ~(SPI_FLASH_SECTOR_SIZE - 1);
+    flash_fill(SectorAddr % SPI_FLASH_SIZE, SPI_FLASH_SECTOR_SIZE);
+    rt_mutex_release(&flash_lock);
+}
+
+void SPI_FLASH_BulkErase(void)
+{
+    if (flash_fd < 0)
+        return;
+
+    rt_mutex_take(&flash_lock, RT_WAITING_FOREVER);
+    flash_erase_count++;
+    flash_fill(0, SPI_FLASH_SIZE);
+    rt_mutex_release(&flash_lock);
+}
+
+void SPI_FLASH_BufferWrite(u8* pBuffer, u32 WriteAddr, u16 NumByteToWrite)
+{
+    u8 buf[256];
+    u16 length, i;
+
+    if (flash_fd < 0)
+        return;
+
+    rt_mutex_take(&flash_lock, RT_WAITING_FOREVER);
+    flash_program_count++;
+    while (NumByteToWrite)
+    {
+        length = NumByteToWrite > sizeof(buf) ? sizeof(buf) : NumByteToWrite;
+        if (WriteAddr + length > SPI_FLASH_SIZE)
+            break;
+
+        /* programming can only clear bits */
+        pread(flash_fd, buf, length, WriteAddr);
+        for (i = 0; i < length; i++)
+            buf[i] &= pBuffer[i];
+        pwrite(flash_fd, buf, length, WriteAddr);
+
+        WriteAddr += length;
+        pBuffer += length;
+        NumByteToWrite -= length;
+    }
+    rt_mutex_release(&flash_lock);
+}
+
+void SPI_FLASH_PageWrite(u8* pBuffer, u32 WriteAddr, u16 NumByteToWrite)
+{
+    SPI_FLASH_BufferWrite(pBuffer, WriteAddr, NumByteToWrite);
+}
+
+void SPI_FLASH_BufferRead(u8* pBuffer, u32 ReadAddr, u16 NumByteToRead)
+{
+    if (flash_fd < 0)
+    {
+        memset(pBuffer, 0xFF, NumByteToRead);
+        return;
+    }
+
+    rt_mutex_take(&flash_lock, RT_WAITING_FOREVER);
+    if (pread(flash_fd, pBuffer, NumByteToRead, ReadAddr) != NumByteToRead)
+        memset(pBuffer, 0xFF, NumByteToRead);
+    rt_mutex_release(&flash_lock);
+}
+
+u32 SPI_FLASH_ReadID(void)
+{
+    /* JEDEC id of a W25Q16 */
+    return 0xEF4015;
+}
+
+u32 SPI_FLASH_ReadDeviceID(void)
+{
+    return 0x14;
+}
+
+void SPI_Flash_PowerDown(void)
+{
+}
+
+void SPI_Flash_WAKEUP(void)
+{
+}
+
+void eeprom_byte_write(u32 address, u8 data)
+{
+    SPI_FLASH_BufferWrite(&data, address, 1);
+}
+
+u8 eeprom_byte_read(u32 address)
+{
+    u8 data;
+
+    SPI_FLASH_BufferRead(&data, address, 1);
+    return data;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void spi_flash_stat(void)
+{
+    rt_kprintf("spi flash: %d erases, %d programs\n",
+               flash_erase_count, flash_program_count);
+}
+FINSH_FUNCTION_EXPORT(spi_flash_stat, show simulated spi flash erase and program counts)
+#endif
@@ -0,0 +1,35 @@
+/*
+ * File      : bsp_spi_flash.h
+ * SPI NOR flash of the host simulator, same interface as the board driver
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#ifndef __SPI_FLASH_H
+#define __SPI_FLASH_H
+
+#include "stm32f10x.h"
+
+/* W25Q16 geometry */
+#define SPI_FLASH_SIZE                          (2 * 1024 * 1024)
+#define SPI_FLASH_SECTOR_SIZE                   4096
+
+/* backing file, in the working directory unless RTT_SPI_FLASH names one */
+#define SPI_FLASH_FILE                          "spi_flash.bin"
+
+void SPI_FLASH_Init(void);
+void SPI_FLASH_SectorErase(u32 SectorAddr);
+void SPI_FLASH_BulkErase(void);
+void SPI_FLASH_PageWrite(u8* pBuffer, u32 WriteAddr, u16 NumByteToWrite);
+void SPI_FLASH_BufferWrite(u8* pBuffer, u32 WriteAddr, u16 NumByteToWrite);
+void SPI_FLASH_BufferRead(u8* pBuffer, u32 ReadAddr, u16 NumByteToRead);
+u32 SPI_FLASH_ReadID(void);
+u32 SPI_FLASH_ReadDeviceID(void);
+void SPI_Flash_PowerDown(void);
+void SPI_Flash_WAKEUP(void);
+
+void eeprom_byte_write(u32 address, u8 data);
+u8 eeprom_byte_read(u32 address);
+
+#endif /* __SPI_FLASH_H */
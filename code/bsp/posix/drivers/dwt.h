@@ -0,0 +1,41 @@
+/*
+ * File      : dwt.h
+ * cycle counter of the DWT for the host simulator
+ *
+ * There is no DWT on the host. DWT_CYCCNT counts the host monotonic clock
+ * at DWT_CYCCNT_HZ, the core clock of the board, so the counter wraps as
+ * often as on the board and the cycles read the same. The simulated core
+ * never sleeps, the counter runs in the idle thread too.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       first version
+ */
+#ifndef __DWT_H__
+#define __DWT_H__
+
+#include <rtthread.h>
+#include <time.h>
+
+#define DWT_CYCCNT_HZ           72000000
+#define DWT_CYCCNT              posix_dwt_cyccnt()
+
+/* the interrupt nest stands for the exception number, 0 in thread mode */
+#define SCB_ICSR                ((rt_uint32_t)rt_interrupt_get_nest())
+#define SCB_ICSR_VECTACTIVE     0x1ff
+
+rt_inline rt_uint32_t posix_dwt_cyccnt(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (rt_uint32_t)((unsigned long long)ts.tv_sec * DWT_CYCCNT_HZ +
+                         (unsigned long long)ts.tv_nsec * (DWT_CYCCNT_HZ / 1000000) / 1000);
+}
+
+rt_inline void dwt_cycles_init(void)
+{
+}
+
+#endif
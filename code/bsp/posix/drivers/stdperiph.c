@@ -0,0 +1,162 @@
+/*
+ * File      : stdperiph.c
+ * peripherals of the host simulator behind the STM32 library calls
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+
+#include <rtthread.h>
+
+#include "stm32f10x.h"
+#include "bsp.h"
+
+GPIO_TypeDef posix_gpio[7];
+
+static rt_bool_t gpio_is_output(GPIO_TypeDef* GPIOx, int pin)
+{
+    return (GPIOx->mode[pin] & 0x10) ? RT_TRUE : RT_FALSE;
+}
+
+void GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_InitStruct)
+{
+    int pin;
+
+    for (pin = 0; pin < 16; pin++)
+    {
+        if (!(GPIO_InitStruct->GPIO_Pin & (1 << pin)))
+            continue;
+
+        GPIOx->mode[pin] = GPIO_InitStruct->GPIO_Mode;
+
+        /* an open input reads its pull resistor */
+        if (GPIO_InitStruct->GPIO_Mode == GPIO_Mode_IPU)
+            GPIOx->IDR |= (1 << pin);
+        else if (GPIO_InitStruct->GPIO_Mode == GPIO_Mode_IPD)
+            GPIOx->IDR &= ~(1 << pin);
+    }
+}
+
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? Bit_SET : Bit_RESET;
+}
+
+uint16_t GPIO_ReadInputData(GPIO_TypeDef* GPIOx)
+{
+    return GPIOx->IDR;
+}
+
+uint8_t GPIO_ReadOutputDataBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->ODR & GPIO_Pin) ? Bit_SET : Bit_RESET;
+}
+
+uint16_t GPIO_ReadOutputData(GPIO_TypeDef* GPIOx)
+{
+    return GPIOx->ODR;
+}
+
+void GPIO_Write(GPIO_TypeDef* GPIOx, uint16_t PortVal)
+{
+    int pin;
+
+    GPIOx->ODR = PortVal;
+
+    /* an output pin reads back what it drives */
+    for (pin = 0; pin < 16; pin++)
+    {
+        if (!gpio_is_output(GPIOx, pin))
+            continue;
+
+        if (PortVal & (1 << pin))
+            GPIOx->IDR |= (1 << pin);
+        else
+            GPIOx->IDR &= ~(1 << pin);
+    }
+}
+
+void GPIO_SetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    GPIO_Write(GPIOx, GPIOx->ODR | GPIO_Pin);
+}
+
+void GPIO_ResetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    GPIO_Write(GPIOx, GPIOx->ODR & ~GPIO_Pin);
+}
+
+void GPIO_WriteBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, BitAction BitVal)
+{
+    if (BitVal != Bit_RESET)
+        GPIO_SetBits(GPIOx, GPIO_Pin);
+    else
+        GPIO_ResetBits(GPIOx, GPIO_Pin);
+}
+
+void FLASH_Unlock(void)
+{
+}
+
+void FLASH_Lock(void)
+{
+}
+
+void FLASH_ClearFlag(uint32_t FLASH_FLAG)
+{
+}
+
+FLASH_Status FLASH_ErasePage(uint32_t Page_Address)
+{
+    return FLASH_COMPLETE;
+}
+
+FLASH_Status FLASH_ProgramWord(uint32_t Address, uint32_t Data)
+{
+    return FLASH_COMPLETE;
+}
+
+FLASH_Status FLASH_ProgramHalfWord(uint32_t Address, uint16_t Data)
+{
+    return FLASH_COMPLETE;
+}
+
+void IWDG_Configuration(void)
+{
+}
+
+void IWDG_Feed(void)
+{
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+/* drive an input pin from the shell, port 0 is GPIOA */
+void gpio_set(int port, int pin, int value)
+{
+    if (port < 0 || port >= 7 || pin < 0 || pin >= 16)
+        return;
+
+    if (value)
+        posix_gpio[port].IDR |= (1 << pin);
+    else
+        posix_gpio[port].IDR &= ~(1 << pin);
+}
+FINSH_FUNCTION_EXPORT(gpio_set, drive a simulated input pin by port pin and level)
+
+void list_gpio(void)
+{
+    int port;
+
+    rt_kprintf(" port   IDR    ODR\n");
+    rt_kprintf("----- ------ ------\n");
+    for (port = 0; port < 7; port++)
+    {
+        rt_kprintf("GPIO%c 0x%04x 0x%04x\n", 'A' + port,
+                   posix_gpio[port].IDR, posix_gpio[port].ODR);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_gpio, list simulated gpio ports)
+#endif
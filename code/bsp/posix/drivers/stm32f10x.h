@@ -0,0 +1,151 @@
+/*
+ * File      : stm32f10x.h
+ * stand-in of the STM32 standard peripheral library for the host simulator
+ *
+ * Only the part the application and the Modbus port use is there. GPIO
+ * ports are an in-memory table: outputs are latched in ODR, inputs are
+ * read from IDR, which the finsh command gpio_set drives. Nothing runs
+ * from the internal flash at run time, its calls only report success,
+ * the clock calls do nothing.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#ifndef __STM32F10x_H
+#define __STM32F10x_H
+
+#include <stdint.h>
+/* before api_type.h, whose uint macro would rename the libc typedef */
+#include <sys/types.h>
+
+typedef int32_t  s32;
+typedef int16_t  s16;
+typedef int8_t   s8;
+
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+
+typedef volatile uint32_t vu32;
+typedef volatile uint16_t vu16;
+typedef volatile uint8_t  vu8;
+
+typedef enum {RESET = 0, SET = !RESET} FlagStatus, ITStatus;
+typedef enum {DISABLE = 0, ENABLE = !DISABLE} FunctionalState;
+typedef enum {ERROR = 0, SUCCESS = !ERROR} ErrorStatus;
+
+/* GPIO */
+typedef struct
+{
+    uint16_t IDR;
+    uint16_t ODR;
+    uint8_t  mode[16];
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef posix_gpio[7];
+
+#define GPIOA               (&posix_gpio[0])
+#define GPIOB               (&posix_gpio[1])
+#define GPIOC               (&posix_gpio[2])
+#define GPIOD               (&posix_gpio[3])
+#define GPIOE               (&posix_gpio[4])
+#define GPIOF               (&posix_gpio[5])
+#define GPIOG               (&posix_gpio[6])
+
+#define GPIO_Pin_0          ((uint16_t)0x0001)
+#define GPIO_Pin_1          ((uint16_t)0x0002)
+#define GPIO_Pin_2          ((uint16_t)0x0004)
+#define GPIO_Pin_3          ((uint16_t)0x0008)
+#define GPIO_Pin_4          ((uint16_t)0x0010)
+#define GPIO_Pin_5          ((uint16_t)0x0020)
+#define GPIO_Pin_6          ((uint16_t)0x0040)
+#define GPIO_Pin_7          ((uint16_t)0x0080)
+#define GPIO_Pin_8          ((uint16_t)0x0100)
+#define GPIO_Pin_9          ((uint16_t)0x0200)
+#define GPIO_Pin_10         ((uint16_t)0x0400)
+#define GPIO_Pin_11         ((uint16_t)0x0800)
+#define GPIO_Pin_12         ((uint16_t)0x1000)
+#define GPIO_Pin_13         ((uint16_t)0x2000)
+#define GPIO_Pin_14         ((uint16_t)0x4000)
+#define GPIO_Pin_15         ((uint16_t)0x8000)
+#define GPIO_Pin_All        ((uint16_t)0xFFFF)
+
+typedef enum
+{
+    GPIO_Speed_10MHz = 1,
+    GPIO_Speed_2MHz,
+    GPIO_Speed_50MHz
+} GPIOSpeed_TypeDef;
+
+typedef enum
+{
+    GPIO_Mode_AIN = 0x0,
+    GPIO_Mode_IN_FLOATING = 0x04,
+    GPIO_Mode_IPD = 0x28,
+    GPIO_Mode_IPU = 0x48,
+    GPIO_Mode_Out_OD = 0x14,
+    GPIO_Mode_Out_PP = 0x10,
+    GPIO_Mode_AF_OD = 0x1C,
+    GPIO_Mode_AF_PP = 0x18
+} GPIOMode_TypeDef;
+
+typedef enum
+{
+    Bit_RESET = 0,
+    Bit_SET
+} BitAction;
+
+typedef struct
+{
+    uint16_t GPIO_Pin;
+    GPIOSpeed_TypeDef GPIO_Speed;
+    GPIOMode_TypeDef GPIO_Mode;
+} GPIO_InitTypeDef;
+
+void GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_InitStruct);
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+uint16_t GPIO_ReadInputData(GPIO_TypeDef* GPIOx);
+uint8_t GPIO_ReadOutputDataBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+uint16_t GPIO_ReadOutputData(GPIO_TypeDef* GPIOx);
+void GPIO_SetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void GPIO_ResetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void GPIO_WriteBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, BitAction BitVal);
+void GPIO_Write(GPIO_TypeDef* GPIOx, uint16_t PortVal);
+
+/* RCC, clocks are always on */
+#define RCC_APB2Periph_AFIO             ((uint32_t)0x00000001)
+#define RCC_APB2Periph_GPIOA            ((uint32_t)0x00000004)
+#define RCC_APB2Periph_GPIOB            ((uint32_t)0x00000008)
+#define RCC_APB2Periph_GPIOC            ((uint32_t)0x00000010)
+#define RCC_APB2Periph_GPIOD            ((uint32_t)0x00000020)
+#define RCC_APB2Periph_GPIOE            ((uint32_t)0x00000040)
+#define RCC_APB2Periph_SPI1             ((uint32_t)0x00001000)
+
+#define RCC_APB2PeriphClockCmd(periph, state)   do { } while (0)
+#define RCC_APB1PeriphClockCmd(periph, state)   do { } while (0)
+#define RCC_AHBPeriphClockCmd(periph, state)    do { } while (0)
+
+/* internal flash, not simulated */
+typedef enum
+{
+    FLASH_BUSY = 1,
+    FLASH_ERROR_PG,
+    FLASH_ERROR_WRP,
+    FLASH_COMPLETE,
+    FLASH_TIMEOUT
+} FLASH_Status;
+
+#define FLASH_FLAG_BSY                  ((uint32_t)0x00000001)
+#define FLASH_FLAG_EOP                  ((uint32_t)0x00000020)
+#define FLASH_FLAG_PGERR                ((uint32_t)0x00000004)
+#define FLASH_FLAG_WRPRTERR             ((uint32_t)0x00000010)
+
+void FLASH_Unlock(void);
+void FLASH_Lock(void);
+void FLASH_ClearFlag(uint32_t FLASH_FLAG);
+FLASH_Status FLASH_ErasePage(uint32_t Page_Address);
+FLASH_Status FLASH_ProgramWord(uint32_t Address, uint32_t Data);
+FLASH_Status FLASH_ProgramHalfWord(uint32_t Address, uint16_t Data);
+
+#endif /* __STM32F10x_H */
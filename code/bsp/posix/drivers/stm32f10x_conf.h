@@ -0,0 +1,12 @@
+/*
+ * File      : stm32f10x_conf.h
+ * the host simulator has a single stand-in header for all the peripherals
+ */
+#ifndef __STM32F10x_CONF_H
+#define __STM32F10x_CONF_H
+
+#include "stm32f10x.h"
+
+#define assert_param(expr) ((void)0)
+
+#endif /* __STM32F10x_CONF_H */
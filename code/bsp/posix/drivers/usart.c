@@ -0,0 +1,307 @@
+/*
+ * File      : usart.c
+ * serial devices of the host simulator
+ *
+ * Each UART of the board is a pseudo-terminal: the firmware owns the
+ * master side, a test tool or a device model opens the slave side, whose
+ * path is printed at boot and linked as ./uartN.pty. The console is the
+ * stdin/stdout of the process.
+ *
+ * Receive is interrupt driven: every fd raises SIGIO when data arrives,
+ * the SIGIO handler is the UART interrupt. DMA receive reads straight
+ * into the serial rx fifo, DMA transmit writes the whole buffer and
+ * reports the completion from SIGUSR1, so the serial framework sees the
+ * same event sequence as with the STM32 DMA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "usart.h"
+
+struct posix_uart
+{
+    const char *name;
+    int fd;                     /* master side, or stdin for the console */
+    int out_fd;                 /* stdout for the console */
+    int slave_fd;               /* kept open, the line stays raw and alive */
+
+    /* DMA transmit done, to be reported from the interrupt */
+    rt_uint8_t tx_done;
+
+    rt_uint32_t rx_count, tx_count;
+};
+
+static struct termios console_termios;
+
+static void posix_uart_async(int fd)
+{
+    fcntl(fd, F_SETOWN, getpid());
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK | O_ASYNC);
+}
+
+static int posix_uart_pty_open(struct posix_uart *uart)
+{
+    struct termios tio;
+    char link[RT_NAME_MAX + 8];
+    const char *path;
+
+    uart->fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (uart->fd < 0 || grantpt(uart->fd) < 0 || unlockpt(uart->fd) < 0)
+        return -1;
+
+    path = ptsname(uart->fd);
+    uart->slave_fd = open(path, O_RDWR | O_NOCTTY);
+    if (uart->slave_fd < 0)
+        return -1;
+
+    /* no echo nor line editing, the line carries binary frames */
+    tcgetattr(uart->slave_fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(uart->slave_fd, TCSANOW, &tio);
+
+    uart->out_fd = uart->fd;
+    posix_uart_async(uart->fd);
+
+    rt_snprintf(link, sizeof(link), "%s.pty", uart->name);
+    unlink(link);
+    if (symlink(path, link) < 0)
+        link[0] = '\0';
+
+    rt_kprintf("%s: %s %s\n", uart->name, path, link);
+
+    return 0;
+}
+
+static void posix_console_restore(void)
+{
+    tcsetattr(STDIN_FILENO, TCSANOW, &console_termios);
+}
+
+static void posix_uart_console_open(struct posix_uart *uart)
+{
+    struct termios tio;
+
+    uart->fd       = STDIN_FILENO;
+    uart->out_fd   = STDOUT_FILENO;
+    uart->slave_fd = -1;
+
+    /* finsh does its own line editing */
+    if (tcgetattr(STDIN_FILENO, &console_termios) == 0)
+    {
+        tio = console_termios;
+        tio.c_lflag &= ~(ICANON | ECHO);
+        tcsetattr(STDIN_FILENO, TCSANOW, &tio);
+        atexit(posix_console_restore);
+    }
+
+    posix_uart_async(uart->fd);
+}
+
+static rt_err_t posix_configure(struct rt_serial_device *serial, struct serial_configure *cfg)
+{
+    /* the line has no speed, a pty is as fast as the host */
+    return RT_EOK;
+}
+
+static rt_err_t posix_control(struct rt_serial_device *serial, int cmd, void *arg)
+{
+    switch (cmd)
+    {
+    case RT_DEVICE_CTRL_CLR_INT:
+    case RT_DEVICE_CTRL_SET_INT:
+    case RT_DEVICE_CTRL_CONFIG:
+        /* SIGIO is always armed, the serial framework picks the path */
+        break;
+    }
+
+    return RT_EOK;
+}
+
+static int posix_putc(struct rt_serial_device *serial, char c)
+{
+    struct posix_uart *uart = (struct posix_uart *)serial->parent.user_data;
+
+    /* nobody on the line: the byte is lost, as on a real wire */
+    if (write(uart->out_fd, &c, 1) == 1)
+        uart->tx_count++;
+
+    return 1;
+}
+
+static int posix_getc(struct rt_serial_device *serial)
+{
+    struct posix_uart *uart = (struct posix_uart *)serial->parent.user_data;
+    unsigned char ch;
+
+    if (read(uart->fd, &ch, 1) != 1)
+        return -1;
+
+    uart->rx_count++;
+    return ch;
+}
+
+static rt_size_t posix_dma_transmit(struct rt_serial_device *serial, const rt_uint8_t *buf, rt_size_t size, int direction)
+{
+    struct posix_uart *uart = (struct posix_uart *)serial->parent.user_data;
+    rt_size_t offset;
+    ssize_t length;
+
+    if (direction != RT_SERIAL_DMA_TX)
+        return 0;
+
+    for (offset = 0; offset < size; offset += length)
+    {
+        length = write(uart->out_fd, buf + offset, size - offset);
+        if (length <= 0)
+            break;
+    }
+    uart->tx_count += offset;
+
+    uart->tx_done = 1;
+    raise(SIGUSR1);
+
+    return size;
+}
+
+static const struct rt_uart_ops posix_uart_ops =
+{
+    posix_configure,
+    posix_control,
+    posix_putc,
+    posix_getc,
+    posix_dma_transmit,
+};
+
+#define POSIX_UART_NUM  4
+static struct posix_uart uarts[POSIX_UART_NUM] =
+{
+    {"console"},
+    {"uart1"},
+    {"uart2"},
+    {"uart4"},
+};
+/* named as on the board, the Modbus port binds them directly */
+static struct rt_serial_device serial0;
+struct rt_serial_device serial1, serial2, serial4;
+static struct rt_serial_device *const serials[POSIX_UART_NUM] =
+{
+    &serial0, &serial1, &serial2, &serial4,
+};
+
+/* the DMA wrote into the rx fifo, hand it the new bytes */
+static void posix_dma_rx(struct rt_serial_device *serial, struct posix_uart *uart)
+{
+    struct rt_serial_rx_fifo *rx_fifo;
+    rt_size_t space;
+    ssize_t length;
+
+    rx_fifo = (struct rt_serial_rx_fifo *)serial->serial_rx;
+
+    do
+    {
+        space = serial->config.bufsz - rx_fifo->put_index;
+        length = read(uart->fd, rx_fifo->buffer + rx_fifo->put_index, space);
+        if (length <= 0)
+            break;
+
+        uart->rx_count += length;
+        rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_DMADONE | (length << 8));
+    } while ((rt_size_t)length == space);
+}
+
+static void posix_uart_isr(int vector, void *param)
+{
+    struct rt_serial_device *serial;
+    int i;
+
+    for (i = 0; i < POSIX_UART_NUM; i++)
+    {
+        serial = serials[i];
+        /* the Modbus port opens its serial without rt_device_open(), only
+         * the receive mode tells that it is in use */
+        if (!(serial->parent.open_flag & (RT_DEVICE_FLAG_INT_RX | RT_DEVICE_FLAG_DMA_RX)))
+            continue;
+
+        if ((serial->parent.open_flag & RT_DEVICE_FLAG_DMA_RX) &&
+            serial->config.bufsz != 0)
+            posix_dma_rx(serial, &uarts[i]);
+        else
+            rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_IND);
+    }
+}
+
+static void posix_dma_tx_isr(int vector, void *param)
+{
+    int i;
+
+    for (i = 0; i < POSIX_UART_NUM; i++)
+    {
+        if (uarts[i].tx_done)
+        {
+            uarts[i].tx_done = 0;
+            rt_hw_serial_isr(serials[i], RT_SERIAL_EVENT_TX_DMADONE);
+        }
+    }
+}
+
+void rt_hw_usart_init(void)
+{
+    struct serial_configure config = RT_SERIAL_CONFIG_DEFAULT;
+    int i;
+
+    config.baud_rate = BAUD_RATE_9600;
+
+    for (i = 0; i < POSIX_UART_NUM; i++)
+    {
+        if (i == 0)
+            posix_uart_console_open(&uarts[i]);
+        else if (posix_uart_pty_open(&uarts[i]) < 0)
+        {
+            rt_kprintf("%s: no pseudo-terminal, %d\n", uarts[i].name, errno);
+            continue;
+        }
+
+        serials[i]->ops    = &posix_uart_ops;
+        serials[i]->config = config;
+
+        rt_hw_serial_register(serials[i], uarts[i].name,
+                              RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX | RT_DEVICE_FLAG_DMA_RX | RT_DEVICE_FLAG_DMA_TX,
+                              &uarts[i]);
+    }
+
+    rt_hw_interrupt_install(SIGIO, posix_uart_isr, RT_NULL, "uart");
+    rt_hw_interrupt_install(SIGUSR1, posix_dma_tx_isr, RT_NULL, "uartdma");
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_uart(void)
+{
+    int i;
+
+    rt_kprintf(" uart        rx bytes   tx bytes\n");
+    rt_kprintf("-------- ---------- ----------\n");
+    for (i = 0; i < POSIX_UART_NUM; i++)
+    {
+        rt_kprintf("%-8s %10d %10d\n", uarts[i].name,
+                   uarts[i].rx_count, uarts[i].tx_count);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_uart, list simulated uart traffic)
+#endif
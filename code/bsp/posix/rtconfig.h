@@ -0,0 +1,100 @@
+/* RT-Thread config file, POSIX host simulator */
+#ifndef __RTTHREAD_CFG_H__
+#define __RTTHREAD_CFG_H__
+
+/* RT_NAME_MAX*/
+#define RT_NAME_MAX	8
+
+/* RT_ALIGN_SIZE, a pointer on a 64bit host */
+#define RT_ALIGN_SIZE	8
+
+/* PRIORITY_MAX */
+#define RT_THREAD_PRIORITY_MAX	32
+
+/* Tick per Second, same as the board */
+#define RT_TICK_PER_SECOND	1000
+
+/* SECTION: RT_DEBUG */
+/* Thread Debug */
+#define RT_DEBUG
+#define RT_THREAD_DEBUG
+
+/* no overflow check: threads run on host stacks, see libcpu/posix */
+/* #define RT_USING_OVERFLOW_CHECK */
+
+/* Using Hook */
+#define RT_USING_HOOK
+
+/* Using tickless idle: the idle thread sleeps in the host instead of spinning */
+#define RT_USING_TICKLESS
+
+/* Using the timing wheel for the hard timers, O(1) start and stop */
+/* #define RT_USING_TIMER_WHEEL */
+
+/* Using Software Timer */
+/* #define RT_USING_TIMER_SOFT */
+#define RT_TIMER_THREAD_PRIO		4
+#define RT_TIMER_THREAD_STACK_SIZE	512
+#define RT_TIMER_TICK_PER_SECOND	10
+
+/* Using tasklets: drivers defer the work of their ISRs to a thread */
+#define RT_USING_TASKLET
+#define RT_TASKLET_THREAD_PRIO		0
+#define RT_TASKLET_THREAD_STACK_SIZE	512
+
+/* SECTION: IPC */
+/* Using Semaphore*/
+#define RT_USING_SEMAPHORE
+
+/* Using Mutex */
+#define RT_USING_MUTEX
+
+/* Using Event */
+#define RT_USING_EVENT
+
+/* Using MailBox */
+#define RT_USING_MAILBOX
+
+/* Using Message Queue */
+#define RT_USING_MESSAGEQUEUE
+
+/* SECTION: Memory Management */
+/* Using Memory Pool Management*/
+#define RT_USING_MEMPOOL
+
+/* Using Dynamic Heap Management */
+#define RT_USING_HEAP
+
+/* Using Small MM */
+#define RT_USING_SMALL_MEM
+
+/* Using TLSF, the O(1) heap, in place of Small MM */
+/* #define RT_USING_TLSF */
+
+/* heap of the simulated board, in bytes */
+#define POSIX_HEAP_SIZE             (1024 * 1024)
+
+#define RT_USING_COMPONENTS_INIT
+
+/* SECTION: Device System */
+/* Using Device System */
+#define RT_USING_DEVICE
+#define RT_USING_DEVICE_IPC
+#define RT_USING_SERIAL
+/* the board pin map, on the in-memory GPIO ports */
+#define RT_USING_PIN
+
+/* SECTION: Console options */
+#define RT_USING_CONSOLE
+/* the buffer size of console*/
+#define RT_CONSOLEBUF_SIZE	        128
+/* stdin/stdout of the process */
+#define RT_CONSOLE_DEVICE_NAME	    "console"
+
+/* SECTION: finsh, a C-Express shell */
+#define RT_USING_FINSH
+/* Using symbol table */
+#define FINSH_USING_SYMTAB
+#define FINSH_USING_DESCRIPTION
+
+#endif
@@ -0,0 +1,46 @@
+import os
+
+# toolchains options
+ARCH='posix'
+CPU='posix'
+CROSS_TOOL='gcc'
+
+# the host compiler, the firmware runs as a native process
+PLATFORM 	= 'posix'
+EXEC_PATH 	= '/usr/bin'
+
+if os.getenv('RTT_EXEC_PATH'):
+	EXEC_PATH = os.getenv('RTT_EXEC_PATH')
+
+BUILD = 'debug'
+
+# toolchains
+PREFIX = ''
+CC = PREFIX + 'gcc'
+AS = PREFIX + 'gcc'
+AR = PREFIX + 'ar'
+LINK = PREFIX + 'gcc'
+TARGET_EXT = 'elf'
+SIZE = PREFIX + 'size'
+OBJDUMP = PREFIX + 'objdump'
+OBJCPY = PREFIX + 'objcopy'
+
+# not position independent: finsh keeps addresses in 32bit words, they
+# have to stay below 4GB on a 64bit host
+DEVICE = ' -ffunction-sections -fdata-sections -fno-pie'
+# the Modbus master times T3.5 with a rt_timer, there is no TIM7 here
+CFLAGS = DEVICE + ' -D_GNU_SOURCE -DMB_MASTER_USING_HW_TIMER=0'
+AFLAGS = ' -c' + DEVICE + ' -x assembler-with-cpp'
+# posix.lds only adds the finsh symbol table sections to the host script
+LFLAGS = DEVICE + ' -no-pie -Wl,--gc-sections,-Map=rtthread-posix.map,-cref -Wl,-T,posix.lds'
+
+CPATH = ''
+LPATH = ''
+
+if BUILD == 'debug':
+    CFLAGS += ' -O0 -g'
+    AFLAGS += ' -g'
+else:
+    CFLAGS += ' -O2'
+
+POST_ACTION = SIZE + ' $TARGET \n'
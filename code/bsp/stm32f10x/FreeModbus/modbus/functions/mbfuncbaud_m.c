@@ -0,0 +1,135 @@
+/*
+ * File      : mbfuncbaud_m.c
+ * vendor Modbus function 0x41: switch a slave to another baud rate
+ *
+ *   request:  41 code
+ *   response: 41 code'
+ *
+ * code is the rate the Master asks for, 1 for 9600 up to 5 for 115200.
+ * The slave answers with the rate it switches to, the one asked for or the
+ * fastest it has below it, at its old rate, and switches once the response
+ * is out. A slave without the function answers with an exception and stays
+ * at the bus rate. A slave at another rate than the bus goes back to it by
+ * itself when it hears no valid request for a few seconds, that is how it
+ * follows the Master when the Master falls back after an error.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       first version
+ */
+
+/* ----------------------- System includes ----------------------------------*/
+#include "stdlib.h"
+#include "string.h"
+
+/* ----------------------- Platform includes --------------------------------*/
+#include "port.h"
+
+/* ----------------------- Modbus includes ----------------------------------*/
+#include "mb.h"
+#include "mb_m.h"
+#include "mbframe.h"
+#include "mbproto.h"
+#include "mbconfig.h"
+
+/* ----------------------- Defines ------------------------------------------*/
+#define MB_PDU_REQ_BAUD_CODE_OFF                ( MB_PDU_DATA_OFF + 0 )
+#define MB_PDU_REQ_BAUD_SIZE                    ( 1 )
+#define MB_PDU_FUNC_BAUD_CODE_OFF               ( MB_PDU_DATA_OFF + 0 )
+#define MB_PDU_FUNC_BAUD_SIZE                   ( 1 )
+
+/* ----------------------- Static variables ---------------------------------*/
+static const ULONG ulMBBaudRates[] = { 0, 9600, 19200, 38400, 57600, 115200 };
+
+/* ----------------------- Start implementation -----------------------------*/
+UCHAR
+ucMBBaudRateCode( ULONG ulBaudRate )
+{
+    UCHAR ucCode;
+
+    for( ucCode = 1; ucCode < sizeof( ulMBBaudRates ) / sizeof( ulMBBaudRates[0] ); ucCode++ )
+    {
+        if( ulMBBaudRates[ucCode] == ulBaudRate )
+        {
+            return ucCode;
+        }
+    }
+    return 0;
+}
+
+ULONG
+ulMBBaudRateFromCode( UCHAR ucCode )
+{
+    if( ucCode >= sizeof( ulMBBaudRates ) / sizeof( ulMBBaudRates[0] ) )
+    {
+        return 0;
+    }
+    return ulMBBaudRates[ucCode];
+}
+
+#if MB_MASTER_RTU_ENABLED > 0 || MB_MASTER_ASCII_ENABLED > 0
+#if MB_FUNC_BAUD_RATE_ENABLED > 0
+
+/**
+ * This function will ask a slave to switch to a baud rate. The requests
+ * that follow go at the rate the slave answers with.
+ *
+ * @param pxMaster the Master
+ * @param ucSndAddr salve address, not a broadcast
+ * @param ulBaudRate the fastest rate wanted
+ * @param lTimeOut timeout (-1 will waiting forever)
+ *
+ * @return error code, MB_MRE_EXE_FUN if the slave has no such function
+ */
+eMBMasterReqErrCode
+eMBMasterReqBaudRate( xMBMasterInstance * pxMaster, UCHAR ucSndAddr, ULONG ulBaudRate, LONG lTimeOut )
+{
+    UCHAR                 *ucMBFrame;
+    UCHAR                  ucCode = ucMBBaudRateCode( ulBaudRate );
+    eMBMasterReqErrCode    eErrStatus = MB_MRE_NO_ERR;
+
+    if ( ucSndAddr < MB_ADDRESS_MIN || ucSndAddr > MB_MASTER_TOTAL_SLAVE_NUM || ucCode == 0 ) eErrStatus = MB_MRE_ILL_ARG;
+    else if ( xMBMasterRunResTake( pxMaster, lTimeOut ) == FALSE ) eErrStatus = MB_MRE_MASTER_BUSY;
+    else
+    {
+		vMBMasterGetPDUSndBuf(pxMaster, &ucMBFrame);
+		vMBMasterSetDestAddress(pxMaster, ucSndAddr);
+		ucMBFrame[MB_PDU_FUNC_OFF]            = MB_FUNC_OTHER_BAUD_RATE;
+		ucMBFrame[MB_PDU_REQ_BAUD_CODE_OFF]   = ucCode;
+		vMBMasterSetPDUSndLength( pxMaster, MB_PDU_SIZE_MIN + MB_PDU_REQ_BAUD_SIZE );
+		( void ) xMBMasterPortEventPost( pxMaster, EV_MASTER_FRAME_SENT );
+		eErrStatus = eMBMasterWaitRequestFinish( pxMaster );
+    }
+    return eErrStatus;
+}
+
+eMBException
+eMBMasterFuncBaudRate( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen )
+{
+    UCHAR          *ucMBFrame;
+    UCHAR           ucCode;
+    eMBException    eStatus = MB_EX_NONE;
+
+    if( *usLen == ( MB_PDU_SIZE_MIN + MB_PDU_FUNC_BAUD_SIZE ) && !xMBMasterRequestIsBroadcast( pxMaster ) )
+    {
+        vMBMasterGetPDUSndBuf(pxMaster, &ucMBFrame);
+        ucCode = pucFrame[MB_PDU_FUNC_BAUD_CODE_OFF];
+
+        /* never faster than asked */
+        if( ucCode == 0 || ucCode > ucMBFrame[MB_PDU_REQ_BAUD_CODE_OFF] ||
+            xMBMasterSetSlaveBaudRate( pxMaster, ucMBMasterGetDestAddress( pxMaster ),
+                                       ulMBBaudRateFromCode( ucCode ) ) != TRUE )
+        {
+            eStatus = MB_EX_ILLEGAL_DATA_VALUE;
+        }
+    }
+    else
+    {
+        /* Can't be a valid request because the length is incorrect. */
+        eStatus = MB_EX_ILLEGAL_DATA_VALUE;
+    }
+    return eStatus;
+}
+
+#endif
+#endif
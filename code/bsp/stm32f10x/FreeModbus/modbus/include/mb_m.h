@@ -47,15 +47,19 @@ PR_BEGIN_EXTERN_C
  * Modbus timeout. If an RTOS is available a separate task should be created
  * and the task should always call the function eMBMasterPoll().
  *
+ * All the state of a Master is in its xMBMasterInstance, so one copy of the
+ * stack runs a Master on each serial port, every function takes the instance.
+ *
  * \code
+ * static xMBMasterInstance xMaster;
  * // Initialize protocol stack in RTU mode for a Master
- * eMBMasterInit( MB_RTU, 38400, MB_PAR_EVEN );
+ * eMBMasterInit( &xMaster, MB_RTU, 2, 38400, MB_PAR_EVEN );
  * // Enable the Modbus Protocol Stack.
- * eMBMasterEnable(  );
+ * eMBMasterEnable( &xMaster );
  * for( ;; )
  * {
  *     // Call the main polling loop of the Modbus Master protocol stack.
- *     eMBMasterPoll(  );
+ *     eMBMasterPoll( &xMaster );
  *     ...
  * }
  * \endcode
@@ -80,7 +84,8 @@ typedef enum
     MB_MRE_REV_DATA,                /*!< receive data error. */
     MB_MRE_TIMEDOUT,                /*!< timeout error occurred. */
     MB_MRE_MASTER_BUSY,             /*!< master is busy now. */
-    MB_MRE_EXE_FUN                  /*!< execute function error. */
+    MB_MRE_EXE_FUN,                 /*!< execute function error. */
+    MB_MRE_CANCELED                 /*!< request canceled before it was sent. */
 } eMBMasterReqErrCode;
 /*! \ingroup modbus
  *  \brief TimerMode is Master 3 kind of Timer modes.
@@ -92,6 +97,115 @@ typedef enum
 	MB_TMODE_CONVERT_DELAY          /*!< Master sent broadcast ,then delay sometime.*/
 }eMBMasterTimerMode;
 
+typedef enum
+{
+    STATE_M_NOT_INITIALIZED,      /*!< Zero, the instance is not initialized. */
+    STATE_M_ENABLED,
+    STATE_M_DISABLED
+} eMBMasterState;
+
+typedef enum
+{
+    STATE_M_RX_INIT,              /*!< Receiver is in initial state. */
+    STATE_M_RX_IDLE,              /*!< Receiver is in idle state. */
+    STATE_M_RX_RCV,               /*!< Frame is beeing received. */
+    STATE_M_RX_ERROR,             /*!< If the frame is invalid. */
+    STATE_M_RX_DONE               /*!< Frame passed on, waiting for the t3.5 silence. */
+} eMBMasterRcvState;
+
+typedef enum
+{
+    STATE_M_TX_IDLE,              /*!< Transmitter is in idle state. */
+    STATE_M_TX_XMIT,              /*!< Transmitter is in transfer state. */
+    STATE_M_TX_XFWR               /*!< Transmitter is in transfer finish and wait receive state. */
+} eMBMasterSndState;
+
+/*! \ingroup modbus
+ * \brief Maximum size of a Modbus RTU frame.
+ */
+#define MB_MASTER_SER_PDU_SIZE_MAX      256
+
+/* The frame functions of a mode and the function handlers, shared by all
+ * the instances.
+ */
+typedef void    ( *pvMBMasterFrameStart ) ( xMBMasterInstance * pxMaster );
+typedef void    ( *pvMBMasterFrameStop ) ( xMBMasterInstance * pxMaster );
+typedef eMBErrorCode( *peMBMasterFrameReceive ) ( xMBMasterInstance * pxMaster,
+                                                  UCHAR * pucRcvAddress,
+                                                  UCHAR ** pucFrame,
+                                                  USHORT * pusLength );
+typedef eMBErrorCode( *peMBMasterFrameSend ) ( xMBMasterInstance * pxMaster,
+                                               UCHAR slaveAddress,
+                                               const UCHAR * pucFrame,
+                                               USHORT usLength );
+typedef void    ( *pvMBMasterFrameClose ) ( xMBMasterInstance * pxMaster );
+typedef BOOL    ( *pxMBMasterFrameCB ) ( xMBMasterInstance * pxMaster );
+
+typedef eMBException( *pxMBMasterFunctionHandler ) ( xMBMasterInstance * pxMaster,
+                                                     UCHAR * pucFrame,
+                                                     USHORT * pusLength );
+
+typedef struct
+{
+    UCHAR           ucFunctionCode;
+    pxMBMasterFunctionHandler pxHandler;
+} xMBMasterFunctionHandler;
+
+/*! \ingroup modbus
+ * \brief A Modbus Master on one serial port.
+ *
+ * The application owns the instance, zeroed or not, and gives it to
+ * eMBMasterInit() and then to every function for this Master.
+ */
+struct xMBMasterInstance
+{
+    eMBMasterState          eState;
+    UCHAR                   ucDestAddress;
+    BOOL                    xRunInMasterMode;
+    eMBMasterErrorEventType eCurErrorType;
+
+    /* set by eMBMasterInit( ) to the implementations of the mode */
+    peMBMasterFrameSend     peFrameSendCur;
+    pvMBMasterFrameStart    pvFrameStartCur;
+    pvMBMasterFrameStop     pvFrameStopCur;
+    peMBMasterFrameReceive  peFrameReceiveCur;
+    pvMBMasterFrameClose    pvFrameCloseCur;
+
+    /* called by the porting layer on a byte, the end of a send or a timeout */
+    pxMBMasterFrameCB       pxFrameCBByteReceived;
+    pxMBMasterFrameCB       pxFrameCBTransmitterEmpty;
+    pxMBMasterFrameCB       pxPortCBTimerExpired;
+
+    /* the frame received, kept by eMBMasterPoll( ) from one event to the next */
+    UCHAR                  *pucMBFrame;
+    UCHAR                   ucRcvAddress;
+    USHORT                  usLength;
+
+    /* RTU */
+    volatile eMBMasterSndState eSndState;
+    volatile eMBMasterRcvState eRcvState;
+    volatile UCHAR          ucRTUSndBuf[MB_MASTER_SER_PDU_SIZE_MAX];
+    volatile UCHAR          ucRTURcvBuf[MB_MASTER_SER_PDU_SIZE_MAX];
+    volatile USHORT         usSendPDULength;
+    volatile UCHAR         *pucSndBufferCur;
+    volatile USHORT         usSndBufferCount;
+    /* where the response goes, the reply buffer of a queued request or our own */
+    volatile UCHAR         *pucRcvBuf;
+    volatile USHORT         usRcvBufSize;
+    volatile USHORT         usRcvBufferPos;
+    volatile USHORT         usRcvCRC;           /* CRC of the bytes received so far. */
+    volatile USHORT         usRcvExpected;      /* Length of the response, 0 if not known. */
+    volatile BOOL           xRcvEarlyEnd;
+    /* the raw frame on the bus, sent as it is, and the end of its reply */
+    const UCHAR            *pucRawFrame;
+    USHORT                  usRawReplyExpect;
+    USHORT                  usRawReplyEnd;
+    volatile BOOL           xFrameIsBroadcast;
+    volatile eMBMasterTimerMode eCurTimerMode;
+
+    xMBMasterPort           xPort;
+};
+
 /* ----------------------- Function prototypes ------------------------------*/
 /*! \ingroup modbus
  * \brief Initialize the Modbus Master protocol stack.
@@ -101,6 +215,7 @@ typedef enum
  * note that the receiver is still disabled and no Modbus frames are
  * processed until eMBMasterEnable( ) has been called.
  *
+ * \param pxMaster The instance, one for each port.
  * \param eMode If ASCII or RTU mode should be used.
  * \param ucPort The port to use. E.g. 1 for COM1 on windows. This value
  *   is platform dependent and some ports simply choose to ignore it.
@@ -114,7 +229,7 @@ typedef enum
  *   is returned:
  *    - eMBErrorCode::MB_EPORTERR IF the porting layer returned an error.
  */
-eMBErrorCode    eMBMasterInit( eMBMode eMode, UCHAR ucPort,
+eMBErrorCode    eMBMasterInit( xMBMasterInstance * pxMaster, eMBMode eMode, UCHAR ucPort,
 		                 ULONG ulBaudRate, eMBParity eParity );
 
 /*! \ingroup modbus
@@ -147,7 +262,7 @@ eMBErrorCode    eMBMasterTCPInit( USHORT usTCPPort );
  *   If the protocol stack is not in the disabled state it returns
  *   eMBErrorCode::MB_EILLSTATE.
  */
-eMBErrorCode    eMBMasterClose( void );
+eMBErrorCode    eMBMasterClose( xMBMasterInstance * pxMaster );
 
 /*! \ingroup modbus
  * \brief Enable the Modbus Master protocol stack.
@@ -159,7 +274,7 @@ eMBErrorCode    eMBMasterClose( void );
  *   eMBErrorCode::MB_ENOERR. If it was not in the disabled state it 
  *   return eMBErrorCode::MB_EILLSTATE.
  */
-eMBErrorCode    eMBMasterEnable( void );
+eMBErrorCode    eMBMasterEnable( xMBMasterInstance * pxMaster );
 
 /*! \ingroup modbus
  * \brief Disable the Modbus Master protocol stack.
@@ -170,7 +285,7 @@ eMBErrorCode    eMBMasterEnable( void );
  *  eMBErrorCode::MB_ENOERR. If it was not in the enabled state it returns
  *  eMBErrorCode::MB_EILLSTATE.
  */
-eMBErrorCode    eMBMasterDisable( void );
+eMBErrorCode    eMBMasterDisable( xMBMasterInstance * pxMaster );
 
 /*! \ingroup modbus
  * \brief The main pooling loop of the Modbus Master protocol stack.
@@ -184,7 +299,7 @@ eMBErrorCode    eMBMasterDisable( void );
  *   returns eMBErrorCode::MB_EILLSTATE. Otherwise it returns 
  *   eMBErrorCode::MB_ENOERR.
  */
-eMBErrorCode    eMBMasterPoll( void );
+eMBErrorCode    eMBMasterPoll( xMBMasterInstance * pxMaster );
 
 /*! \ingroup modbus
  * \brief Registers a callback handler for a given function code.
@@ -207,7 +322,7 @@ eMBErrorCode    eMBMasterPoll( void );
  *   valid it returns eMBErrorCode::MB_EINVAL.
  */
 eMBErrorCode    eMBMasterRegisterCB( UCHAR ucFunctionCode,
-                               pxMBFunctionHandler pxHandler );
+                               pxMBMasterFunctionHandler pxHandler );
 
 /* ----------------------- Callback -----------------------------------------*/
 
@@ -247,7 +362,7 @@ eMBErrorCode    eMBMasterRegisterCB( UCHAR ucFunctionCode,
  *       within the requested address range. In this case a
  *       <b>ILLEGAL DATA ADDRESS</b> is sent as a response.
  */
-eMBErrorCode eMBMasterRegInputCB( UCHAR * pucRegBuffer, USHORT usAddress,
+eMBErrorCode eMBMasterRegInputCB( xMBMasterInstance * pxMaster, UCHAR * pucRegBuffer, USHORT usAddress,
 		USHORT usNRegs );
 
 /*! \ingroup modbus_registers
@@ -276,7 +391,7 @@ eMBErrorCode eMBMasterRegInputCB( UCHAR * pucRegBuffer, USHORT usAddress,
  *       within the requested address range. In this case a
  *       <b>ILLEGAL DATA ADDRESS</b> is sent as a response.
  */
-eMBErrorCode eMBMasterRegHoldingCB( UCHAR * pucRegBuffer, USHORT usAddress,
+eMBErrorCode eMBMasterRegHoldingCB( xMBMasterInstance * pxMaster, UCHAR * pucRegBuffer, USHORT usAddress,
 		USHORT usNRegs, eMBRegisterMode eMode );
 
 /*! \ingroup modbus_registers
@@ -305,7 +420,7 @@ eMBErrorCode eMBMasterRegHoldingCB( UCHAR * pucRegBuffer, USHORT usAddress,
  *       within the requested address range. In this case a
  *       <b>ILLEGAL DATA ADDRESS</b> is sent as a response.
  */
-eMBErrorCode eMBMasterRegCoilsCB( UCHAR * pucRegBuffer, USHORT usAddress,
+eMBErrorCode eMBMasterRegCoilsCB( xMBMasterInstance * pxMaster, UCHAR * pucRegBuffer, USHORT usAddress,
 		USHORT usNCoils, eMBRegisterMode eMode );
 
 /*! \ingroup modbus_registers
@@ -328,71 +443,171 @@ eMBErrorCode eMBMasterRegCoilsCB( UCHAR * pucRegBuffer, USHORT usAddress,
  *       within the requested address range. In this case a
  *       <b>ILLEGAL DATA ADDRESS</b> is sent as a response.
  */
-eMBErrorCode eMBMasterRegDiscreteCB( UCHAR * pucRegBuffer, USHORT usAddress,
+eMBErrorCode eMBMasterRegDiscreteCB( xMBMasterInstance * pxMaster, UCHAR * pucRegBuffer, USHORT usAddress,
 		USHORT usNDiscrete );
 
 /*! \ingroup modbus
  *\brief These Modbus functions are called for user when Modbus run in Master Mode.
  */
 eMBMasterReqErrCode
-eMBMasterReqReadInputRegister( UCHAR ucSndAddr, USHORT usRegAddr, USHORT usNRegs, LONG lTimeOut );
+eMBMasterReqReadInputRegister( xMBMasterInstance * pxMaster, UCHAR ucSndAddr, USHORT usRegAddr, USHORT usNRegs, LONG lTimeOut );
 eMBMasterReqErrCode
-eMBMasterReqWriteHoldingRegister( UCHAR ucSndAddr, USHORT usRegAddr, USHORT usRegData, LONG lTimeOut );
+eMBMasterReqWriteHoldingRegister( xMBMasterInstance * pxMaster, UCHAR ucSndAddr, USHORT usRegAddr, USHORT usRegData, LONG lTimeOut );
 eMBMasterReqErrCode
-eMBMasterReqWriteMultipleHoldingRegister( UCHAR ucSndAddr, USHORT usRegAddr,
+eMBMasterReqWriteMultipleHoldingRegister( xMBMasterInstance * pxMaster, UCHAR ucSndAddr, USHORT usRegAddr,
 		USHORT usNRegs, USHORT * pusDataBuffer, LONG lTimeOut );
 eMBMasterReqErrCode
-eMBMasterReqReadHoldingRegister( UCHAR ucSndAddr, USHORT usRegAddr, USHORT usNRegs, LONG lTimeOut );
+eMBMasterReqReadHoldingRegister( xMBMasterInstance * pxMaster, UCHAR ucSndAddr, USHORT usRegAddr, USHORT usNRegs, LONG lTimeOut );
 eMBMasterReqErrCode
-eMBMasterReqReadWriteMultipleHoldingRegister( UCHAR ucSndAddr,
+eMBMasterReqReadWriteMultipleHoldingRegister( xMBMasterInstance * pxMaster, UCHAR ucSndAddr,
 		USHORT usReadRegAddr, USHORT usNReadRegs, USHORT * pusDataBuffer,
 		USHORT usWriteRegAddr, USHORT usNWriteRegs, LONG lTimeOut );
 eMBMasterReqErrCode
-eMBMasterReqReadCoils( UCHAR ucSndAddr, USHORT usCoilAddr, USHORT usNCoils, LONG lTimeOut );
+eMBMasterReqReadCoils( xMBMasterInstance * pxMaster, UCHAR ucSndAddr, USHORT usCoilAddr, USHORT usNCoils, LONG lTimeOut );
 eMBMasterReqErrCode
-eMBMasterReqWriteCoil( UCHAR ucSndAddr, USHORT usCoilAddr, USHORT usCoilData, LONG lTimeOut );
+eMBMasterReqWriteCoil( xMBMasterInstance * pxMaster, UCHAR ucSndAddr, USHORT usCoilAddr, USHORT usCoilData, LONG lTimeOut );
 eMBMasterReqErrCode
-eMBMasterReqWriteMultipleCoils( UCHAR ucSndAddr,
+eMBMasterReqWriteMultipleCoils( xMBMasterInstance * pxMaster, UCHAR ucSndAddr,
 		USHORT usCoilAddr, USHORT usNCoils, UCHAR * pucDataBuffer, LONG lTimeOut );
 eMBMasterReqErrCode
-eMBMasterReqReadDiscreteInputs( UCHAR ucSndAddr, USHORT usDiscreteAddr, USHORT usNDiscreteIn, LONG lTimeOut );
+eMBMasterReqReadDiscreteInputs( xMBMasterInstance * pxMaster, UCHAR ucSndAddr, USHORT usDiscreteAddr, USHORT usNDiscreteIn, LONG lTimeOut );
+eMBMasterReqErrCode
+eMBMasterReqBaudRate( xMBMasterInstance * pxMaster, UCHAR ucSndAddr, ULONG ulBaudRate, LONG lTimeOut );
+
+/*! \ingroup modbus
+ * \brief Baud rate codes of the vendor function MB_FUNC_OTHER_BAUD_RATE,
+ * 1 for 9600 up to 5 for 115200, 0 for a rate without a code.
+ */
+UCHAR ucMBBaudRateCode( ULONG ulBaudRate );
+ULONG ulMBBaudRateFromCode( UCHAR ucCode );
+
+/*! \ingroup modbus
+ * \brief Asynchronous Master request.
+ *
+ * The caller fills the first members and keeps the request until it is
+ * complete. Submitted requests wait in a queue, lower ucPriority first and
+ * in order of submission within one priority, and go on the bus as soon as
+ * the Master is free. The request completes with its callback, which runs
+ * in the thread completing it, mostly the Master poll thread, so it must be
+ * short and must not block nor submit the request again. The submitter may
+ * also wait for it with eMBMasterReqWait().
+ *
+ * The frame is sent from pucFrame and the reply received into pucReply as
+ * they are, without a copy, so both stay untouched until the end. For a
+ * Modbus request pucReply gets the whole serial frame, address and CRC
+ * included. The reply to a raw frame ends at usReplyExpect bytes or at the
+ * byte of usReplyEnd, else at the t3.5 silence after it.
+ */
+typedef struct xMBMasterRequest xMBMasterRequest;
+typedef void ( *pxMBMasterRequestCB )( xMBMasterRequest * pxRequest, eMBMasterReqErrCode eErrStatus );
+
+struct xMBMasterRequest
+{
+    UCHAR               ucSndAddr;      /*!< slave address, for a raw frame the device whose baud rate it goes at, 0 for the bus rate. */
+    BOOL                xRaw;           /*!< pucFrame is sent as it is, no address nor CRC. */
+    UCHAR              *pucFrame;       /*!< request PDU, or the raw frame. */
+    USHORT              usLength;
+    UCHAR              *pucReply;       /*!< receives the reply frame, may be NULL. */
+    USHORT              usReplySize;
+    USHORT              usReplyExpect;  /*!< raw frame: length of the reply, 0 if not known. */
+    USHORT              usReplyEnd;     /*!< raw frame: MB_RAW_END( last byte ) of the reply, or 0. */
+    UCHAR               ucPriority;     /*!< 0 is the most urgent. */
+    LONG                lDeadline;      /*!< ticks after submit to start it, -1 for none. */
+    pxMBMasterRequestCB pxCallback;     /*!< may be NULL. */
+    void               *pvParameter;
+
+    /* owned by the request queue */
+    xMBMasterInstance  *pxMaster;       /*!< the Master it is submitted to. */
+    rt_list_t           xList;
+    rt_tick_t           xExpire;
+    UCHAR               ucState;
+    eMBMasterReqErrCode eErrStatus;
+    USHORT              usReplyLength;  /*!< bytes received in pucReply. */
+    struct rt_completion xDone;
+};
 
+#define MB_RAW_END( ucByte )        ( ( USHORT )( 0x100 | ( ucByte ) ) )
+
+eMBMasterReqErrCode eMBMasterReqSubmit( xMBMasterInstance * pxMaster, xMBMasterRequest * pxRequest );
+BOOL xMBMasterReqCancel( xMBMasterRequest * pxRequest );
+eMBMasterReqErrCode eMBMasterReqWait( xMBMasterRequest * pxRequest, LONG lTimeOut );
+BOOL xMBMasterReqIsBusy( xMBMasterRequest * pxRequest );
+eMBMasterReqErrCode eMBMasterReqRaw( xMBMasterInstance * pxMaster, UCHAR ucDevice, UCHAR * pucFrame, USHORT usLength,
+        UCHAR * pucReply, USHORT usReplySize, USHORT usReplyExpect, USHORT usReplyEnd,
+        USHORT * pusReplyLength, LONG lTimeOut );
+
+/*! \ingroup modbus
+ * \brief How a slave answers the Master.
+ *
+ * The respond timeout of a slave follows its response times. A slave that
+ * misses MB_MASTER_SLAVE_DEAD_MISSES responses in a row is dead: its
+ * requests complete at once with MB_MRE_TIMEDOUT, but for a probe now and
+ * then, until it answers again.
+ */
+typedef struct
+{
+    BOOL                xAlive;
+    USHORT              usRespondMs;    /*!< average response time, 0 before the first. */
+    USHORT              usTimeoutMs;    /*!< respond timeout it gets now. */
+    ULONG               ulReplies;
+    ULONG               ulTimeouts;
+    ULONG               ulSkipped;      /*!< requests completed without the bus while dead. */
+    ULONG               ulBaudRate;     /*!< its requests go at. */
+    ULONG               ulBaudFallbacks;/*!< back to the bus rate after an error. */
+} xMBMasterSlaveStat;
+
+BOOL xMBMasterGetSlaveStat( xMBMasterInstance * pxMaster, UCHAR ucSlave, xMBMasterSlaveStat * pxStat );
+
+/*! \ingroup modbus
+ * \brief The baud rate of each slave.
+ *
+ * Every slave starts at the rate given to eMBMasterInit(), the line is
+ * switched to the rate of the slave each request is for. A request that
+ * times out or gets a broken response at another rate sets the slave back
+ * to the bus rate, the slave is expected to do the same when it hears
+ * nothing valid for a while. Raw frames go at the rate of the device given
+ * with them, a number out of the same table.
+ */
+BOOL xMBMasterSetSlaveBaudRate( xMBMasterInstance * pxMaster, UCHAR ucSlave, ULONG ulBaudRate );
+
+eMBException
+eMBMasterFuncReportSlaveID( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncReportSlaveID( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncReadInputRegister( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncReadInputRegister( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncReadHoldingRegister( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncReadHoldingRegister( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncWriteHoldingRegister( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncWriteHoldingRegister( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncWriteMultipleHoldingRegister( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncWriteMultipleHoldingRegister( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncReadCoils( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncReadCoils( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncWriteCoil( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncWriteCoil( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncWriteMultipleCoils( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncWriteMultipleCoils( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncReadDiscreteInputs( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncReadDiscreteInputs( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncReadWriteMultipleHoldingRegister( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 eMBException
-eMBMasterFuncReadWriteMultipleHoldingRegister( UCHAR * pucFrame, USHORT * usLen );
+eMBMasterFuncBaudRate( xMBMasterInstance * pxMaster, UCHAR * pucFrame, USHORT * usLen );
 
 /* \ingroup modbus
  *\brief These functions are interface for Modbus Master
  */
-void vMBMasterGetPDUSndBuf( UCHAR ** pucFrame );
-UCHAR ucMBMasterGetDestAddress( void );
-void vMBMasterSetDestAddress( UCHAR Address );
-BOOL xMBMasterGetCBRunInMasterMode( void );
-void vMBMasterSetCBRunInMasterMode( BOOL IsMasterMode );
-USHORT usMBMasterGetPDUSndLength( void );
-void vMBMasterSetPDUSndLength( USHORT SendPDULength );
-void vMBMasterSetCurTimerMode( eMBMasterTimerMode eMBTimerMode );
-BOOL xMBMasterRequestIsBroadcast( void );
-eMBMasterErrorEventType eMBMasterGetErrorType( void );
-void vMBMasterSetErrorType( eMBMasterErrorEventType errorType );
-eMBMasterReqErrCode eMBMasterWaitRequestFinish( void );
+void vMBMasterGetPDUSndBuf( xMBMasterInstance * pxMaster, UCHAR ** pucFrame );
+UCHAR ucMBMasterGetDestAddress( xMBMasterInstance * pxMaster );
+void vMBMasterSetDestAddress( xMBMasterInstance * pxMaster, UCHAR Address );
+BOOL xMBMasterGetCBRunInMasterMode( xMBMasterInstance * pxMaster );
+void vMBMasterSetCBRunInMasterMode( xMBMasterInstance * pxMaster, BOOL IsMasterMode );
+USHORT usMBMasterGetPDUSndLength( xMBMasterInstance * pxMaster );
+void vMBMasterSetPDUSndLength( xMBMasterInstance * pxMaster, USHORT SendPDULength );
+void vMBMasterSetCurTimerMode( xMBMasterInstance * pxMaster, eMBMasterTimerMode eMBTimerMode );
+BOOL xMBMasterRequestIsBroadcast( xMBMasterInstance * pxMaster );
+eMBMasterErrorEventType eMBMasterGetErrorType( xMBMasterInstance * pxMaster );
+void vMBMasterSetErrorType( xMBMasterInstance * pxMaster, eMBMasterErrorEventType errorType );
+eMBMasterReqErrCode eMBMasterWaitRequestFinish( xMBMasterInstance * pxMaster );
 
 /* ----------------------- Callback -----------------------------------------*/
 
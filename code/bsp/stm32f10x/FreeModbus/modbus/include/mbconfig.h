@@ -103,6 +103,8 @@ PR_BEGIN_EXTERN_C
 #define MB_FUNC_READ_DISCRETE_INPUTS_ENABLED    (  1 )
 /*! \brief If the <em>Read/Write Multiple Registers</em> function should be enabled. */
 #define MB_FUNC_READWRITE_HOLDING_ENABLED       (  1 )
+/*! \brief If the vendor <em>Baud Rate</em> function should be enabled. */
+#define MB_FUNC_BAUD_RATE_ENABLED               (  1 )
 /*! @} */
 #ifdef __cplusplus
     PR_END_EXTERN_C
@@ -116,9 +118,28 @@ PR_BEGIN_EXTERN_C
  * And if slave is not respond in this time,the master will process this timeout error.
  * Then master can send other frame */
 #define MB_MASTER_TIMEOUT_MS_RESPOND             (200 )//(100 )
+/*! \brief The respond timeout of a slave follows its response times, from
+ * this up to MB_MASTER_TIMEOUT_MS_RESPOND. */
+#define MB_MASTER_TIMEOUT_MS_RESPOND_MIN         ( 20 )
+/*! \brief A slave that misses this many responses in a row is dead, its
+ * requests complete at once with a timeout but for a probe now and then. */
+#define MB_MASTER_SLAVE_DEAD_MISSES              (  3 )
+/*! \brief The time between the probes of a dead slave, it doubles after
+ * every probe missed. */
+#define MB_MASTER_SLAVE_BACKOFF_MS_MIN           ( 1000 )
+#define MB_MASTER_SLAVE_BACKOFF_MS_MAX           ( 32000 )
+/*! \brief A request to a slave that just switched its baud rate waits this
+ * long, the slave changes over once its response is out. */
+#define MB_MASTER_BAUD_SETTLE_MS                 (  5 )
 /*! \brief The total slaves in Modbus Master system. Default 16.
  * \note : The slave ID must be continuous from 1.*/
 #define MB_MASTER_TOTAL_SLAVE_NUM              ( 16 )
+/*! \brief If master T3.5 and respond timeout run on a hardware timer (TIM7)
+ * instead of a kernel timer, so they do not depend on RT_TICK_PER_SECOND.
+ * A BSP without TIM7 (the host simulator) sets it to 0 on the command line. */
+#ifndef MB_MASTER_USING_HW_TIMER
+#define MB_MASTER_USING_HW_TIMER               (  1 )
+#endif
 #endif
 
 #endif
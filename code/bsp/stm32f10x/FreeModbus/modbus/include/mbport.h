@@ -89,17 +89,17 @@ BOOL            xMBPortEventPost( eMBEventType eEvent );
 
 BOOL            xMBPortEventGet(  /*@out@ */ eMBEventType * eEvent );
 
-BOOL            xMBMasterPortEventInit( void );
+BOOL            xMBMasterPortEventInit( xMBMasterInstance * pxMaster );
 
-BOOL            xMBMasterPortEventPost( eMBMasterEventType eEvent );
+BOOL            xMBMasterPortEventPost( xMBMasterInstance * pxMaster, eMBMasterEventType eEvent );
 
-BOOL            xMBMasterPortEventGet(  /*@out@ */ eMBMasterEventType * eEvent );
+BOOL            xMBMasterPortEventGet( xMBMasterInstance * pxMaster, /*@out@ */ eMBMasterEventType * eEvent );
 
-void            vMBMasterOsResInit( void );
+void            vMBMasterOsResInit( xMBMasterInstance * pxMaster );
 
-BOOL            xMBMasterRunResTake( int32_t time );
+BOOL            xMBMasterRunResTake( xMBMasterInstance * pxMaster, int32_t time );
 
-void            vMBMasterRunResRelease( void );
+void            vMBMasterRunResRelease( xMBMasterInstance * pxMaster );
 
 /* ----------------------- Serial port functions ----------------------------*/
 
@@ -116,18 +116,22 @@ INLINE BOOL     xMBPortSerialGetByte( CHAR * pucByte );
 
 INLINE BOOL     xMBPortSerialPutByte( CHAR ucByte );
 
-BOOL            xMBMasterPortSerialInit( UCHAR ucPort, ULONG ulBaudRate,
+BOOL            xMBMasterPortSerialInit( xMBMasterInstance * pxMaster, UCHAR ucPort, ULONG ulBaudRate,
                                    UCHAR ucDataBits, eMBParity eParity );
 
-void            vMBMasterPortClose( void );
+void            vMBMasterPortClose( xMBMasterInstance * pxMaster );
 
-void            xMBMasterPortSerialClose( void );
+void            xMBMasterPortSerialClose( xMBMasterInstance * pxMaster );
 
-void            vMBMasterPortSerialEnable( BOOL xRxEnable, BOOL xTxEnable );
+void            vMBMasterPortSerialEnable( xMBMasterInstance * pxMaster, BOOL xRxEnable, BOOL xTxEnable );
 
-INLINE BOOL     xMBMasterPortSerialGetByte( CHAR * pucByte );
+INLINE BOOL     xMBMasterPortSerialGetByte( xMBMasterInstance * pxMaster, CHAR * pucByte );
 
-INLINE BOOL     xMBMasterPortSerialPutByte( CHAR ucByte );
+BOOL            xMBMasterPortSerialPutFrame( xMBMasterInstance * pxMaster, const UCHAR * pucFrame, USHORT usLength );
+
+BOOL            xMBMasterPortSerialSetBaudRate( xMBMasterInstance * pxMaster, ULONG ulBaudRate );
+
+xMBMasterInstance *pxMBMasterPortSerialInstance( UCHAR ucPort );
 
 /* ----------------------- Timers functions ---------------------------------*/
 BOOL            xMBPortTimersInit( USHORT usTimeOut50us );
@@ -138,29 +142,37 @@ INLINE void     vMBPortTimersEnable( void );
 
 INLINE void     vMBPortTimersDisable( void );
 
-BOOL            xMBMasterPortTimersInit( USHORT usTimeOut50us );
+BOOL            xMBMasterPortTimersInit( xMBMasterInstance * pxMaster, USHORT usTimeOut50us );
 
-void            xMBMasterPortTimersClose( void );
+void            xMBMasterPortTimersClose( xMBMasterInstance * pxMaster );
 
-INLINE void     vMBMasterPortTimersT35Enable( void );
+INLINE void     vMBMasterPortTimersT35Enable( xMBMasterInstance * pxMaster );
 
-INLINE void     vMBMasterPortTimersConvertDelayEnable( void );
+void            vMBMasterPortTimersT35Set( xMBMasterInstance * pxMaster, USHORT usTimeOut50us );
 
-INLINE void     vMBMasterPortTimersRespondTimeoutEnable( void );
+INLINE void     vMBMasterPortTimersConvertDelayEnable( xMBMasterInstance * pxMaster );
 
-INLINE void     vMBMasterPortTimersDisable( void );
+INLINE void     vMBMasterPortTimersRespondTimeoutEnable( xMBMasterInstance * pxMaster );
+
+INLINE void     vMBMasterPortTimersDisable( xMBMasterInstance * pxMaster );
 
 /* ----------------- Callback for the master error process ------------------*/
-void            vMBMasterErrorCBRespondTimeout( UCHAR ucDestAddress, const UCHAR* pucPDUData,
-                                                USHORT ucPDULength );
+void            vMBMasterErrorCBRespondTimeout( xMBMasterInstance * pxMaster, UCHAR ucDestAddress,
+                                                const UCHAR* pucPDUData, USHORT ucPDULength );
+
+void            vMBMasterErrorCBReceiveData( xMBMasterInstance * pxMaster, UCHAR ucDestAddress,
+                                             const UCHAR* pucPDUData, USHORT ucPDULength );
 
-void            vMBMasterErrorCBReceiveData( UCHAR ucDestAddress, const UCHAR* pucPDUData,
-                                             USHORT ucPDULength );
+void            vMBMasterErrorCBExecuteFunction( xMBMasterInstance * pxMaster, UCHAR ucDestAddress,
+                                                 const UCHAR* pucPDUData, USHORT ucPDULength );
 
-void            vMBMasterErrorCBExecuteFunction( UCHAR ucDestAddress, const UCHAR* pucPDUData,
-                                                 USHORT ucPDULength );
+void            vMBMasterCBRequestScuuess( xMBMasterInstance * pxMaster );
 
-void            vMBMasterCBRequestScuuess( void );
+/* TRUE to complete the request with a respond timeout instead of sending it */
+BOOL            xMBMasterPortSlaveSkip( xMBMasterInstance * pxMaster );
+
+/* switch the line to the baud rate of the slave the request is for */
+void            vMBMasterPortSlaveSelect( xMBMasterInstance * pxMaster );
 
 /* ----------------------- Callback for the protocol stack ------------------*/
 
@@ -182,11 +194,9 @@ extern          BOOL( *pxMBFrameCBTransmitterEmpty ) ( void );
 
 extern          BOOL( *pxMBPortCBTimerExpired ) ( void );
 
-extern          BOOL( *pxMBMasterFrameCBByteReceived ) ( void );
-
-extern          BOOL( *pxMBMasterFrameCBTransmitterEmpty ) ( void );
-
-extern          BOOL( *pxMBMasterPortCBTimerExpired ) ( void );
+/* The Master ones are in its instance: pxFrameCBByteReceived,
+ * pxFrameCBTransmitterEmpty and pxPortCBTimerExpired.
+ */
 
 /* ----------------------- TCP port functions -------------------------------*/
 BOOL            xMBTCPPortInit( USHORT usTCPPort );
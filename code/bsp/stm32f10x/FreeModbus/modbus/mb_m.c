@@ -63,43 +63,10 @@
 
 /* ----------------------- Static variables ---------------------------------*/
 
-static UCHAR    ucMBMasterDestAddress;
-static BOOL     xMBRunInMasterMode = FALSE;
-static eMBMasterErrorEventType eMBMasterCurErrorType;
-
-static enum
-{
-    STATE_ENABLED,
-    STATE_DISABLED,
-    STATE_NOT_INITIALIZED
-} eMBState = STATE_NOT_INITIALIZED;
-
-/* Functions pointer which are initialized in eMBInit( ). Depending on the
- * mode (RTU or ASCII) the are set to the correct implementations.
- * Using for Modbus Master,Add by Armink 20130813
- */
-static peMBFrameSend peMBMasterFrameSendCur;
-static pvMBFrameStart pvMBMasterFrameStartCur;
-static pvMBFrameStop pvMBMasterFrameStopCur;
-static peMBFrameReceive peMBMasterFrameReceiveCur;
-static pvMBFrameClose pvMBMasterFrameCloseCur;
-
-/* Callback functions required by the porting layer. They are called when
- * an external event has happend which includes a timeout or the reception
- * or transmission of a character.
- * Using for Modbus Master,Add by Armink 20130813
- */
-BOOL( *pxMBMasterFrameCBByteReceived ) ( void );
-BOOL( *pxMBMasterFrameCBTransmitterEmpty ) ( void );
-BOOL( *pxMBMasterPortCBTimerExpired ) ( void );
-
-BOOL( *pxMBMasterFrameCBReceiveFSMCur ) ( void );
-BOOL( *pxMBMasterFrameCBTransmitFSMCur ) ( void );
-
 /* An array of Modbus functions handlers which associates Modbus function
- * codes with implementing functions.
+ * codes with implementing functions, the same for every instance.
  */
-static xMBFunctionHandler xMasterFuncHandlers[MB_FUNC_HANDLERS_MAX] = {
+static xMBMasterFunctionHandler xMasterFuncHandlers[MB_FUNC_HANDLERS_MAX] = {
 #if MB_FUNC_OTHER_REP_SLAVEID_ENABLED > 0
 	//TODO Add Master function define
     {MB_FUNC_OTHER_REPORT_SLAVEID, eMBFuncReportSlaveID},
@@ -131,42 +98,58 @@ static xMBFunctionHandler xMasterFuncHandlers[MB_FUNC_HANDLERS_MAX] = {
 #if MB_FUNC_READ_DISCRETE_INPUTS_ENABLED > 0
     {MB_FUNC_READ_DISCRETE_INPUTS, eMBMasterFuncReadDiscreteInputs},
 #endif
+#if MB_FUNC_BAUD_RATE_ENABLED > 0
+    {MB_FUNC_OTHER_BAUD_RATE, eMBMasterFuncBaudRate},
+#endif
 };
 
 /* ----------------------- Start implementation -----------------------------*/
 eMBErrorCode
-eMBMasterInit( eMBMode eMode, UCHAR ucPort, ULONG ulBaudRate, eMBParity eParity )
+eMBMasterInit( xMBMasterInstance * pxMaster, eMBMode eMode, UCHAR ucPort, ULONG ulBaudRate, eMBParity eParity )
 {
     eMBErrorCode    eStatus = MB_ENOERR;
 
+	memset( pxMaster, 0, sizeof( *pxMaster ) );
+
+	/* The OS resources first, the port may post an event as soon as the
+	 * serial port is open.
+	 */
+	if (!xMBMasterPortEventInit(pxMaster))
+	{
+		/* port dependent event module initalization failed. */
+		return MB_EPORTERR;
+	}
+	/* initialize the OS resource for modbus master. */
+	vMBMasterOsResInit(pxMaster);
+
 	switch (eMode)
 	{
 #if MB_MASTER_RTU_ENABLED > 0
 	case MB_RTU:
-		pvMBMasterFrameStartCur = eMBMasterRTUStart;
-		pvMBMasterFrameStopCur = eMBMasterRTUStop;
-		peMBMasterFrameSendCur = eMBMasterRTUSend;
-		peMBMasterFrameReceiveCur = eMBMasterRTUReceive;
-		pvMBMasterFrameCloseCur = MB_PORT_HAS_CLOSE ? vMBMasterPortClose : NULL;
-		pxMBMasterFrameCBByteReceived = xMBMasterRTUReceiveFSM;
-		pxMBMasterFrameCBTransmitterEmpty = xMBMasterRTUTransmitFSM;
-		pxMBMasterPortCBTimerExpired = xMBMasterRTUTimerExpired;
-
-		eStatus = eMBMasterRTUInit(ucPort, ulBaudRate, eParity);
+		pxMaster->pvFrameStartCur = eMBMasterRTUStart;
+		pxMaster->pvFrameStopCur = eMBMasterRTUStop;
+		pxMaster->peFrameSendCur = eMBMasterRTUSend;
+		pxMaster->peFrameReceiveCur = eMBMasterRTUReceive;
+		pxMaster->pvFrameCloseCur = MB_PORT_HAS_CLOSE ? vMBMasterPortClose : NULL;
+		pxMaster->pxFrameCBByteReceived = xMBMasterRTUReceiveFSM;
+		pxMaster->pxFrameCBTransmitterEmpty = xMBMasterRTUTransmitFSM;
+		pxMaster->pxPortCBTimerExpired = xMBMasterRTUTimerExpired;
+
+		eStatus = eMBMasterRTUInit(pxMaster, ucPort, ulBaudRate, eParity);
 		break;
 #endif
 #if MB_MASTER_ASCII_ENABLED > 0
 		case MB_ASCII:
-		pvMBMasterFrameStartCur = eMBMasterASCIIStart;
-		pvMBMasterFrameStopCur = eMBMasterASCIIStop;
-		peMBMasterFrameSendCur = eMBMasterASCIISend;
-		peMBMasterFrameReceiveCur = eMBMasterASCIIReceive;
-		pvMBMasterFrameCloseCur = MB_PORT_HAS_CLOSE ? vMBMasterPortClose : NULL;
-		pxMBMasterFrameCBByteReceived = xMBMasterASCIIReceiveFSM;
-		pxMBMasterFrameCBTransmitterEmpty = xMBMasterASCIITransmitFSM;
-		pxMBMasterPortCBTimerExpired = xMBMasterASCIITimerT1SExpired;
-
-		eStatus = eMBMasterASCIIInit(ucPort, ulBaudRate, eParity );
+		pxMaster->pvFrameStartCur = eMBMasterASCIIStart;
+		pxMaster->pvFrameStopCur = eMBMasterASCIIStop;
+		pxMaster->peFrameSendCur = eMBMasterASCIISend;
+		pxMaster->peFrameReceiveCur = eMBMasterASCIIReceive;
+		pxMaster->pvFrameCloseCur = MB_PORT_HAS_CLOSE ? vMBMasterPortClose : NULL;
+		pxMaster->pxFrameCBByteReceived = xMBMasterASCIIReceiveFSM;
+		pxMaster->pxFrameCBTransmitterEmpty = xMBMasterASCIITransmitFSM;
+		pxMaster->pxPortCBTimerExpired = xMBMasterASCIITimerT1SExpired;
+
+		eStatus = eMBMasterASCIIInit(pxMaster, ucPort, ulBaudRate, eParity );
 		break;
 #endif
 	default:
@@ -176,31 +159,21 @@ eMBMasterInit( eMBMode eMode, UCHAR ucPort, ULONG ulBaudRate, eMBParity eParity
 
 	if (eStatus == MB_ENOERR)
 	{
-		if (!xMBMasterPortEventInit())
-		{
-			/* port dependent event module initalization failed. */
-			eStatus = MB_EPORTERR;
-		}
-		else
-		{
-			eMBState = STATE_DISABLED;
-		}
-		/* initialize the OS resource for modbus master. */
-		vMBMasterOsResInit();
+		pxMaster->eState = STATE_M_DISABLED;
 	}
 	return eStatus;
 }
 
 eMBErrorCode
-eMBMasterClose( void )
+eMBMasterClose( xMBMasterInstance * pxMaster )
 {
     eMBErrorCode    eStatus = MB_ENOERR;
 
-    if( eMBState == STATE_DISABLED )
+    if( pxMaster->eState == STATE_M_DISABLED )
     {
-        if( pvMBMasterFrameCloseCur != NULL )
+        if( pxMaster->pvFrameCloseCur != NULL )
         {
-            pvMBMasterFrameCloseCur(  );
+            pxMaster->pvFrameCloseCur( pxMaster );
         }
     }
     else
@@ -211,15 +184,15 @@ eMBMasterClose( void )
 }
 
 eMBErrorCode
-eMBMasterEnable( void )
+eMBMasterEnable( xMBMasterInstance * pxMaster )
 {
     eMBErrorCode    eStatus = MB_ENOERR;
 
-    if( eMBState == STATE_DISABLED )
+    if( pxMaster->eState == STATE_M_DISABLED )
     {
         /* Activate the protocol stack. */
-        pvMBMasterFrameStartCur(  );
-        eMBState = STATE_ENABLED;
+        pxMaster->pvFrameStartCur( pxMaster );
+        pxMaster->eState = STATE_M_ENABLED;
     }
     else
     {
@@ -229,17 +202,17 @@ eMBMasterEnable( void )
 }
 
 eMBErrorCode
-eMBMasterDisable( void )
+eMBMasterDisable( xMBMasterInstance * pxMaster )
 {
     eMBErrorCode    eStatus;
 
-    if( eMBState == STATE_ENABLED )
+    if( pxMaster->eState == STATE_M_ENABLED )
     {
-        pvMBMasterFrameStopCur(  );
-        eMBState = STATE_DISABLED;
+        pxMaster->pvFrameStopCur( pxMaster );
+        pxMaster->eState = STATE_M_DISABLED;
         eStatus = MB_ENOERR;
     }
-    else if( eMBState == STATE_DISABLED )
+    else if( pxMaster->eState == STATE_M_DISABLED )
     {
         eStatus = MB_ENOERR;
     }
@@ -251,13 +224,11 @@ eMBMasterDisable( void )
 }
 
 eMBErrorCode
-eMBMasterPoll( void )
+eMBMasterPoll( xMBMasterInstance * pxMaster )
 {
-    static UCHAR   *ucMBFrame;
-    static UCHAR    ucRcvAddress;
-    static UCHAR    ucFunctionCode;
-    static USHORT   usLength;
-    static eMBException eException;
+    UCHAR           ucFunctionCode;
+    eMBException    eException;
+    UCHAR          *ucMBFrame;
 
     int             i , j;
     eMBErrorCode    eStatus = MB_ENOERR;
@@ -265,14 +236,14 @@ eMBMasterPoll( void )
     eMBMasterErrorEventType errorType;
 
     /* Check if the protocol stack is ready. */
-    if( eMBState != STATE_ENABLED )
+    if( pxMaster->eState != STATE_M_ENABLED )
     {
         return MB_EILLSTATE;
     }
 
     /* Check if there is a event available. If not return control to caller.
      * Otherwise we will handle the event. */
-    if( xMBMasterPortEventGet( &eEvent ) == TRUE )
+    if( xMBMasterPortEventGet( pxMaster, &eEvent ) == TRUE )
     {
         switch ( eEvent )
         {
@@ -280,20 +251,39 @@ eMBMasterPoll( void )
             break;
 
         case EV_MASTER_FRAME_RECEIVED:
-			eStatus = peMBMasterFrameReceiveCur( &ucRcvAddress, &ucMBFrame, &usLength );
+			eStatus = pxMaster->peFrameReceiveCur( pxMaster, &pxMaster->ucRcvAddress,
+					&pxMaster->pucMBFrame, &pxMaster->usLength );
+#if MB_MASTER_RTU_ENABLED > 0
+			/* The reply to a raw frame is the result, there is nothing to execute. */
+			if ( xMBMasterRTURequestIsRaw( pxMaster ) )
+			{
+				if ( eStatus == MB_ENOERR )
+				{
+					vMBMasterCBRequestScuuess( pxMaster );
+					vMBMasterRunResRelease( pxMaster );
+				}
+				else
+				{
+					vMBMasterSetErrorType(pxMaster, EV_ERROR_RECEIVE_DATA);
+					( void ) xMBMasterPortEventPost( pxMaster, EV_MASTER_ERROR_PROCESS );
+				}
+				break;
+			}
+#endif
 			/* Check if the frame is for us. If not ,send an error process event. */
-			if ( ( eStatus == MB_ENOERR ) && ( ucRcvAddress == ucMBMasterGetDestAddress() ) )
+			if ( ( eStatus == MB_ENOERR ) && ( pxMaster->ucRcvAddress == ucMBMasterGetDestAddress(pxMaster) ) )
 			{
-				( void ) xMBMasterPortEventPost( EV_MASTER_EXECUTE );
+				( void ) xMBMasterPortEventPost( pxMaster, EV_MASTER_EXECUTE );
 			}
 			else
 			{
-				vMBMasterSetErrorType(EV_ERROR_RECEIVE_DATA);
-				( void ) xMBMasterPortEventPost( EV_MASTER_ERROR_PROCESS );
+				vMBMasterSetErrorType(pxMaster, EV_ERROR_RECEIVE_DATA);
+				( void ) xMBMasterPortEventPost( pxMaster, EV_MASTER_ERROR_PROCESS );
 			}
 			break;
 
         case EV_MASTER_EXECUTE:
+            ucMBFrame = pxMaster->pucMBFrame;
             ucFunctionCode = ucMBFrame[MB_PDU_FUNC_OFF];
             eException = MB_EX_ILLEGAL_FUNCTION;
             /* If receive frame has exception .The receive function code highest bit is 1.*/
@@ -309,61 +299,70 @@ eMBMasterPoll( void )
 						break;
 					}
 					else if (xMasterFuncHandlers[i].ucFunctionCode == ucFunctionCode) {
-						vMBMasterSetCBRunInMasterMode(TRUE);
+						vMBMasterSetCBRunInMasterMode(pxMaster, TRUE);
 						/* If master request is broadcast,
 						 * the master need execute function for all slave.
 						 */
-						if ( xMBMasterRequestIsBroadcast() ) {
-							usLength = usMBMasterGetPDUSndLength();
+						if ( xMBMasterRequestIsBroadcast(pxMaster) ) {
+							pxMaster->usLength = usMBMasterGetPDUSndLength(pxMaster);
 							for(j = 1; j <= MB_MASTER_TOTAL_SLAVE_NUM; j++){
-								vMBMasterSetDestAddress(j);
-								eException = xMasterFuncHandlers[i].pxHandler(ucMBFrame, &usLength);
+								vMBMasterSetDestAddress(pxMaster, j);
+								eException = xMasterFuncHandlers[i].pxHandler(pxMaster, ucMBFrame, &pxMaster->usLength);
 							}
 						}
 						else {
-							eException = xMasterFuncHandlers[i].pxHandler(ucMBFrame, &usLength);
+							eException = xMasterFuncHandlers[i].pxHandler(pxMaster, ucMBFrame, &pxMaster->usLength);
 						}
-						vMBMasterSetCBRunInMasterMode(FALSE);
+						vMBMasterSetCBRunInMasterMode(pxMaster, FALSE);
 						break;
 					}
 				}
 			}
             /* If master has exception ,Master will send error process.Otherwise the Master is idle.*/
             if (eException != MB_EX_NONE) {
-            	vMBMasterSetErrorType(EV_ERROR_EXECUTE_FUNCTION);
-            	( void ) xMBMasterPortEventPost( EV_MASTER_ERROR_PROCESS );
+            	vMBMasterSetErrorType(pxMaster, EV_ERROR_EXECUTE_FUNCTION);
+            	( void ) xMBMasterPortEventPost( pxMaster, EV_MASTER_ERROR_PROCESS );
             }
             else {
-            	vMBMasterCBRequestScuuess( );
-            	vMBMasterRunResRelease( );
+            	vMBMasterCBRequestScuuess( pxMaster );
+            	vMBMasterRunResRelease( pxMaster );
             }
             break;
 
         case EV_MASTER_FRAME_SENT:
+			/* A slave that stopped answering is only probed now and then. */
+			if ( xMBMasterPortSlaveSkip( pxMaster ) )
+			{
+				vMBMasterSetErrorType(pxMaster, EV_ERROR_RESPOND_TIMEOUT);
+				( void ) xMBMasterPortEventPost( pxMaster, EV_MASTER_ERROR_PROCESS );
+				break;
+			}
+			vMBMasterPortSlaveSelect( pxMaster );
         	/* Master is busy now. */
-        	vMBMasterGetPDUSndBuf( &ucMBFrame );
-			eStatus = peMBMasterFrameSendCur( ucMBMasterGetDestAddress(), ucMBFrame, usMBMasterGetPDUSndLength() );
+        	vMBMasterGetPDUSndBuf( pxMaster, &ucMBFrame );
+			eStatus = pxMaster->peFrameSendCur( pxMaster, ucMBMasterGetDestAddress(pxMaster),
+					ucMBFrame, usMBMasterGetPDUSndLength(pxMaster) );
             break;
 
         case EV_MASTER_ERROR_PROCESS:
         	/* Execute specified error process callback function. */
-			errorType = eMBMasterGetErrorType();
-			vMBMasterGetPDUSndBuf( &ucMBFrame );
+			errorType = eMBMasterGetErrorType(pxMaster);
+			vMBMasterGetPDUSndBuf( pxMaster, &ucMBFrame );
 			switch (errorType) {
 			case EV_ERROR_RESPOND_TIMEOUT:
-				vMBMasterErrorCBRespondTimeout(ucMBMasterGetDestAddress(),
-						ucMBFrame, usMBMasterGetPDUSndLength());
+				vMBMasterErrorCBRespondTimeout(pxMaster, ucMBMasterGetDestAddress(pxMaster),
+						ucMBFrame, usMBMasterGetPDUSndLength(pxMaster));
 				break;
 			case EV_ERROR_RECEIVE_DATA:
-				vMBMasterErrorCBReceiveData(ucMBMasterGetDestAddress(),
-						ucMBFrame, usMBMasterGetPDUSndLength());
+				vMBMasterErrorCBReceiveData(pxMaster, ucMBMasterGetDestAddress(pxMaster),
+						ucMBFrame, usMBMasterGetPDUSndLength(pxMaster));
 				break;
 			case EV_ERROR_EXECUTE_FUNCTION:
-				vMBMasterErrorCBExecuteFunction(ucMBMasterGetDestAddress(),
-						ucMBFrame, usMBMasterGetPDUSndLength());
+				vMBMasterErrorCBExecuteFunction(pxMaster, ucMBMasterGetDestAddress(pxMaster),
+						ucMBFrame, usMBMasterGetPDUSndLength(pxMaster));
 				break;
 			}
-			vMBMasterRunResRelease();
+			vMBMasterRunResRelease(pxMaster);
         	break;
         }
     }
@@ -371,34 +370,34 @@ eMBMasterPoll( void )
 }
 
 /* Get whether the Modbus Master is run in master mode.*/
-BOOL xMBMasterGetCBRunInMasterMode( void )
+BOOL xMBMasterGetCBRunInMasterMode( xMBMasterInstance * pxMaster )
 {
-	return xMBRunInMasterMode;
+	return pxMaster->xRunInMasterMode;
 }
 /* Set whether the Modbus Master is run in master mode.*/
-void vMBMasterSetCBRunInMasterMode( BOOL IsMasterMode )
+void vMBMasterSetCBRunInMasterMode( xMBMasterInstance * pxMaster, BOOL IsMasterMode )
 {
-	xMBRunInMasterMode = IsMasterMode;
+	pxMaster->xRunInMasterMode = IsMasterMode;
 }
 /* Get Modbus Master send destination address. */
-UCHAR ucMBMasterGetDestAddress( void )
+UCHAR ucMBMasterGetDestAddress( xMBMasterInstance * pxMaster )
 {
-	return ucMBMasterDestAddress;
+	return pxMaster->ucDestAddress;
 }
 /* Set Modbus Master send destination address. */
-void vMBMasterSetDestAddress( UCHAR Address )
+void vMBMasterSetDestAddress( xMBMasterInstance * pxMaster, UCHAR Address )
 {
-	ucMBMasterDestAddress = Address;
+	pxMaster->ucDestAddress = Address;
 }
 /* Get Modbus Master current error event type. */
-eMBMasterErrorEventType eMBMasterGetErrorType( void )
+eMBMasterErrorEventType eMBMasterGetErrorType( xMBMasterInstance * pxMaster )
 {
-	return eMBMasterCurErrorType;
+	return pxMaster->eCurErrorType;
 }
 /* Set Modbus Master current error event type. */
-void vMBMasterSetErrorType( eMBMasterErrorEventType errorType )
+void vMBMasterSetErrorType( xMBMasterInstance * pxMaster, eMBMasterErrorEventType errorType )
 {
-	eMBMasterCurErrorType = errorType;
+	pxMaster->eCurErrorType = errorType;
 }
 
 
@@ -96,3 +96,15 @@ usMBCRC16( UCHAR * pucFrame, USHORT usLen )
     }
     return ( USHORT )( ucCRCHi << 8 | ucCRCLo );
 }
+
+/* Fold one more byte into a CRC started at 0xFFFF. A frame followed by
+ * its own CRC folds to 0, so the receiver can check a frame as it comes.
+ */
+USHORT
+usMBCRC16Update( USHORT usCRC, UCHAR ucByte )
+{
+    int             iIndex;
+
+    iIndex = ( UCHAR )( usCRC ^ ucByte );
+    return ( USHORT )( aucCRCLo[iIndex] << 8 | ( UCHAR )( ( usCRC >> 8 ) ^ aucCRCHi[iIndex] ) );
+}
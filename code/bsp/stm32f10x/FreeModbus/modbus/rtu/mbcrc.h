@@ -33,4 +33,7 @@
 
 USHORT          usMBCRC16( UCHAR * pucFrame, USHORT usLen );
 
+#define MB_CRC16_INIT   0xFFFF
+USHORT          usMBCRC16Update( USHORT usCRC, UCHAR ucByte );
+
 #endif
@@ -75,6 +75,7 @@ static volatile UCHAR *pucSndBufferCur;
 static volatile USHORT usSndBufferCount;
 
 static volatile USHORT usRcvBufferPos;
+static volatile USHORT usRcvCRC;        /*!< CRC of the bytes received so far. */
 
 /* ----------------------- Start implementation -----------------------------*/
 eMBErrorCode
@@ -155,9 +156,9 @@ eMBRTUReceive( UCHAR * pucRcvAddress, UCHAR ** pucFrame, USHORT * pusLength )
     ENTER_CRITICAL_SECTION(  );
     assert_param( usRcvBufferPos < MB_SER_PDU_SIZE_MAX );
 
-    /* Length and CRC check */
+    /* Length and CRC check, the CRC was folded in as the bytes came */
     if( ( usRcvBufferPos >= MB_SER_PDU_SIZE_MIN )
-        && ( usMBCRC16( ( UCHAR * ) ucRTUBuf, usRcvBufferPos ) == 0 ) )
+        && ( usRcvCRC == 0 ) )
     {
         /* Save the address field. All frames are passed to the upper layed
          * and the decision if a frame is used is done there.
@@ -254,6 +255,7 @@ xMBRTUReceiveFSM( void )
     case STATE_RX_IDLE:
         usRcvBufferPos = 0;
         ucRTUBuf[usRcvBufferPos++] = ucByte;
+        usRcvCRC = usMBCRC16Update( MB_CRC16_INIT, ucByte );
         eRcvState = STATE_RX_RCV;
 
         /* Enable t3.5 timers. */
@@ -269,6 +271,7 @@ xMBRTUReceiveFSM( void )
         if( usRcvBufferPos < MB_SER_PDU_SIZE_MAX )
         {
             ucRTUBuf[usRcvBufferPos++] = ucByte;
+            usRcvCRC = usMBCRC16Update( usRcvCRC, ucByte );
         }
         else
         {
@@ -48,14 +48,20 @@ BOOL            xMBRTUTimerT15Expired( void );
 BOOL            xMBRTUTimerT35Expired( void );
 
 #if MB_MASTER_RTU_ENABLED > 0
-eMBErrorCode    eMBMasterRTUInit( UCHAR ucPort, ULONG ulBaudRate,eMBParity eParity );
-void            eMBMasterRTUStart( void );
-void            eMBMasterRTUStop( void );
-eMBErrorCode    eMBMasterRTUReceive( UCHAR * pucRcvAddress, UCHAR ** pucFrame, USHORT * pusLength );
-eMBErrorCode    eMBMasterRTUSend( UCHAR slaveAddress, const UCHAR * pucFrame, USHORT usLength );
-BOOL            xMBMasterRTUReceiveFSM( void );
-BOOL            xMBMasterRTUTransmitFSM( void );
-BOOL            xMBMasterRTUTimerExpired( void );
+eMBErrorCode    eMBMasterRTUInit( xMBMasterInstance * pxMaster, UCHAR ucPort, ULONG ulBaudRate,eMBParity eParity );
+void            eMBMasterRTUStart( xMBMasterInstance * pxMaster );
+void            eMBMasterRTUStop( xMBMasterInstance * pxMaster );
+eMBErrorCode    eMBMasterRTUReceive( xMBMasterInstance * pxMaster, UCHAR * pucRcvAddress, UCHAR ** pucFrame, USHORT * pusLength );
+eMBErrorCode    eMBMasterRTUSend( xMBMasterInstance * pxMaster, UCHAR slaveAddress, const UCHAR * pucFrame, USHORT usLength );
+BOOL            xMBMasterRTUReceiveFSM( xMBMasterInstance * pxMaster );
+BOOL            xMBMasterRTUTransmitFSM( xMBMasterInstance * pxMaster );
+BOOL            xMBMasterRTUTimerExpired( xMBMasterInstance * pxMaster );
+void            vMBMasterRTUSetEarlyFrameEnd( xMBMasterInstance * pxMaster, BOOL xEnable );
+void            vMBMasterRTUSetRaw( xMBMasterInstance * pxMaster, const UCHAR * pucFrame, USHORT usReplyExpect, USHORT usReplyEnd );
+BOOL            xMBMasterRTURequestIsRaw( xMBMasterInstance * pxMaster );
+void            vMBMasterRTUSetRcvBuf( xMBMasterInstance * pxMaster, UCHAR * pucRcvBuf, USHORT usSize );
+USHORT          usMBMasterRTUGetRcvLength( xMBMasterInstance * pxMaster );
+BOOL            xMBMasterRTUSetBaudRate( xMBMasterInstance * pxMaster, ULONG ulBaudRate );
 #endif
 
 #ifdef __cplusplus
@@ -52,85 +52,68 @@
 #define MB_SER_PDU_ADDR_OFF     0       /*!< Offset of slave address in Ser-PDU. */
 #define MB_SER_PDU_PDU_OFF      1       /*!< Offset of Modbus-PDU in Ser-PDU. */
 
-/* ----------------------- Type definitions ---------------------------------*/
-typedef enum
-{
-    STATE_M_RX_INIT,              /*!< Receiver is in initial state. */
-    STATE_M_RX_IDLE,              /*!< Receiver is in idle state. */
-    STATE_M_RX_RCV,               /*!< Frame is beeing received. */
-    STATE_M_RX_ERROR,              /*!< If the frame is invalid. */
-} eMBMasterRcvState;
-
-typedef enum
+/* ----------------------- Start implementation -----------------------------*/
+static USHORT
+prvusMBMasterRTUT35( ULONG ulBaudRate )
 {
-    STATE_M_TX_IDLE,              /*!< Transmitter is in idle state. */
-    STATE_M_TX_XMIT,              /*!< Transmitter is in transfer state. */
-    STATE_M_TX_XFWR,              /*!< Transmitter is in transfer finish and wait receive state. */
-} eMBMasterSndState;
-
-/* ----------------------- Static variables ---------------------------------*/
-static volatile eMBMasterSndState eSndState;
-static volatile eMBMasterRcvState eRcvState;
-
- volatile UCHAR  ucMasterRTUSndBuf[MB_PDU_SIZE_MAX];
- volatile UCHAR  ucMasterRTURcvBuf[MB_SER_PDU_SIZE_MAX];
-static volatile USHORT usMasterSendPDULength;
-
-static volatile UCHAR *pucMasterSndBufferCur;
-static volatile USHORT usMasterSndBufferCount;
-
-static volatile USHORT usMasterRcvBufferPos;
-static volatile BOOL   xFrameIsBroadcast = FALSE;
-
-static volatile eMBMasterTimerMode eMasterCurTimerMode;
+    /* If baudrate > 19200 then we should use the fixed timer values
+     * t35 = 1750us. Otherwise t35 must be 3.5 times the character time.
+     */
+    if( ulBaudRate > 19200 )
+    {
+        return 35;                      /* 1800us. */
+    }
+    /* The timer reload value for a character is given by:
+     *
+     * ChTimeValue = Ticks_per_1s / ( Baudrate / 11 )
+     *             = 11 * Ticks_per_1s / Baudrate
+     *             = 220000 / Baudrate
+     * The reload for t3.5 is 1.5 times this value and similary
+     * for t3.5.
+     */
+    return ( USHORT )( ( 7UL * 220000UL ) / ( 2UL * ulBaudRate ) );
+}
 
-/* ----------------------- Start implementation -----------------------------*/
 eMBErrorCode
-eMBMasterRTUInit(UCHAR ucPort, ULONG ulBaudRate, eMBParity eParity )
+eMBMasterRTUInit(xMBMasterInstance * pxMaster, UCHAR ucPort, ULONG ulBaudRate, eMBParity eParity )
 {
     eMBErrorCode    eStatus = MB_ENOERR;
-    ULONG           usTimerT35_50us;
 
     ENTER_CRITICAL_SECTION(  );
 
+    /* responses go into our own buffer, passed on at their last byte */
+    pxMaster->pucRcvBuf = pxMaster->ucRTURcvBuf;
+    pxMaster->usRcvBufSize = MB_SER_PDU_SIZE_MAX;
+    pxMaster->xRcvEarlyEnd = TRUE;
+
     /* Modbus RTU uses 8 Databits. */
-    if( xMBMasterPortSerialInit( ucPort, ulBaudRate, 8, eParity ) != TRUE )
+    if( xMBMasterPortSerialInit( pxMaster, ucPort, ulBaudRate, 8, eParity ) != TRUE )
     {
         eStatus = MB_EPORTERR;
     }
-    else
+    else if( xMBMasterPortTimersInit( pxMaster, prvusMBMasterRTUT35( ulBaudRate ) ) != TRUE )
     {
-        /* If baudrate > 19200 then we should use the fixed timer values
-         * t35 = 1750us. Otherwise t35 must be 3.5 times the character time.
-         */
-        if( ulBaudRate > 19200 )
-        {
-            usTimerT35_50us = 35;       /* 1800us. */
-        }
-        else
-        {
-            /* The timer reload value for a character is given by:
-             *
-             * ChTimeValue = Ticks_per_1s / ( Baudrate / 11 )
-             *             = 11 * Ticks_per_1s / Baudrate
-             *             = 220000 / Baudrate
-             * The reload for t3.5 is 1.5 times this value and similary
-             * for t3.5.
-             */
-            usTimerT35_50us = ( 7UL * 220000UL ) / ( 2UL * ulBaudRate );
-        }
-        if( xMBMasterPortTimersInit( ( USHORT ) usTimerT35_50us ) != TRUE )
-        {
-            eStatus = MB_EPORTERR;
-        }
+        eStatus = MB_EPORTERR;
     }
     EXIT_CRITICAL_SECTION(  );
 
     return eStatus;
 }
 
+/* Only between two requests, the line is silent then. */
+BOOL
+xMBMasterRTUSetBaudRate( xMBMasterInstance * pxMaster, ULONG ulBaudRate )
+{
+    if( ulBaudRate == 0 || xMBMasterPortSerialSetBaudRate( pxMaster, ulBaudRate ) != TRUE )
+    {
+        return FALSE;
+    }
+    vMBMasterPortTimersT35Set( pxMaster, prvusMBMasterRTUT35( ulBaudRate ) );
+    return TRUE;
+}
+
 void
-eMBMasterRTUStart( void )
+eMBMasterRTUStart( xMBMasterInstance * pxMaster )
 {
     ENTER_CRITICAL_SECTION(  );
     /* Initially the receiver is in the state STATE_M_RX_INIT. we start
@@ -138,46 +121,53 @@ eMBMasterRTUStart( void )
      * to STATE_M_RX_IDLE. This makes sure that we delay startup of the
      * modbus protocol stack until the bus is free.
      */
-    eRcvState = STATE_M_RX_INIT;
-    vMBMasterPortSerialEnable( TRUE, FALSE );
-    vMBMasterPortTimersT35Enable(  );
+    pxMaster->eRcvState = STATE_M_RX_INIT;
+    vMBMasterPortSerialEnable( pxMaster, TRUE, FALSE );
+    vMBMasterPortTimersT35Enable( pxMaster );
 
     EXIT_CRITICAL_SECTION(  );
 }
 
 void
-eMBMasterRTUStop( void )
+eMBMasterRTUStop( xMBMasterInstance * pxMaster )
 {
     ENTER_CRITICAL_SECTION(  );
-    vMBMasterPortSerialEnable( FALSE, FALSE );
-    vMBMasterPortTimersDisable(  );
+    vMBMasterPortSerialEnable( pxMaster, FALSE, FALSE );
+    vMBMasterPortTimersDisable( pxMaster );
     EXIT_CRITICAL_SECTION(  );
 }
 
 eMBErrorCode
-eMBMasterRTUReceive( UCHAR * pucRcvAddress, UCHAR ** pucFrame, USHORT * pusLength )
+eMBMasterRTUReceive( xMBMasterInstance * pxMaster, UCHAR * pucRcvAddress, UCHAR ** pucFrame, USHORT * pusLength )
 {
     eMBErrorCode    eStatus = MB_ENOERR;
 
     ENTER_CRITICAL_SECTION(  );
-    assert_param( usMasterRcvBufferPos < MB_SER_PDU_SIZE_MAX );
+    assert_param( pxMaster->usRcvBufferPos <= pxMaster->usRcvBufSize );
 
-    /* Length and CRC check */
-    if( ( usMasterRcvBufferPos >= MB_SER_PDU_SIZE_MIN )
-        && ( usMBCRC16( ( UCHAR * ) ucMasterRTURcvBuf, usMasterRcvBufferPos ) == 0 ) )
+    /* The reply to a raw frame is returned whole, it has no CRC. */
+    if( pxMaster->pucRawFrame != NULL )
+    {
+        *pucRcvAddress = pxMaster->pucRcvBuf[MB_SER_PDU_ADDR_OFF];
+        *pusLength = pxMaster->usRcvBufferPos;
+        *pucFrame = ( UCHAR * ) pxMaster->pucRcvBuf;
+    }
+    /* Length and CRC check, the CRC was folded in as the bytes came */
+    else if( ( pxMaster->usRcvBufferPos >= MB_SER_PDU_SIZE_MIN )
+        && ( pxMaster->usRcvCRC == 0 ) )
     {
         /* Save the address field. All frames are passed to the upper layed
          * and the decision if a frame is used is done there.
          */
-        *pucRcvAddress = ucMasterRTURcvBuf[MB_SER_PDU_ADDR_OFF];
+        *pucRcvAddress = pxMaster->pucRcvBuf[MB_SER_PDU_ADDR_OFF];
 
         /* Total length of Modbus-PDU is Modbus-Serial-Line-PDU minus
          * size of address field and CRC checksum.
          */
-        *pusLength = ( USHORT )( usMasterRcvBufferPos - MB_SER_PDU_PDU_OFF - MB_SER_PDU_SIZE_CRC );
+        *pusLength = ( USHORT )( pxMaster->usRcvBufferPos - MB_SER_PDU_PDU_OFF - MB_SER_PDU_SIZE_CRC );
 
         /* Return the start of the Modbus PDU to the caller. */
-        *pucFrame = ( UCHAR * ) & ucMasterRTURcvBuf[MB_SER_PDU_PDU_OFF];
+        *pucFrame = ( UCHAR * ) & pxMaster->pucRcvBuf[MB_SER_PDU_PDU_OFF];
     }
     else
     {
@@ -190,12 +180,11 @@ eMBMasterRTUReceive( UCHAR * pucRcvAddress, UCHAR ** pucFrame, USHORT * pusLengt
 
 
 
-eMBErrorCode
-eMBMaster_Send_not_datas(UCHAR * pucFrame, USHORT usLength )//ͷǱ׼
+/* Send a frame that is not Modbus as it is, from the buffer of the caller. */
+static eMBErrorCode
+prveMBMasterRTUSendRaw( xMBMasterInstance * pxMaster, const UCHAR * pucFrame, USHORT usLength )
 {
     eMBErrorCode    eStatus = MB_ENOERR;
-    USHORT          usCRC16;
-
 
     ENTER_CRITICAL_SECTION(  );
 
@@ -203,16 +192,17 @@ eMBMaster_Send_not_datas(UCHAR * pucFrame, USHORT usLength )//
      * slow with processing the received frame and the master sent another
      * frame on the network. We have to abort sending the frame.
      */
-    if( eRcvState == STATE_M_RX_IDLE )
+    if( ( pxMaster->eRcvState == STATE_M_RX_IDLE ) || ( pxMaster->eRcvState == STATE_M_RX_DONE ) )
     {
-        /* First byte before the Modbus-PDU is the slave address. */
-        pucMasterSndBufferCur = ( UCHAR * ) pucFrame;
-        usMasterSndBufferCount = usLength;
+        pxMaster->pucSndBufferCur = ( UCHAR * ) pucFrame;
+        pxMaster->usSndBufferCount = usLength;
 
-
-        /* Activate the transmitter. */
-        eSndState = STATE_M_TX_XMIT;
-        vMBMasterPortSerialEnable( FALSE, TRUE );
+        /* Activate the transmitter, after the t3.5 of the last response. */
+        pxMaster->eSndState = STATE_M_TX_XMIT;
+        if( pxMaster->eRcvState == STATE_M_RX_IDLE )
+        {
+            vMBMasterPortSerialEnable( pxMaster, FALSE, TRUE );
+        }
     }
     else
     {
@@ -222,22 +212,17 @@ eMBMaster_Send_not_datas(UCHAR * pucFrame, USHORT usLength )//
     return eStatus;
 }
 
-extern u8 mb_switch_flag;
-extern u8 mb_not_rtu_data_len;
-extern u8 rs485_send_buf_not_modbus[50];
-
 eMBErrorCode
-eMBMasterRTUSend( UCHAR ucSlaveAddress, const UCHAR * pucFrame, USHORT usLength )
+eMBMasterRTUSend( xMBMasterInstance * pxMaster, UCHAR ucSlaveAddress, const UCHAR * pucFrame, USHORT usLength )
 {
     eMBErrorCode    eStatus = MB_ENOERR;
     USHORT          usCRC16;
 
-    if(mb_switch_flag)
+    if( pxMaster->pucRawFrame != NULL )
     {
-        return (eMBMaster_Send_not_datas(rs485_send_buf_not_modbus,mb_not_rtu_data_len) );
-        
+        return prveMBMasterRTUSendRaw( pxMaster, pxMaster->pucRawFrame, usLength );
     }
-    
+
     if ( ucSlaveAddress > MB_MASTER_TOTAL_SLAVE_NUM ) return MB_EINVAL;
 
     ENTER_CRITICAL_SECTION(  );
@@ -246,24 +231,27 @@ eMBMasterRTUSend( UCHAR ucSlaveAddress, const UCHAR * pucFrame, USHORT usLength
      * slow with processing the received frame and the master sent another
      * frame on the network. We have to abort sending the frame.
      */
-    if( eRcvState == STATE_M_RX_IDLE )
+    if( ( pxMaster->eRcvState == STATE_M_RX_IDLE ) || ( pxMaster->eRcvState == STATE_M_RX_DONE ) )
     {
         /* First byte before the Modbus-PDU is the slave address. */
-        pucMasterSndBufferCur = ( UCHAR * ) pucFrame - 1;
-        usMasterSndBufferCount = 1;
+        pxMaster->pucSndBufferCur = ( UCHAR * ) pucFrame - 1;
+        pxMaster->usSndBufferCount = 1;
 
         /* Now copy the Modbus-PDU into the Modbus-Serial-Line-PDU. */
-        pucMasterSndBufferCur[MB_SER_PDU_ADDR_OFF] = ucSlaveAddress;
-        usMasterSndBufferCount += usLength;
+        pxMaster->pucSndBufferCur[MB_SER_PDU_ADDR_OFF] = ucSlaveAddress;
+        pxMaster->usSndBufferCount += usLength;
 
         /* Calculate CRC16 checksum for Modbus-Serial-Line-PDU. */
-        usCRC16 = usMBCRC16( ( UCHAR * ) pucMasterSndBufferCur, usMasterSndBufferCount );
-        ucMasterRTUSndBuf[usMasterSndBufferCount++] = ( UCHAR )( usCRC16 & 0xFF );
-        ucMasterRTUSndBuf[usMasterSndBufferCount++] = ( UCHAR )( usCRC16 >> 8 );
+        usCRC16 = usMBCRC16( ( UCHAR * ) pxMaster->pucSndBufferCur, pxMaster->usSndBufferCount );
+        pxMaster->ucRTUSndBuf[pxMaster->usSndBufferCount++] = ( UCHAR )( usCRC16 & 0xFF );
+        pxMaster->ucRTUSndBuf[pxMaster->usSndBufferCount++] = ( UCHAR )( usCRC16 >> 8 );
 
-        /* Activate the transmitter. */
-        eSndState = STATE_M_TX_XMIT;
-        vMBMasterPortSerialEnable( FALSE, TRUE );
+        /* Activate the transmitter, after the t3.5 of the last response. */
+        pxMaster->eSndState = STATE_M_TX_XMIT;
+        if( pxMaster->eRcvState == STATE_M_RX_IDLE )
+        {
+            vMBMasterPortSerialEnable( pxMaster, FALSE, TRUE );
+        }
     }
     else
     {
@@ -276,31 +264,158 @@ eMBMasterRTUSend( UCHAR ucSlaveAddress, const UCHAR * pucFrame, USHORT usLength
 
 
 
+/* Length of the response to the request on the bus, from its first three
+ * bytes, or 0 for the functions and the frames it is not known for.
+ */
+static USHORT
+prvusMBMasterRTUResponseLength( xMBMasterInstance * pxMaster )
+{
+    UCHAR           ucFunctionCode = pxMaster->pucRcvBuf[MB_SER_PDU_PDU_OFF + MB_PDU_FUNC_OFF];
+    UCHAR           ucByteCount = pxMaster->pucRcvBuf[MB_SER_PDU_PDU_OFF + MB_PDU_DATA_OFF];
+
+    if( ucFunctionCode & MB_FUNC_ERROR )
+    {
+        return MB_SER_PDU_PDU_OFF + 2 + MB_SER_PDU_SIZE_CRC;
+    }
+    switch ( ucFunctionCode )
+    {
+    case MB_FUNC_READ_COILS:
+    case MB_FUNC_READ_DISCRETE_INPUTS:
+    case MB_FUNC_READ_HOLDING_REGISTER:
+    case MB_FUNC_READ_INPUT_REGISTER:
+    case MB_FUNC_READWRITE_MULTIPLE_REGISTERS:
+        return MB_SER_PDU_PDU_OFF + 2 + ucByteCount + MB_SER_PDU_SIZE_CRC;
+
+    case MB_FUNC_WRITE_SINGLE_COIL:
+    case MB_FUNC_WRITE_REGISTER:
+    case MB_FUNC_WRITE_MULTIPLE_COILS:
+    case MB_FUNC_WRITE_MULTIPLE_REGISTERS:
+        return MB_SER_PDU_PDU_OFF + 5 + MB_SER_PDU_SIZE_CRC;
+
+    default:
+        return 0;
+    }
+}
+
+/* TRUE when the frame received so far is complete, ucByte being its last
+ * byte, without waiting for the t3.5.
+ */
+static BOOL
+prvxMBMasterRTUFrameComplete( xMBMasterInstance * pxMaster, UCHAR ucByte )
+{
+    if( !pxMaster->xRcvEarlyEnd )
+    {
+        return FALSE;
+    }
+
+    /* The reply to a raw frame has no CRC, it ends at the length or at the
+     * end byte its sender gave.
+     */
+    if( pxMaster->pucRawFrame != NULL )
+    {
+        return ( pxMaster->usRcvBufferPos == pxMaster->usRawReplyExpect ) ||
+               ( ( pxMaster->usRawReplyEnd != 0 ) && ( ucByte == ( UCHAR )pxMaster->usRawReplyEnd ) ) ? TRUE : FALSE;
+    }
+
+    /* Once the function code and the byte count are in, the length of a
+     * response to a known function is known. It is complete at that length
+     * with a good CRC.
+     */
+    if( pxMaster->usRcvBufferPos == MB_SER_PDU_PDU_OFF + 2 )
+    {
+        pxMaster->usRcvExpected = prvusMBMasterRTUResponseLength( pxMaster );
+    }
+    return ( pxMaster->usRcvBufferPos == pxMaster->usRcvExpected ) && ( pxMaster->usRcvCRC == 0 ) ? TRUE : FALSE;
+}
+
+/* Pass the responses on at their last byte, or at the t3.5 after it. */
+void
+vMBMasterRTUSetEarlyFrameEnd( xMBMasterInstance * pxMaster, BOOL xEnable )
+{
+    pxMaster->xRcvEarlyEnd = xEnable;
+}
+
+/* The next request is the raw frame pucFrame, of the PDU send length,
+ * or a Modbus one again for NULL. Its reply ends after usReplyExpect bytes
+ * or at the byte of usReplyEnd, see MB_RAW_END, 0 for each when unknown.
+ */
+void
+vMBMasterRTUSetRaw( xMBMasterInstance * pxMaster, const UCHAR * pucFrame, USHORT usReplyExpect, USHORT usReplyEnd )
+{
+    ENTER_CRITICAL_SECTION(  );
+    pxMaster->pucRawFrame = pucFrame;
+    pxMaster->usRawReplyExpect = usReplyExpect;
+    pxMaster->usRawReplyEnd = usReplyEnd;
+    EXIT_CRITICAL_SECTION(  );
+}
+
+BOOL
+xMBMasterRTURequestIsRaw( xMBMasterInstance * pxMaster )
+{
+    return pxMaster->pucRawFrame != NULL ? TRUE : FALSE;
+}
+
+/* The response to the next request is received straight into pucRcvBuf,
+ * or into our own buffer again for NULL.
+ */
+void
+vMBMasterRTUSetRcvBuf( xMBMasterInstance * pxMaster, UCHAR * pucRcvBuf, USHORT usSize )
+{
+    ENTER_CRITICAL_SECTION(  );
+    if( pucRcvBuf != NULL )
+    {
+        pxMaster->pucRcvBuf = pucRcvBuf;
+        pxMaster->usRcvBufSize = usSize;
+    }
+    else
+    {
+        pxMaster->pucRcvBuf = pxMaster->ucRTURcvBuf;
+        pxMaster->usRcvBufSize = MB_SER_PDU_SIZE_MAX;
+    }
+    pxMaster->usRcvBufferPos = 0;
+    EXIT_CRITICAL_SECTION(  );
+}
+
+USHORT
+usMBMasterRTUGetRcvLength( xMBMasterInstance * pxMaster )
+{
+    return pxMaster->usRcvBufferPos;
+}
+
 BOOL
-xMBMasterRTUReceiveFSM( void )
+xMBMasterRTUReceiveFSM( xMBMasterInstance * pxMaster )
 {
     BOOL            xTaskNeedSwitch = FALSE;
     UCHAR           ucByte;
 
-    assert_param(( eSndState == STATE_M_TX_IDLE ) || ( eSndState == STATE_M_TX_XFWR ));
+    assert_param(( pxMaster->eSndState == STATE_M_TX_IDLE ) || ( pxMaster->eSndState == STATE_M_TX_XFWR ) ||
+            ( ( pxMaster->eSndState == STATE_M_TX_XMIT ) && ( pxMaster->eRcvState == STATE_M_RX_DONE ) ));
 
     /* Always read the character. */
-    ( void )xMBMasterPortSerialGetByte( ( CHAR * ) & ucByte );
+    ( void )xMBMasterPortSerialGetByte( pxMaster, ( CHAR * ) & ucByte );
 
-    switch ( eRcvState )
+    switch ( pxMaster->eRcvState )
     {
         /* If we have received a character in the init state we have to
          * wait until the frame is finished.
          */
     case STATE_M_RX_INIT:
-        vMBMasterPortTimersT35Enable( );
+        vMBMasterPortTimersT35Enable( pxMaster );
         break;
 
         /* In the error state we wait until all characters in the
          * damaged frame are transmitted.
          */
     case STATE_M_RX_ERROR:
-        vMBMasterPortTimersT35Enable( );
+        vMBMasterPortTimersT35Enable( pxMaster );
+        break;
+
+        /* The response was passed on already, the slave is sending more
+         * than it should. Keep the bus silent until it stops, the frame
+         * in the buffer is left as it was.
+         */
+    case STATE_M_RX_DONE:
+        vMBMasterPortTimersT35Enable( pxMaster );
         break;
 
         /* In the idle state we wait for a new character. If a character
@@ -312,15 +427,17 @@ xMBMasterRTUReceiveFSM( void )
     	/* In time of respond timeout,the receiver receive a frame.
     	 * Disable timer of respond timeout and change the transmiter state to idle.
     	 */
-    	vMBMasterPortTimersDisable( );
-    	eSndState = STATE_M_TX_IDLE;
+    	vMBMasterPortTimersDisable( pxMaster );
+    	pxMaster->eSndState = STATE_M_TX_IDLE;
 
-        usMasterRcvBufferPos = 0;
-        ucMasterRTURcvBuf[usMasterRcvBufferPos++] = ucByte;
-        eRcvState = STATE_M_RX_RCV;
+        pxMaster->usRcvBufferPos = 0;
+        pxMaster->pucRcvBuf[pxMaster->usRcvBufferPos++] = ucByte;
+        pxMaster->usRcvCRC = usMBCRC16Update( MB_CRC16_INIT, ucByte );
+        pxMaster->usRcvExpected = 0;
+        pxMaster->eRcvState = STATE_M_RX_RCV;
 
         /* Enable t3.5 timers. */
-        vMBMasterPortTimersT35Enable( );
+        vMBMasterPortTimersT35Enable( pxMaster );
         break;
 
         /* We are currently receiving a frame. Reset the timer after
@@ -329,60 +446,70 @@ xMBMasterRTUReceiveFSM( void )
          * ignored.
          */
     case STATE_M_RX_RCV:
-        if( usMasterRcvBufferPos < MB_SER_PDU_SIZE_MAX )
+        if( pxMaster->usRcvBufferPos < pxMaster->usRcvBufSize )
         {
-            ucMasterRTURcvBuf[usMasterRcvBufferPos++] = ucByte;
+            pxMaster->pucRcvBuf[pxMaster->usRcvBufferPos++] = ucByte;
+            pxMaster->usRcvCRC = usMBCRC16Update( pxMaster->usRcvCRC, ucByte );
         }
         else
         {
-            eRcvState = STATE_M_RX_ERROR;
+            pxMaster->eRcvState = STATE_M_RX_ERROR;
+        }
+        vMBMasterPortTimersT35Enable(pxMaster);
+
+        /* A complete frame is passed on now instead of after the t3.5. */
+        if( ( pxMaster->eRcvState == STATE_M_RX_RCV ) && prvxMBMasterRTUFrameComplete( pxMaster, ucByte ) )
+        {
+            pxMaster->eRcvState = STATE_M_RX_DONE;
+            xTaskNeedSwitch = xMBMasterPortEventPost( pxMaster, EV_MASTER_FRAME_RECEIVED );
         }
-        vMBMasterPortTimersT35Enable();
         break;
     }
     return xTaskNeedSwitch;
 }
 
 BOOL
-xMBMasterRTUTransmitFSM( void )
+xMBMasterRTUTransmitFSM( xMBMasterInstance * pxMaster )
 {
     BOOL            xNeedPoll = FALSE;
 
-    assert_param( eRcvState == STATE_M_RX_IDLE );
+    assert_param( pxMaster->eRcvState == STATE_M_RX_IDLE );
 
-    switch ( eSndState )
+    switch ( pxMaster->eSndState )
     {
         /* We should not get a transmitter event if the transmitter is in
          * idle state.  */
     case STATE_M_TX_IDLE:
         /* enable receiver/disable transmitter. */
-        vMBMasterPortSerialEnable( TRUE, FALSE );
+        vMBMasterPortSerialEnable( pxMaster, TRUE, FALSE );
         break;
 
     case STATE_M_TX_XMIT:
         /* check if we are finished. */
-        if( usMasterSndBufferCount != 0 )
+        if( pxMaster->usSndBufferCount != 0 )
         {
-            xMBMasterPortSerialPutByte( ( CHAR )*pucMasterSndBufferCur );
-            pucMasterSndBufferCur++;  /* next byte in sendbuffer. */
-            usMasterSndBufferCount--;
+            /* the whole frame at once, the port sends it from where it is */
+            xMBMasterPortSerialPutFrame( pxMaster, ( const UCHAR * )pxMaster->pucSndBufferCur, pxMaster->usSndBufferCount );
+            pxMaster->pucSndBufferCur += pxMaster->usSndBufferCount;
+            pxMaster->usSndBufferCount = 0;
         }
         else
         {
-            xFrameIsBroadcast = ( ucMasterRTUSndBuf[MB_SER_PDU_ADDR_OFF] == MB_ADDRESS_BROADCAST ) ? TRUE : FALSE;
+            pxMaster->xFrameIsBroadcast = ( pxMaster->pucRawFrame == NULL ) &&
+                ( pxMaster->ucRTUSndBuf[MB_SER_PDU_ADDR_OFF] == MB_ADDRESS_BROADCAST ) ? TRUE : FALSE;
             /* Disable transmitter. This prevents another transmit buffer
              * empty interrupt. */
-            vMBMasterPortSerialEnable( TRUE, FALSE );
-            eSndState = STATE_M_TX_XFWR;
+            vMBMasterPortSerialEnable( pxMaster, TRUE, FALSE );
+            pxMaster->eSndState = STATE_M_TX_XFWR;
             /* If the frame is broadcast ,master will enable timer of convert delay,
              * else master will enable timer of respond timeout. */
-            if ( xFrameIsBroadcast == TRUE )
+            if ( pxMaster->xFrameIsBroadcast == TRUE )
             {
-            	vMBMasterPortTimersConvertDelayEnable( );
+            	vMBMasterPortTimersConvertDelayEnable( pxMaster );
             }
             else
             {
-            	vMBMasterPortTimersRespondTimeoutEnable( );
+            	vMBMasterPortTimersRespondTimeoutEnable( pxMaster );
             }
         }
         break;
@@ -392,99 +519,109 @@ xMBMasterRTUTransmitFSM( void )
 }
 
 BOOL
-xMBMasterRTUTimerExpired(void)
+xMBMasterRTUTimerExpired(xMBMasterInstance * pxMaster)
 {
 	BOOL xNeedPoll = FALSE;
 
-	switch (eRcvState)
+	switch (pxMaster->eRcvState)
 	{
 		/* Timer t35 expired. Startup phase is finished. */
 	case STATE_M_RX_INIT:
-		xNeedPoll = xMBMasterPortEventPost(EV_MASTER_READY);
+		xNeedPoll = xMBMasterPortEventPost(pxMaster, EV_MASTER_READY);
 		break;
 
 		/* A frame was received and t35 expired. Notify the listener that
 		 * a new frame was received. */
 	case STATE_M_RX_RCV:
-		xNeedPoll = xMBMasterPortEventPost(EV_MASTER_FRAME_RECEIVED);
+		xNeedPoll = xMBMasterPortEventPost(pxMaster, EV_MASTER_FRAME_RECEIVED);
 		break;
 
 		/* An error occured while receiving the frame. */
 	case STATE_M_RX_ERROR:
-		vMBMasterSetErrorType(EV_ERROR_RECEIVE_DATA);
-		xNeedPoll = xMBMasterPortEventPost( EV_MASTER_ERROR_PROCESS );
+		vMBMasterSetErrorType(pxMaster, EV_ERROR_RECEIVE_DATA);
+		xNeedPoll = xMBMasterPortEventPost( pxMaster, EV_MASTER_ERROR_PROCESS );
 		break;
 
+		/* The response was passed on at its last byte. The bus is free now,
+		 * start the request the master queued while it waited. */
+	case STATE_M_RX_DONE:
+		vMBMasterPortTimersDisable( pxMaster );
+		pxMaster->eRcvState = STATE_M_RX_IDLE;
+		if ( pxMaster->eSndState == STATE_M_TX_XMIT ) {
+			vMBMasterPortSerialEnable( pxMaster, FALSE, TRUE );
+		}
+		return xNeedPoll;
+
 		/* Function called in an illegal state. */
 	default:
 		assert_param(
-				( eRcvState == STATE_M_RX_INIT ) || ( eRcvState == STATE_M_RX_RCV ) ||
-				( eRcvState == STATE_M_RX_ERROR ) || ( eRcvState == STATE_M_RX_IDLE ));
+				( pxMaster->eRcvState == STATE_M_RX_INIT ) || ( pxMaster->eRcvState == STATE_M_RX_RCV ) ||
+				( pxMaster->eRcvState == STATE_M_RX_ERROR ) || ( pxMaster->eRcvState == STATE_M_RX_IDLE ));
 		break;
 	}
-	eRcvState = STATE_M_RX_IDLE;
+	pxMaster->eRcvState = STATE_M_RX_IDLE;
 
-	switch (eSndState)
+	switch (pxMaster->eSndState)
 	{
 		/* A frame was send finish and convert delay or respond timeout expired.
 		 * If the frame is broadcast,The master will idle,and if the frame is not
 		 * broadcast.Notify the listener process error.*/
 	case STATE_M_TX_XFWR:
-		if ( xFrameIsBroadcast == FALSE ) {
-			vMBMasterSetErrorType(EV_ERROR_RESPOND_TIMEOUT);
-			xNeedPoll = xMBMasterPortEventPost(EV_MASTER_ERROR_PROCESS);
+		if ( pxMaster->xFrameIsBroadcast == FALSE ) {
+			vMBMasterSetErrorType(pxMaster, EV_ERROR_RESPOND_TIMEOUT);
+			xNeedPoll = xMBMasterPortEventPost(pxMaster, EV_MASTER_ERROR_PROCESS);
 		}
 		break;
 		/* Function called in an illegal state. */
 	default:
 		assert_param(
-				( eSndState == STATE_M_TX_XFWR ) || ( eSndState == STATE_M_TX_IDLE ));
+				( pxMaster->eSndState == STATE_M_TX_XFWR ) || ( pxMaster->eSndState == STATE_M_TX_IDLE ));
 		break;
 	}
-	eSndState = STATE_M_TX_IDLE;
+	pxMaster->eSndState = STATE_M_TX_IDLE;
 
-	vMBMasterPortTimersDisable( );
+	vMBMasterPortTimersDisable( pxMaster );
 	/* If timer mode is convert delay, the master event then turns EV_MASTER_EXECUTE status. */
-	if (eMasterCurTimerMode == MB_TMODE_CONVERT_DELAY) {
-		xNeedPoll = xMBMasterPortEventPost( EV_MASTER_EXECUTE );
+	if (pxMaster->eCurTimerMode == MB_TMODE_CONVERT_DELAY) {
+		xNeedPoll = xMBMasterPortEventPost( pxMaster, EV_MASTER_EXECUTE );
 	}
 
 	return xNeedPoll;
 }
 
 /* Get Modbus Master send RTU's buffer address pointer.*/
-void vMBMasterGetRTUSndBuf( UCHAR ** pucFrame )
+void vMBMasterGetRTUSndBuf( xMBMasterInstance * pxMaster, UCHAR ** pucFrame )
 {
-	*pucFrame = ( UCHAR * ) ucMasterRTUSndBuf;
+	*pucFrame = ( UCHAR * ) pxMaster->ucRTUSndBuf;
 }
 
 /* Get Modbus Master send PDU's buffer address pointer.*/
-void vMBMasterGetPDUSndBuf( UCHAR ** pucFrame )
+void vMBMasterGetPDUSndBuf( xMBMasterInstance * pxMaster, UCHAR ** pucFrame )
 {
-	*pucFrame = ( UCHAR * ) &ucMasterRTUSndBuf[MB_SER_PDU_PDU_OFF];
+	*pucFrame = ( UCHAR * ) &pxMaster->ucRTUSndBuf[MB_SER_PDU_PDU_OFF];
 }
 
 /* Set Modbus Master send PDU's buffer length.*/
-void vMBMasterSetPDUSndLength( USHORT SendPDULength )
+void vMBMasterSetPDUSndLength( xMBMasterInstance * pxMaster, USHORT SendPDULength )
 {
-	usMasterSendPDULength = SendPDULength;
+	pxMaster->usSendPDULength = SendPDULength;
 }
 
 /* Get Modbus Master send PDU's buffer length.*/
-USHORT usMBMasterGetPDUSndLength( void )
+USHORT usMBMasterGetPDUSndLength( xMBMasterInstance * pxMaster )
 {
-	return usMasterSendPDULength;
+	return pxMaster->usSendPDULength;
 }
 
 /* Set Modbus Master current timer mode.*/
-void vMBMasterSetCurTimerMode( eMBMasterTimerMode eMBTimerMode )
+void vMBMasterSetCurTimerMode( xMBMasterInstance * pxMaster, eMBMasterTimerMode eMBTimerMode )
 {
-	eMasterCurTimerMode = eMBTimerMode;
+	pxMaster->eCurTimerMode = eMBTimerMode;
 }
 
 /* The master request is broadcast? */
-BOOL xMBMasterRequestIsBroadcast( void ){
-	return xFrameIsBroadcast;
+BOOL xMBMasterRequestIsBroadcast( xMBMasterInstance * pxMaster ){
+	return pxMaster->xFrameIsBroadcast;
 }
 #endif
 
@@ -26,6 +26,7 @@
 #include "mbconfig.h"
 #include <rthw.h>
 #include <rtthread.h>
+#include <rtdevice.h>
 
 #include <assert.h>
 #include <inttypes.h>
@@ -59,4 +60,73 @@ typedef int32_t LONG;
 void EnterCriticalSection(void);
 void ExitCriticalSection(void);
 
+/* ----------------------- Modbus Master port -------------------------------*/
+/* a Master on each of UART1 to UART4 at most */
+#define MB_MASTER_PORT_NUM          4
+
+typedef struct xMBMasterInstance xMBMasterInstance;
+struct xMBMasterRequest;
+
+/* how a slave answers, all times in ms */
+typedef struct
+{
+    USHORT              usRespAvg8;         /* response time average, times 8 */
+    USHORT              usRespDev4;         /* and its mean deviation, times 4 */
+    USHORT              usBackoff;          /* time between probes once dead, 0 while alive */
+    UCHAR               ucMisses;           /* timeouts in a row */
+    rt_tick_t           xNextProbe;
+    ULONG               ulReplies;
+    ULONG               ulTimeouts;
+    ULONG               ulSkipped;          /* requests completed without the bus */
+    ULONG               ulBaudRate;         /* 0 for the bus rate */
+    ULONG               ulBaudFallbacks;    /* back to the bus rate after an error */
+} xMBMasterSlaveHealth;
+
+/* what the RT-Thread port keeps for one Modbus Master, in its instance */
+typedef struct
+{
+    UCHAR               ucPort;             /* serial port, 1 for UART1 */
+    rt_serial_t        *serial;
+    ULONG               ulBaudRate;         /* of the bus, every slave starts at it */
+    ULONG               ulBaudCur;          /* the line is at now */
+    BOOL                xBaudSettle;        /* a slave just switched, let it follow */
+    /* software simulation serial transmit IRQ handler thread */
+    struct rt_thread    xTransThread;
+    rt_uint32_t         ulTransStack[512 / 4];
+    struct rt_event     xSerialEvent;
+    /* frame given whole, sent by one Tx DMA */
+    const UCHAR        *pucTxFrame;
+    USHORT              usTxLen;
+    /* Tx DMA has finished and the line is idle */
+    struct rt_semaphore xTxDone;
+
+    USHORT              usT35TimeOut50us;
+    struct rt_timer     xTimer;             /* unless it runs on the hardware timer */
+
+    struct rt_semaphore xRunRes;
+    struct rt_event     xOsEvent;
+    /* the asynchronous requests waiting, by priority, and the one on the bus */
+    rt_list_t           xReqQueue;
+    struct xMBMasterRequest *pxReqCur;
+    /* from the request sent to the first byte of its response */
+    rt_tick_t           xRespStart;
+    rt_tick_t           xRespDelay;
+    xMBMasterSlaveHealth xSlave[MB_MASTER_TOTAL_SLAVE_NUM];
+    BOOL                xSkipping;          /* the request is completed without the bus */
+#ifdef RT_USING_FINSH
+    /* cycles from the last byte of a response to its success callback */
+    rt_uint32_t         ulRxCycles;
+    rt_uint32_t         ulLatencyCount;
+    rt_uint32_t         ulLatencyMin;
+    rt_uint32_t         ulLatencyMax;
+    unsigned long long  ullLatencySum;
+#endif
+} xMBMasterPort;
+
+/* respond timeout of the request going on the bus, in ms */
+USHORT usMBMasterPortRespondTimeout( xMBMasterInstance * pxMaster );
+/* hold the expiry of the Master's timer off, for one received byte */
+rt_base_t xMBMasterPortTimersLock( xMBMasterInstance * pxMaster );
+void vMBMasterPortTimersUnlock( xMBMasterInstance * pxMaster, rt_base_t level );
+
 #endif
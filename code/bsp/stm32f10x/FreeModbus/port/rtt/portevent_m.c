@@ -24,33 +24,48 @@
 #include "mb_m.h"
 #include "mbport.h"
 #include "port.h"
+#include "mbrtu.h"
 
 #if MB_MASTER_RTU_ENABLED > 0 || MB_MASTER_ASCII_ENABLED > 0
 /* ----------------------- Defines ------------------------------------------*/
-/* ----------------------- Variables ----------------------------------------*/
-static struct rt_semaphore xMasterRunRes;
-static struct rt_event     xMasterOsEvent;
+#define MB_MASTER_REQ_IDLE          0
+#define MB_MASTER_REQ_QUEUED        1
+#define MB_MASTER_REQ_ACTIVE        2
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+#include "dwt.h"
+#endif
+
+static void prvvMBMasterReqFinish( xMBMasterRequest * pxRequest, eMBMasterReqErrCode eErrStatus );
+static BOOL prvxMBMasterReqStart( xMBMasterInstance * pxMaster );
+static void prvvMBMasterReqKick( xMBMasterInstance * pxMaster );
+static xMBMasterSlaveHealth *prvxMBMasterSlaveCur( xMBMasterInstance * pxMaster );
+static void prvvMBMasterSlaveAnswered( xMBMasterInstance * pxMaster, BOOL xSuccess );
+static void prvvMBMasterSlaveMissed( xMBMasterInstance * pxMaster );
+static xMBMasterSlaveHealth *prvxMBMasterDeviceCur( xMBMasterInstance * pxMaster );
+static void prvvMBMasterSlaveBaudFallback( xMBMasterInstance * pxMaster );
 /* ----------------------- Start implementation -----------------------------*/
 BOOL
-xMBMasterPortEventInit( void )
+xMBMasterPortEventInit( xMBMasterInstance * pxMaster )
 {
-    rt_event_init(&xMasterOsEvent,"master event",RT_IPC_FLAG_PRIO);
+    rt_event_init(&pxMaster->xPort.xOsEvent,"master event",RT_IPC_FLAG_PRIO);
     return TRUE;
 }
 
 BOOL
-xMBMasterPortEventPost( eMBMasterEventType eEvent )
+xMBMasterPortEventPost( xMBMasterInstance * pxMaster, eMBMasterEventType eEvent )
 {
-    rt_event_send(&xMasterOsEvent, eEvent);
+    rt_event_send(&pxMaster->xPort.xOsEvent, eEvent);
     return TRUE;
 }
 
 BOOL
-xMBMasterPortEventGet( eMBMasterEventType * eEvent )
+xMBMasterPortEventGet( xMBMasterInstance * pxMaster, eMBMasterEventType * eEvent )
 {
     rt_uint32_t recvedEvent;
     /* waiting forever OS event */
-    rt_event_recv(&xMasterOsEvent,
+    rt_event_recv(&pxMaster->xPort.xOsEvent,
             EV_MASTER_READY | EV_MASTER_FRAME_RECEIVED | EV_MASTER_EXECUTE |
             EV_MASTER_FRAME_SENT | EV_MASTER_ERROR_PROCESS,
             RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER,
@@ -81,23 +96,26 @@ xMBMasterPortEventGet( eMBMasterEventType * eEvent )
  * Note:The resource is define by OS.If you not use OS this function can be empty.
  *
  */
-void vMBMasterOsResInit( void )
+void vMBMasterOsResInit( xMBMasterInstance * pxMaster )
 {
-    rt_sem_init(&xMasterRunRes, "master res", 0x01 , RT_IPC_FLAG_PRIO);
+    rt_sem_init(&pxMaster->xPort.xRunRes, "master res", 0x01 , RT_IPC_FLAG_PRIO);
+    rt_list_init(&pxMaster->xPort.xReqQueue);
+    pxMaster->xPort.pxReqCur = RT_NULL;
 }
 
 /**
  * This function is take Mobus Master running resource.
  * Note:The resource is define by Operating System.If you not use OS this function can be just return TRUE.
  *
+ * @param pxMaster the Master
  * @param lTimeOut the waiting time.
  *
  * @return resource taked result
  */
-BOOL xMBMasterRunResTake( LONG lTimeOut )
+BOOL xMBMasterRunResTake( xMBMasterInstance * pxMaster, LONG lTimeOut )
 {
     /*If waiting time is -1 .It will wait forever */
-    return rt_sem_take(&xMasterRunRes, lTimeOut) ? FALSE : TRUE ;
+    return rt_sem_take(&pxMaster->xPort.xRunRes, lTimeOut) ? FALSE : TRUE ;
 }
 
 /**
@@ -105,10 +123,17 @@ BOOL xMBMasterRunResTake( LONG lTimeOut )
  * Note:The resource is define by Operating System.If you not use OS this function can be empty.
  *
  */
-void vMBMasterRunResRelease( void )
+void vMBMasterRunResRelease( xMBMasterInstance * pxMaster )
 {
+    /* a queued request takes the Master over before any thread waiting */
+    if ( prvxMBMasterReqStart( pxMaster ) == TRUE )
+    {
+        return;
+    }
+
     /* release resource */
-    rt_sem_release(&xMasterRunRes);
+    rt_sem_release(&pxMaster->xPort.xRunRes);
+    prvvMBMasterReqKick( pxMaster );
 }
 
 /**
@@ -116,18 +141,32 @@ void vMBMasterRunResRelease( void )
  * @note There functions will block modbus master poll while execute OS waiting.
  * So,for real-time of system.Do not execute too much waiting process.
  *
+ * @param pxMaster the Master
  * @param ucDestAddress destination salve address
  * @param pucPDUData PDU buffer data
  * @param ucPDULength PDU buffer length
  *
  */
-void vMBMasterErrorCBRespondTimeout(UCHAR ucDestAddress, const UCHAR* pucPDUData,
+void vMBMasterErrorCBRespondTimeout(xMBMasterInstance * pxMaster, UCHAR ucDestAddress, const UCHAR* pucPDUData,
         USHORT ucPDULength) {
     /**
      * @note This code is use OS's event mechanism for modbus master protocol stack.
      * If you don't use OS, you can change it.
      */
-    rt_event_send(&xMasterOsEvent, EV_MASTER_ERROR_RESPOND_TIMEOUT);
+    xMBMasterRequest *pxRequest = pxMaster->xPort.pxReqCur;
+
+    /* a raw frame that takes no reply is not answered, that is no miss */
+    if ( pxRequest == RT_NULL || !pxRequest->xRaw || pxRequest->pucReply != RT_NULL )
+    {
+        prvvMBMasterSlaveBaudFallback( pxMaster );
+        prvvMBMasterSlaveMissed( pxMaster );
+    }
+    if ( pxMaster->xPort.pxReqCur != RT_NULL )
+    {
+        prvvMBMasterReqFinish( pxMaster->xPort.pxReqCur, MB_MRE_TIMEDOUT );
+        return;
+    }
+    rt_event_send(&pxMaster->xPort.xOsEvent, EV_MASTER_ERROR_RESPOND_TIMEOUT);
 
     /* You can add your code under here. */
 
@@ -138,18 +177,26 @@ void vMBMasterErrorCBRespondTimeout(UCHAR ucDestAddress, const UCHAR* pucPDUData
  * @note There functions will block modbus master poll while execute OS waiting.
  * So,for real-time of system.Do not execute too much waiting process.
  *
+ * @param pxMaster the Master
  * @param ucDestAddress destination salve address
  * @param pucPDUData PDU buffer data
  * @param ucPDULength PDU buffer length
  *
  */
-void vMBMasterErrorCBReceiveData(UCHAR ucDestAddress, const UCHAR* pucPDUData,
+void vMBMasterErrorCBReceiveData(xMBMasterInstance * pxMaster, UCHAR ucDestAddress, const UCHAR* pucPDUData,
         USHORT ucPDULength) {
     /**
      * @note This code is use OS's event mechanism for modbus master protocol stack.
      * If you don't use OS, you can change it.
      */
-    rt_event_send(&xMasterOsEvent, EV_MASTER_ERROR_RECEIVE_DATA);
+    prvvMBMasterSlaveBaudFallback( pxMaster );
+    prvvMBMasterSlaveAnswered( pxMaster, FALSE );
+    if ( pxMaster->xPort.pxReqCur != RT_NULL )
+    {
+        prvvMBMasterReqFinish( pxMaster->xPort.pxReqCur, MB_MRE_REV_DATA );
+        return;
+    }
+    rt_event_send(&pxMaster->xPort.xOsEvent, EV_MASTER_ERROR_RECEIVE_DATA);
 
     /* You can add your code under here. */
 
@@ -160,18 +207,25 @@ void vMBMasterErrorCBReceiveData(UCHAR ucDestAddress, const UCHAR* pucPDUData,
  * @note There functions will block modbus master poll while execute OS waiting.
  * So,for real-time of system.Do not execute too much waiting process.
  *
+ * @param pxMaster the Master
  * @param ucDestAddress destination salve address
  * @param pucPDUData PDU buffer data
  * @param ucPDULength PDU buffer length
  *
  */
-void vMBMasterErrorCBExecuteFunction(UCHAR ucDestAddress, const UCHAR* pucPDUData,
+void vMBMasterErrorCBExecuteFunction(xMBMasterInstance * pxMaster, UCHAR ucDestAddress, const UCHAR* pucPDUData,
         USHORT ucPDULength) {
     /**
      * @note This code is use OS's event mechanism for modbus master protocol stack.
      * If you don't use OS, you can change it.
      */
-    rt_event_send(&xMasterOsEvent, EV_MASTER_ERROR_EXECUTE_FUNCTION);
+    prvvMBMasterSlaveAnswered( pxMaster, FALSE );
+    if ( pxMaster->xPort.pxReqCur != RT_NULL )
+    {
+        prvvMBMasterReqFinish( pxMaster->xPort.pxReqCur, MB_MRE_EXE_FUN );
+        return;
+    }
+    rt_event_send(&pxMaster->xPort.xOsEvent, EV_MASTER_ERROR_EXECUTE_FUNCTION);
 
     /* You can add your code under here. */
 
@@ -183,12 +237,29 @@ void vMBMasterErrorCBExecuteFunction(UCHAR ucDestAddress, const UCHAR* pucPDUDat
  * So,for real-time of system.Do not execute too much waiting process.
  *
  */
-void vMBMasterCBRequestScuuess( void ) {
+void vMBMasterCBRequestScuuess( xMBMasterInstance * pxMaster ) {
+#ifdef RT_USING_FINSH
+    xMBMasterPort *pxPort = &pxMaster->xPort;
+    rt_uint32_t ulCycles = DWT_CYCCNT - pxPort->ulRxCycles;
+
+    if ( pxPort->ulLatencyCount == 0 || ulCycles < pxPort->ulLatencyMin )
+        pxPort->ulLatencyMin = ulCycles;
+    if ( ulCycles > pxPort->ulLatencyMax )
+        pxPort->ulLatencyMax = ulCycles;
+    pxPort->ullLatencySum += ulCycles;
+    pxPort->ulLatencyCount++;
+#endif
     /**
      * @note This code is use OS's event mechanism for modbus master protocol stack.
      * If you don't use OS, you can change it.
      */
-    rt_event_send(&xMasterOsEvent, EV_MASTER_PROCESS_SUCESS);
+    prvvMBMasterSlaveAnswered( pxMaster, TRUE );
+    if ( pxMaster->xPort.pxReqCur != RT_NULL )
+    {
+        prvvMBMasterReqFinish( pxMaster->xPort.pxReqCur, MB_MRE_NO_ERR );
+        return;
+    }
+    rt_event_send(&pxMaster->xPort.xOsEvent, EV_MASTER_PROCESS_SUCESS);
 
     /* You can add your code under here. */
 
@@ -203,11 +274,11 @@ void vMBMasterCBRequestScuuess( void ) {
  *
  * @return request error code
  */
-eMBMasterReqErrCode eMBMasterWaitRequestFinish( void ) {
+eMBMasterReqErrCode eMBMasterWaitRequestFinish( xMBMasterInstance * pxMaster ) {
     eMBMasterReqErrCode    eErrStatus = MB_MRE_NO_ERR;
     rt_uint32_t recvedEvent;
     /* waiting for OS event */
-    rt_event_recv(&xMasterOsEvent,
+    rt_event_recv(&pxMaster->xPort.xOsEvent,
             EV_MASTER_PROCESS_SUCESS | EV_MASTER_ERROR_RESPOND_TIMEOUT
                     | EV_MASTER_ERROR_RECEIVE_DATA
                     | EV_MASTER_ERROR_EXECUTE_FUNCTION,
@@ -236,4 +307,588 @@ eMBMasterReqErrCode eMBMasterWaitRequestFinish( void ) {
     return eErrStatus;
 }
 
+/* called with the Master running resource taken */
+static void prvvMBMasterReqFinish( xMBMasterRequest * pxRequest, eMBMasterReqErrCode eErrStatus )
+{
+    xMBMasterInstance *pxMaster = pxRequest->pxMaster;
+    rt_base_t          level;
+
+    if ( pxRequest == pxMaster->xPort.pxReqCur )
+    {
+        pxMaster->xPort.pxReqCur = RT_NULL;
+        /* the reply is in pucReply already */
+        if ( pxRequest->pucReply != RT_NULL )
+        {
+            pxRequest->usReplyLength = usMBMasterRTUGetRcvLength( pxMaster );
+        }
+        vMBMasterRTUSetRaw( pxMaster, RT_NULL, 0, 0 );
+        vMBMasterRTUSetRcvBuf( pxMaster, RT_NULL, 0 );
+    }
+
+    /* busy until after its callback, it is submitted again by the waiter */
+    pxRequest->eErrStatus = eErrStatus;
+    if ( pxRequest->pxCallback != RT_NULL )
+    {
+        pxRequest->pxCallback( pxRequest, eErrStatus );
+    }
+    /* idle and done at once, a submitter that gets in between would have its
+     * completion signaled by this old one */
+    level = rt_hw_interrupt_disable( );
+    pxRequest->ucState = MB_MASTER_REQ_IDLE;
+    rt_completion_done( &pxRequest->xDone );
+    rt_hw_interrupt_enable( level );
+}
+
+/**
+ * This function puts the first request of the queue on the bus. Requests
+ * past their deadline complete with MB_MRE_TIMEDOUT instead.
+ * Note: the caller holds the Master running resource.
+ *
+ * @return TRUE if a request is started, the resource is kept for it
+ */
+static BOOL prvxMBMasterReqStart( xMBMasterInstance * pxMaster )
+{
+    xMBMasterRequest *pxRequest;
+    UCHAR            *ucMBFrame;
+    rt_base_t         level;
+
+    for ( ;; )
+    {
+        level = rt_hw_interrupt_disable( );
+        if ( rt_list_isempty( &pxMaster->xPort.xReqQueue ) )
+        {
+            rt_hw_interrupt_enable( level );
+            return FALSE;
+        }
+        pxRequest = rt_list_entry( pxMaster->xPort.xReqQueue.next, xMBMasterRequest, xList );
+        rt_list_remove( &pxRequest->xList );
+
+        if ( pxRequest->lDeadline < 0 ||
+             ( rt_int32_t )( rt_tick_get( ) - pxRequest->xExpire ) <= 0 )
+        {
+            pxRequest->ucState = MB_MASTER_REQ_ACTIVE;
+            pxMaster->xPort.pxReqCur = pxRequest;
+            rt_hw_interrupt_enable( level );
+            break;
+        }
+        rt_hw_interrupt_enable( level );
+
+        prvvMBMasterReqFinish( pxRequest, MB_MRE_TIMEDOUT );
+    }
+
+    vMBMasterRTUSetRcvBuf( pxMaster, pxRequest->pucReply, pxRequest->usReplySize );
+    if ( pxRequest->xRaw )
+    {
+        vMBMasterRTUSetRaw( pxMaster, pxRequest->pucFrame, pxRequest->usReplyExpect, pxRequest->usReplyEnd );
+    }
+    else
+    {
+        vMBMasterGetPDUSndBuf( pxMaster, &ucMBFrame );
+        rt_memcpy( ucMBFrame, pxRequest->pucFrame, pxRequest->usLength );
+    }
+    vMBMasterSetDestAddress( pxMaster, pxRequest->ucSndAddr );
+    vMBMasterSetPDUSndLength( pxMaster, pxRequest->usLength );
+    ( void ) xMBMasterPortEventPost( pxMaster, EV_MASTER_FRAME_SENT );
+
+    return TRUE;
+}
+
+/* starts the queue if the Master is free, a release or a submit may race */
+static void prvvMBMasterReqKick( xMBMasterInstance * pxMaster )
+{
+    while ( !rt_list_isempty( &pxMaster->xPort.xReqQueue ) && rt_sem_trytake( &pxMaster->xPort.xRunRes ) == RT_EOK )
+    {
+        if ( prvxMBMasterReqStart( pxMaster ) == TRUE )
+        {
+            break;
+        }
+        rt_sem_release( &pxMaster->xPort.xRunRes );
+    }
+}
+
+/**
+ * This function queues a request for the Master without waiting for it.
+ *
+ * @param pxMaster the Master
+ * @param pxRequest the request, kept by the caller until it completes
+ *
+ * @return MB_MRE_NO_ERR if queued, MB_MRE_ILL_ARG for a bad request,
+ * MB_MRE_MASTER_BUSY if the request is already queued or on the bus
+ */
+eMBMasterReqErrCode eMBMasterReqSubmit( xMBMasterInstance * pxMaster, xMBMasterRequest * pxRequest )
+{
+    xMBMasterRequest *pxOther;
+    rt_list_t        *pxNode;
+    rt_base_t         level;
+
+    if ( pxRequest == RT_NULL || pxRequest->pucFrame == RT_NULL || pxRequest->usLength == 0 ||
+         ( pxRequest->pucReply != RT_NULL && pxRequest->usReplySize == 0 ) ||
+         pxRequest->ucSndAddr > MB_MASTER_TOTAL_SLAVE_NUM )
+    {
+        return MB_MRE_ILL_ARG;
+    }
+
+    level = rt_hw_interrupt_disable( );
+    if ( xMBMasterReqIsBusy( pxRequest ) )
+    {
+        rt_hw_interrupt_enable( level );
+        return MB_MRE_MASTER_BUSY;
+    }
+
+    rt_completion_init( &pxRequest->xDone );
+    pxRequest->pxMaster = pxMaster;
+    pxRequest->eErrStatus = MB_MRE_NO_ERR;
+    pxRequest->usReplyLength = 0;
+    pxRequest->ucState = MB_MASTER_REQ_QUEUED;
+    pxRequest->xExpire = rt_tick_get( ) + ( rt_tick_t )pxRequest->lDeadline;
+
+    /* after the requests of the same or a more urgent priority */
+    for ( pxNode = pxMaster->xPort.xReqQueue.next; pxNode != &pxMaster->xPort.xReqQueue; pxNode = pxNode->next )
+    {
+        pxOther = rt_list_entry( pxNode, xMBMasterRequest, xList );
+        if ( pxOther->ucPriority > pxRequest->ucPriority )
+        {
+            break;
+        }
+    }
+    rt_list_insert_before( pxNode, &pxRequest->xList );
+    rt_hw_interrupt_enable( level );
+
+    prvvMBMasterReqKick( pxMaster );
+
+    return MB_MRE_NO_ERR;
+}
+
+/**
+ * This function takes a request out of the queue, it completes with
+ * MB_MRE_CANCELED. A request already on the bus can not be canceled.
+ *
+ * @param pxRequest the request
+ *
+ * @return TRUE if canceled
+ */
+BOOL xMBMasterReqCancel( xMBMasterRequest * pxRequest )
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable( );
+    if ( pxRequest->ucState != MB_MASTER_REQ_QUEUED )
+    {
+        rt_hw_interrupt_enable( level );
+        return FALSE;
+    }
+    rt_list_remove( &pxRequest->xList );
+    rt_hw_interrupt_enable( level );
+
+    prvvMBMasterReqFinish( pxRequest, MB_MRE_CANCELED );
+
+    return TRUE;
+}
+
+/**
+ * This function waits for a submitted request to complete. On timeout the
+ * request is canceled, or waited for until its end if it is on the bus.
+ *
+ * @param pxRequest the request
+ * @param lTimeOut the waiting time (-1 will waiting forever)
+ *
+ * @return request error code
+ */
+eMBMasterReqErrCode eMBMasterReqWait( xMBMasterRequest * pxRequest, LONG lTimeOut )
+{
+    if ( rt_completion_wait( &pxRequest->xDone, lTimeOut ) != RT_EOK )
+    {
+        if ( xMBMasterReqCancel( pxRequest ) == FALSE )
+        {
+            rt_completion_wait( &pxRequest->xDone, RT_WAITING_FOREVER );
+        }
+    }
+
+    return pxRequest->eErrStatus;
+}
+
+/**
+ * This function sends a frame that is not Modbus, as it is, and waits for
+ * the reply. The request is queued after all the submitted ones.
+ *
+ * @param pxMaster the Master
+ * @param ucDevice the device whose baud rate the frame goes at, 0 for the bus rate
+ * @param pucFrame the frame, sent from there
+ * @param usLength its length
+ * @param pucReply the reply, received straight in it
+ * @param usReplySize the size of pucReply
+ * @param usReplyExpect the reply ends at this length, 0 if not known
+ * @param usReplyEnd or at this byte, MB_RAW_END( byte ), 0 for none
+ * @param pusReplyLength the length received, may be NULL
+ * @param lTimeOut the waiting time to get on the bus (-1 will waiting forever)
+ *
+ * @return request error code, MB_MRE_NO_ERR when a reply is received
+ */
+eMBMasterReqErrCode eMBMasterReqRaw( xMBMasterInstance * pxMaster, UCHAR ucDevice, UCHAR * pucFrame, USHORT usLength,
+        UCHAR * pucReply, USHORT usReplySize, USHORT usReplyExpect, USHORT usReplyEnd,
+        USHORT * pusReplyLength, LONG lTimeOut )
+{
+    xMBMasterRequest     xRequest;
+    eMBMasterReqErrCode  eErrStatus;
+
+    rt_memset( &xRequest, 0, sizeof( xRequest ) );
+    xRequest.xRaw = TRUE;
+    xRequest.ucSndAddr = ucDevice;
+    xRequest.pucFrame = pucFrame;
+    xRequest.usLength = usLength;
+    xRequest.pucReply = pucReply;
+    xRequest.usReplySize = usReplySize;
+    xRequest.usReplyExpect = usReplyExpect;
+    xRequest.usReplyEnd = usReplyEnd;
+    xRequest.ucPriority = 0xFF;
+    xRequest.lDeadline = -1;
+
+    eErrStatus = eMBMasterReqSubmit( pxMaster, &xRequest );
+    if ( eErrStatus == MB_MRE_NO_ERR )
+    {
+        eErrStatus = eMBMasterReqWait( &xRequest, lTimeOut );
+    }
+    if ( pusReplyLength != RT_NULL )
+    {
+        *pusReplyLength = xRequest.usReplyLength;
+    }
+
+    return eErrStatus;
+}
+
+/* TRUE while the request is queued or on the bus */
+BOOL xMBMasterReqIsBusy( xMBMasterRequest * pxRequest )
+{
+    return pxRequest->ucState != MB_MASTER_REQ_IDLE ? TRUE : FALSE;
+}
+
+/* the slave the request on the bus is for, RT_NULL for a raw frame or a broadcast */
+static xMBMasterSlaveHealth *prvxMBMasterSlaveCur( xMBMasterInstance * pxMaster )
+{
+    UCHAR ucSlave = ucMBMasterGetDestAddress( pxMaster );
+
+    if ( xMBMasterRTURequestIsRaw( pxMaster ) ||
+         ucSlave < MB_ADDRESS_MIN || ucSlave > MB_MASTER_TOTAL_SLAVE_NUM )
+    {
+        return RT_NULL;
+    }
+    return &pxMaster->xPort.xSlave[ucSlave - 1];
+}
+
+/* the average response time and four mean deviations, the full timeout
+ * until the first response and after a miss */
+static USHORT prvusMBMasterSlaveTimeout( xMBMasterSlaveHealth * pxSlave )
+{
+    USHORT usTimeout;
+
+    if ( pxSlave == RT_NULL || pxSlave->ulReplies == 0 || pxSlave->ucMisses != 0 )
+    {
+        return MB_MASTER_TIMEOUT_MS_RESPOND;
+    }
+    usTimeout = pxSlave->usRespAvg8 / 8 + pxSlave->usRespDev4;
+    if ( usTimeout < MB_MASTER_TIMEOUT_MS_RESPOND_MIN )
+    {
+        usTimeout = MB_MASTER_TIMEOUT_MS_RESPOND_MIN;
+    }
+    else if ( usTimeout > MB_MASTER_TIMEOUT_MS_RESPOND )
+    {
+        usTimeout = MB_MASTER_TIMEOUT_MS_RESPOND;
+    }
+    return usTimeout;
+}
+
+USHORT usMBMasterPortRespondTimeout( xMBMasterInstance * pxMaster )
+{
+    return prvusMBMasterSlaveTimeout( prvxMBMasterSlaveCur( pxMaster ) );
+}
+
+/* the slave answered, a successful response also gives its response time */
+static void prvvMBMasterSlaveAnswered( xMBMasterInstance * pxMaster, BOOL xSuccess )
+{
+    xMBMasterSlaveHealth *pxSlave = prvxMBMasterSlaveCur( pxMaster );
+    rt_tick_t xDelay = pxMaster->xPort.xRespDelay;
+    SHORT sErr;
+    USHORT usMs;
+
+    if ( pxSlave == RT_NULL )
+    {
+        return;
+    }
+    pxSlave->ucMisses = 0;
+    pxSlave->usBackoff = 0;
+    if ( !xSuccess )
+    {
+        return;
+    }
+    if ( xDelay != RT_TICK_MAX )
+    {
+        usMs = xDelay * 1000 / RT_TICK_PER_SECOND;
+        if ( pxSlave->ulReplies == 0 )
+        {
+            pxSlave->usRespAvg8 = usMs * 8;
+            pxSlave->usRespDev4 = usMs * 2;
+        }
+        else
+        {
+            /* gains of 1/8 and 1/4, as for the TCP round trip time */
+            sErr = usMs - pxSlave->usRespAvg8 / 8;
+            pxSlave->usRespAvg8 += sErr;
+            if ( sErr < 0 ) sErr = -sErr;
+            pxSlave->usRespDev4 += sErr - pxSlave->usRespDev4 / 4;
+        }
+    }
+    pxSlave->ulReplies++;
+}
+
+static void prvvMBMasterSlaveMissed( xMBMasterInstance * pxMaster )
+{
+    xMBMasterSlaveHealth *pxSlave = prvxMBMasterSlaveCur( pxMaster );
+
+    /* a skipped request is counted already */
+    if ( pxMaster->xPort.xSkipping )
+    {
+        pxMaster->xPort.xSkipping = FALSE;
+        return;
+    }
+    if ( pxSlave == RT_NULL )
+    {
+        return;
+    }
+    pxSlave->ulTimeouts++;
+    if ( pxSlave->ucMisses < MB_MASTER_SLAVE_DEAD_MISSES )
+    {
+        pxSlave->ucMisses++;
+    }
+    if ( pxSlave->ucMisses < MB_MASTER_SLAVE_DEAD_MISSES )
+    {
+        return;
+    }
+    if ( pxSlave->usBackoff == 0 )
+    {
+        pxSlave->usBackoff = MB_MASTER_SLAVE_BACKOFF_MS_MIN;
+    }
+    else if ( pxSlave->usBackoff < MB_MASTER_SLAVE_BACKOFF_MS_MAX / 2 )
+    {
+        pxSlave->usBackoff *= 2;
+    }
+    else
+    {
+        pxSlave->usBackoff = MB_MASTER_SLAVE_BACKOFF_MS_MAX;
+    }
+    pxSlave->xNextProbe = rt_tick_get( ) + rt_tick_from_millisecond( pxSlave->usBackoff );
+}
+
+BOOL xMBMasterPortSlaveSkip( xMBMasterInstance * pxMaster )
+{
+    xMBMasterSlaveHealth *pxSlave = prvxMBMasterSlaveCur( pxMaster );
+
+    if ( pxSlave == RT_NULL || pxSlave->usBackoff == 0 )
+    {
+        return FALSE;
+    }
+    /* one probe a period, whoever asks first */
+    if ( ( rt_int32_t )( rt_tick_get( ) - pxSlave->xNextProbe ) >= 0 )
+    {
+        pxSlave->xNextProbe = rt_tick_get( ) + rt_tick_from_millisecond( pxSlave->usBackoff );
+        return FALSE;
+    }
+    pxSlave->ulSkipped++;
+    pxMaster->xPort.xSkipping = TRUE;
+    return TRUE;
+}
+
+/* the slave or the device of a raw frame the request on the bus is for, RT_NULL for a broadcast */
+static xMBMasterSlaveHealth *prvxMBMasterDeviceCur( xMBMasterInstance * pxMaster )
+{
+    UCHAR ucSlave = ucMBMasterGetDestAddress( pxMaster );
+
+    if ( ucSlave < MB_ADDRESS_MIN || ucSlave > MB_MASTER_TOTAL_SLAVE_NUM )
+    {
+        return RT_NULL;
+    }
+    return &pxMaster->xPort.xSlave[ucSlave - 1];
+}
+
+void vMBMasterPortSlaveSelect( xMBMasterInstance * pxMaster )
+{
+    xMBMasterPort *pxPort = &pxMaster->xPort;
+    xMBMasterSlaveHealth *pxSlave = prvxMBMasterDeviceCur( pxMaster );
+    ULONG ulBaudRate = pxPort->ulBaudRate;
+
+    if ( pxSlave != RT_NULL && pxSlave->ulBaudRate != 0 )
+    {
+        ulBaudRate = pxSlave->ulBaudRate;
+    }
+    if ( pxPort->xBaudSettle )
+    {
+        pxPort->xBaudSettle = FALSE;
+        rt_thread_delay( rt_tick_from_millisecond( MB_MASTER_BAUD_SETTLE_MS ) );
+    }
+    /* a rate the UART can not take is no rate for the slave either */
+    if ( xMBMasterRTUSetBaudRate( pxMaster, ulBaudRate ) != TRUE && pxSlave != RT_NULL )
+    {
+        pxSlave->ulBaudRate = 0;
+        ( void ) xMBMasterRTUSetBaudRate( pxMaster, pxPort->ulBaudRate );
+    }
+}
+
+/* the request went at another rate than the bus and failed, the slave goes
+ * back to the bus rate by itself once it hears nothing valid */
+static void prvvMBMasterSlaveBaudFallback( xMBMasterInstance * pxMaster )
+{
+    xMBMasterSlaveHealth *pxSlave = prvxMBMasterDeviceCur( pxMaster );
+
+    if ( pxMaster->xPort.xSkipping || pxSlave == RT_NULL || pxSlave->ulBaudRate == 0 )
+    {
+        return;
+    }
+    pxSlave->ulBaudRate = 0;
+    pxSlave->ulBaudFallbacks++;
+}
+
+/**
+ * This function sets the baud rate the requests to a slave go at, once the
+ * slave has switched to it.
+ *
+ * @param pxMaster the Master
+ * @param ucSlave slave address, or the device of raw frames
+ * @param ulBaudRate the rate, the bus rate to set it back
+ *
+ * @return FALSE for a bad address
+ */
+BOOL xMBMasterSetSlaveBaudRate( xMBMasterInstance * pxMaster, UCHAR ucSlave, ULONG ulBaudRate )
+{
+    xMBMasterSlaveHealth *pxSlave;
+
+    if ( ucSlave < MB_ADDRESS_MIN || ucSlave > MB_MASTER_TOTAL_SLAVE_NUM || ulBaudRate == 0 )
+    {
+        return FALSE;
+    }
+    pxSlave = &pxMaster->xPort.xSlave[ucSlave - 1];
+
+    if ( ulBaudRate == pxMaster->xPort.ulBaudRate )
+    {
+        ulBaudRate = 0;
+    }
+    if ( pxSlave->ulBaudRate != ulBaudRate )
+    {
+        pxSlave->ulBaudRate = ulBaudRate;
+        pxMaster->xPort.xBaudSettle = TRUE;
+    }
+    return TRUE;
+}
+
+/**
+ * This function gets how a slave answers the Master.
+ *
+ * @param pxMaster the Master
+ * @param ucSlave slave address
+ * @param pxStat the health of the slave
+ *
+ * @return FALSE for a bad address
+ */
+BOOL xMBMasterGetSlaveStat( xMBMasterInstance * pxMaster, UCHAR ucSlave, xMBMasterSlaveStat * pxStat )
+{
+    xMBMasterSlaveHealth *pxSlave;
+    rt_base_t level;
+
+    if ( ucSlave < MB_ADDRESS_MIN || ucSlave > MB_MASTER_TOTAL_SLAVE_NUM )
+    {
+        return FALSE;
+    }
+    pxSlave = &pxMaster->xPort.xSlave[ucSlave - 1];
+
+    level = rt_hw_interrupt_disable( );
+    pxStat->xAlive = pxSlave->usBackoff == 0 ? TRUE : FALSE;
+    pxStat->usRespondMs = pxSlave->ulReplies ? pxSlave->usRespAvg8 / 8 : 0;
+    pxStat->usTimeoutMs = prvusMBMasterSlaveTimeout( pxSlave );
+    pxStat->ulReplies = pxSlave->ulReplies;
+    pxStat->ulTimeouts = pxSlave->ulTimeouts;
+    pxStat->ulSkipped = pxSlave->ulSkipped;
+    pxStat->ulBaudRate = pxSlave->ulBaudRate ? pxSlave->ulBaudRate : pxMaster->xPort.ulBaudRate;
+    pxStat->ulBaudFallbacks = pxSlave->ulBaudFallbacks;
+    rt_hw_interrupt_enable( level );
+
+    return TRUE;
+}
+
+#ifdef RT_USING_FINSH
+/* The latency of the responses of each Master since the last call, in us,
+ * then start again with the responses passed on at their last byte (early 1)
+ * or at the t3.5 after it (early 0), to compare the two on the same traffic.
+ */
+void mb_latency(int early)
+{
+    xMBMasterInstance *pxMaster;
+    xMBMasterPort *pxPort;
+    rt_uint32_t count, min, max;
+    unsigned long long sum;
+    rt_uint32_t per_us = DWT_CYCCNT_HZ / 1000000;
+    rt_base_t level;
+    UCHAR ucPort;
+
+    for (ucPort = 1; ucPort <= MB_MASTER_PORT_NUM; ucPort++)
+    {
+        pxMaster = pxMBMasterPortSerialInstance(ucPort);
+        if (pxMaster == RT_NULL)
+            continue;
+        pxPort = &pxMaster->xPort;
+
+        level = rt_hw_interrupt_disable();
+        count = pxPort->ulLatencyCount;
+        min = pxPort->ulLatencyMin;
+        max = pxPort->ulLatencyMax;
+        sum = pxPort->ullLatencySum;
+        pxPort->ulLatencyCount = 0;
+        pxPort->ulLatencyMin = 0;
+        pxPort->ulLatencyMax = 0;
+        pxPort->ullLatencySum = 0;
+        rt_hw_interrupt_enable(level);
+
+        if (count)
+        {
+            rt_kprintf("port %d: %d responses, frame end to callback min %d avg %d max %d us\n",
+                       ucPort, count, min / per_us, (rt_uint32_t)(sum / count) / per_us, max / per_us);
+        }
+        else
+        {
+            rt_kprintf("port %d: no response\n", ucPort);
+        }
+
+        vMBMasterRTUSetEarlyFrameEnd(pxMaster, early ? TRUE : FALSE);
+    }
+
+    dwt_cycles_init();
+}
+FINSH_FUNCTION_EXPORT(mb_latency, print the Modbus response latency and set the early frame end)
+
+/* the slaves each Master has talked to */
+void mb_slaves(void)
+{
+    xMBMasterInstance *pxMaster;
+    xMBMasterSlaveStat xStat;
+    UCHAR ucPort, ucSlave;
+
+    rt_kprintf("port slave state respond timeout  replies timeouts  skipped   baud fallback\n");
+    for (ucPort = 1; ucPort <= MB_MASTER_PORT_NUM; ucPort++)
+    {
+        pxMaster = pxMBMasterPortSerialInstance(ucPort);
+        if (pxMaster == RT_NULL)
+            continue;
+        for (ucSlave = MB_ADDRESS_MIN; ucSlave <= MB_MASTER_TOTAL_SLAVE_NUM; ucSlave++)
+        {
+            xMBMasterGetSlaveStat(pxMaster, ucSlave, &xStat);
+            if (xStat.ulReplies == 0 && xStat.ulTimeouts == 0 && xStat.ulBaudFallbacks == 0 &&
+                xStat.ulBaudRate == pxMaster->xPort.ulBaudRate)
+                continue;
+            rt_kprintf("%4d %5d %-5s %4d ms %4d ms %8d %8d %8d %6d %8d\n", ucPort, ucSlave,
+                       xStat.xAlive ? "alive" : "dead", xStat.usRespondMs, xStat.usTimeoutMs,
+                       xStat.ulReplies, xStat.ulTimeouts, xStat.ulSkipped,
+                       xStat.ulBaudRate, xStat.ulBaudFallbacks);
+        }
+    }
+}
+FINSH_FUNCTION_EXPORT(mb_slaves, list the response times and health of the Modbus slaves)
+#endif
+
 #endif
@@ -23,36 +23,57 @@
 
 /* ----------------------- Modbus includes ----------------------------------*/
 #include "mb.h"
+#include "mb_m.h"
 #include "mbport.h"
 #include "rtdevice.h"
 #include "bsp.h"
 
 #if MB_MASTER_RTU_ENABLED > 0 || MB_MASTER_ASCII_ENABLED > 0
 /* ----------------------- Static variables ---------------------------------*/
-ALIGN(RT_ALIGN_SIZE)
-/* software simulation serial transmit IRQ handler thread stack */
-static rt_uint8_t serial_soft_trans_irq_stack[512];
-/* software simulation serial transmit IRQ handler thread */
-static struct rt_thread thread_serial_soft_trans_irq;
-/* serial event */
-static struct rt_event event_serial;
-/* modbus master serial device */
-static rt_serial_t *serial;
+/* the Master on each port, to find it from its serial device */
+static xMBMasterInstance *serial_master[MB_MASTER_PORT_NUM];
+
+/* 485 driver enable of each port, high while transmitting */
+static const struct
+{
+    GPIO_TypeDef *gpio;
+    uint16_t pin;
+} serial_rt_control[MB_MASTER_PORT_NUM] =
+{
+    { RT_NULL, 0 },
+    { GPIOA, GPIO_Pin_1 },
+    { RT_NULL, 0 },
+    { RT_NULL, 0 },
+};
+#ifdef RT_USING_FINSH
+#include "dwt.h"
+#endif
 
 /* ----------------------- Defines ------------------------------------------*/
 /* serial transmit event */
 #define EVENT_SERIAL_TRANS_START    (1<<0)
+/* the DMA of a frame is given twice its time at 10 bits a byte, one tick spare */
+#define SERIAL_TX_TIMEOUT(len, baud) (rt_tick_from_millisecond((len) * 10 * 1000 * 2 / (baud)) + 1)
 
 /* ----------------------- static functions ---------------------------------*/
-static void prvvUARTTxReadyISR(void);
-static void prvvUARTRxISR(void);
+static xMBMasterInstance *serial_find_master(rt_device_t dev);
 static rt_err_t serial_rx_ind(rt_device_t dev, rt_size_t size);
+static rt_err_t serial_tx_done_ind(rt_device_t dev, void *buffer);
 static void serial_soft_trans_irq(void* parameter);
 
 /* ----------------------- Start implementation -----------------------------*/
-BOOL xMBMasterPortSerialInit(UCHAR ucPORT, ULONG ulBaudRate, UCHAR ucDataBits,
-        eMBParity eParity)
+BOOL xMBMasterPortSerialInit(xMBMasterInstance * pxMaster, UCHAR ucPORT, ULONG ulBaudRate,
+        UCHAR ucDataBits, eMBParity eParity)
 {
+    xMBMasterPort *port = &pxMaster->xPort;
+    rt_serial_t *serial = RT_NULL;
+    char name[RT_NAME_MAX];
+
+    if (ucPORT < 1 || ucPORT > MB_MASTER_PORT_NUM || serial_master[ucPORT - 1] != RT_NULL)
+    {
+        return FALSE;
+    }
+
     /**
      * set 485 mode receive and transmit control IO
      * @note MODBUS_MASTER_RT_CONTROL_PIN_INDEX need be defined by user
@@ -82,6 +103,14 @@ BOOL xMBMasterPortSerialInit(UCHAR ucPORT, ULONG ulBaudRate, UCHAR ucDataBits,
 			serial = &serial4;
 #endif			
 		}
+    if (serial == RT_NULL)
+    {
+        return FALSE;
+    }
+    port->ucPort = ucPORT;
+    port->serial = serial;
+    port->ulBaudRate = ulBaudRate;
+    port->ulBaudCur = ulBaudRate;
 
     /* set serial configure parameter */
     serial->config.baud_rate = ulBaudRate;
@@ -106,115 +135,159 @@ BOOL xMBMasterPortSerialInit(UCHAR ucPORT, ULONG ulBaudRate, UCHAR ucDataBits,
     /* set serial configure */
     serial->ops->configure(serial, &(serial->config));
 
+    port->usTxLen = 0;
+    rt_sem_init(&port->xTxDone, "master tx", 0, RT_IPC_FLAG_FIFO);
+    /* before the thread, which waits on it at once */
+    rt_event_init(&port->xSerialEvent, "master event", RT_IPC_FLAG_PRIO);
+    /* before the device, it calls back as soon as it is open */
+    serial_master[ucPORT - 1] = pxMaster;
+
     /* open serial device */
     if (!serial->parent.open(&serial->parent,
-            RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX )) {
+            RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_DMA_RX | RT_DEVICE_FLAG_DMA_TX)) {
         serial->parent.rx_indicate = serial_rx_ind;
+        serial->parent.tx_complete = serial_tx_done_ind;
     } else {
+        serial_master[ucPORT - 1] = RT_NULL;
         return FALSE;
     }
 
     /* software initialize */
-    rt_thread_init(&thread_serial_soft_trans_irq,
-                   "master trans",
+    rt_snprintf(name, sizeof(name), "mtrans%d", ucPORT);
+    rt_thread_init(&port->xTransThread,
+                   name,
                    serial_soft_trans_irq,
-                   RT_NULL,
-                   serial_soft_trans_irq_stack,
-                   sizeof(serial_soft_trans_irq_stack),
+                   pxMaster,
+                   port->ulTransStack,
+                   sizeof(port->ulTransStack),
                    10, 5);
-    rt_thread_startup(&thread_serial_soft_trans_irq);
-    rt_event_init(&event_serial, "master event", RT_IPC_FLAG_PRIO);
+    rt_thread_startup(&port->xTransThread);
 
     return TRUE;
 }
 
-void vMBMasterPortSerialEnable(BOOL xRxEnable, BOOL xTxEnable)
+void vMBMasterPortSerialEnable(xMBMasterInstance * pxMaster, BOOL xRxEnable, BOOL xTxEnable)
 {
+    xMBMasterPort *port = &pxMaster->xPort;
+    GPIO_TypeDef *gpio = serial_rt_control[port->ucPort - 1].gpio;
     rt_uint32_t recved_event;
-    if (xRxEnable)
+    rt_base_t level;
+    /* end of frame: send it and keep the 485 driver on until it is out */
+    if (!xTxEnable && port->usTxLen)
     {
-//        /* enable RX interrupt */
-//        serial->ops->control(serial, RT_DEVICE_CTRL_SET_INT, (void *)RT_DEVICE_FLAG_INT_RX);
-//        /* switch 485 to receive mode */
-//        rt_pin_write(MODBUS_MASTER_RT_CONTROL_PIN_INDEX, PIN_LOW);
-
-		
-			GPIO_ResetBits(GPIOA,GPIO_Pin_1);
+        port->serial->parent.write(&(port->serial->parent), 0, port->pucTxFrame, port->usTxLen);
+        if (rt_sem_take(&port->xTxDone, SERIAL_TX_TIMEOUT(port->usTxLen, port->ulBaudCur)) != RT_EOK)
+        {
+            /* the completion is lost: end the DMA job in its place, so that the
+             * next frame starts, and take the frame as sent, the reply times out */
+            level = rt_hw_interrupt_disable();
+            rt_hw_serial_isr(port->serial, RT_SERIAL_EVENT_TX_DMADONE);
+            rt_sem_control(&port->xTxDone, RT_IPC_CMD_RESET, 0);
+            rt_hw_interrupt_enable(level);
+        }
+        port->usTxLen = 0;
     }
-    else
+    if (gpio != RT_NULL)
     {
-		
-			GPIO_SetBits(GPIOA,GPIO_Pin_1);
-
+        /* switch 485 to receive mode, or to transmit */
+        if (xRxEnable)
+            GPIO_ResetBits(gpio, serial_rt_control[port->ucPort - 1].pin);
+        else
+            GPIO_SetBits(gpio, serial_rt_control[port->ucPort - 1].pin);
     }
     if (xTxEnable)
     {
         /* start serial transmit */
-        rt_event_send(&event_serial, EVENT_SERIAL_TRANS_START);
+        rt_event_send(&port->xSerialEvent, EVENT_SERIAL_TRANS_START);
     }
     else
     {
         /* stop serial transmit */
-        rt_event_recv(&event_serial, EVENT_SERIAL_TRANS_START,
+        rt_event_recv(&port->xSerialEvent, EVENT_SERIAL_TRANS_START,
                 RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, 0,
                 &recved_event);
     }
 }
 
-void vMBMasterPortClose(void)
+void vMBMasterPortClose(xMBMasterInstance * pxMaster)
 {
-    serial->parent.close(&(serial->parent));
+    pxMaster->xPort.serial->parent.close(&(pxMaster->xPort.serial->parent));
 }
 
-BOOL xMBMasterPortSerialPutByte(CHAR ucByte)
+/* the frame is sent from where it is, it stays untouched until the end */
+BOOL xMBMasterPortSerialPutFrame(xMBMasterInstance * pxMaster, const UCHAR * pucFrame, USHORT usLength)
 {
-    serial->parent.write(&(serial->parent), 0, &ucByte, 1);
+    xMBMasterPort *port = &pxMaster->xPort;
+
+    if (port->serial->parent.open_flag & RT_DEVICE_FLAG_DMA_TX)
+    {
+        port->pucTxFrame = pucFrame;
+        port->usTxLen = usLength;
+    }
+    else
+    {
+        port->serial->parent.write(&(port->serial->parent), 0, pucFrame, usLength);
+    }
     return TRUE;
 }
 
-BOOL xMBMasterPortSerialGetByte(CHAR * pucByte)
+/* the receiver keeps its DMA, only the rate of the UART changes */
+BOOL xMBMasterPortSerialSetBaudRate(xMBMasterInstance * pxMaster, ULONG ulBaudRate)
 {
-    serial->parent.read(&(serial->parent), 0, pucByte, 1);
+    xMBMasterPort *port = &pxMaster->xPort;
+
+    if (port->ulBaudCur == ulBaudRate)
+        return TRUE;
+    port->serial->config.baud_rate = ulBaudRate;
+    if (port->serial->ops->configure(port->serial, &(port->serial->config)) != RT_EOK)
+        return FALSE;
+    port->ulBaudCur = ulBaudRate;
     return TRUE;
 }
 
-/* 
- * Create an interrupt handler for the transmit buffer empty interrupt
- * (or an equivalent) for your target processor. This function should then
- * call pxMBFrameCBTransmitterEmpty( ) which tells the protocol stack that
- * a new character can be sent. The protocol stack will then call 
- * xMBPortSerialPutByte( ) to send the character.
- */
-void prvvUARTTxReadyISR(void)
+BOOL xMBMasterPortSerialGetByte(xMBMasterInstance * pxMaster, CHAR * pucByte)
 {
-    pxMBMasterFrameCBTransmitterEmpty();
+    pxMaster->xPort.serial->parent.read(&(pxMaster->xPort.serial->parent), 0, pucByte, 1);
+    return TRUE;
 }
 
-/* 
- * Create an interrupt handler for the receive interrupt for your target
- * processor. This function should then call pxMBFrameCBByteReceived( ). The
- * protocol stack will then call xMBPortSerialGetByte( ) to retrieve the
- * character.
- */
-void prvvUARTRxISR(void)
+/* the Master on the port, RT_NULL if there is none */
+xMBMasterInstance *pxMBMasterPortSerialInstance(UCHAR ucPort)
+{
+    if (ucPort < 1 || ucPort > MB_MASTER_PORT_NUM)
+        return RT_NULL;
+    return serial_master[ucPort - 1];
+}
+
+static xMBMasterInstance *serial_find_master(rt_device_t dev)
 {
-    pxMBMasterFrameCBByteReceived();
+    int i;
+
+    for (i = 0; i < MB_MASTER_PORT_NUM; i++)
+    {
+        if (serial_master[i] != RT_NULL && &serial_master[i]->xPort.serial->parent == dev)
+            return serial_master[i];
+    }
+    return RT_NULL;
 }
 
 /**
- * Software simulation serial transmit IRQ handler.
+ * Software simulation serial transmit IRQ handler. It calls
+ * pxFrameCBTransmitterEmpty( ) of the Master, which then gives the
+ * whole frame to xMBMasterPortSerialPutFrame( ).
  *
- * @param parameter parameter
+ * @param parameter the Master
  */
 static void serial_soft_trans_irq(void* parameter) {
+    xMBMasterInstance *pxMaster = (xMBMasterInstance *)parameter;
     rt_uint32_t recved_event;
     while (1)
     {
         /* waiting for serial transmit start */
-        rt_event_recv(&event_serial, EVENT_SERIAL_TRANS_START, RT_EVENT_FLAG_OR,
+        rt_event_recv(&pxMaster->xPort.xSerialEvent, EVENT_SERIAL_TRANS_START, RT_EVENT_FLAG_OR,
                 RT_WAITING_FOREVER, &recved_event);
         /* execute modbus callback */
-        prvvUARTTxReadyISR();
+        pxMaster->pxFrameCBTransmitterEmpty(pxMaster);
     }
 }
 
@@ -227,7 +300,40 @@ static void serial_soft_trans_irq(void* parameter) {
  * @return return RT_EOK
  */
 static rt_err_t serial_rx_ind(rt_device_t dev, rt_size_t size) {
-    prvvUARTRxISR();
+    xMBMasterInstance *pxMaster = serial_find_master(dev);
+    rt_base_t level;
+
+    if (pxMaster == RT_NULL)
+        return RT_EOK;
+    /* DMA Rx reports a whole chunk, feed the FSM byte by byte. This runs in
+     * the serial tasklet thread now, keep the T3.5 and respond timeout
+     * expiry from cutting into a state change of the FSM, a byte at a time
+     * so the other interrupts wait no longer than that. */
+    while (size--)
+    {
+        level = xMBMasterPortTimersLock(pxMaster);
+        pxMaster->pxFrameCBByteReceived(pxMaster);
+        vMBMasterPortTimersUnlock(pxMaster, level);
+    }
+#ifdef RT_USING_FINSH
+    pxMaster->xPort.ulRxCycles = DWT_CYCCNT;
+#endif
+    return RT_EOK;
+}
+
+/**
+ * This function is serial transmit DMA done callback function
+ *
+ * @param dev the device of serial
+ * @param buffer the data buffer that has been sent
+ *
+ * @return return RT_EOK
+ */
+static rt_err_t serial_tx_done_ind(rt_device_t dev, void *buffer) {
+    xMBMasterInstance *pxMaster = serial_find_master(dev);
+
+    if (pxMaster != RT_NULL)
+        rt_sem_release(&pxMaster->xPort.xTxDone);
     return RT_EOK;
 }
 
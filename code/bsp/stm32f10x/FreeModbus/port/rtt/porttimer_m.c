@@ -28,80 +28,204 @@
 #include "mbport.h"
 
 #if MB_MASTER_RTU_ENABLED > 0 || MB_MASTER_ASCII_ENABLED > 0
-/* ----------------------- Variables ----------------------------------------*/
-static USHORT usT35TimeOut50us;
-static struct rt_timer timer;
-static void prvvTIMERExpiredISR(void);
-static void timer_timeout_ind(void* parameter);
-
 /* ----------------------- static functions ---------------------------------*/
-static void prvvTIMERExpiredISR(void);
+static void prvvTIMERExpiredISR(xMBMasterInstance * pxMaster);
+static void timer_timeout_ind(void* parameter);
 
 /* ----------------------- Start implementation -----------------------------*/
-BOOL xMBMasterPortTimersInit(USHORT usTimeOut50us)
+#if MB_MASTER_USING_HW_TIMER > 0
+/*
+ * TIM7 counts 50us steps in one-pulse mode, so T3.5 and the respond
+ * timeout expire exactly, whatever RT_TICK_PER_SECOND is. There is only
+ * one TIM7: it goes to the first Master, the others use a system timer.
+ */
+#define MB_MASTER_TIMER                 TIM7
+#define MB_MASTER_TIMER_IRQ             TIM7_IRQn
+
+static xMBMasterInstance *pxTimerMaster;
+
+static void prvvTimerHWInit(void)
 {
-    /* backup T35 ticks */
-    usT35TimeOut50us = usTimeOut50us;
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM7, ENABLE);
+
+    /* APB1 timers run at SystemCoreClock, count at 20kHz (50us) */
+    TIM_TimeBaseStructure.TIM_Prescaler = SystemCoreClock / 20000 - 1;
+    TIM_TimeBaseStructure.TIM_Period = pxTimerMaster->xPort.usT35TimeOut50us - 1;
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(MB_MASTER_TIMER, &TIM_TimeBaseStructure);
+
+    TIM_SelectOnePulseMode(MB_MASTER_TIMER, TIM_OPMode_Single);
+    /* the update generated by TIM_TimeBaseInit() must not interrupt */
+    TIM_UpdateRequestConfig(MB_MASTER_TIMER, TIM_UpdateSource_Regular);
+    TIM_ClearFlag(MB_MASTER_TIMER, TIM_FLAG_Update);
+    TIM_ITConfig(MB_MASTER_TIMER, TIM_IT_Update, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = MB_MASTER_TIMER_IRQ;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+void TIM7_IRQHandler(void)
+{
+    /* enter interrupt */
+    rt_interrupt_enter();
+    if (TIM_GetITStatus(MB_MASTER_TIMER, TIM_IT_Update) != RESET)
+    {
+        TIM_ClearITPendingBit(MB_MASTER_TIMER, TIM_IT_Update);
+        prvvTIMERExpiredISR(pxTimerMaster);
+    }
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
+#endif /* MB_MASTER_USING_HW_TIMER */
+
+static void prvvTimerStart(xMBMasterInstance * pxMaster, USHORT usTimeOut50us)
+{
+    rt_tick_t timer_tick;
+
+    if (usTimeOut50us == 0) usTimeOut50us = 1;
+
+#if MB_MASTER_USING_HW_TIMER > 0
+    if (pxMaster == pxTimerMaster)
+    {
+        TIM_Cmd(MB_MASTER_TIMER, DISABLE);
+        TIM_SetCounter(MB_MASTER_TIMER, 0);
+        TIM_SetAutoreload(MB_MASTER_TIMER, usTimeOut50us - 1);
+        TIM_ClearITPendingBit(MB_MASTER_TIMER, TIM_IT_Update);
+        TIM_Cmd(MB_MASTER_TIMER, ENABLE);
+        return;
+    }
+#endif
+    timer_tick = (50 * (rt_uint32_t)usTimeOut50us) / (1000 * 1000 / RT_TICK_PER_SECOND);
+    if (timer_tick == 0) timer_tick = 1;
+
+    rt_timer_control(&pxMaster->xPort.xTimer, RT_TIMER_CTRL_SET_TIME, &timer_tick);
+    rt_timer_start(&pxMaster->xPort.xTimer);
+}
+
+BOOL xMBMasterPortTimersInit(xMBMasterInstance * pxMaster, USHORT usTimeOut50us)
+{
+    char name[RT_NAME_MAX];
 
-    rt_timer_init(&timer, "master timer",
+    /* backup T35 ticks */
+    pxMaster->xPort.usT35TimeOut50us = usTimeOut50us;
+
+#if MB_MASTER_USING_HW_TIMER > 0
+    if (pxTimerMaster == RT_NULL || pxTimerMaster == pxMaster)
+    {
+        pxTimerMaster = pxMaster;
+        prvvTimerHWInit();
+        return TRUE;
+    }
+#endif
+    rt_snprintf(name, sizeof(name), "mtimer%d", pxMaster->xPort.ucPort);
+    rt_timer_init(&pxMaster->xPort.xTimer, name,
                    timer_timeout_ind, /* bind timeout callback function */
-                   RT_NULL,
-                   (50 * usT35TimeOut50us) / (1000 * 1000 / RT_TICK_PER_SECOND),
+                   pxMaster,
+                   1,
                    RT_TIMER_FLAG_ONE_SHOT); /* one shot */
 
     return TRUE;
 }
 
-void vMBMasterPortTimersT35Enable()
+void vMBMasterPortTimersT35Enable(xMBMasterInstance * pxMaster)
 {
-    rt_tick_t timer_tick = (50 * usT35TimeOut50us)
-            / (1000 * 1000 / RT_TICK_PER_SECOND);
+    /* the first byte of the response */
+    if (pxMaster->eCurTimerMode == MB_TMODE_RESPOND_TIMEOUT)
+    {
+        pxMaster->xPort.xRespDelay = rt_tick_get() - pxMaster->xPort.xRespStart;
+    }
 
     /* Set current timer mode, don't change it.*/
-    vMBMasterSetCurTimerMode(MB_TMODE_T35);
+    vMBMasterSetCurTimerMode(pxMaster, MB_TMODE_T35);
 
-    rt_timer_control(&timer, RT_TIMER_CTRL_SET_TIME, &timer_tick);
-
-    rt_timer_start(&timer);
+    prvvTimerStart(pxMaster, pxMaster->xPort.usT35TimeOut50us);
 }
 
-void vMBMasterPortTimersConvertDelayEnable()
+void vMBMasterPortTimersT35Set(xMBMasterInstance * pxMaster, USHORT usTimeOut50us)
 {
-    rt_tick_t timer_tick = MB_MASTER_DELAY_MS_CONVERT * RT_TICK_PER_SECOND / 1000;
+    /* the next start takes it, the hardware timer too */
+    pxMaster->xPort.usT35TimeOut50us = usTimeOut50us;
+}
 
+void vMBMasterPortTimersConvertDelayEnable(xMBMasterInstance * pxMaster)
+{
     /* Set current timer mode, don't change it.*/
-    vMBMasterSetCurTimerMode(MB_TMODE_CONVERT_DELAY);
-
-    rt_timer_control(&timer, RT_TIMER_CTRL_SET_TIME, &timer_tick);
+    vMBMasterSetCurTimerMode(pxMaster, MB_TMODE_CONVERT_DELAY);
 
-    rt_timer_start(&timer);
+    prvvTimerStart(pxMaster, MB_MASTER_DELAY_MS_CONVERT * 20);
 }
 
-void vMBMasterPortTimersRespondTimeoutEnable()
+void vMBMasterPortTimersRespondTimeoutEnable(xMBMasterInstance * pxMaster)
 {
-    rt_tick_t timer_tick = MB_MASTER_TIMEOUT_MS_RESPOND * RT_TICK_PER_SECOND / 1000;
-
     /* Set current timer mode, don't change it.*/
-    vMBMasterSetCurTimerMode(MB_TMODE_RESPOND_TIMEOUT);
+    vMBMasterSetCurTimerMode(pxMaster, MB_TMODE_RESPOND_TIMEOUT);
+
+    pxMaster->xPort.xRespStart = rt_tick_get();
+    pxMaster->xPort.xRespDelay = RT_TICK_MAX;
+    prvvTimerStart(pxMaster, usMBMasterPortRespondTimeout(pxMaster) * 20);
+}
 
-    rt_timer_control(&timer, RT_TIMER_CTRL_SET_TIME, &timer_tick);
+void vMBMasterPortTimersDisable(xMBMasterInstance * pxMaster)
+{
+#if MB_MASTER_USING_HW_TIMER > 0
+    if (pxMaster == pxTimerMaster)
+    {
+        TIM_Cmd(MB_MASTER_TIMER, DISABLE);
+        TIM_ClearITPendingBit(MB_MASTER_TIMER, TIM_IT_Update);
+        return;
+    }
+#endif
+    rt_timer_stop(&pxMaster->xPort.xTimer);
+}
 
-    rt_timer_start(&timer);
+/*
+ * The receiver runs in the tasklet thread. TIM7 alone is masked while it
+ * takes a byte, the other interrupts go on. The system timer expires in
+ * the tick interrupt, which is only held off with all the others.
+ */
+rt_base_t xMBMasterPortTimersLock(xMBMasterInstance * pxMaster)
+{
+#if MB_MASTER_USING_HW_TIMER > 0
+    if (pxMaster == pxTimerMaster)
+    {
+        NVIC_DisableIRQ(MB_MASTER_TIMER_IRQ);
+        __DSB();
+        __ISB();
+        return 0;
+    }
+#endif
+    return rt_hw_interrupt_disable();
 }
 
-void vMBMasterPortTimersDisable()
+void vMBMasterPortTimersUnlock(xMBMasterInstance * pxMaster, rt_base_t level)
 {
-    rt_timer_stop(&timer);
+#if MB_MASTER_USING_HW_TIMER > 0
+    if (pxMaster == pxTimerMaster)
+    {
+        /* an expiry in between is pending, it is taken now */
+        NVIC_EnableIRQ(MB_MASTER_TIMER_IRQ);
+        return;
+    }
+#endif
+    rt_hw_interrupt_enable(level);
 }
 
-void prvvTIMERExpiredISR(void)
+static void prvvTIMERExpiredISR(xMBMasterInstance * pxMaster)
 {
-    (void) pxMBMasterPortCBTimerExpired();
+    (void) pxMaster->pxPortCBTimerExpired(pxMaster);
 }
 
 static void timer_timeout_ind(void* parameter)
 {
-    prvvTIMERExpiredISR();
+    prvvTIMERExpiredISR((xMBMasterInstance *)parameter);
 }
 
 #endif
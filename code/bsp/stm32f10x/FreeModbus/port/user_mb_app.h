@@ -32,10 +32,6 @@
 #define M_DISCRETE_INPUT_NDISCRETES   16
 #define M_COIL_START                  0
 #define M_COIL_NCOILS                 64
-#define M_REG_INPUT_START             0
-#define M_REG_INPUT_NREGS             10//100
-#define M_REG_HOLDING_START           0
-#define M_REG_HOLDING_NREGS           50//100
 /* master mode: holding register's all address */
 #define          M_HD_RESERVE                     0
 /* master mode: input register's all address */
@@ -45,4 +41,33 @@
 /* master mode: discrete's all address */
 #define          M_DI_RESERVE                     0
 
+/* -----------------------Master register cache ------------------------------*/
+/* the slave sends the low byte first */
+#define M_REG_CACHE_SWAP              0x01
+
+typedef enum
+{
+    MB_MASTER_REG_HOLDING,
+    MB_MASTER_REG_INPUT,
+} eMBMasterRegType;
+
+typedef enum
+{
+    MB_MASTER_REG_NONE,             /*!< not declared, or never read. */
+    MB_MASTER_REG_FRESH,            /*!< read within its max age. */
+    MB_MASTER_REG_STALE,            /*!< last read longer ago than its max age. */
+} eMBMasterRegState;
+
+eMBErrorCode eMBMasterRegCacheDeclare( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress, USHORT usNRegs,
+        UCHAR ucFlags, rt_tick_t xMaxAge );
+eMBMasterRegState eMBMasterRegCacheGetU16( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress, USHORT * pusValue );
+eMBMasterRegState eMBMasterRegCacheGetS16( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress, SHORT * psValue );
+eMBMasterRegState eMBMasterRegCacheGetU32( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress, ULONG * pulValue );
+rt_tick_t xMBMasterRegCacheAge( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress );
+
 #endif
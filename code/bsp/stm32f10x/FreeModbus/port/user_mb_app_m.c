@@ -36,62 +36,301 @@ UCHAR    ucMCoilBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_COIL_NCOILS/8+1];
 #else
 UCHAR    ucMCoilBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_COIL_NCOILS/8];
 #endif
-//Master mode:InputRegister variables
-USHORT   usMRegInStart                              = M_REG_INPUT_START;
-USHORT   usMRegInBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_REG_INPUT_NREGS];
-//Master mode:HoldingRegister variables
-USHORT   usMRegHoldStart                            = M_REG_HOLDING_START;
-USHORT   usMRegHoldBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_REG_HOLDING_NREGS];
+//Master mode:register cache, kept sorted by Master, slave, type and address
+typedef struct
+{
+    xMBMasterInstance * pxMaster;
+    ULONG           ulKey;
+    USHORT          usValue;
+    UCHAR           ucFlags;
+    rt_tick_t       xUpdated;
+    rt_tick_t       xMaxAge;
+} xMBMasterRegEntry;
+
+/* set once the register has been read */
+#define M_REG_CACHE_VALID             0x80
+
+/* grown from the heap by the declarations, one entry per register polled */
+static xMBMasterRegEntry *xMRegCache;
+static USHORT   usMRegCacheNum;
+
+static ULONG prvulMBMasterRegKey( UCHAR ucSlave, eMBMasterRegType eType, USHORT usAddress )
+{
+    return ( ( ULONG ) ucSlave << 17 ) | ( ( ULONG ) eType << 16 ) | usAddress;
+}
+
+/* the first entry not before the key, xMRegCache + usMRegCacheNum if there is none */
+static xMBMasterRegEntry *prvxMBMasterRegFind( xMBMasterInstance * pxMaster, ULONG ulKey )
+{
+    USHORT          usLow = 0, usHigh = usMRegCacheNum, usMid;
+
+    while( usLow < usHigh )
+    {
+        usMid = ( usLow + usHigh ) / 2;
+        if( ( rt_ubase_t ) xMRegCache[usMid].pxMaster < ( rt_ubase_t ) pxMaster ||
+            ( xMRegCache[usMid].pxMaster == pxMaster && xMRegCache[usMid].ulKey < ulKey ) )
+        {
+            usLow = usMid + 1;
+        }
+        else
+        {
+            usHigh = usMid;
+        }
+    }
+    return &xMRegCache[usLow];
+}
+
+static xMBMasterRegEntry *prvxMBMasterRegGet( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress )
+{
+    ULONG           ulKey = prvulMBMasterRegKey( ucSlave, eType, usAddress );
+    xMBMasterRegEntry *pxEntry = prvxMBMasterRegFind( pxMaster, ulKey );
+
+    if( pxEntry < &xMRegCache[usMRegCacheNum] &&
+        pxEntry->pxMaster == pxMaster && pxEntry->ulKey == ulKey )
+    {
+        return pxEntry;
+    }
+    return RT_NULL;
+}
+
+/* store the registers of a request, those nobody declared are dropped */
+static eMBErrorCode prveMBMasterRegStore( xMBMasterInstance * pxMaster, eMBMasterRegType eType,
+        UCHAR * pucRegBuffer, USHORT usAddress, USHORT usNRegs )
+{
+    UCHAR           ucSlave = ucMBMasterGetDestAddress( pxMaster );
+    ULONG           ulKey = prvulMBMasterRegKey( ucSlave, eType, usAddress );
+    xMBMasterRegEntry *pxEntry = prvxMBMasterRegFind( pxMaster, ulKey );
+    xMBMasterRegEntry *pxEnd = &xMRegCache[usMRegCacheNum];
+    rt_tick_t       xNow = rt_tick_get( );
+    USHORT          usValue;
+    rt_base_t       level;
+
+    for( ; usNRegs > 0; usNRegs--, ulKey++, pucRegBuffer += 2 )
+    {
+        while( pxEntry < pxEnd && pxEntry->pxMaster == pxMaster && pxEntry->ulKey < ulKey )
+        {
+            pxEntry++;
+        }
+        if( pxEntry == pxEnd || pxEntry->pxMaster != pxMaster )
+        {
+            break;
+        }
+        if( pxEntry->ulKey != ulKey )
+        {
+            continue;
+        }
+        if( pxEntry->ucFlags & M_REG_CACHE_SWAP )
+        {
+            usValue = pucRegBuffer[0] | ( pucRegBuffer[1] << 8 );
+        }
+        else
+        {
+            usValue = ( pucRegBuffer[0] << 8 ) | pucRegBuffer[1];
+        }
+        level = rt_hw_interrupt_disable( );
+        pxEntry->usValue = usValue;
+        pxEntry->xUpdated = xNow;
+        pxEntry->ucFlags |= M_REG_CACHE_VALID;
+        rt_hw_interrupt_enable( level );
+    }
+    return MB_ENOERR;
+}
 
 /**
- * Modbus master input register callback function.
+ * Declare registers the application polls, the Master keeps them from
+ * then on. Declare them all before the polls start, the cache is not
+ * locked against the Master.
  *
- * @param pucRegBuffer input register buffer
- * @param usAddress input register address
- * @param usNRegs input register number
+ * @param pxMaster the Master the slave is on
+ * @param ucSlave slave address
+ * @param eType holding or input registers
+ * @param usAddress first register address
+ * @param usNRegs register number
+ * @param ucFlags M_REG_CACHE_SWAP if the slave sends the low byte first
+ * @param xMaxAge ticks after which a value is stale
  *
- * @return result
+ * @return MB_ENORES if there is no memory for the new entries
  */
-eMBErrorCode eMBMasterRegInputCB( UCHAR * pucRegBuffer, USHORT usAddress, USHORT usNRegs )
+eMBErrorCode eMBMasterRegCacheDeclare( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress, USHORT usNRegs,
+        UCHAR ucFlags, rt_tick_t xMaxAge )
 {
-    eMBErrorCode    eStatus = MB_ENOERR;
-    USHORT          iRegIndex;
-    USHORT *        pusRegInputBuf;
-    USHORT          REG_INPUT_START;
-    USHORT          REG_INPUT_NREGS;
-    USHORT          usRegInStart;
-
-    pusRegInputBuf = usMRegInBuf[ucMBMasterGetDestAddress() - 1];
-    REG_INPUT_START = M_REG_INPUT_START;
-    REG_INPUT_NREGS = M_REG_INPUT_NREGS;
-    usRegInStart = usMRegInStart;
-
-    /* it already plus one in modbus function method. */
-    usAddress--;
+    xMBMasterRegEntry *pxEntry;
+    ULONG           ulKey;
+    USHORT          i, usNew = 0;
 
-    if ((usAddress >= REG_INPUT_START)
-            && (usAddress + usNRegs <= REG_INPUT_START + REG_INPUT_NREGS))
+    if( ucSlave < MB_ADDRESS_MIN || ucSlave > MB_MASTER_TOTAL_SLAVE_NUM ||
+        ( ULONG ) usAddress + usNRegs > 0x10000 )
+    {
+        return MB_EINVAL;
+    }
+    /* make room for the registers not declared yet, all at once */
+    for( i = 0; i < usNRegs; i++ )
     {
-        iRegIndex = usAddress - usRegInStart;
-        while (usNRegs > 0)
+        if( prvxMBMasterRegGet( pxMaster, ucSlave, eType, usAddress + i ) == RT_NULL )
         {
-            pusRegInputBuf[iRegIndex] = *pucRegBuffer++ << 8;
-            pusRegInputBuf[iRegIndex] |= *pucRegBuffer++;
-            iRegIndex++;
-            usNRegs--;
+            usNew++;
         }
     }
+    if( usNew > 0 )
+    {
+        if( ( ULONG ) usMRegCacheNum + usNew > 0xFFFF )
+        {
+            return MB_ENORES;
+        }
+        pxEntry = rt_realloc( xMRegCache, ( usMRegCacheNum + usNew ) * sizeof( *pxEntry ) );
+        if( pxEntry == RT_NULL )
+        {
+            return MB_ENORES;
+        }
+        xMRegCache = pxEntry;
+    }
+    for( ; usNRegs > 0; usNRegs--, usAddress++ )
+    {
+        ulKey = prvulMBMasterRegKey( ucSlave, eType, usAddress );
+        pxEntry = prvxMBMasterRegFind( pxMaster, ulKey );
+        if( pxEntry == &xMRegCache[usMRegCacheNum] ||
+            pxEntry->pxMaster != pxMaster || pxEntry->ulKey != ulKey )
+        {
+            rt_memmove( pxEntry + 1, pxEntry,
+                        ( &xMRegCache[usMRegCacheNum] - pxEntry ) * sizeof( *pxEntry ) );
+            usMRegCacheNum++;
+            pxEntry->pxMaster = pxMaster;
+            pxEntry->ulKey = ulKey;
+            pxEntry->ucFlags = 0;
+        }
+        pxEntry->ucFlags = ( pxEntry->ucFlags & M_REG_CACHE_VALID ) | ucFlags;
+        pxEntry->xMaxAge = xMaxAge;
+    }
+    return MB_ENOERR;
+}
+
+/**
+ * Read a register from the cache, in host byte order.
+ *
+ * @param pxMaster the Master the slave is on
+ * @param ucSlave slave address
+ * @param eType holding or input registers
+ * @param usAddress register address
+ * @param pusValue the last value read, left alone if there is none
+ *
+ * @return how fresh the value is
+ */
+eMBMasterRegState eMBMasterRegCacheGetU16( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress, USHORT * pusValue )
+{
+    xMBMasterRegEntry *pxEntry = prvxMBMasterRegGet( pxMaster, ucSlave, eType, usAddress );
+    eMBMasterRegState eState;
+    rt_base_t       level;
+
+    if( pxEntry == RT_NULL )
+    {
+        return MB_MASTER_REG_NONE;
+    }
+    level = rt_hw_interrupt_disable( );
+    if( !( pxEntry->ucFlags & M_REG_CACHE_VALID ) )
+    {
+        eState = MB_MASTER_REG_NONE;
+    }
     else
     {
-        eStatus = MB_ENOREG;
+        *pusValue = pxEntry->usValue;
+        eState = rt_tick_get( ) - pxEntry->xUpdated > pxEntry->xMaxAge ?
+                 MB_MASTER_REG_STALE : MB_MASTER_REG_FRESH;
     }
+    rt_hw_interrupt_enable( level );
+    return eState;
+}
 
-    return eStatus;
+eMBMasterRegState eMBMasterRegCacheGetS16( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress, SHORT * psValue )
+{
+    return eMBMasterRegCacheGetU16( pxMaster, ucSlave, eType, usAddress, ( USHORT * ) psValue );
+}
+
+/**
+ * Read two registers from the cache as one value, the first one is the
+ * high word.
+ *
+ * @return the state of the older of the two
+ */
+eMBMasterRegState eMBMasterRegCacheGetU32( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress, ULONG * pulValue )
+{
+    eMBMasterRegState eHigh, eLow;
+    USHORT          usHigh, usLow;
+
+    eHigh = eMBMasterRegCacheGetU16( pxMaster, ucSlave, eType, usAddress, &usHigh );
+    eLow = eMBMasterRegCacheGetU16( pxMaster, ucSlave, eType, usAddress + 1, &usLow );
+    if( eHigh == MB_MASTER_REG_NONE || eLow == MB_MASTER_REG_NONE )
+    {
+        return MB_MASTER_REG_NONE;
+    }
+    *pulValue = ( ( ULONG ) usHigh << 16 ) | usLow;
+    return eHigh == MB_MASTER_REG_STALE || eLow == MB_MASTER_REG_STALE ?
+           MB_MASTER_REG_STALE : MB_MASTER_REG_FRESH;
+}
+
+/* ticks since the register was read, RT_TICK_MAX if it never was */
+rt_tick_t xMBMasterRegCacheAge( xMBMasterInstance * pxMaster, UCHAR ucSlave,
+        eMBMasterRegType eType, USHORT usAddress )
+{
+    xMBMasterRegEntry *pxEntry = prvxMBMasterRegGet( pxMaster, ucSlave, eType, usAddress );
+
+    if( pxEntry == RT_NULL || !( pxEntry->ucFlags & M_REG_CACHE_VALID ) )
+    {
+        return RT_TICK_MAX;
+    }
+    return rt_tick_get( ) - pxEntry->xUpdated;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+static void mb_regs(void)
+{
+    xMBMasterRegEntry *pxEntry;
+    USHORT          i;
+
+    rt_kprintf("port slave type  addr value  age\n");
+    for (i = 0; i < usMRegCacheNum; i++)
+    {
+        pxEntry = &xMRegCache[i];
+        rt_kprintf("%4d %5d %-5s %4d ", pxEntry->pxMaster->xPort.ucPort,
+                   pxEntry->ulKey >> 17, (pxEntry->ulKey >> 16) & 1 ? "input" : "hold",
+                   pxEntry->ulKey & 0xFFFF);
+        if (pxEntry->ucFlags & M_REG_CACHE_VALID)
+            rt_kprintf("%5d %4d%s\n", pxEntry->usValue, rt_tick_get() - pxEntry->xUpdated,
+                       rt_tick_get() - pxEntry->xUpdated > pxEntry->xMaxAge ? " stale" : "");
+        else
+            rt_kprintf("    -    -\n");
+    }
+}
+FINSH_FUNCTION_EXPORT(mb_regs, list the Modbus master register cache)
+#endif
+
+/**
+ * Modbus master input register callback function.
+ *
+ * @param pxMaster the Master, its destination address is the slave
+ * @param pucRegBuffer input register buffer
+ * @param usAddress input register address
+ * @param usNRegs input register number
+ *
+ * @return result
+ */
+eMBErrorCode eMBMasterRegInputCB( xMBMasterInstance * pxMaster, UCHAR * pucRegBuffer, USHORT usAddress, USHORT usNRegs )
+{
+    /* it already plus one in modbus function method. */
+    usAddress--;
+
+    return prveMBMasterRegStore( pxMaster, MB_MASTER_REG_INPUT, pucRegBuffer, usAddress, usNRegs );
 }
 
 /**
  * Modbus master holding register callback function.
  *
+ * @param pxMaster the Master, its destination address is the slave
  * @param pucRegBuffer holding register buffer
  * @param usAddress holding register address
  * @param usNRegs holding register number
@@ -99,64 +338,20 @@ eMBErrorCode eMBMasterRegInputCB( UCHAR * pucRegBuffer, USHORT usAddress, USHORT
  *
  * @return result
  */
-eMBErrorCode eMBMasterRegHoldingCB(UCHAR * pucRegBuffer, USHORT usAddress,
+eMBErrorCode eMBMasterRegHoldingCB(xMBMasterInstance * pxMaster, UCHAR * pucRegBuffer, USHORT usAddress,
         USHORT usNRegs, eMBRegisterMode eMode)
 {
-    eMBErrorCode    eStatus = MB_ENOERR;
-    USHORT          iRegIndex;
-    USHORT *        pusRegHoldingBuf;
-    USHORT          REG_HOLDING_START;
-    USHORT          REG_HOLDING_NREGS;
-    USHORT          usRegHoldStart;
-
-    pusRegHoldingBuf = usMRegHoldBuf[ucMBMasterGetDestAddress() - 1];
-    REG_HOLDING_START = M_REG_HOLDING_START;
-    REG_HOLDING_NREGS = M_REG_HOLDING_NREGS;
-    usRegHoldStart = usMRegHoldStart;
-    /* if mode is read, the master will write the received date to buffer. */
-    eMode = MB_REG_WRITE;
-
     /* it already plus one in modbus function method. */
     usAddress--;
 
-    if ((usAddress >= REG_HOLDING_START)
-            && (usAddress + usNRegs <= REG_HOLDING_START + REG_HOLDING_NREGS))
-    {
-        iRegIndex = usAddress - usRegHoldStart;
-        switch (eMode)
-        {
-        /* read current register values from the protocol stack. */
-        case MB_REG_READ:
-            while (usNRegs > 0)
-            {
-                *pucRegBuffer++ = (UCHAR) (pusRegHoldingBuf[iRegIndex] >> 8);
-                *pucRegBuffer++ = (UCHAR) (pusRegHoldingBuf[iRegIndex] & 0xFF);
-                iRegIndex++;
-                usNRegs--;
-            }
-            break;
-        /* write current register values with new values from the protocol stack. */
-        case MB_REG_WRITE:
-            while (usNRegs > 0)
-            {
-                pusRegHoldingBuf[iRegIndex] = *pucRegBuffer++ << 8;
-                pusRegHoldingBuf[iRegIndex] |= *pucRegBuffer++;
-                iRegIndex++;
-                usNRegs--;
-            }
-            break;
-        }
-    }
-    else
-    {
-        eStatus = MB_ENOREG;
-    }
-    return eStatus;
+    /* the values a write sent or a read got back are the slave's now */
+    return prveMBMasterRegStore( pxMaster, MB_MASTER_REG_HOLDING, pucRegBuffer, usAddress, usNRegs );
 }
 
 /**
  * Modbus master coils callback function.
  *
+ * @param pxMaster the Master, its destination address is the slave
  * @param pucRegBuffer coils buffer
  * @param usAddress coils address
  * @param usNCoils coils number
@@ -164,7 +359,7 @@ eMBErrorCode eMBMasterRegHoldingCB(UCHAR * pucRegBuffer, USHORT usAddress,
  *
  * @return result
  */
-eMBErrorCode eMBMasterRegCoilsCB(UCHAR * pucRegBuffer, USHORT usAddress,
+eMBErrorCode eMBMasterRegCoilsCB(xMBMasterInstance * pxMaster, UCHAR * pucRegBuffer, USHORT usAddress,
         USHORT usNCoils, eMBRegisterMode eMode)
 {
     eMBErrorCode    eStatus = MB_ENOERR;
@@ -175,7 +370,7 @@ eMBErrorCode eMBMasterRegCoilsCB(UCHAR * pucRegBuffer, USHORT usAddress,
     USHORT          usCoilStart;
     iNReg =  usNCoils / 8 + 1;
 
-    pucCoilBuf = ucMCoilBuf[ucMBMasterGetDestAddress() - 1];
+    pucCoilBuf = ucMCoilBuf[ucMBMasterGetDestAddress(pxMaster) - 1];
     COIL_START = M_COIL_START;
     COIL_NCOILS = M_COIL_NCOILS;
     usCoilStart = usMCoilStart;
@@ -238,13 +433,14 @@ eMBErrorCode eMBMasterRegCoilsCB(UCHAR * pucRegBuffer, USHORT usAddress,
 /**
  * Modbus master discrete callback function.
  *
+ * @param pxMaster the Master, its destination address is the slave
  * @param pucRegBuffer discrete buffer
  * @param usAddress discrete address
  * @param usNDiscrete discrete number
  *
  * @return result
  */
-eMBErrorCode eMBMasterRegDiscreteCB( UCHAR * pucRegBuffer, USHORT usAddress, USHORT usNDiscrete )
+eMBErrorCode eMBMasterRegDiscreteCB( xMBMasterInstance * pxMaster, UCHAR * pucRegBuffer, USHORT usAddress, USHORT usNDiscrete )
 {
     eMBErrorCode    eStatus = MB_ENOERR;
     USHORT          iRegIndex , iRegBitIndex , iNReg;
@@ -254,7 +450,7 @@ eMBErrorCode eMBMasterRegDiscreteCB( UCHAR * pucRegBuffer, USHORT usAddress, USH
     USHORT          usDiscreteInputStart;
     iNReg =  usNDiscrete / 8 + 1;
 
-    pucDiscreteInputBuf = ucMDiscInBuf[ucMBMasterGetDestAddress() - 1];
+    pucDiscreteInputBuf = ucMDiscInBuf[ucMBMasterGetDestAddress(pxMaster) - 1];
     DISCRETE_INPUT_START = M_DISCRETE_INPUT_START;
     DISCRETE_INPUT_NDISCRETES = M_DISCRETE_INPUT_NDISCRETES;
     usDiscreteInputStart = usMDiscInStart;
@@ -3,34 +3,34 @@
 
 #include "includes.h"
 
-struct queue_node
-{    //ӽṹ
-	int data;
-	struct queue_node *next;
+//a received keyboard frame, as the protocol decoders take it
+#define	QUEUE_FRAME_SIZE	20
+//frame slots of the ring, a power of two
+#define	QUEUE_SLOTS			32
+//frames the protocol thread takes out at once
+#define	QUEUE_BATCH			4
+
+/*
+ * Single producer, single consumer ring of preallocated frame slots:
+ * pelco_rx_isr() pushes, the protocol thread pops. Each side writes its own
+ * index only, so neither needs a lock, the interrupts off or the heap. A
+ * frame that finds the ring full is dropped and counted.
+ */
+struct queue_ring
+{
+	volatile u16 head;		//written by the producer only
+	volatile u16 tail;		//written by the consumer only
+	volatile u32 overflow;
+	volatile u8 slot[QUEUE_SLOTS][QUEUE_FRAME_SIZE];
 };
 
+extern struct queue_ring keyboard_queue;
 
-struct Queue_NodeType
-{    //ӽṹ
-	u8 data[20];
-	struct Queue_NodeType *next;
-};
-
-
-typedef struct Queue_NodeType queue_list; //
-typedef queue_list* queue_link;    //ָ
-
-extern signed char QueueLenght;
-extern queue_link rear;
-extern queue_link front;
-
-extern u8 delqueue_extend(u8 type,u8 dataLen,u8 *dst);
-extern u8 delqueue(u8 dataLen,u8 *dst);
 extern u8 addqueue(u8 dataLen,u8 *datapointer);
-extern u8 out_queue_rear(u8 type,u8 dataLen,u8 *dst);
-extern void dle_queue_node(queue_link node);
+extern u8 delqueue(u8 dataLen,u8 *dst);
+extern u8 delqueue_batch(u8 (*dst)[QUEUE_FRAME_SIZE],u8 count);
+extern u8 queue_length(void);
 extern void queue_init(void);
 
 
 #endif  /* _QUEUE_H_ */
-
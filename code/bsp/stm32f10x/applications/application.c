@@ -48,6 +48,12 @@
 #include "bsp_spi_flash.h"
 
 #include "disp_board.h"
+#include "bus_sched.h"
+#include "para_store.h"
+#include "ts_store.h"
+#include "dev_state.h"
+#include "auto_rules.h"
+#include "sched_trace.h"
 
 
 
@@ -61,6 +67,22 @@ extern void set_display_board_data(void);
 extern void get_display_board_data(void);
 extern void thread_entry_ModbusMasterPoll(void* parameter);
 
+enum
+{
+	BUS_JOB_DISP_GET = 0,
+	BUS_JOB_DISP_SET,
+	BUS_JOB_DC_MOTOR,
+	BUS_JOB_ROOM1,
+	BUS_JOB_ROOM2,
+	BUS_JOB_ROOM3,
+	BUS_JOB_ROOM4,
+	BUS_JOB_ROOM5,
+	BUS_JOB_BAUD,
+	BUS_JOB_NUM
+};
+
+extern struct bus_job bus_job_table[BUS_JOB_NUM];
+
 
 
 
@@ -104,6 +126,9 @@ void rt_init_thread_entry(void* parameter)
     finsh_set_device(RT_CONSOLE_DEVICE_NAME);
 #endif  /* RT_USING_FINSH */
 
+    /* thread and interrupt time on the DWT cycle counter */
+    cpu_usage_init();
+
     /* Filesystem Initialization */
 #if defined(RT_USING_DFS) && defined(RT_USING_DFS_ELMFAT)
     /* mount sd card fat partition 1 as root directory */
@@ -130,65 +155,61 @@ void rt_init_thread_entry(void* parameter)
 
 u16 myreg1,myreg2;
 
-extern USHORT   usMRegInBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_REG_INPUT_NREGS];
-extern USHORT   usMRegHoldBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_REG_HOLDING_NREGS];
-
 extern DEVICE_WORK_TYPE device_work_data;
 
-#define sw16(x) \
-   ((short)(\
-      (((short)(x) &(short)0x00ffU) << 8) |\
-      (((short)(x) &(short)0xff00U) >> 8)))
+/* room sensors are polled every second, a value older than this is stale */
+#define ROOM_REG_MAX_AGE	(RT_TICK_PER_SECOND*3)
 
 
-#define	exchange_16bit_hi_lo(x)		sw16(x)
+/* master bus priority of the commands, they go out ahead of the periodic polls */
+#define MB_PRIO_COMMAND		0
 
+/* the Master on the RS485 bus of the rooms, UART2 */
+xMBMasterInstance rs485_master;
 
-extern eMBMasterReqErrCode eMBMasterReqRead_not_rtu_datas(UCHAR *ucMBFrame, USHORT usLength, LONG lTimeOut );
+/* every device starts at the bus rate, the ones that can are switched up */
+#define BUS_BAUD_RATE		9600
+#define BUS_BAUD_HIGH		115200
 
-u8 rs485_send_buf_not_modbus[50];
+/* the start of the last reply, only read from the bus scheduler thread */
+static u8 bus_reply[33];
 
+//one raw frame on the master bus at the rate of device (0 the bus rate), after the commands, its reply of expect bytes (0 unknown) lands in bus_reply
+static eMBMasterReqErrCode bus_raw_request(u8 device,u8 *frame,u8 len,u8 expect)
+{
+	return eMBMasterReqRaw(&rs485_master,device,frame,len,bus_reply,sizeof(bus_reply),expect,0,RT_NULL,RT_WAITING_FOREVER);
+}
 
+//the dc motor frame is built from the work state when the job sends it, send it now
 void set_dc_motor_speed(u8 speed)
 {
-	//device_work_data.para_type.wind_speed_state = speed;
-
-    rs485_send_buf_not_modbus[0] = 0xBC;
-    rs485_send_buf_not_modbus[1] = 0x07;
-    rs485_send_buf_not_modbus[2] = 0x01;
-    rs485_send_buf_not_modbus[3] = speed>3?3:speed;
-    rs485_send_buf_not_modbus[4] = rs485_send_buf_not_modbus[0]+rs485_send_buf_not_modbus[1]+rs485_send_buf_not_modbus[2]+rs485_send_buf_not_modbus[3];
-
+	bus_sched_trigger(&bus_job_table[BUS_JOB_DC_MOTOR]);
 }
 
-extern volatile UCHAR  ucMasterRTURcvBuf[256];
-extern volatile UCHAR  ucMasterRTUSndBuf[256];
-
 void set_dc_motor(void)
 {
 	eMBMasterReqErrCode    errorCode = MB_MRE_NO_ERR;
+	u8 frame[5];
+	u8 speed = 0;
 
+	if(device_work_data.para_type.device_power_state)
+		speed = device_work_data.para_type.wind_speed_state;
 
-	if(device_work_data.para_type.device_power_state==0)
-	{
-		
-		set_dc_motor_speed(0);
-	}
-	else
-	{
-		set_dc_motor_speed(device_work_data.para_type.wind_speed_state);
-
-	}
+	frame[0] = 0xBC;
+	frame[1] = 0x07;
+	frame[2] = 0x01;
+	frame[3] = speed>3?3:speed;
+	frame[4] = frame[0]+frame[1]+frame[2]+frame[3];
 
-    ucMasterRTURcvBuf[0] = 0;
-	errorCode = eMBMasterReqRead_not_rtu_datas(rs485_send_buf_not_modbus,5,RT_WAITING_FOREVER);
-	if(errorCode == MB_MRE_REV_DATA)
+	bus_reply[0] = 0;
+	errorCode = bus_raw_request(0,frame,5,5);
+	if(errorCode == MB_MRE_NO_ERR)
 	{
-		if(ucMasterRTURcvBuf[0] == 0xBC && ucMasterRTURcvBuf[1] == 0x07)
+		if(bus_reply[0] == 0xBC && bus_reply[1] == 0x07)
         {
             u8 tmp;
 
-            tmp  = ucMasterRTURcvBuf[3];
+            tmp  = bus_reply[3];
             if(tmp&0x03)
                 {
                 fault_set_bit(FAULT_MOTOR_BIT,1);
@@ -462,63 +483,27 @@ rt_mutex_t modbus_mutex = RT_NULL;
 rt_mutex_t motor_mutex = RT_NULL;
 
 
-void thread_dc_motor_set(void* parameter)
-{
-
-	u8 dc_motor_state_pre = 0xff;
-	
-	while (1)
-	{
-		
-		//rt_thread_delay(RT_TICK_PER_SECOND/10);
-		rt_thread_delay(RT_TICK_PER_SECOND/2);
-
-		
-		set_dc_motor();//1s
-
-
-		
-	}
-}
-
-
+/* the image the display board has, valid while it acknowledges */
+static u8 disp_image[DISP_IMAGE_SIZE];
+static u8 disp_seq;
+static u8 disp_synced = 0;
+static rt_uint32_t disp_snapshot_cnt, disp_delta_cnt, disp_sync_bytes;
 
 void get_display_board_data(void)
 {
 	eMBMasterReqErrCode    errorCode = MB_MRE_NO_ERR;
-	u8 i;
 	static u8 device_power_state_bak = 0xff;
 
-	rt_mutex_take(modbus_mutex,RT_WAITING_FOREVER);
-	
-    rs485_send_buf_not_modbus[0] = 0xF1;
-    rs485_send_buf_not_modbus[1] = 0xF1;
-    rs485_send_buf_not_modbus[2] = 0x01;
-    rs485_send_buf_not_modbus[3] = 0x01;
-    rs485_send_buf_not_modbus[4] = 0x00;
-    rs485_send_buf_not_modbus[5] = 0x02;
-    rs485_send_buf_not_modbus[6] = 0x7E;
-
-       ucMasterRTURcvBuf[0] = 0; 
-	errorCode = eMBMasterReqRead_not_rtu_datas(rs485_send_buf_not_modbus,7,RT_WAITING_FOREVER);
-	if(errorCode == MB_MRE_REV_DATA)
+	static u8 frame[7] = {0xF1,0xF1,0x01,0x01,0x00,0x02,0x7E};
+
+    bus_reply[0] = 0;
+	errorCode = bus_raw_request(DISP_BUS_DEVICE,frame,7,0);
+	if(errorCode == MB_MRE_NO_ERR)
 	{
-		if(ucMasterRTURcvBuf[0] == 0xF2 && ucMasterRTURcvBuf[1] == 0xF2 && ucMasterRTURcvBuf[32] == 0x7e)
+		if(bus_reply[0] == 0xF2 && bus_reply[1] == 0xF2 && bus_reply[32] == 0x7e)
         {
-
-        
-    		for(i=0;i<sizeof(struct __para_type);i++)
-			{
-				
-				device_work_data_bak.device_data[i] = device_work_data.device_data[i];
-				
-				
-			}
-
-
-			
             //device_work_data.para_type.device_power_state = ucMasterRTURcvBuf_2[4];
-            device_work_data.para_type.device_mode = ucMasterRTURcvBuf[5];
+            dev_state_set(DEV_STATE_MODE, bus_reply[5]);
 
             if(device_work_data.para_type.device_mode == 1)
             {
@@ -527,12 +512,12 @@ void get_display_board_data(void)
             else
             {
 
-                device_work_data.para_type.wind_speed_state = ucMasterRTURcvBuf[6];
-                device_work_data.para_type.high_pressur_state = ucMasterRTURcvBuf[7];
-                device_work_data.para_type.pht_work_state = ucMasterRTURcvBuf[8];
+                dev_state_set(DEV_STATE_WIND_SPEED, bus_reply[6]);
+                dev_state_set(DEV_STATE_HIGH_PRESSURE, bus_reply[7]);
+                dev_state_set(DEV_STATE_PHT, bus_reply[8]);
             }
 
-            device_work_data.para_type.timing_state = ucMasterRTURcvBuf[9];
+            dev_state_set(DEV_STATE_TIMING, bus_reply[9]);
             //device_work_data.para_type.fault_state = ucMasterRTURcvBuf_2[9];
 
 			//fault_set_bit(FAULT_RESET_WIFI_BIT,ucMasterRTURcvBuf_2[30]&(1<<FAULT_RESET_WIFI_BIT));
@@ -542,49 +527,40 @@ void get_display_board_data(void)
 
 
 			
-			if(ucMasterRTURcvBuf[30]&(1<<FAULT_RESET_WIFI_BIT))
+			if(bus_reply[30]&(1<<FAULT_RESET_WIFI_BIT))
 			{
 				
 				wifi_factory_set();
 
 			}
 
-			for(i=0;i<6;i++)
-			{
-				
-				if(device_work_data_bak.device_data[i] != device_work_data.device_data[i])
-				{
-
-					device_sys_para_save();
-					break;
-				}
-				
-				
-			}
 
 				
         }      
-		else if(ucMasterRTURcvBuf[0] == 0xF1 && ucMasterRTURcvBuf[1] == 0xF1 && ucMasterRTURcvBuf[6] == 0x7e)
+		else if(bus_reply[0] == 0xF1 && bus_reply[1] == 0xF1 && bus_reply[6] == 0x7e)
 		{
 
-			if((ucMasterRTURcvBuf[2] <=7) && (ucMasterRTURcvBuf[2] > 1))
+			if((bus_reply[2] <=7) && (bus_reply[2] > 1))
 			{
 			
-			set_device_work_mode(ucMasterRTURcvBuf[2],ucMasterRTURcvBuf[4],0);
+			set_device_work_mode(bus_reply[2],bus_reply[4],0);
 
 
 			}
+			else if(bus_reply[2] == 0x01 && (bus_reply[4] & DISP_SYNC_REQUEST))
+			{
+				//the board restarted or dropped a delta
+				disp_synced = 0;
+				bus_sched_trigger(&bus_job_table[BUS_JOB_DISP_SET]);
+			}
 
 
 			
 		}
 	}
-
-	rt_mutex_release(modbus_mutex);
-	
 }
 
-static u8 disp_board_packet_data(u8 len)
+static u8 disp_board_packet_data(u8 *frame,u8 len,u8 *image)
 {
 
     u8 buftmp[35];
@@ -594,163 +570,304 @@ static u8 disp_board_packet_data(u8 len)
 
     u8 i;
 
-    for(i=0;i<27;i++)
+    for(i=0;i<DISP_IMAGE_SIZE;i++)
         {
-        buftmp[2+i] = device_work_data.device_data[i];
+        buftmp[2+i] = image[i];
 
     }
 
 
-    u8 chk;
+    u8 chk = 0;
 
 
-    rs485_send_buf_not_modbus[0] = 0xF2;
-    rs485_send_buf_not_modbus[1] = 0xF2;
+    frame[0] = 0xF2;
+    frame[1] = 0xF2;
 
     for(i=0;i<len;i++)
     {
-        rs485_send_buf_not_modbus[i+2] = buftmp[i];
+        frame[i+2] = buftmp[i];
         chk += buftmp[i];    
     }
 
-    rs485_send_buf_not_modbus[i+2] = chk;
-    rs485_send_buf_not_modbus[i+3] = 0x7E;
+    frame[i+2] = chk;
+    frame[i+3] = 0x7E;
 	
 		return 1;
 }
 
 
-static u8 send_packet_data(u8 len,u8 *buftmp)
+static u8 send_packet_data_head(u8 *frame,u8 head,u8 len,u8 *buftmp)
 {
 
 
     u8 i;
 
 
-    u8 chk;
+    u8 chk = 0;
 
 
-    rs485_send_buf_not_modbus[0] = 0xF1;
-    rs485_send_buf_not_modbus[1] = 0xF1;
+    frame[0] = head;
+    frame[1] = head;
 
     for(i=0;i<len;i++)
     {
-        rs485_send_buf_not_modbus[i+2] = buftmp[i];
+        frame[i+2] = buftmp[i];
         chk += buftmp[i];    
     }
 
-    rs485_send_buf_not_modbus[i+2] = chk;
-    rs485_send_buf_not_modbus[i+3] = 0x7E;
+    frame[i+2] = chk;
+    frame[i+3] = 0x7E;
 	
 		return 1;
 }
 
+static u8 send_packet_data(u8 *frame,u8 len,u8 *buftmp)
+{
+	return send_packet_data_head(frame,0xF1,len,buftmp);
+}
 
 
 
-void set_dispboard_function_mode(enum DEVICE_CMD_TYPE type,u8 mode)
-{
 
-#if 1
-	eMBMasterReqErrCode    errorCode = MB_MRE_NO_ERR;
+#define D_CMD_NUM	(D_CMD_WIND_SPEED - D_CMD_POWER + 1)
 
+//the command goes out ahead of the polls, the caller does not wait for it
+void set_dispboard_function_mode(enum DEVICE_CMD_TYPE type,u8 mode)
+{
+	//one slot per type: a power command is not lost to a wind command after it
+	static xMBMasterRequest req[D_CMD_NUM];
+	static u8 frame[D_CMD_NUM][7];
+	xMBMasterRequest *cmd;
+	u8 tmpbuf[3];
 
-	u8 tmpbuf[10];
+	if(type < D_CMD_POWER || type > D_CMD_WIND_SPEED)
+		return;
+	cmd = &req[type - D_CMD_POWER];
 
-	
 	tmpbuf[0] = (u8)type;
-	tmpbuf[0] = 0x01;
-	tmpbuf[0] = mode;
+	tmpbuf[1] = 0x01;
+	tmpbuf[2] = mode;
 
 	rt_mutex_take(modbus_mutex,RT_WAITING_FOREVER);
-	
-    send_packet_data(3,tmpbuf);
 
-      ucMasterRTURcvBuf[0] = 0; 
-	errorCode = eMBMasterReqRead_not_rtu_datas(rs485_send_buf_not_modbus,7,RT_WAITING_FOREVER);
-	if(errorCode == MB_MRE_REV_DATA)
-	{
-		if(ucMasterRTURcvBuf[0] == 0xF2 && ucMasterRTURcvBuf[1] == 0xF2 && ucMasterRTURcvBuf[32] == 0x7e)
-        {
-            ;
-        }      
-	}
+	//the last command of a type replaces the one of that type not sent yet
+	if(!xMBMasterReqCancel(cmd) && xMBMasterReqIsBusy(cmd))
+		eMBMasterReqWait(cmd,RT_WAITING_FOREVER);
 
-	
-	rt_mutex_release(modbus_mutex);
+	send_packet_data(frame[type - D_CMD_POWER],3,tmpbuf);
+
+	cmd->xRaw = TRUE;
+	cmd->ucSndAddr = DISP_BUS_DEVICE;
+	cmd->pucFrame = frame[type - D_CMD_POWER];
+	cmd->usLength = 7;
+	cmd->ucPriority = MB_PRIO_COMMAND;
+	cmd->lDeadline = RT_TICK_PER_SECOND;
+	eMBMasterReqSubmit(&rs485_master,cmd);
 
-	#endif
+	rt_mutex_release(modbus_mutex);
 }
 
 
 
-void set_display_board_data(void)
+static u8 disp_sync_acked(u8 seq)
 {
+	return bus_reply[0] == 0xF3 && bus_reply[1] == 0xF3 &&
+		bus_reply[2] == DISP_SYNC_ACK && bus_reply[4] == seq &&
+		bus_reply[6] == 0x7e;
+}
 
-#if 1
+//only the changed bytes of the image once the board acknowledges, see disp_board.h
+void set_display_board_data(void)
+{
 	eMBMasterReqErrCode    errorCode = MB_MRE_NO_ERR;
+	u8 image[DISP_IMAGE_SIZE];
+	u8 delta[3 + DISP_SYNC_DELTA_MAX*2];
+	u8 frame[33];
+	u8 i,n = 0;
 
-	rt_mutex_take(modbus_mutex,RT_WAITING_FOREVER);
+	rt_memcpy(image,device_work_data.device_data,DISP_IMAGE_SIZE);
 
+	i = 0;
+	if(disp_synced)
+	{
+		for(i=0;i<DISP_IMAGE_SIZE;i++)
+		{
+			if(image[i] == disp_image[i])
+				continue;
+			if(n == DISP_SYNC_DELTA_MAX)
+				break;
+
+			delta[3+n*2] = i;
+			delta[4+n*2] = image[i];
+			n++;
+		}
 
-    disp_board_packet_data(33-4);
+		if(n == 0)
+			return;
+	}
 
-      ucMasterRTURcvBuf[0] = 0; 
-	errorCode = eMBMasterReqRead_not_rtu_datas(rs485_send_buf_not_modbus,33,RT_WAITING_FOREVER);
-	if(errorCode == MB_MRE_REV_DATA)
+	bus_reply[0] = 0;
+	if(disp_synced && i == DISP_IMAGE_SIZE)
 	{
-		if(ucMasterRTURcvBuf[0] == 0xF2 && ucMasterRTURcvBuf[1] == 0xF2 && ucMasterRTURcvBuf[32] == 0x7e)
-        {
-            ;
-        }      
+		delta[0] = DISP_SYNC_DELTA;
+		delta[1] = 1 + n*2;
+		delta[2] = disp_seq + 1;
+		send_packet_data_head(frame,0xF3,3 + n*2,delta);
+
+		errorCode = bus_raw_request(DISP_BUS_DEVICE,frame,7 + n*2,7);
+		disp_delta_cnt++;
+		disp_sync_bytes += 7 + n*2;
+
+		if(errorCode == MB_MRE_NO_ERR && disp_sync_acked(delta[2]))
+		{
+			disp_seq = delta[2];
+		}
+		else
+		{
+			//lost on the way, the snapshot follows at once
+			disp_synced = 0;
+			bus_sched_trigger(&bus_job_table[BUS_JOB_DISP_SET]);
+		}
 	}
-	
-	rt_mutex_release(modbus_mutex);
-	#endif
-	
-}
+	else
+	{
+		disp_board_packet_data(frame,33-4,image);
 
+		errorCode = bus_raw_request(DISP_BUS_DEVICE,frame,33,7);
+		disp_snapshot_cnt++;
+		disp_sync_bytes += 33;
 
+		//a board without the sync extension does not answer, it keeps getting snapshots
+		disp_synced = (errorCode == MB_MRE_NO_ERR && disp_sync_acked(0));
+		disp_seq = 0;
+	}
+
+	if(disp_synced)
+		rt_memcpy(disp_image,image,DISP_IMAGE_SIZE);
+
+}
 
+#ifdef RT_USING_FINSH
+#include <finsh.h>
 
-void thread_disp_board_set_handle(void* parameter)
+void list_disp_sync(void)
 {
+	rt_kprintf("synced %d seq %d\n", disp_synced, disp_seq);
+	rt_kprintf("snapshots %d deltas %d bytes %d\n",
+			   disp_snapshot_cnt, disp_delta_cnt, disp_sync_bytes);
+}
+FINSH_FUNCTION_EXPORT(list_disp_sync, show the display board sync state)
+#endif
 
-	
-	u8 mystate;
-	while (1)
-	{
-		
-		rt_thread_delay(RT_TICK_PER_SECOND/10);
 
 
-	    set_display_board_data(); //100ms
-	       
 
+static void disp_get_job(void* parameter)
+{
+	get_display_board_data();
+}
+
+/* a room sensor register, as the last poll read it */
+static u16 room_reg(u8 slave,u16 reg)
+{
+	USHORT value = 0;
 
-		rt_thread_delay(RT_TICK_PER_SECOND/10);
+	eMBMasterRegCacheGetU16(&rs485_master,slave,MB_MASTER_REG_HOLDING,reg,&value);
+	return value;
+}
 
-	}
+static void disp_set_job(void* parameter)
+{
+	set_display_board_data();
+}
 
+static void dc_motor_job(void* parameter)
+{
+	set_dc_motor();
 }
 
-void thread_disp_board_get_handle(void* parameter)
+static void room_sensor_job(void* parameter)
 {
+	eMBMasterReqErrCode    errorCode = MB_MRE_NO_ERR;
+	u8 slave = (u8)(rt_uint32_t)parameter;
 
-	
-	u8 mystate;
-	while (1)
+	errorCode = eMBMasterReqReadHoldingRegister(&rs485_master,slave,0,2,RT_WAITING_FOREVER);
+	if(errorCode == MB_MRE_NO_ERR && slave >= 11 && slave <= 15)
 	{
-		
-		rt_thread_delay(RT_TICK_PER_SECOND/10);
+		dev_state_set(DEV_STATE_HOUSE_CO2(slave - 10), room_reg(slave,0));
+		dev_state_set(DEV_STATE_HOUSE_PM25(slave - 10), room_reg(slave,1));
+
+		ts_store_sample(TS_CH_CO2(slave - 10), room_reg(slave,0));
+		ts_store_sample(TS_CH_PM25(slave - 10), room_reg(slave,1));
+	}
+}
+
+/* room sensors that answered they have no other rate */
+static u16 bus_baud_refused;
+
+static void disp_baud_negotiate(void)
+{
+	u8 data[3];
+	u8 frame[7];
+
+	data[0] = DISP_BAUD_SET;
+	data[1] = 1;
+	data[2] = ucMBBaudRateCode(BUS_BAUD_HIGH);
+	send_packet_data_head(frame,0xF3,3,data);
+
+	//a board without it does not answer, it is asked again next time
+	bus_reply[0] = 0;
+	if(bus_raw_request(DISP_BUS_DEVICE,frame,7,7) == MB_MRE_NO_ERR &&
+		bus_reply[0] == 0xF3 && bus_reply[1] == 0xF3 && bus_reply[2] == DISP_BAUD_ACK &&
+		bus_reply[4] <= data[2] && bus_reply[6] == 0x7e)
+	{
+		xMBMasterSetSlaveBaudRate(&rs485_master,DISP_BUS_DEVICE,ulMBBaudRateFromCode(bus_reply[4]));
+	}
+}
 
-		get_display_board_data(); //1s
-		rt_thread_delay(RT_TICK_PER_SECOND/10);
+/* the devices at the bus rate are asked for the high one, again after a fallback */
+static void bus_baud_job(void* parameter)
+{
+	xMBMasterSlaveStat stat;
+	u8 slave;
+
+	xMBMasterGetSlaveStat(&rs485_master,DISP_BUS_DEVICE,&stat);
+	if(stat.ulBaudRate == BUS_BAUD_RATE)
+		disp_baud_negotiate();
 
+	for(slave=11;slave<=15;slave++)
+	{
+		xMBMasterGetSlaveStat(&rs485_master,slave,&stat);
+		if(stat.ulBaudRate != BUS_BAUD_RATE || !stat.xAlive || (bus_baud_refused & (1<<slave)))
+			continue;
+		if(eMBMasterReqBaudRate(&rs485_master,slave,BUS_BAUD_HIGH,RT_WAITING_FOREVER) == MB_MRE_EXE_FUN)
+			bus_baud_refused |= 1<<slave;
 	}
+}
 
+/* master bus job table: name, handler, parameter, period, deadline,
+ * dispset has no period, it runs when the device state changes */
+struct bus_job bus_job_table[BUS_JOB_NUM] =
+{
+	{"dispget", disp_get_job,    RT_NULL,     RT_TICK_PER_SECOND/5, RT_TICK_PER_SECOND/10},
+	{"dispset", disp_set_job,    RT_NULL,     0,                    RT_TICK_PER_SECOND/10},
+	{"dcm",     dc_motor_job,    RT_NULL,     RT_TICK_PER_SECOND/2, RT_TICK_PER_SECOND/2},
+	{"room1",   room_sensor_job, (void*)11,   RT_TICK_PER_SECOND,   RT_TICK_PER_SECOND},
+	{"room2",   room_sensor_job, (void*)12,   RT_TICK_PER_SECOND,   RT_TICK_PER_SECOND},
+	{"room3",   room_sensor_job, (void*)13,   RT_TICK_PER_SECOND,   RT_TICK_PER_SECOND},
+	{"room4",   room_sensor_job, (void*)14,   RT_TICK_PER_SECOND,   RT_TICK_PER_SECOND},
+	{"room5",   room_sensor_job, (void*)15,   RT_TICK_PER_SECOND,   RT_TICK_PER_SECOND},
+	{"baud",    bus_baud_job,    RT_NULL,     RT_TICK_PER_SECOND*60, RT_TICK_PER_SECOND*2},
+};
+
+static void disp_sync_notify(rt_uint32_t changed)
+{
+	bus_sched_trigger(&bus_job_table[BUS_JOB_DISP_SET]);
 }
 
+/* done by the master poll thread once the master takes requests */
+static struct rt_completion master_ready;
+
 
 
 //***************************ϵͳ߳***************************
@@ -763,117 +880,22 @@ void thread_disp_board_get_handle(void* parameter)
 #if 1
 void thread_entry_SysMonitor(void* parameter)
 {
-	eMBMasterReqErrCode    errorCode = MB_MRE_NO_ERR;
     rt_thread_t init_thread;
 
+	rt_completion_init(&master_ready);
 	init_thread = rt_thread_create("MBMasterPoll",
 								   thread_entry_ModbusMasterPoll, RT_NULL,
 								   512, 20, 30);
 	if (init_thread != RT_NULL)
 		rt_thread_startup(init_thread);
-	
-
-	init_thread = rt_thread_create("disp",
-								   thread_disp_board_get_handle, RT_NULL,
-								   512, 9, 30);
-	if (init_thread != RT_NULL)
-		rt_thread_startup(init_thread);
-
-	init_thread = rt_thread_create("dispset",
-								   thread_disp_board_set_handle, RT_NULL,
-								   512, 9, 30);
-	if (init_thread != RT_NULL)
-		rt_thread_startup(init_thread);
-
-
-
-	init_thread = rt_thread_create("dcm",
-								   thread_dc_motor_set, RT_NULL,
-								   512, 20, 300);
-	if (init_thread != RT_NULL)
-		rt_thread_startup(init_thread);
-
-
-	
-	while (1)
-	{
-		
-		rt_thread_delay(RT_TICK_PER_SECOND/10);
-		//rt_thread_delay(RT_TICK_PER_SECOND);
-
-
-#if 1
-		for(u8 i=11;i<=15;i++)//1s
-		{
-
-		
-			rt_mutex_take(modbus_mutex,RT_WAITING_FOREVER);
-			
-			errorCode = eMBMasterReqReadHoldingRegister(i,0,2,RT_WAITING_FOREVER);
-			//errorCode = eMBMasterReqReadHoldingRegister(12,0,2,RT_WAITING_FOREVER);
-
-			if(errorCode == MB_MRE_NO_ERR)
-			{	
-				u8 kk;
-
-				kk = i-1;
-				switch(i)
-				{
-				case 11:
-					device_work_data.para_type.house1_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house1_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
-					break;
-				case 12:
-					device_work_data.para_type.house2_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house2_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
-					break;
-				case 13:
-					device_work_data.para_type.house3_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house3_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
-					break;
-				case 14:
-					device_work_data.para_type.house4_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house4_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
-					break;
-				case 15:
-					device_work_data.para_type.house5_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house5_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
-					break;
-
-				default:
-					break;
-				}		  
-				
-
-			}
-
-			rt_mutex_release(modbus_mutex);
-
-			rt_thread_delay(RT_TICK_PER_SECOND/5);
-		
-		}
-
-#endif
-
-#if 0
-			errorCode = eMBMasterReqReadHoldingRegister(1,0,2,RT_WAITING_FOREVER);
-
-			if(errorCode == MB_MRE_NO_ERR)
-			{	
-
-					device_work_data.para_type.house1_co2 = sw16(usMRegHoldBuf[0][0]);
-					device_work_data.para_type.house1_pm2_5 = sw16(usMRegHoldBuf[0][1]);
-
-					
-
-		}
 
-#endif
+	/* the master is set up by its own lower priority thread */
+	rt_completion_wait(&master_ready, RT_WAITING_FOREVER);
 
-		
-	}
+	/* all periodic bus traffic runs from here, back to back */
+	bus_sched_init(bus_job_table, BUS_JOB_NUM);
+	bus_sched_run();
 }
-
 #else
 void thread_entry_SysMonitor(void* parameter)
 {
@@ -918,34 +940,31 @@ void thread_entry_SysMonitor(void* parameter)
 
 		for(u8 i=11;i<=15;i++)//1s
 		{
-			errorCode = eMBMasterReqReadHoldingRegister(i,0,2,RT_WAITING_FOREVER);
+			errorCode = eMBMasterReqReadHoldingRegister(&rs485_master,i,0,2,RT_WAITING_FOREVER);
 
 			if(errorCode == MB_MRE_NO_ERR)
 			{	
-				u8 kk;
-
-				kk = i-1;
 				switch(i)
 				{
 				case 11:
-					device_work_data.para_type.house1_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house1_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
+					device_work_data.para_type.house1_co2 = room_reg(i,0);
+					device_work_data.para_type.house1_pm2_5 = room_reg(i,1);
 					break;
 				case 12:
-					device_work_data.para_type.house2_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house2_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
+					device_work_data.para_type.house2_co2 = room_reg(i,0);
+					device_work_data.para_type.house2_pm2_5 = room_reg(i,1);
 					break;
 				case 13:
-					device_work_data.para_type.house3_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house3_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
+					device_work_data.para_type.house3_co2 = room_reg(i,0);
+					device_work_data.para_type.house3_pm2_5 = room_reg(i,1);
 					break;
 				case 14:
-					device_work_data.para_type.house4_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house4_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
+					device_work_data.para_type.house4_co2 = room_reg(i,0);
+					device_work_data.para_type.house4_pm2_5 = room_reg(i,1);
 					break;
 				case 15:
-					device_work_data.para_type.house5_co2 = sw16(usMRegHoldBuf[kk][0]);
-					device_work_data.para_type.house5_pm2_5 = sw16(usMRegHoldBuf[kk][1]);
+					device_work_data.para_type.house5_co2 = room_reg(i,0);
+					device_work_data.para_type.house5_pm2_5 = room_reg(i,1);
 					break;
 
 				default:
@@ -964,13 +983,13 @@ void thread_entry_SysMonitor(void* parameter)
 	}
 
 #if 0
-			errorCode = eMBMasterReqReadHoldingRegister(1,0,2,RT_WAITING_FOREVER);
+			errorCode = eMBMasterReqReadHoldingRegister(&rs485_master,1,0,2,RT_WAITING_FOREVER);
 
 			if(errorCode == MB_MRE_NO_ERR)
 			{	
 
-					device_work_data.para_type.house1_co2 = sw16(usMRegHoldBuf[0][0]);
-					device_work_data.para_type.house1_pm2_5 = sw16(usMRegHoldBuf[0][1]);
+					device_work_data.para_type.house1_co2 = room_reg(1,0);
+					device_work_data.para_type.house1_pm2_5 = room_reg(1,1);
 
 					
 
@@ -1013,15 +1032,22 @@ void thread_entry_SysMonitor(void* parameter)
 //******************************************************************
 void thread_entry_ModbusMasterPoll(void* parameter)
 {
-	eMBMasterInit(MB_RTU, 2, 9600,  MB_PAR_NONE);
-	eMBMasterEnable();
+	eMBMasterInit(&rs485_master,MB_RTU, 2, BUS_BAUD_RATE,  MB_PAR_NONE);
+	/* the room sensors send CO2 and PM2.5 low byte first */
+	for(u8 slave=11;slave<=15;slave++)
+		eMBMasterRegCacheDeclare(&rs485_master,slave,MB_MASTER_REG_HOLDING,0,2,M_REG_CACHE_SWAP,ROOM_REG_MAX_AGE);
+	eMBMasterEnable(&rs485_master);
         extern struct rt_serial_device serial1;
 
+	/* the first event is EV_MASTER_READY, after a silent T3.5 the receiver
+	 * is idle and requests can go */
+	eMBMasterPoll(&rs485_master);
+	rt_completion_done(&master_ready);
+
 	
 	while (1)
 	{
-		eMBMasterPoll();
-		rt_thread_delay(DELAY_MS(10));
+		eMBMasterPoll(&rs485_master);
 	}
 }
 
@@ -1134,30 +1160,22 @@ void ac_workmode_set(u8 mode)
     
 }
 
-DEVICE_WORK_TYPE device_work_data_bak;
-
+//returns 1 when the device state changed, the change is reported by dev_state
 u8 set_device_work_mode(u8 type,u8 data,u8 signal_ch)
 {
 
 //02ػ03ģʽ2-ֶ1-Զ04ѹ05⣬06ʱ07
 
-	u8 i;
+	u8 changed = 0;
 
 
     if((type != 0x02) && (type != 0x03))
     {// 
         if ((device_work_data.para_type.device_mode == 1) || (device_work_data.para_type.device_power_state == 0))
-            return 1;
+            return 0;
 
     }   //ػģʽwyh 0314
     
-	for(i=0;i<sizeof(struct __para_type);i++)
-	{
-		
-		device_work_data_bak.device_data[i] = device_work_data.device_data[i];
-		
-		
-	}
 
 	
 //	if(device_work_data.para_type.device_mode == 1)
@@ -1171,47 +1189,47 @@ u8 set_device_work_mode(u8 type,u8 data,u8 signal_ch)
         {
     case 0x02:
         if(data)
-        {    device_work_data.para_type.device_power_state = 1;
+        {    changed |= dev_state_set(DEV_STATE_POWER, 1);
             airclean_power_onoff(1);
 		}
         else
-        {    device_work_data.para_type.device_power_state = 0;
+        {    changed |= dev_state_set(DEV_STATE_POWER, 0);
             airclean_power_onoff(0);
         }
         break;
     case 0x03:
         if(data==1||data==2)//1,auto;2,manual
-            device_work_data.para_type.device_mode = data;
+            changed |= dev_state_set(DEV_STATE_MODE, data);
          
         break;
     case 0x04:
         if(data)
-            device_work_data.para_type.high_pressur_state = 1;
+            changed |= dev_state_set(DEV_STATE_HIGH_PRESSURE, 1);
         else
-            device_work_data.para_type.high_pressur_state = 0;
+            changed |= dev_state_set(DEV_STATE_HIGH_PRESSURE, 0);
 
         
         break;
     case 0x05:
         if(data)
-            device_work_data.para_type.pht_work_state = 1;
+            changed |= dev_state_set(DEV_STATE_PHT, 1);
         else
-            device_work_data.para_type.pht_work_state = 0;
+            changed |= dev_state_set(DEV_STATE_PHT, 0);
 
         ac_pht_set(data);
  
         break;
     case 0x06:
         if(data<=0x0c)
-            device_work_data.para_type.timing_state = data;
+            changed |= dev_state_set(DEV_STATE_TIMING, data);
         else
-            device_work_data.para_type.timing_state = 0;
+            changed |= dev_state_set(DEV_STATE_TIMING, 0);
 
         
         break;
     case 0x07:
         if(data<=3)
-            device_work_data.para_type.wind_speed_state = data;
+            changed |= dev_state_set(DEV_STATE_WIND_SPEED, data);
         set_dc_motor_speed(data);
 
 		ac_ac_motor_set(data);
@@ -1219,7 +1237,7 @@ u8 set_device_work_mode(u8 type,u8 data,u8 signal_ch)
 
     default:
 
-		return 1;
+		return 0;
 
     }
 
@@ -1228,35 +1246,17 @@ u8 set_device_work_mode(u8 type,u8 data,u8 signal_ch)
 
 
 
-	for(i=0;i<6;i++)
-	{
-		
-		if(device_work_data_bak.device_data[i] != device_work_data.device_data[i])
-		{
-
-			device_sys_para_save();
-			break;
-		}
-		
-		
-	}
-	
-	return 1;
+	return changed;
 }
 
 //
 void airclean_motor_set(u8 mode)
 {
 	rt_mutex_take(motor_mutex,RT_WAITING_FOREVER);	
-	device_work_data.para_type.wind_speed_state = mode;
+	dev_state_set(DEV_STATE_WIND_SPEED, mode);
 
 	ac_ac_motor_set(device_work_data.para_type.wind_speed_state);
-    
-	
-	rt_mutex_take(modbus_mutex,RT_WAITING_FOREVER);
-	
-	set_dc_motor_speed(device_work_data.para_type.wind_speed_state); //100ms
-	rt_mutex_release(modbus_mutex);
+	set_dc_motor_speed(device_work_data.para_type.wind_speed_state);
 
 	rt_mutex_release(motor_mutex);
 	
@@ -1511,482 +1511,71 @@ LABEL_AUTO_AC_CONTINUE:
 
 extern DEVICE_WORK_TYPE device_work_data_auto;
 
-#define	HOUSE_CO2_NUM_LINK(ID)	device_work_data.para_type.house##ID##_co2
-#define	HOUSE_PM25_NUM_LINK(ID)	device_work_data.para_type.house##ID##_pm2_5
+//the outputs last driven by the work mode, 0xff when they have to be driven again
+static u8 ac_out_esd = 0xff;
+static u8 ac_out_pht = 0xff;
+static u8 ac_out_wind = 0xff;
 
+static void airclean_out_set(u8 esd,u8 pht,u8 wind)
+{
+	if(esd != ac_out_esd)
+	{
+		ac_esd_set(esd);
+		ac_out_esd = esd;
+	}
+	if(pht != ac_out_pht)
+	{
+		ac_pht_set(pht);
+		ac_out_pht = pht;
+	}
+	if(wind != ac_out_wind)
+	{
+		airclean_motor_set(wind);
+		ac_out_wind = wind;
+	}
+}
 
-#define	byte_2_to_short(x,y)	((short)(\
-      (((short)(x) &(short)0x00ffU) << 8) |\
-      (((short)(y) &(short)0x00ffU))))
+//takes the state fields changed since the last call, returns the ticks until it has to run again
+rt_int32_t airclean_work_auto_handle(rt_uint32_t changed)
+{
+	const struct auto_rule *rule;
+	rt_int32_t timeout;
 
+	//the room levels follow the readings in every mode
+	rule = auto_rules_eval(changed, &timeout);
 
+	//airclean_power_onoff() switched the outputs behind our back
+	if(changed & DEV_STATE_BIT(DEV_STATE_POWER))
+	{
+		ac_out_esd = 0xff;
+		ac_out_pht = 0xff;
+		ac_out_wind = 0xff;
+	}
 
-#define	HOUSE_DATA_START		6
-#if 1
-void airclean_work_auto_handle(void)
-{
+	if(device_work_data.para_type.device_power_state == 0)
+		return RT_WAITING_FOREVER;
 
-	u8 i;
-	u16 co2_tmp,pm25_tmp;
-	u8 device_work_data_pre = 0xff;
+	if(device_work_data.para_type.device_mode == 1)
+	{//auto
+		airclean_out_set(rule->high_pressure,rule->pht,rule->wind_speed);
 
+		device_work_data_auto.para_type.high_pressur_state = rule->high_pressure;
+		device_work_data_auto.para_type.pht_work_state = rule->pht;
+		device_work_data_auto.para_type.wind_speed_state = rule->wind_speed;
 
-	if(device_work_data.para_type.device_power_state)
-    {
-        if(device_work_data.para_type.device_mode == 1)
-        {//auto
+		return timeout;
+	}
 
-  
- //////////////////  1
-			 for(i = 0;i<5;i++)
-			 {
-				 pm25_tmp = byte_2_to_short((device_work_data.device_data[HOUSE_DATA_START+i*4]),(device_work_data.device_data[HOUSE_DATA_START+i*4+1]));
-				 co2_tmp = byte_2_to_short((device_work_data.device_data[HOUSE_DATA_START+i*4+2]),(device_work_data.device_data[HOUSE_DATA_START+i*4+3]));
-			 
-				 if(co2_tmp!=0 ||pm25_tmp!=0)
-				 {
-					 if(pm25_tmp > 134 || co2_tmp > 2500)
-					 {
-                        ac_esd_set(1);
-                        ac_pht_set(1);
-                        airclean_motor_set(3);
-
-                        device_work_data_auto.para_type.high_pressur_state = 1;
-            			(device_work_data_auto.para_type.pht_work_state) = 1;
-            			(device_work_data_auto.para_type.wind_speed_state) = 3;
-            	            
-		device_work_data_pre = 0;
-						 goto LABEL_AUTO_AC_CONTINUE;
-					 }
-			 
-				 }
-				 
-			 
-			 }
-
- //////////////////  2
-			 for(i = 0;i<5;i++)
-			 {
-				 pm25_tmp = byte_2_to_short((device_work_data.device_data[HOUSE_DATA_START+i*4]),(device_work_data.device_data[HOUSE_DATA_START+i*4+1]));
-				 co2_tmp = byte_2_to_short((device_work_data.device_data[HOUSE_DATA_START+i*4+2]),(device_work_data.device_data[HOUSE_DATA_START+i*4+3]));
-			 
-				 if(co2_tmp!=0 ||pm25_tmp!=0)
-				 {
-					 if(pm25_tmp > 96 || co2_tmp > 1300)
-					 {
-						 ac_esd_set(1);
-						 ac_pht_set(1);
-						 airclean_motor_set(2);
-                         device_work_data_auto.para_type.high_pressur_state = 1;
-            			(device_work_data_auto.para_type.pht_work_state) = 1;
-            			(device_work_data_auto.para_type.wind_speed_state) = 2;
-		device_work_data_pre = 0;
-						 goto LABEL_AUTO_AC_CONTINUE;
-					 }
-			 
-				 }
-				 
-			 
-			 }
-
-
- ///////////  3
-
-			for(i = 0;i<5;i++)
-			{
-				pm25_tmp = byte_2_to_short((device_work_data.device_data[HOUSE_DATA_START+i*4]),(device_work_data.device_data[HOUSE_DATA_START+i*4+1]));
-				co2_tmp = byte_2_to_short((device_work_data.device_data[HOUSE_DATA_START+i*4+2]),(device_work_data.device_data[HOUSE_DATA_START+i*4+3]));
-
-				if(co2_tmp!=0 ||pm25_tmp!=0)
-				{
-					if(pm25_tmp < PM2_5_LEVEL1_MAX && co2_tmp < CO2_LEVEL1_MAX)
-		            {
-
-				
-						ac_esd_set(0);
-						ac_pht_set(0);
-						airclean_motor_set(0);
-                        device_work_data_auto.para_type.high_pressur_state = 0;
-            			(device_work_data_auto.para_type.pht_work_state) = 0;
-            			(device_work_data_auto.para_type.wind_speed_state) = 0;
-		device_work_data_pre = 0;
-						goto LABEL_AUTO_AC_CONTINUE;
-		            }
-
-				}
-				
-
-			}
-				
-
- /////////// 4
- 
-			for(i = 0;i<5;i++)
-			{
-				pm25_tmp = byte_2_to_short((device_work_data.device_data[HOUSE_DATA_START+i*4]),(device_work_data.device_data[HOUSE_DATA_START+i*4+1]));
-				co2_tmp = byte_2_to_short((device_work_data.device_data[HOUSE_DATA_START+i*4+2]),(device_work_data.device_data[HOUSE_DATA_START+i*4+3]));
-
-				if(co2_tmp!=0 ||pm25_tmp!=0)
-				{
-					if(pm25_tmp < PM2_5_LEVEL2_MAX && co2_tmp < CO2_LEVEL2_MAX)
-		            {
-						ac_esd_set(1);
-						ac_pht_set(1);
-						airclean_motor_set(1);
-//wyh
-                        	device_work_data_auto.para_type.high_pressur_state = 1;
-            			(device_work_data_auto.para_type.pht_work_state) = 1;
-            			(device_work_data_auto.para_type.wind_speed_state) = 1;
-								device_work_data_pre = 0;
-						goto LABEL_AUTO_AC_CONTINUE;
-		            }
-
-				}
-				
-
-			}
-		ac_esd_set(0);
-		ac_pht_set(0);
-		airclean_motor_set(0);
-                        	device_work_data_auto.para_type.high_pressur_state = 0;
-            			(device_work_data_auto.para_type.pht_work_state) = 0;
-            			(device_work_data_auto.para_type.wind_speed_state) = 0;
-		device_work_data_pre = 0;
-		goto LABEL_AUTO_AC_CONTINUE;	
-            
-        }
-        else if(device_work_data.para_type.device_mode == 2 )
-        {//manual
-        		if ( device_work_data_pre == 0)  //ǴԶлֶ״̬ //wyh 0314
-        			{
-			ac_esd_set(1);
-			ac_pht_set(1);
-			airclean_motor_set(1);
-			device_work_data_pre = 0xff;
-        			} else 
-        				{
-        				ac_esd_set(device_work_data.para_type.high_pressur_state);
-					ac_pht_set(device_work_data.para_type.pht_work_state);
-					if 	(device_work_data.para_type.wind_speed_state == 0)airclean_motor_set(1);//wyh 0313
-					airclean_motor_set(device_work_data.para_type.wind_speed_state);
-					
-        				}
-
-        }
-	/*
-		else if(device_work_data.para_type.device_mode == 0) //wyh 0 
-        {//auto
-
-			
-                ac_esd_set(device_work_data.para_type.high_pressur_state);
-                ac_pht_set(device_work_data.para_type.pht_work_state);
-                airclean_motor_set(device_work_data.para_type.wind_speed_state);
-          
-        }
-        */
-
-    
-//		if(fault_get_bit(FAULT_RESET_WIFI_BIT))
-//		{
-//			
-//			wifi_factory_set();
-//			fault_set_bit(FAULT_RESET_WIFI_BIT,0);
-//		}
-		
-LABEL_AUTO_AC_CONTINUE:
-       rt_thread_delay(RT_TICK_PER_SECOND/20);
-	
-    }
+	if(device_work_data.para_type.device_mode == 2)
+	{//manual
+		airclean_out_set(device_work_data.para_type.high_pressur_state,
+			device_work_data.para_type.pht_work_state,
+			device_work_data.para_type.wind_speed_state);
+	}
 
+	return RT_WAITING_FOREVER;
 }
 
-
-#else
-void airclean_work_auto_handle(void)
-{
-
-	if(device_work_data.para_type.device_power_state)
-    {
-        if(device_work_data.para_type.device_mode == 1)
-        {//auto
-
-#if 0
-		if(HOUSE_CO2_NUM_LINK(1) == 0 && HOUSE_PM25_NUM_LINK(1)==0)
-				goto LABEL_AUTO_AC_CONTINUE;
-
-
-			if(HOUSE_CO2_NUM_LINK(2) == 0 && HOUSE_PM25_NUM_LINK(2)==0)
-				goto LABEL_AUTO_AC_CONTINUE;
-
-
-			if(HOUSE_CO2_NUM_LINK(3) == 0 && HOUSE_PM25_NUM_LINK(3)==0)
-				goto LABEL_AUTO_AC_CONTINUE;
-
-
-			if(HOUSE_CO2_NUM_LINK(4) == 0 && HOUSE_PM25_NUM_LINK(4)==0)
-				goto LABEL_AUTO_AC_CONTINUE;
-
-
-			if(HOUSE_CO2_NUM_LINK(5) == 0 && HOUSE_PM25_NUM_LINK(5)==0)
-				goto LABEL_AUTO_AC_CONTINUE;
-
-
-
-#endif			
-
-
-		
-            if(exchange_16bit_hi_lo(device_work_data.para_type.house1_pm2_5) > 96 || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house1_co2) > 1300)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house2_pm2_5) > 96 || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house2_co2) > 1300)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house3_pm2_5) > 96 || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house3_co2) > 1300)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house4_pm2_5) > 96 || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house4_co2) > 1300)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house5_pm2_5) > 96 || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house5_co2) > 1300)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-
-
-///////////  2
-            if(exchange_16bit_hi_lo(device_work_data.para_type.house1_pm2_5) > PM2_5_LEVEL2_MIN || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house1_co2) > CO2_LEVEL2_MIN)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(1);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house2_pm2_5) > PM2_5_LEVEL2_MIN || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house2_co2) > CO2_LEVEL2_MIN)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(1);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house3_pm2_5) > PM2_5_LEVEL2_MIN || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house3_co2) > CO2_LEVEL2_MIN)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(1);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house4_pm2_5) > PM2_5_LEVEL2_MIN || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house4_co2) > CO2_LEVEL2_MIN)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(1);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house5_pm2_5) > PM2_5_LEVEL2_MIN || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house5_co2) > CO2_LEVEL2_MIN)
-            {
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(1);
-                goto LABEL_AUTO_AC_CONTINUE;
-            }
-
- ///////////  3
-            if(exchange_16bit_hi_lo(device_work_data.para_type.house1_pm2_5) < PM2_5_LEVEL1_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house1_co2) < CO2_LEVEL1_MAX)
-            {
-
-			
-				if(HOUSE_CO2_NUM_LINK(1) != 0 || HOUSE_PM25_NUM_LINK(1)!=0)
-				{ 
-					ac_esd_set(0);
-					ac_pht_set(0);
-					airclean_motor_set(0);
-					goto LABEL_AUTO_AC_CONTINUE;
-				}
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house2_pm2_5) < PM2_5_LEVEL1_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house2_co2) < CO2_LEVEL1_MAX)
-            {
-
-							if(HOUSE_CO2_NUM_LINK(2) != 0 || HOUSE_PM25_NUM_LINK(2)!=0)
-				{ 
-                ac_esd_set(0);
-                ac_pht_set(0);
-                airclean_motor_set(0);
-                goto LABEL_AUTO_AC_CONTINUE;
-								}
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house3_pm2_5) < PM2_5_LEVEL1_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house3_co2) < CO2_LEVEL1_MAX)
-            {
-
-				if(HOUSE_CO2_NUM_LINK(3) != 0 || HOUSE_PM25_NUM_LINK(3)!=0)
-				{ 
-                ac_esd_set(0);
-                ac_pht_set(0);
-                airclean_motor_set(0);
-                goto LABEL_AUTO_AC_CONTINUE;
-
-									}
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house4_pm2_5) <PM2_5_LEVEL1_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house4_co2) <CO2_LEVEL1_MAX)
-            {
-
-							if(HOUSE_CO2_NUM_LINK(4) != 0 || HOUSE_PM25_NUM_LINK(4)!=0)
-				{ 
-                ac_esd_set(0);
-                ac_pht_set(0);
-                airclean_motor_set(0);
-                goto LABEL_AUTO_AC_CONTINUE;
-
-								}
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house5_pm2_5) <PM2_5_LEVEL1_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house5_co2) <CO2_LEVEL1_MAX)
-            {
-
-				if(HOUSE_CO2_NUM_LINK(5) != 0 || HOUSE_PM25_NUM_LINK(5)!=0)
-				{ 
-
-				ac_esd_set(0);
-                ac_pht_set(0);
-                airclean_motor_set(0);
-
-               goto LABEL_AUTO_AC_CONTINUE;
-					}
-            }
-
- /////////// 4
-            if(exchange_16bit_hi_lo(device_work_data.para_type.house1_pm2_5) < PM2_5_LEVEL2_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house1_co2) < CO2_LEVEL2_MAX)
-            {
-
-							if(HOUSE_CO2_NUM_LINK(1) != 0 || HOUSE_PM25_NUM_LINK(1)!=0)
-				{ 
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-               goto LABEL_AUTO_AC_CONTINUE;}
-
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house2_pm2_5) < PM2_5_LEVEL2_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house2_co2) < CO2_LEVEL2_MAX)
-            {
-            				if(HOUSE_CO2_NUM_LINK(2) != 0 || HOUSE_PM25_NUM_LINK(2)!=0)
-				{ 
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-
-                               goto LABEL_AUTO_AC_CONTINUE;}
-
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house3_pm2_5) < PM2_5_LEVEL2_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house3_co2) < CO2_LEVEL2_MAX)
-            {
-            				if(HOUSE_CO2_NUM_LINK(3) != 0 || HOUSE_PM25_NUM_LINK(3)!=0)
-				{ 
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-
-                goto LABEL_AUTO_AC_CONTINUE;}
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house4_pm2_5) <PM2_5_LEVEL2_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house4_co2) <CO2_LEVEL2_MAX)
-            {
-            				if(HOUSE_CO2_NUM_LINK(4) != 0 || HOUSE_PM25_NUM_LINK(4)!=0)
-				{ 
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-
-               goto LABEL_AUTO_AC_CONTINUE;}
-
-            }
-            else if(exchange_16bit_hi_lo(device_work_data.para_type.house5_pm2_5) <PM2_5_LEVEL2_MAX || 
-                exchange_16bit_hi_lo(device_work_data.para_type.house5_co2) <CO2_LEVEL2_MAX)
-            {
-            				if(HOUSE_CO2_NUM_LINK(5) != 0 || HOUSE_PM25_NUM_LINK(5)!=0)
-				{ 
-                ac_esd_set(1);
-                ac_pht_set(1);
-                airclean_motor_set(2);
-
-               goto LABEL_AUTO_AC_CONTINUE;}
-            }
-
-
-
-
-            
-        }
-        else if(device_work_data.para_type.device_mode == 2)
-        {//manual
-        
-			ac_esd_set(device_work_data.para_type.high_pressur_state);
-			ac_pht_set(device_work_data.para_type.pht_work_state);
-			airclean_motor_set(device_work_data.para_type.wind_speed_state);
-	            
-
-        }
-		else if(device_work_data.para_type.device_mode == 0)
-        {//manual
-
-			
-                ac_esd_set(device_work_data.para_type.high_pressur_state);
-                ac_pht_set(device_work_data.para_type.pht_work_state);
-                airclean_motor_set(device_work_data.para_type.wind_speed_state);
-          
-        }
-
-    
-//		if(fault_get_bit(FAULT_RESET_WIFI_BIT))
-//		{
-//			
-//			wifi_factory_set();
-//			fault_set_bit(FAULT_RESET_WIFI_BIT,0);
-//		}
-		
-LABEL_AUTO_AC_CONTINUE:
-       rt_thread_delay(RT_TICK_PER_SECOND/20);
-    }
-
-}
-
-#endif
-
 void airclean_out_pin_init(void)
 {
 	GPIO_InitTypeDef GPIOA_InitStructure;
@@ -2129,11 +1718,11 @@ void airclean_power_onoff(u8 mode)
 
 	if(mode)
     {   
-        device_work_data.para_type.device_power_state = 1;
+        dev_state_set(DEV_STATE_POWER, 1);
 	}
     else
     {    
-	    device_work_data.para_type.device_power_state = 0;
+	    dev_state_set(DEV_STATE_POWER, 0);
 
     }
 }
@@ -2151,16 +1740,19 @@ void airclean_system_init(void)
 
 void fault_set_bit(u8 fault_type,u8 val) 
 {
+    u8 fault = device_work_data.para_type.fault_state;
+
     if(val)
-        device_work_data.para_type.fault_state |= 1<<fault_type;
+        fault |= 1<<fault_type;
     else
-        device_work_data.para_type.fault_state &= ~(1<<fault_type);
-    
+        fault &= ~(1<<fault_type);
 
+    dev_state_set(DEV_STATE_FAULT, fault);
 }
 
 
-u8 fault_state_pre = 0xff;
+static struct dev_state_sub check_ex_sub;
+
 void rt_check_ex_device_thread_entry(void* parameter)
 {
 
@@ -2186,26 +1778,16 @@ void rt_check_ex_device_thread_entry(void* parameter)
     		
     		//fault_set_bit(FAULT_WIND_BIT,wind_state_get(1));
 
-
-    		if(fault_state_pre==0xff || fault_state_pre!= device_work_data.para_type.fault_state)
-    		{
-    			if(device_work_data.para_type.fault_state)
-    			{
-
-        			set_display_board_data(); //100ms
-        			
-
-    			}
-    			fault_state_pre = device_work_data.para_type.fault_state;
-    		}
-
+    		//the fault pins are polled, a change goes to the display board through dev_state
+    		rt_thread_delay(RT_TICK_PER_SECOND/5);
         }
         else
         {
-            device_work_data.para_type.fault_state = 0;
+            dev_state_set(DEV_STATE_FAULT, 0);
 
+            //nothing to check until the device is powered on
+            dev_state_wait(&check_ex_sub, RT_WAITING_FOREVER);
         }
-		rt_thread_delay(RT_TICK_PER_SECOND/5);
 
 	}
 
@@ -2223,14 +1805,16 @@ void rt_main_thread_entry(void* parameter)
 
 
 	SPI_FLASH_Init();
+	para_store_init();
+	ts_store_init();
 
 	device_state_init();
 
 	if(device_work_data.para_type.device_mode == 0)
 	{	
-		device_work_data.para_type.device_mode = 2;
-		device_work_data.para_type.high_pressur_state = 1;
-		device_work_data.para_type.pht_work_state = 1;
+		dev_state_set(DEV_STATE_MODE, 2);
+		dev_state_set(DEV_STATE_HIGH_PRESSURE, 1);
+		dev_state_set(DEV_STATE_PHT, 1);
 		ac_esd_set(1);
 		ac_pht_set(1);
 		ac_ac_motor_set(1);
@@ -2291,9 +1875,12 @@ void rt_main_thread_entry(void* parameter)
 
 
 u8 power_state_pre = 0xff;
+static struct dev_state_sub power_sub;
 
 void thread_entry_power_monitor (void* parameter)
 {
+	rt_uint32_t changed = DEV_STATE_ALL;
+	rt_int32_t timeout = RT_WAITING_FOREVER;
 
     while(1)
     {
@@ -2336,7 +1923,7 @@ void thread_entry_power_monitor (void* parameter)
 		if(power_tim_cnt == (0.01*60*60) && (power_state_pre) )
 		{
 			//power_tim_cnt = 0; //? power_tim_cnt == 0
-			device_work_data.para_type.timing_state -= 1;
+			dev_state_set(DEV_STATE_TIMING, device_work_data.para_type.timing_state - 1);
 			
 		}
 		
@@ -2346,9 +1933,9 @@ void thread_entry_power_monitor (void* parameter)
 //        	if(device_work_data.para_type.timing_state)
  		if(power_state_pre)
             {	
-				device_work_data.para_type.device_power_state = 0;
+				dev_state_set(DEV_STATE_POWER, 0);
 				//wyh
-				device_work_data.para_type.timing_state = 0 ;
+				dev_state_set(DEV_STATE_TIMING, 0);
 				power_tim_cnt = 0; 
 				power_state_pre = 0xff;
 
@@ -2363,9 +1950,18 @@ void thread_entry_power_monitor (void* parameter)
         else
         {
         
-			airclean_work_auto_handle();
+			timeout = airclean_work_auto_handle(changed);
+			changed = 0;
         }
-        rt_thread_delay(RT_TICK_PER_SECOND/10);
+
+        //the timing counts down, else nothing is due before the state changes or a level dwell ends
+        if(device_work_data.para_type.timing_state)
+        {
+            rt_thread_delay(RT_TICK_PER_SECOND/10);
+            changed |= dev_state_wait(&power_sub, RT_WAITING_NO);
+        }
+        else
+            changed |= dev_state_wait(&power_sub, timeout);
 
 
 		
@@ -2373,10 +1969,34 @@ void thread_entry_power_monitor (void* parameter)
 }
 
 
+static struct dev_state_sub disp_sync_sub;
+static struct dev_state_sub para_save_sub;
+
+/* merge the setting changes until they settle for this long, then write once */
+#define PARA_SAVE_DELAY		(RT_TICK_PER_SECOND / 2)
+
+/* the flash writes and sector erases stay out of the threads that set the state */
+static void para_save_thread_entry(void* parameter)
+{
+	while(1)
+	{
+		dev_state_wait(&para_save_sub, RT_WAITING_FOREVER);
+		while(dev_state_wait(&para_save_sub, PARA_SAVE_DELAY));
+
+		device_sys_para_save();
+	}
+}
+
 int rt_application_init(void)
 {
     rt_thread_t init_thread;
 
+	/* every thread below is woken by the state fields it depends on */
+	dev_state_init();
+	dev_state_subscribe(&disp_sync_sub, "dispsync", DEV_STATE_ALL, disp_sync_notify);
+	dev_state_subscribe(&para_save_sub, "parasave", DEV_STATE_SETTINGS, RT_NULL);
+	dev_state_subscribe(&check_ex_sub, "checkex", DEV_STATE_BIT(DEV_STATE_POWER), RT_NULL);
+	dev_state_subscribe(&power_sub, "power", DEV_STATE_SETTINGS | DEV_STATE_HOUSES, RT_NULL);
 
 	modbus_mutex = rt_mutex_create("mdbusmut",RT_IPC_FLAG_FIFO);
 	motor_mutex = rt_mutex_create("motor_set",RT_IPC_FLAG_FIFO);
@@ -2410,6 +2030,12 @@ int rt_application_init(void)
 								   512, 9, 50);
 	if (init_thread != RT_NULL)
 		rt_thread_startup(init_thread);
+
+	init_thread = rt_thread_create("parasave",
+								   para_save_thread_entry, RT_NULL,
+								   512, 22, 20);
+	if (init_thread != RT_NULL)
+		rt_thread_startup(init_thread);
 					
 			
     return 0;
@@ -5,7 +5,8 @@
 extern void airclean_power_onoff(u8 mode);
 extern u8 set_device_work_mode(u8 type,u8 data,u8 signal_ch);
 
-extern DEVICE_WORK_TYPE device_work_data_bak;
+/* the Master on the RS485 bus of the rooms */
+extern xMBMasterInstance rs485_master;
 
 
 #define FlashSize_KB    (256)
@@ -0,0 +1,145 @@
+/*
+ * File      : auto_rules.c
+ * air quality rules of the auto work mode
+ *
+ * The levels are a table, the rooms an array: a reading that changed moves
+ * the level of its room only, and the device level is taken again from the
+ * room levels. Nothing is evaluated while no reading changes, and the caller
+ * drives the outputs only when the level it gets back is another one.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#include <rtthread.h>
+
+#include "auto_rules.h"
+#include "dev_state.h"
+
+static const struct auto_rule auto_rules[AUTO_RULES_LEVEL_NUM] =
+{
+    /* pm2.5  co2  hysteresis  esd pht wind */
+    {    0,    0,   0,  0,      0,  0,  0},
+    {   55,  730,   5, 10,      1,  1,  1},
+    {   96, 1300,   5, 10,      1,  1,  2},
+    {  134, 2500,   5, 10,      1,  1,  3},
+};
+
+static rt_uint8_t  room_level[AUTO_RULES_ROOM_NUM];
+static rt_uint32_t room_mask = AUTO_RULES_ROOM_ALL;
+
+static rt_uint8_t  auto_level;
+static rt_tick_t   auto_level_tick;
+static rt_uint32_t auto_level_cnt;
+
+/* the readings are kept in the byte order of the bus */
+static rt_uint16_t room_reading(enum dev_state_field field)
+{
+    rt_uint16_t value = dev_state_get(field);
+
+    return (rt_uint16_t)((value << 8) | (value >> 8));
+}
+
+static rt_bool_t room_above(int level, rt_uint16_t pm25, rt_uint16_t co2, rt_bool_t hyst)
+{
+    const struct auto_rule *rule = &auto_rules[level];
+
+    if (hyst)
+        return pm25 + rule->pm25_hyst > rule->pm25 || co2 + rule->co2_hyst > rule->co2;
+
+    return pm25 > rule->pm25 || co2 > rule->co2;
+}
+
+static void room_update(int room)
+{
+    rt_uint16_t pm25, co2;
+    int level = room_level[room];
+
+    pm25 = room_reading((enum dev_state_field)DEV_STATE_HOUSE_PM25(room + 1));
+    co2  = room_reading((enum dev_state_field)DEV_STATE_HOUSE_CO2(room + 1));
+
+    /* no sensor in the room */
+    if (pm25 == 0 && co2 == 0)
+    {
+        room_level[room] = 0;
+        return;
+    }
+
+    while (level < AUTO_RULES_LEVEL_NUM - 1 && room_above(level + 1, pm25, co2, RT_FALSE))
+        level++;
+    while (level > 0 && !room_above(level, pm25, co2, RT_TRUE))
+        level--;
+
+    room_level[room] = level;
+}
+
+/*
+ * Takes the change bits of the room readings, returns the rule of the level
+ * to run at. A lower level waiting for its dwell time sets the ticks until
+ * it is due to timeout, which is RT_WAITING_FOREVER otherwise.
+ */
+const struct auto_rule *auto_rules_eval(rt_uint32_t changed, rt_int32_t *timeout)
+{
+    rt_tick_t held;
+    int room, level = 0;
+
+    for (room = 0; room < AUTO_RULES_ROOM_NUM; room++)
+    {
+        if (changed & (DEV_STATE_BIT(DEV_STATE_HOUSE_PM25(room + 1)) |
+                       DEV_STATE_BIT(DEV_STATE_HOUSE_CO2(room + 1))))
+            room_update(room);
+
+        if ((room_mask & (1UL << room)) && room_level[room] > level)
+            level = room_level[room];
+    }
+
+    *timeout = RT_WAITING_FOREVER;
+    if (level < auto_level)
+    {
+        held = rt_tick_get() - auto_level_tick;
+        if (held < AUTO_RULES_DWELL)
+        {
+            *timeout = AUTO_RULES_DWELL - held;
+            return &auto_rules[auto_level];
+        }
+    }
+
+    if (level != auto_level)
+    {
+        auto_level      = level;
+        auto_level_tick = rt_tick_get();
+        auto_level_cnt++;
+    }
+
+    return &auto_rules[auto_level];
+}
+
+/* rooms left out of the device level, e.g. with a sensor out of order */
+void auto_rules_room_mask(rt_uint32_t mask)
+{
+    room_mask = mask & AUTO_RULES_ROOM_ALL;
+
+    /* wakes the auto mode up to take the level again */
+    dev_state_changed(DEV_STATE_HOUSES);
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_auto_rules(void)
+{
+    int room;
+
+    rt_kprintf("level %d since %d ticks, %d changes\n", auto_level,
+               rt_tick_get() - auto_level_tick, auto_level_cnt);
+    rt_kprintf("room enabled level\n");
+    rt_kprintf("---- ------- -----\n");
+    for (room = 0; room < AUTO_RULES_ROOM_NUM; room++)
+    {
+        rt_kprintf("%4d %7s %5d\n", room + 1,
+                   (room_mask & (1UL << room)) ? "yes" : "no", room_level[room]);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_auto_rules, list auto mode room levels)
+FINSH_FUNCTION_EXPORT_ALIAS(auto_rules_room_mask, auto_rooms, set the rooms of the auto mode)
+#endif
@@ -0,0 +1,44 @@
+/*
+ * File      : auto_rules.h
+ * air quality rules of the auto work mode
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#ifndef __AUTO_RULES_H__
+#define __AUTO_RULES_H__
+
+#include <rtthread.h>
+
+/* level 0 is off, the others the wind speeds */
+#define AUTO_RULES_LEVEL_NUM        4
+/* room sensors on the bus, see DEV_STATE_HOUSE_PM25(n) */
+#define AUTO_RULES_ROOM_NUM         5
+#define AUTO_RULES_ROOM_ALL         ((1UL << AUTO_RULES_ROOM_NUM) - 1)
+/* the least time a level is kept before it may step down */
+#define AUTO_RULES_DWELL            (RT_TICK_PER_SECOND * 30)
+
+/*
+ * A room is at the level when one of its readings is above the threshold of
+ * the level, and leaves it downwards only when both fell below the threshold
+ * minus the hysteresis band. The device runs at the highest level of the
+ * enabled rooms.
+ */
+struct auto_rule
+{
+    rt_uint16_t pm25;
+    rt_uint16_t co2;
+    rt_uint16_t pm25_hyst;
+    rt_uint16_t co2_hyst;
+
+    /* the outputs at the level */
+    rt_uint8_t  high_pressure;
+    rt_uint8_t  pht;
+    rt_uint8_t  wind_speed;
+};
+
+const struct auto_rule *auto_rules_eval(rt_uint32_t changed, rt_int32_t *timeout);
+void auto_rules_room_mask(rt_uint32_t mask);
+
+#endif
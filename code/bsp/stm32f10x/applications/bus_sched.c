@@ -0,0 +1,147 @@
+/*
+ * File      : bus_sched.c
+ * RS485 master bus scheduler
+ *
+ * All transactions of the master bus (room sensors, display board, DC
+ * motor) are described by a table of jobs, run periodically or when they
+ * are triggered. A single thread runs them back to back, earliest deadline
+ * first, so the next frame goes out as soon as the previous transaction
+ * has completed and the thread only sleeps when no job is released.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#include "bus_sched.h"
+
+static struct bus_job *bus_jobs = RT_NULL;
+static rt_uint8_t bus_job_count = 0;
+static struct rt_semaphore bus_wakeup;
+
+/* a is before b, tick overflow safe */
+#define TICK_BEFORE(a, b)   ((rt_int32_t)((a) - (b)) < 0)
+
+void bus_sched_init(struct bus_job *table, rt_uint8_t count)
+{
+    rt_uint8_t i;
+    rt_tick_t now;
+
+    RT_ASSERT(table != RT_NULL);
+
+    rt_sem_init(&bus_wakeup, "buswake", 0, RT_IPC_FLAG_FIFO);
+
+    now = rt_tick_get();
+    for (i = 0; i < count; i++)
+    {
+        table[i].release  = now;
+        table[i].pending  = 1;
+        table[i].run_cnt  = 0;
+        table[i].miss_cnt = 0;
+    }
+
+    bus_jobs = table;
+    bus_job_count = count;
+}
+
+/* release a job now, e.g. when the data it carries has just changed */
+void bus_sched_trigger(struct bus_job *job)
+{
+    RT_ASSERT(job != RT_NULL);
+
+    /* not running yet, every job is released at init anyway */
+    if (bus_jobs == RT_NULL)
+        return;
+
+    job->release = rt_tick_get();
+    job->pending = 1;
+    rt_sem_release(&bus_wakeup);
+}
+
+/* pick the released job with the earliest absolute deadline */
+static struct bus_job *bus_sched_pick(rt_tick_t now, rt_tick_t *sleep)
+{
+    rt_uint8_t i;
+    struct bus_job *job, *best = RT_NULL;
+    rt_tick_t next = now + RT_TICK_PER_SECOND;
+
+    for (i = 0; i < bus_job_count; i++)
+    {
+        job = &bus_jobs[i];
+
+        if (job->period == 0 && !job->pending)
+            continue;
+        if (TICK_BEFORE(now, job->release))
+        {
+            if (TICK_BEFORE(job->release, next))
+                next = job->release;
+            continue;
+        }
+
+        if (best == RT_NULL ||
+            TICK_BEFORE(job->release + job->deadline, best->release + best->deadline))
+            best = job;
+    }
+
+    *sleep = next - now;
+    return best;
+}
+
+void bus_sched_run(void)
+{
+    struct bus_job *job;
+    rt_tick_t now, sleep;
+
+    RT_ASSERT(bus_jobs != RT_NULL);
+
+    while (1)
+    {
+        now = rt_tick_get();
+        job = bus_sched_pick(now, &sleep);
+        if (job == RT_NULL)
+        {
+            /* bus is idle until the next release or a trigger */
+            rt_sem_take(&bus_wakeup, sleep);
+            continue;
+        }
+
+        if (TICK_BEFORE(job->release + job->deadline, now))
+            job->miss_cnt++;
+
+        /* a trigger during the run releases the job again */
+        job->pending = 0;
+        job->handler(job->parameter);
+        job->run_cnt++;
+
+        /* keep the period phase, but never queue up a backlog of runs */
+        job->release += job->period;
+        now = rt_tick_get();
+        if (TICK_BEFORE(job->release, now))
+            job->release = now;
+    }
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_bus_job(void)
+{
+    rt_uint8_t i;
+
+    rt_kprintf(" job      period deadline    runs  missed\n");
+    rt_kprintf("-------- ------- -------- ------- -------\n");
+    for (i = 0; i < bus_job_count; i++)
+    {
+        rt_kprintf("%-8.*s %7d %8d %7d %7d\n", RT_NAME_MAX,
+                   bus_jobs[i].name,
+                   bus_jobs[i].period,
+                   bus_jobs[i].deadline,
+                   bus_jobs[i].run_cnt,
+                   bus_jobs[i].miss_cnt);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_bus_job, list master bus scheduler jobs)
+#endif
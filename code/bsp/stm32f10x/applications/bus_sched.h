@@ -0,0 +1,39 @@
+/*
+ * File      : bus_sched.h
+ * RS485 master bus scheduler
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#ifndef __BUS_SCHED_H__
+#define __BUS_SCHED_H__
+
+#include <rtthread.h>
+
+typedef void (*bus_job_handler_t)(void *parameter);
+
+/*
+ * One transaction on the master bus. The first five members are the static
+ * description of the job, the rest is owned by the scheduler. A job with a
+ * zero period runs once at start, then only when it is triggered.
+ */
+struct bus_job
+{
+    const char       *name;
+    bus_job_handler_t handler;
+    void             *parameter;
+    rt_tick_t         period;       /* release interval, in ticks */
+    rt_tick_t         deadline;     /* relative to release, in ticks */
+
+    rt_tick_t         release;      /* absolute tick of the next release */
+    rt_uint8_t        pending;      /* zero period: released and not run yet */
+    rt_uint32_t       run_cnt;
+    rt_uint32_t       miss_cnt;     /* started after release + deadline */
+};
+
+void bus_sched_init(struct bus_job *table, rt_uint8_t count);
+void bus_sched_run(void);
+void bus_sched_trigger(struct bus_job *job);
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * File      : dev_state.c
+ * observable store of the device work state
+ *
+ * device_work_data stays where everybody reads the state from, but it is
+ * written through dev_state_set(), which knows which field changed. The
+ * change bits go to the subscribers of the field only: the display board
+ * sync, the flash persistence, the wifi report and the work mode handling
+ * then react at once, and sleep as long as nothing changes.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#include <rthw.h>
+#include <rtthread.h>
+#include <stddef.h>
+
+#include "app_task.h"
+#include "dev_state.h"
+
+extern DEVICE_WORK_TYPE device_work_data;
+
+#define FIELD(member)   {offsetof(struct __para_type, member), \
+                         sizeof(((struct __para_type *)0)->member)}
+
+static const struct
+{
+    rt_uint8_t offset;
+    rt_uint8_t size;
+} dev_state_layout[DEV_STATE_FIELD_NUM] =
+{
+    FIELD(device_power_state),
+    FIELD(device_mode),
+    FIELD(wind_speed_state),
+    FIELD(high_pressur_state),
+    FIELD(pht_work_state),
+    FIELD(timing_state),
+    FIELD(house1_pm2_5),
+    FIELD(house1_co2),
+    FIELD(house2_pm2_5),
+    FIELD(house2_co2),
+    FIELD(house3_pm2_5),
+    FIELD(house3_co2),
+    FIELD(house4_pm2_5),
+    FIELD(house4_co2),
+    FIELD(house5_pm2_5),
+    FIELD(house5_co2),
+    FIELD(fault_state),
+};
+
+static rt_list_t dev_state_subs;
+static rt_uint32_t dev_state_change_cnt[DEV_STATE_FIELD_NUM];
+
+void dev_state_init(void)
+{
+    rt_list_init(&dev_state_subs);
+}
+
+/* subscribers are static and set up at init, they are never removed */
+void dev_state_subscribe(struct dev_state_sub *sub, const char *name,
+                         rt_uint32_t mask, dev_state_notify_t notify)
+{
+    rt_base_t level;
+
+    RT_ASSERT(sub != RT_NULL);
+
+    sub->mask       = mask;
+    sub->notify     = notify;
+    sub->notify_cnt = 0;
+    rt_event_init(&sub->event, name, RT_IPC_FLAG_FIFO);
+
+    level = rt_hw_interrupt_disable();
+    rt_list_insert_before(&dev_state_subs, &sub->list);
+    rt_hw_interrupt_enable(level);
+}
+
+/* the fields of the mask changed since the last call, 0 on timeout */
+rt_uint32_t dev_state_wait(struct dev_state_sub *sub, rt_int32_t timeout)
+{
+    rt_uint32_t changed;
+
+    if (rt_event_recv(&sub->event, sub->mask, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                      timeout, &changed) != RT_EOK)
+        return 0;
+
+    return changed;
+}
+
+/* tell the subscribers about fields written without dev_state_set() */
+void dev_state_changed(rt_uint32_t changed)
+{
+    struct dev_state_sub *sub;
+    rt_list_t *node;
+
+    for (node = dev_state_subs.next; node != &dev_state_subs; node = node->next)
+    {
+        sub = rt_list_entry(node, struct dev_state_sub, list);
+        if (!(sub->mask & changed))
+            continue;
+
+        sub->notify_cnt++;
+        if (sub->notify != RT_NULL)
+            sub->notify(sub->mask & changed);
+        else
+            rt_event_send(&sub->event, sub->mask & changed);
+    }
+}
+
+rt_bool_t dev_state_set(enum dev_state_field field, rt_uint16_t value)
+{
+    rt_uint8_t *data;
+    rt_base_t level;
+    rt_bool_t changed = RT_FALSE;
+
+    RT_ASSERT(field < DEV_STATE_FIELD_NUM);
+
+    data = &device_work_data.device_data[dev_state_layout[field].offset];
+
+    level = rt_hw_interrupt_disable();
+    if (dev_state_layout[field].size == 1)
+    {
+        if (*data != (rt_uint8_t)value)
+        {
+            *data = (rt_uint8_t)value;
+            changed = RT_TRUE;
+        }
+    }
+    else if (*(rt_uint16_t *)data != value)
+    {
+        *(rt_uint16_t *)data = value;
+        changed = RT_TRUE;
+    }
+    rt_hw_interrupt_enable(level);
+
+    /* subscribers run outside of the lock, they may block */
+    if (changed)
+    {
+        dev_state_change_cnt[field]++;
+        dev_state_changed(DEV_STATE_BIT(field));
+    }
+
+    return changed;
+}
+
+rt_uint16_t dev_state_get(enum dev_state_field field)
+{
+    rt_uint8_t *data;
+
+    RT_ASSERT(field < DEV_STATE_FIELD_NUM);
+
+    data = &device_work_data.device_data[dev_state_layout[field].offset];
+    if (dev_state_layout[field].size == 1)
+        return *data;
+
+    return *(rt_uint16_t *)data;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_dev_state(void)
+{
+    struct dev_state_sub *sub;
+    rt_list_t *node;
+    int i;
+
+    rt_kprintf("field  value changes\n");
+    rt_kprintf("----- ------ -------\n");
+    for (i = 0; i < DEV_STATE_FIELD_NUM; i++)
+    {
+        rt_kprintf("%5d %6d %7d\n", i, dev_state_get((enum dev_state_field)i),
+                   dev_state_change_cnt[i]);
+    }
+
+    rt_kprintf("\nsubscriber  mask     notified\n");
+    rt_kprintf("-------- ---------- --------\n");
+    for (node = dev_state_subs.next; node != &dev_state_subs; node = node->next)
+    {
+        sub = rt_list_entry(node, struct dev_state_sub, list);
+        rt_kprintf("%-8.*s 0x%08x %8d\n", RT_NAME_MAX, sub->event.parent.parent.name,
+                   sub->mask, sub->notify_cnt);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_dev_state, list device state fields and subscribers)
+#endif
@@ -0,0 +1,73 @@
+/*
+ * File      : dev_state.h
+ * observable store of the device work state
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#ifndef __DEV_STATE_H__
+#define __DEV_STATE_H__
+
+#include <rtthread.h>
+
+/* fields of device_work_data, in their order, one change bit each */
+enum dev_state_field
+{
+    DEV_STATE_POWER = 0,
+    DEV_STATE_MODE,
+    DEV_STATE_WIND_SPEED,
+    DEV_STATE_HIGH_PRESSURE,
+    DEV_STATE_PHT,
+    DEV_STATE_TIMING,
+    DEV_STATE_HOUSE1_PM25,
+    DEV_STATE_HOUSE1_CO2,
+    DEV_STATE_HOUSE2_PM25,
+    DEV_STATE_HOUSE2_CO2,
+    DEV_STATE_HOUSE3_PM25,
+    DEV_STATE_HOUSE3_CO2,
+    DEV_STATE_HOUSE4_PM25,
+    DEV_STATE_HOUSE4_CO2,
+    DEV_STATE_HOUSE5_PM25,
+    DEV_STATE_HOUSE5_CO2,
+    DEV_STATE_FAULT,
+    DEV_STATE_FIELD_NUM
+};
+
+/* room sensor n, 1 to 5 */
+#define DEV_STATE_HOUSE_PM25(n)     (DEV_STATE_HOUSE1_PM25 + ((n) - 1) * 2)
+#define DEV_STATE_HOUSE_CO2(n)      (DEV_STATE_HOUSE1_CO2 + ((n) - 1) * 2)
+
+#define DEV_STATE_BIT(field)        (1UL << (field))
+#define DEV_STATE_ALL               (DEV_STATE_BIT(DEV_STATE_FIELD_NUM) - 1)
+/* the user settings, saved to flash */
+#define DEV_STATE_SETTINGS          (DEV_STATE_BIT(DEV_STATE_TIMING + 1) - 1)
+#define DEV_STATE_HOUSES            (DEV_STATE_BIT(DEV_STATE_FAULT) - DEV_STATE_BIT(DEV_STATE_HOUSE1_PM25))
+
+typedef void (*dev_state_notify_t)(rt_uint32_t changed);
+
+/*
+ * A subscriber is told about the changes of the fields in its mask, either
+ * by its notify function, called right from the setter, or, without one,
+ * through its event, which a thread waits on with dev_state_wait().
+ */
+struct dev_state_sub
+{
+    rt_list_t          list;
+    rt_uint32_t        mask;
+    dev_state_notify_t notify;
+    struct rt_event    event;
+
+    rt_uint32_t        notify_cnt;
+};
+
+void dev_state_init(void);
+void dev_state_subscribe(struct dev_state_sub *sub, const char *name,
+                         rt_uint32_t mask, dev_state_notify_t notify);
+rt_uint32_t dev_state_wait(struct dev_state_sub *sub, rt_int32_t timeout);
+
+rt_bool_t dev_state_set(enum dev_state_field field, rt_uint16_t value);
+rt_uint16_t dev_state_get(enum dev_state_field field);
+void dev_state_changed(rt_uint32_t changed);
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * File      : disp_board.h
+ * display board on the second RS485 line
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#ifndef __DISP_BOARD_H__
+#define __DISP_BOARD_H__
+
+#include "includes.h"
+
+/* same numbering as the wifi command of set_device_work_mode() */
+enum DEVICE_CMD_TYPE
+{
+    D_CMD_POWER = 0x02,
+    D_CMD_MODE,
+    D_CMD_HIGH_PRESSURE,
+    D_CMD_PHT,
+    D_CMD_TIMING,
+    D_CMD_WIND_SPEED,
+};
+
+/*
+ * State image sync. The F2 frame carries the whole image, a board with the
+ * sync extension acknowledges it and from then on only gets the bytes that
+ * changed, as offset/value pairs:
+ *   F3 F3 02 len seq {offset value}... chk 7E
+ * Each F3 or F2 frame is acknowledged with the sequence number applied:
+ *   F3 F3 81 01 seq chk 7E
+ * A snapshot starts the sequence at 0. A board that lost its image asks for
+ * a snapshot with DISP_SYNC_REQUEST in the data of its 01 frame.
+ */
+#define DISP_IMAGE_SIZE         27
+#define DISP_SYNC_DELTA         0x02
+#define DISP_SYNC_ACK           0x81
+#define DISP_SYNC_REQUEST       0x80
+/* a longer delta is no shorter than the snapshot */
+#define DISP_SYNC_DELTA_MAX     13
+
+/*
+ * Baud rate of the line, the codes of the Modbus function 0x41:
+ *   F3 F3 03 01 code chk 7E
+ * is answered at the old rate with the rate the board switches to:
+ *   F3 F3 83 01 code chk 7E
+ * The board goes back to 9600 when it hears nothing valid for 2 s. In the
+ * baud rate table of the master it is device DISP_BUS_DEVICE.
+ */
+#define DISP_BAUD_SET           0x03
+#define DISP_BAUD_ACK           0x83
+#define DISP_BUS_DEVICE         1
+
+void get_display_board_data(void);
+void set_display_board_data(void);
+void set_dispboard_function_mode(enum DEVICE_CMD_TYPE type, u8 mode);
+void thread_entry_com_displayboard(void* parameter);
+
+#endif
@@ -16,14 +16,14 @@
 #include "jiguang.h"
 //#include "eeprom.h"
 
-#include "protocol.h"
+#include "Protocol.h"
 
 #include "motor_config.h"
 
 #include "Queue.h"
 #include "malloc.h"
 
-#include "an41908a.h"
+#include "AN41908A.h"
 #include "protocol_send.h"
 
 #include "osd_menu.h"
@@ -0,0 +1,249 @@
+/*
+ * File      : memfunc_bench.c
+ * rt_memcpy, rt_memset and rt_memmove benchmark
+ *
+ * memfunc_bench(step) runs the three functions over the sizes 1 to 4096, by
+ * step, at every alignment of the destination and the source in a word, and
+ * checks each result and the bytes around it. The calls are timed in the
+ * cycle counter of the DWT with the interrupts off, and reported as the mean
+ * cycles per call by size and by alignment: both aligned, aligned the same
+ * way, aligned differently. Built once with RT_USING_CPU_MEMFUNC and once
+ * without, it gives the speedup of the libcpu versions on the board.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#include "dwt.h"
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+#define BENCH_MAX               4096
+/* guard bytes on both sides, and room for the memmove overlap */
+#define BENCH_PAD               8
+#define BENCH_BUF_SIZE          (BENCH_MAX + 2 * BENCH_PAD)
+#define BENCH_GUARD             0x5a
+
+#define BENCH_SIZE_CLASS        6
+#define BENCH_ALIGN_CLASS       3
+
+enum
+{
+    BENCH_MEMCPY,
+    BENCH_MEMSET,
+    BENCH_MEMMOVE,
+    BENCH_FUNC_NUM
+};
+
+static const char *bench_func_name[BENCH_FUNC_NUM] = {"memcpy", "memset", "memmove"};
+static const rt_uint16_t bench_size_class[BENCH_SIZE_CLASS] = {8, 32, 128, 512, 2048, BENCH_MAX + 1};
+
+struct bench_stat
+{
+    rt_uint32_t count;
+    rt_uint32_t cycles;
+};
+
+static struct bench_stat bench_stat[BENCH_FUNC_NUM][BENCH_SIZE_CLASS][BENCH_ALIGN_CLASS];
+static rt_uint32_t bench_overhead;
+
+static int bench_size_index(rt_uint32_t size)
+{
+    int i;
+
+    for (i = 0; size >= bench_size_class[i]; i++);
+
+    return i;
+}
+
+static int bench_align_index(rt_uint32_t dst, rt_uint32_t src)
+{
+    if ((dst & 3) == 0 && (src & 3) == 0)
+        return 0;
+
+    return ((dst - src) & 3) ? 2 : 1;
+}
+
+static void bench_fill(rt_uint8_t *buf, rt_uint32_t size, rt_uint8_t seed)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < size; i++)
+        buf[i] = (rt_uint8_t)(seed + i * 7);
+}
+
+static void bench_guard(rt_uint8_t *buf)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < BENCH_BUF_SIZE; i++)
+        buf[i] = BENCH_GUARD;
+}
+
+/* ref is NULL for memset, which is checked against c */
+static rt_bool_t bench_check(const rt_uint8_t *buf, const rt_uint8_t *dst,
+                             const rt_uint8_t *ref, int c, rt_uint32_t size)
+{
+    const rt_uint8_t *p;
+
+    for (p = buf; p < dst; p++)
+        if (*p != BENCH_GUARD)
+            return RT_FALSE;
+    for (; p < dst + size; p++, ref++)
+        if (*p != (ref ? *ref : (rt_uint8_t)c))
+            return RT_FALSE;
+    for (; p < buf + BENCH_BUF_SIZE; p++)
+        if (*p != BENCH_GUARD)
+            return RT_FALSE;
+
+    return RT_TRUE;
+}
+
+static void bench_account(int func, rt_uint32_t size, rt_uint32_t dst, rt_uint32_t src,
+                          rt_uint32_t cycles)
+{
+    struct bench_stat *stat;
+
+    stat = &bench_stat[func][bench_size_index(size)][bench_align_index(dst, src)];
+    stat->count++;
+    stat->cycles += cycles > bench_overhead ? cycles - bench_overhead : 0;
+}
+
+static void bench_report(void)
+{
+    struct bench_stat *stat;
+    int func, size, align;
+
+    rt_kprintf("cycles per call     aligned  same mod  diff mod\n");
+    for (func = 0; func < BENCH_FUNC_NUM; func++)
+    {
+        rt_kprintf("---------------- --------- --------- ---------\n");
+        for (size = 0; size < BENCH_SIZE_CLASS; size++)
+        {
+            rt_kprintf("%-7s %4d-%-4d", bench_func_name[func],
+                       size ? bench_size_class[size - 1] : 1, bench_size_class[size] - 1);
+            for (align = 0; align < BENCH_ALIGN_CLASS; align++)
+            {
+                stat = &bench_stat[func][size][align];
+                if (stat->count == 0)
+                    rt_kprintf(" %9s", "-");
+                else
+                    rt_kprintf(" %9d", stat->cycles / stat->count);
+            }
+            rt_kprintf("\n");
+        }
+    }
+}
+
+void memfunc_bench(int step)
+{
+    rt_uint8_t *dst_buf, *src_buf, *ref_buf;
+    rt_uint8_t *dst, *src;
+    rt_uint32_t size, start, cycles, failed = 0;
+    rt_uint32_t da, sa;
+    rt_base_t level;
+
+    if (step <= 0)
+        step = 1;
+
+    dst_buf = rt_malloc(BENCH_BUF_SIZE);
+    src_buf = rt_malloc(BENCH_BUF_SIZE);
+    ref_buf = rt_malloc(BENCH_BUF_SIZE);
+    if (dst_buf == RT_NULL || src_buf == RT_NULL || ref_buf == RT_NULL)
+    {
+        rt_kprintf("no memory for the buffers\n");
+        goto _exit;
+    }
+
+    dwt_cycles_init();
+
+    level = rt_hw_interrupt_disable();
+    start = DWT_CYCCNT;
+    bench_overhead = DWT_CYCCNT - start;
+    rt_hw_interrupt_enable(level);
+
+    rt_memset(bench_stat, 0, sizeof(bench_stat));
+
+    for (size = 1; size <= BENCH_MAX; size += step)
+    {
+        for (da = 0; da < 4; da++)
+        {
+            for (sa = 0; sa < 4; sa++)
+            {
+                /* the buffers come from the heap, word aligned */
+                dst = dst_buf + BENCH_PAD + da;
+                src = src_buf + BENCH_PAD + sa;
+                bench_fill(src_buf, BENCH_BUF_SIZE, (rt_uint8_t)size);
+                bench_guard(dst_buf);
+
+                level = rt_hw_interrupt_disable();
+                start = DWT_CYCCNT;
+                rt_memcpy(dst, src, size);
+                cycles = DWT_CYCCNT - start;
+                rt_hw_interrupt_enable(level);
+                bench_account(BENCH_MEMCPY, size, (rt_uint32_t)dst, (rt_uint32_t)src, cycles);
+                if (!bench_check(dst_buf, dst, src, 0, size))
+                {
+                    rt_kprintf("memcpy failed: size %d dst %d src %d\n", size, da, sa);
+                    failed++;
+                }
+
+                /* overlapped, dst after src: the copy runs backward */
+                bench_fill(dst_buf, BENCH_BUF_SIZE, (rt_uint8_t)size);
+                src = dst_buf + sa;
+                dst = dst_buf + BENCH_PAD + da;
+                rt_memcpy(ref_buf, src, size);
+
+                level = rt_hw_interrupt_disable();
+                start = DWT_CYCCNT;
+                rt_memmove(dst, src, size);
+                cycles = DWT_CYCCNT - start;
+                rt_hw_interrupt_enable(level);
+                bench_account(BENCH_MEMMOVE, size, (rt_uint32_t)dst, (rt_uint32_t)src, cycles);
+                if (rt_memcmp(dst, ref_buf, size) != 0)
+                {
+                    rt_kprintf("memmove failed: size %d dst %d src %d\n", size, da, sa);
+                    failed++;
+                }
+            }
+
+            dst = dst_buf + BENCH_PAD + da;
+            bench_guard(dst_buf);
+
+            level = rt_hw_interrupt_disable();
+            start = DWT_CYCCNT;
+            rt_memset(dst, size, size);
+            cycles = DWT_CYCCNT - start;
+            rt_hw_interrupt_enable(level);
+            /* no source, only the destination alignment counts */
+            bench_account(BENCH_MEMSET, size, (rt_uint32_t)dst, (rt_uint32_t)dst, cycles);
+            if (!bench_check(dst_buf, dst, RT_NULL, size, size))
+            {
+                rt_kprintf("memset failed: size %d dst %d\n", size, da);
+                failed++;
+            }
+        }
+    }
+
+#ifdef RT_USING_CPU_MEMFUNC
+    rt_kprintf("libcpu memory functions, step %d, %d failed\n", step, failed);
+#else
+    rt_kprintf("kservice memory functions, step %d, %d failed\n", step, failed);
+#endif
+    bench_report();
+
+_exit:
+    if (dst_buf != RT_NULL)
+        rt_free(dst_buf);
+    if (src_buf != RT_NULL)
+        rt_free(src_buf);
+    if (ref_buf != RT_NULL)
+        rt_free(ref_buf);
+}
+FINSH_FUNCTION_EXPORT(memfunc_bench, time and check rt_memcpy rt_memset and rt_memmove)
+#endif
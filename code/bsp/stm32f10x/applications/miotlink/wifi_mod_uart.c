@@ -8,18 +8,43 @@
 
 #include "application.h"
 #include "bsp_spi_flash.h"
+#include "para_store.h"
+#include "ts_store.h"
+#include "dev_state.h"
 
 void uart_wifi_set_device(void);
 
 
 
 u8 wifi_send_packet_buf_pub[100];
-u8 wifi_recv_packet_buf_pub[100];
-u8 wifi_data_buffer_recv_tmp[100];  
-u8 wifi_recieve_data_length = 0;
 
 struct _uart_dev_my* wifi_uart_dev_my;
 
+/*
+ * Receive window of the wifi link. The rx thread reads whatever the DMA
+ * brought in behind wifi_rx_tail and parses the F1 F1 cmd len .. chk 7E
+ * frames in place, from wifi_rx_head: a complete frame is decoded right
+ * from this buffer. Both ends go back to 0 once everything is parsed,
+ * which is the usual case between two frames.
+ */
+#define WIFI_FRAME_HEAD		0xF1
+#define WIFI_FRAME_MAX		100
+#define WIFI_RX_BUF_SIZE	256
+
+static u8 wifi_rx_buf[WIFI_RX_BUF_SIZE];
+static u16 wifi_rx_head = 0, wifi_rx_tail = 0;
+
+/*
+ * Sending is over when the DMA is done with the buffer that was written.
+ * The UART is shared with the console, whose writes complete on the same
+ * callback, so only the completion of wifi_tx_buf counts.
+ */
+static struct rt_semaphore wifi_tx_done;
+static const void *wifi_tx_buf = RT_NULL;
+
+/* the serial DMA queues 8 writes, the console may have 7 ahead of ours */
+#define WIFI_TX_AHEAD_MAX	(7 * RT_CONSOLEBUF_SIZE)
+
 // return 0,fail; 1,success
 //buf,յݻ壬lenݵĳ
 u8 wifi_receive_data_check(u8* buf,u8 len)
@@ -55,6 +80,12 @@ rt_mutex_t wifi_send_mut = RT_NULL;
 
 rt_err_t wifi_send_data(u8* data,u16 len)
 {
+	rt_device_t dev;
+	rt_base_t level;
+	rt_uint32_t baud;
+	rt_int32_t timeout;
+	rt_err_t result = RT_EOK;
+
 	rt_mutex_take(wifi_send_mut,RT_WAITING_FOREVER);
 	
 	//RS485_TX_ENABLE;
@@ -62,14 +93,30 @@ rt_err_t wifi_send_data(u8* data,u16 len)
 	{
 		uart_wifi_set_device();
 	}
+	dev = wifi_uart_dev_my->device;
 	
-	rt_device_write(wifi_uart_dev_my->device, 0, data, len);
-
-	rt_thread_delay (80);
+	/* the DMA reads data until it is done, wait for that and no longer */
+	level = rt_hw_interrupt_disable();
+	wifi_tx_buf = data;
+	rt_hw_interrupt_enable(level);
+	if (rt_device_write(dev, 0, data, len) == len &&
+		(dev->open_flag & RT_DEVICE_FLAG_DMA_TX))
+	{
+		/* 10 bits a byte for ours and what may be queued ahead, one tick spare */
+		baud = ((struct rt_serial_device *)dev)->config.baud_rate;
+		timeout = rt_tick_from_millisecond((len + WIFI_TX_AHEAD_MAX) * 10 * 1000 / baud) + 1;
+		result = rt_sem_take(&wifi_tx_done, timeout);
+	}
+	level = rt_hw_interrupt_disable();
+	wifi_tx_buf = RT_NULL;
+	rt_hw_interrupt_enable(level);
+	/* the completion may have come between the timeout and now */
+	if (result != RT_EOK)
+		rt_sem_control(&wifi_tx_done, RT_IPC_CMD_RESET, 0);
 	//RS485_RX_ENABLE;
 
 	rt_mutex_release(wifi_send_mut);
-	return RT_EOK;
+	return result;
 }
 
 
@@ -79,9 +126,12 @@ rt_err_t wifi_send_data(u8* data,u16 len)
 u8 wifi_send_packet_data(u8* buf,u8 len)
 {
     u8 i;
-    u8 chk;
+    u8 chk = 0;
 
 
+    //the wifi and the report thread share the buffer, the mutex nests
+    rt_mutex_take(wifi_send_mut,RT_WAITING_FOREVER);
+
     wifi_send_packet_buf_pub[0] = 0xF2;
     wifi_send_packet_buf_pub[1] = 0xF2;
 
@@ -95,6 +145,8 @@ u8 wifi_send_packet_data(u8* buf,u8 len)
     wifi_send_packet_buf_pub[i+3] = 0x7E;
 
     wifi_send_data(wifi_send_packet_buf_pub,len+4);
+
+    rt_mutex_release(wifi_send_mut);
 	
 		return 1;
 }
@@ -151,9 +203,29 @@ u8 device_power_state_pre=0xff;
 extern void FLASH_Program_read_para(void);
 
 
+//legacy parameter area, only read once to import it into the para store
 #define	SYS_PARA_FLAG_ADDR		2
 #define	SYS_PARA_START_ADDR			10
 
+static void device_sys_para_load(void)
+{
+	u8 sys_para_flag = 0;
+
+	if(para_store_read(PARA_KEY_WORK_STATE,device_work_data.device_data,6) != 6)
+	{
+		SPI_FLASH_BufferRead(&sys_para_flag,SYS_PARA_FLAG_ADDR,1);
+
+		if(sys_para_flag == 0x86)
+		{
+			SPI_FLASH_BufferRead(device_work_data.device_data,SYS_PARA_START_ADDR,6);
+			para_store_write(PARA_KEY_WORK_STATE,device_work_data.device_data,6);
+		}
+	}
+
+	//read in as a whole, behind the setters
+	dev_state_changed(DEV_STATE_SETTINGS);
+}
+
 void device_state_init(void)
 {
     for(u8 i=0;i<sizeof(struct __para_type);i++)
@@ -163,17 +235,9 @@ void device_state_init(void)
 
 	device_power_state_pre = 0xff;
 
-	
-
-	u8 sys_para_flag = 0;
-
-	SPI_FLASH_BufferRead(&sys_para_flag,SYS_PARA_FLAG_ADDR,1);
+	device_sys_para_load();
 
-	if(sys_para_flag == 0x86)
-		SPI_FLASH_BufferRead(device_work_data.device_data,SYS_PARA_START_ADDR,6);
-
-
-	device_work_data.para_type.fault_state = 0;
+	dev_state_set(DEV_STATE_FAULT, 0);
 
 	airclean_power_onoff(1);
 	
@@ -181,27 +245,16 @@ void device_state_init(void)
 
 void device_sys_para_get(void)
 {
-	u8 sys_para_flag = 0;
-
-	SPI_FLASH_BufferRead(&sys_para_flag,SYS_PARA_FLAG_ADDR,1);
+	device_sys_para_load();
 
-	if(sys_para_flag == 0x86)
-		SPI_FLASH_BufferRead(device_work_data.device_data,SYS_PARA_START_ADDR,6);
-
-
-	device_work_data.para_type.fault_state = 0;
+	dev_state_set(DEV_STATE_FAULT, 0);
 
 }
 
+//appended to the para store log, nothing is written when the state is unchanged
 void device_sys_para_save(void)
 {
-	u8 sys_para_flag = 0x86;
-
-		SPI_FLASH_BufferWrite(&sys_para_flag,SYS_PARA_FLAG_ADDR,1);
-
-		SPI_FLASH_BufferWrite(device_work_data.device_data,SYS_PARA_START_ADDR,6);
-
-
+	para_store_write(PARA_KEY_WORK_STATE,device_work_data.device_data,6);
 }
 
 u8 return_current_device_state(void)
@@ -255,6 +308,156 @@ u8 return_current_device_state(void)
 
 
 
+/*
+ * History request 08: level, then the first and the last minute, big
+ * endian. The samples go back in 08 frames of level, frame number, minute
+ * of the first sample, count and the values of every channel, a frame only
+ * holds consecutive samples. A frame with count 0 ends the answer: it
+ * carries the minute a next request goes on from and the current minute of
+ * the device, which maps the minutes to the wall time.
+ */
+#define WIFI_HISTORY_CHUNK		4
+#define WIFI_HISTORY_MAX		1440	//samples per request, a day of minutes
+
+struct wifi_history
+{
+	u8  level;
+	u8  seq;
+	u8  count;
+	u16 period;
+	u16 sent;
+	u32 time;
+	u32 next;
+	u8  buf[9 + WIFI_HISTORY_CHUNK * TS_CHANNEL_NUM * 2];
+};
+
+static struct wifi_history wifi_history;
+
+static void wifi_put16(u8* buf,u16 value)
+{
+	buf[0] = value >> 8;
+	buf[1] = value;
+}
+
+static void wifi_put32(u8* buf,u32 value)
+{
+	buf[0] = value >> 24;
+	buf[1] = value >> 16;
+	buf[2] = value >> 8;
+	buf[3] = value;
+}
+
+static void wifi_history_send(struct wifi_history* h)
+{
+	h->buf[0] = 0x08;
+	h->buf[1] = 7 + h->count * TS_CHANNEL_NUM * 2;
+	h->buf[2] = h->level;
+	h->buf[3] = h->seq++;
+	wifi_put32(&h->buf[4],h->time);
+	h->buf[8] = h->count;
+
+	wifi_send_packet_data(h->buf,h->buf[1] + 2);
+	h->count = 0;
+}
+
+static rt_bool_t wifi_history_sample(rt_uint32_t time, const rt_uint16_t *value, void *parameter)
+{
+	struct wifi_history* h = (struct wifi_history*)parameter;
+	u8* p;
+	u8 ch;
+
+	if(h->sent == WIFI_HISTORY_MAX)
+	{
+		h->next = time;
+		return RT_FALSE;
+	}
+
+	if(h->count == WIFI_HISTORY_CHUNK ||
+	   (h->count != 0 && time != h->time + h->count * h->period))
+		wifi_history_send(h);
+	if(h->count == 0)
+		h->time = time;
+
+	p = &h->buf[9 + h->count * TS_CHANNEL_NUM * 2];
+	for(ch=0;ch<TS_CHANNEL_NUM;ch++)
+	{
+		p[2*ch] = value[ch] >> 8;
+		p[2*ch+1] = value[ch];
+	}
+	h->count++;
+	h->sent++;
+
+	return RT_TRUE;
+}
+
+static void return_history(u8* buf)
+{
+	struct wifi_history* h = &wifi_history;
+	u32 from, to, now;
+
+	from = ((u32)buf[3] << 24) | ((u32)buf[4] << 16) | ((u32)buf[5] << 8) | buf[6];
+	to = ((u32)buf[7] << 24) | ((u32)buf[8] << 16) | ((u32)buf[9] << 8) | buf[10];
+
+	//nothing past the current minute
+	now = ts_store_now();
+	if(to >= now)
+		to = now - 1;
+
+	h->level = buf[2];
+	h->period = ts_store_period(h->level);
+	h->seq = 0;
+	h->count = 0;
+	h->sent = 0;
+	h->next = to + 1;
+
+	if(h->period != 0)
+		ts_store_query(h->level,from,to,wifi_history_sample,h);
+	if(h->count != 0)
+		wifi_history_send(h);
+
+	h->buf[0] = 0x08;
+	h->buf[1] = 11;
+	h->buf[2] = h->level;
+	h->buf[3] = h->seq;
+	wifi_put32(&h->buf[4],h->next);
+	h->buf[8] = 0;
+	wifi_put32(&h->buf[9],now);
+	wifi_send_packet_data(h->buf,13);
+}
+
+/*
+ * Bus health 09: the count of room sensors, then for each its address, 1 if
+ * it answers, its average response time and respond timeout in ms, and the
+ * replies, the timeouts and the requests skipped while it was dead, 16 bits
+ * each, they wrap.
+ */
+#define WIFI_HEALTH_SLAVE_SIZE	12
+
+static void return_bus_health(void)
+{
+	xMBMasterSlaveStat stat;
+	u8 buf[3 + 5 * WIFI_HEALTH_SLAVE_SIZE];
+	u8* p = &buf[3];
+	u8 slave;
+
+	for(slave=11;slave<=15;slave++,p+=WIFI_HEALTH_SLAVE_SIZE)
+	{
+		xMBMasterGetSlaveStat(&rs485_master,slave,&stat);
+		p[0] = slave;
+		p[1] = stat.xAlive;
+		wifi_put16(&p[2],stat.usRespondMs);
+		wifi_put16(&p[4],stat.usTimeoutMs);
+		wifi_put16(&p[6],stat.ulReplies);
+		wifi_put16(&p[8],stat.ulTimeouts);
+		wifi_put16(&p[10],stat.ulSkipped);
+	}
+
+	buf[0] = 0x09;
+	buf[1] = 1 + 5 * WIFI_HEALTH_SLAVE_SIZE;
+	buf[2] = 5;
+	wifi_send_packet_data(buf,buf[1] + 2);
+}
+
 u8 wifi_receive_data_decode(u8* buf,u8 len)
 {
 //    u8 i;
@@ -271,8 +474,16 @@ u8 wifi_receive_data_decode(u8* buf,u8 len)
     case 0x05:
     case 0x06:
     case 0x07:
-        set_device_work_mode(buf[0],buf[2],1);
-        return_current_device_state(); 
+        //a change is reported by the report thread
+        if(!set_device_work_mode(buf[0],buf[2],1))
+            return_current_device_state(); 
+        break;
+    case 0x08:
+        if(buf[1] >= 9)
+            return_history(buf);
+        break;
+    case 0x09:
+        return_bus_health();
         break;
     case 0xf7:
         send_F7_packet();
@@ -288,10 +499,6 @@ u8 wifi_receive_data_decode(u8* buf,u8 len)
 
 
 
-rt_sem_t	wifi_uart_sem;
-
-
-
 static rt_err_t wifi_rx_ind(rt_device_t dev, rt_size_t size)
 {
     RT_ASSERT(wifi_uart_dev_my != RT_NULL);
@@ -301,6 +508,19 @@ static rt_err_t wifi_rx_ind(rt_device_t dev, rt_size_t size)
 
     return RT_EOK;
 }
+
+static rt_err_t wifi_tx_done_ind(rt_device_t dev, void *buffer)
+{
+    /* a console write done, or ours after the wait gave up */
+    if (buffer != wifi_tx_buf)
+        return RT_EOK;
+
+    wifi_tx_buf = RT_NULL;
+    rt_sem_release(&wifi_tx_done);
+
+    return RT_EOK;
+}
+
 void uart_wifi_set_device(void)
 {
 	    rt_device_t dev = RT_NULL;
@@ -315,8 +535,9 @@ void uart_wifi_set_device(void)
     /* check whether it's a same device */
     if (dev == wifi_uart_dev_my->device) return;
 		
-    if (rt_device_open(dev, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX |\
-                       RT_DEVICE_FLAG_STREAM) == RT_EOK)
+    /* binary frames: no stream mode, whole frames in and out by DMA */
+    if (rt_device_open(dev, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_DMA_RX |\
+                       RT_DEVICE_FLAG_DMA_TX) == RT_EOK)
     {
         if (wifi_uart_dev_my->device != RT_NULL)
         {
@@ -327,150 +548,101 @@ void uart_wifi_set_device(void)
 
         wifi_uart_dev_my->device = dev;
         rt_device_set_rx_indicate(dev, wifi_rx_ind);
+        rt_device_set_tx_complete(dev, wifi_tx_done_ind);
     }
 }
 
 
-void wifi_rx_isr(u8 udr0)
+/* hand every complete frame of the window to the decoder, keep the rest */
+static void wifi_rx_parse(void)
 {
-    u8 i;
-    static u8 wait_len = 0,wait_len_cnt = 0;
-    static u8 recieved_len = 0;
+    u8 *frame;
+    u16 avail, len;
 
-
-    if(recieved_len == 0)
+    while ((avail = wifi_rx_tail - wifi_rx_head) != 0)
     {
-        if(udr0 == 0xF1)
+        frame = &wifi_rx_buf[wifi_rx_head];
+
+        /* hunt for the F1 F1 start code */
+        if (frame[0] != WIFI_FRAME_HEAD || (avail > 1 && frame[1] != WIFI_FRAME_HEAD))
         {
-            wifi_data_buffer_recv_tmp[recieved_len] = 0xf1;
-            recieved_len++;
+            wifi_rx_head++;
+            continue;
         }
-        else
+        if (avail < 4)
+            break;
+
+        /* start code, cmd, len, data, checksum, end code */
+        len = frame[3] + 6;
+        if (len > WIFI_FRAME_MAX)
         {
-            
-            recieved_len = 0;
-            return;
+            wifi_rx_head++;
+            continue;
         }
-    }
-    else if(recieved_len == 1)
-    {
-        if(udr0 == 0xf1)
+        if (avail < len)
+            break;
+
+        if (wifi_receive_data_check(frame, len))
         {
-            wifi_data_buffer_recv_tmp[recieved_len] = 0xf1;
-            recieved_len++;
+            wifi_receive_data_decode(&frame[2], len - 4);
+            wifi_rx_head += len;
         }
         else
         {
-            recieved_len = 0;
-            return;
+            /* not a frame after all, resync on the next byte */
+            wifi_rx_head++;
         }
     }
-    else if(recieved_len <= 3)
-    {
-        wifi_data_buffer_recv_tmp[recieved_len] = udr0;
-        recieved_len++;
-			
-		if(recieved_len == 4)
-			{
-		wait_len = udr0;
-        wait_len_cnt = 0;
-			}
-    }
-	else
-		{
-    if(wait_len_cnt <= wait_len)
+
+    if (wifi_rx_head == wifi_rx_tail)
+        wifi_rx_head = wifi_rx_tail = 0;
+}
+
+/* read what the serial fifo holds behind the window, returns its length */
+static rt_size_t wifi_rx_fill(void)
+{
+    rt_size_t len;
+
+    /* a partial frame at the very end: move it to the front, it is short */
+    if (wifi_rx_tail == sizeof(wifi_rx_buf))
     {
-        wait_len_cnt++;
-        wifi_data_buffer_recv_tmp[recieved_len] = udr0;
-        recieved_len++;
+        memmove(wifi_rx_buf, &wifi_rx_buf[wifi_rx_head], wifi_rx_tail - wifi_rx_head);
+        wifi_rx_tail -= wifi_rx_head;
+        wifi_rx_head = 0;
     }
-    else if(wait_len_cnt == wait_len+1)
-    {
-	     wifi_data_buffer_recv_tmp[recieved_len] = udr0;
-	 
-        recieved_len++;
-        wifi_recieve_data_length = recieved_len;
 
-        for(i=0;i<recieved_len;i++)
-        {
-            wifi_recv_packet_buf_pub[i] = wifi_data_buffer_recv_tmp[i];
-        }
+    len = rt_device_read(wifi_uart_dev_my->device, 0, &wifi_rx_buf[wifi_rx_tail],
+                         sizeof(wifi_rx_buf) - wifi_rx_tail);
+    wifi_rx_tail += len;
 
-        recieved_len = 0;
-        wait_len_cnt = 0;
-        wait_len = 0;
-       rt_sem_release(wifi_uart_sem);
- 
-    }
-		}
+    return len;
 }
 
 void rt_wifi_thread_entry(void* parameter)
 {
-    char ch;
-
 	while (1)
     {
         /* wait receive */
         if (rt_sem_take(&wifi_uart_dev_my->rx_sem, RT_WAITING_FOREVER) != RT_EOK) continue;
 
-            /* read one character from device */
-            while (rt_device_read(wifi_uart_dev_my->device, 0, &ch, 1) == 1)
-            {
-                wifi_rx_isr(ch);
-            } /* end of device read */
-    }	
-	
-}
-
-
-void rt_wifi_decode_thread_entry(void* parameter)
-{
-//	u16 k;
-
-	while(1)
-	{
-		if(rt_sem_take(wifi_uart_sem, RT_WAITING_FOREVER) == RT_EOK)
+        while (wifi_rx_fill() > 0)
         {
-			if (wifi_receive_data_check(wifi_recv_packet_buf_pub,wifi_recieve_data_length)) 
-            {
-                wifi_receive_data_decode(&wifi_recv_packet_buf_pub[2],wifi_recieve_data_length-4);
-            }
-                       
-            rt_thread_delay(RT_TICK_PER_SECOND/50);
-		}
+            wifi_rx_parse();
+        }
     }
-
 }
 
-//u8 *testb = {"yes,my at\n"};
-void rt_wifi_key_thread_entry(void* parameter)
-{
-//	u16 k;
+static struct dev_state_sub wifi_report_sub;
 
+//the settings and the faults go to the cloud as soon as they change
+void rt_wifi_report_thread_entry(void* parameter)
+{
 	while(1)
 	{
-//		if(GPIO_ReadInputDataBit(GPIOC,GPIO_Pin_5) == 0)
-//        {
-//                       
-//            rt_thread_delay(DELAY_MS(20));
-//
-//			if(GPIO_ReadInputDataBit(GPIOC,GPIO_Pin_5) == 0)
-//	        {
-//				wifi_factory_set();
-//			}
-//		}
-
-
-
-		//wifi_factory_set();
-
-		
-		//wifi_send_data(testb,strlen(testb));
-
-		rt_thread_delay(DELAY_MS(300));
-    }
+		dev_state_wait(&wifi_report_sub, RT_WAITING_FOREVER);
 
+		return_current_device_state();
+	}
 }
 
 
@@ -553,30 +725,24 @@ int wifi_uart_init(void)
     }
     memset(wifi_uart_dev_my, 0, sizeof(struct _uart_dev_my));
     rt_sem_init(&(wifi_uart_dev_my->rx_sem), "wifirx", 0, 0);
+    rt_sem_init(&wifi_tx_done, "wifitx", 0, RT_IPC_FLAG_FIFO);
 	wifi_uart_dev_my->device = RT_NULL;
 	uart_wifi_set_device();
 
-	
-	
-	
-	wifi_uart_sem = rt_sem_create("wifi_sem",0, RT_IPC_FLAG_FIFO);  
-
 
+	/* receives and decodes, the frames are answered from this thread */
 		wifi_thread_id = rt_thread_create("wifif",rt_wifi_thread_entry, RT_NULL,
-                                   256, 8, 21);
+                                   512, 8, 21);
 	  if (wifi_thread_id != RT_NULL)
         rt_thread_startup(wifi_thread_id);
 
-    init_thread = rt_thread_create("wifidecode",rt_wifi_decode_thread_entry, RT_NULL,
+    dev_state_subscribe(&wifi_report_sub, "wifirpt",
+                        DEV_STATE_SETTINGS | DEV_STATE_BIT(DEV_STATE_FAULT), RT_NULL);
+    init_thread = rt_thread_create("wifirpt",rt_wifi_report_thread_entry, RT_NULL,
                                    512, 8, 21);
     if (init_thread != RT_NULL)
         rt_thread_startup(init_thread);
 
-    init_thread = rt_thread_create("wifiKEY",rt_wifi_key_thread_entry, RT_NULL,
-                                   256, 8, 21);
-    if (init_thread != RT_NULL)
-        rt_thread_startup(init_thread);
-
 
     return 0;
 }
@@ -704,9 +870,11 @@ void wifi_factory_set(void)
 LABLE_WF_END:		
 		rt_thread_delay(DELAY_S(1));
 
+		/* what the old thread left in the window is stale */
+		wifi_rx_head = wifi_rx_tail = 0;
 		
 		wifi_thread_id = rt_thread_create("wifif",rt_wifi_thread_entry, RT_NULL,
-										   256, 8, 21);
+										   512, 8, 21);
 			  if (wifi_thread_id != RT_NULL)
 				rt_thread_startup(wifi_thread_id);
 		
@@ -0,0 +1,329 @@
+/*
+ * File      : para_store.c
+ * log-structured parameter store on the SPI NOR flash
+ *
+ * Parameters are saved as CRC checked key/value records appended to a
+ * ring of flash sectors, so a save costs a page program and no erase.
+ * A RAM index of the latest record of every key is built at boot.
+ *
+ * Every sector starts with a header holding a sequence number, the sector
+ * with the highest one is where records are appended. When it is full the
+ * next sector of the ring is erased and becomes the active one. The sector
+ * after that is then evacuated: its live records are copied into the new
+ * active sector, so when the ring comes round to it, it can be erased
+ * without losing anything. A copy always exists before an erase, a power
+ * cut at any point leaves either the old or the new record readable.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+
+#include <rtthread.h>
+
+#include "bsp_spi_flash.h"
+#include "para_store.h"
+
+#define PARA_SECTOR_MAGIC       0x41524150UL    /* "PARA" */
+
+struct para_sector_header
+{
+    rt_uint32_t magic;
+    rt_uint32_t seq;
+};
+
+/* len goes first: once it is programmed the extent of the record is known */
+struct para_record_header
+{
+    rt_uint8_t  len;                            /* 0xff: free space */
+    rt_uint8_t  key;
+    rt_uint16_t crc;                            /* over key, len and value */
+};
+
+#define PARA_HDR_SIZE           sizeof(struct para_sector_header)
+/* header, value, then a commit byte programmed once the rest is written */
+#define PARA_REC_SIZE(len)      (sizeof(struct para_record_header) + (len) + 1)
+#define PARA_COMMIT             0x00
+
+struct para_index
+{
+    rt_uint32_t addr;                           /* 0: key never written */
+    rt_uint8_t  len;
+};
+
+static struct para_index para_index[PARA_KEY_MAX];
+static rt_uint8_t  para_active;
+static rt_uint32_t para_seq;
+static rt_uint32_t para_write_off;
+static struct rt_mutex para_lock;
+
+#define PARA_SECTOR_ADDR(n)     (PARA_STORE_ADDR + (rt_uint32_t)(n) * PARA_STORE_SECTOR_SIZE)
+#define PARA_ADDR_SECTOR(a)     (((a) - PARA_STORE_ADDR) / PARA_STORE_SECTOR_SIZE)
+
+static rt_uint16_t para_crc16(rt_uint16_t crc, const rt_uint8_t *buf, rt_size_t len)
+{
+    rt_uint8_t i;
+
+    while (len--)
+    {
+        crc ^= *buf++;
+        for (i = 0; i < 8; i++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+    }
+
+    return crc;
+}
+
+static rt_uint16_t para_record_crc(rt_uint8_t key, const rt_uint8_t *value, rt_uint8_t len)
+{
+    rt_uint8_t head[2];
+
+    head[0] = key;
+    head[1] = len;
+
+    return para_crc16(para_crc16(0xFFFF, head, 2), value, len);
+}
+
+/* append one record to the active sector, the caller checked the room */
+static void para_append(rt_uint8_t key, const rt_uint8_t *value, rt_uint8_t len)
+{
+    rt_uint8_t record[PARA_REC_SIZE(PARA_VALUE_MAX)];
+    struct para_record_header *head;
+    rt_uint32_t addr;
+    rt_uint8_t commit = PARA_COMMIT;
+
+    head = (struct para_record_header *)record;
+    head->len = len;
+    head->key = key;
+    head->crc = para_record_crc(key, value, len);
+    rt_memcpy(record + sizeof(*head), value, len);
+
+    addr = PARA_SECTOR_ADDR(para_active) + para_write_off;
+    SPI_FLASH_BufferWrite(record, addr, PARA_REC_SIZE(len) - 1);
+    SPI_FLASH_BufferWrite(&commit, addr + PARA_REC_SIZE(len) - 1, 1);
+    para_write_off += PARA_REC_SIZE(len);
+
+    para_index[key].addr = addr;
+    para_index[key].len  = len;
+}
+
+/* copy the live records of a sector into the active one */
+static void para_evacuate(rt_uint8_t sector)
+{
+    rt_uint8_t key;
+    rt_uint8_t value[PARA_VALUE_MAX];
+
+    for (key = 0; key < PARA_KEY_MAX; key++)
+    {
+        if (para_index[key].addr == 0 ||
+            PARA_ADDR_SECTOR(para_index[key].addr) != sector)
+            continue;
+
+        SPI_FLASH_BufferRead(value, para_index[key].addr + sizeof(struct para_record_header),
+                             para_index[key].len);
+        para_append(key, value, para_index[key].len);
+    }
+}
+
+static void para_format(rt_uint8_t sector, rt_uint32_t seq)
+{
+    struct para_sector_header header;
+
+    SPI_FLASH_SectorErase(PARA_SECTOR_ADDR(sector));
+
+    /* sequence first, the magic makes the sector valid only once it is there */
+    header.magic = PARA_SECTOR_MAGIC;
+    header.seq   = seq;
+    SPI_FLASH_BufferWrite((u8 *)&header.seq,
+                          PARA_SECTOR_ADDR(sector) + sizeof(header.magic), sizeof(header.seq));
+    SPI_FLASH_BufferWrite((u8 *)&header.magic, PARA_SECTOR_ADDR(sector), sizeof(header.magic));
+
+    para_active    = sector;
+    para_seq       = seq;
+    para_write_off = PARA_HDR_SIZE;
+}
+
+/* move on to the next sector of the ring */
+static void para_rotate(void)
+{
+    para_format((para_active + 1) % PARA_STORE_SECTOR_NUM, para_seq + 1);
+    para_evacuate((para_active + 1) % PARA_STORE_SECTOR_NUM);
+}
+
+static rt_bool_t para_sector_live(rt_uint8_t sector)
+{
+    rt_uint8_t key;
+
+    for (key = 0; key < PARA_KEY_MAX; key++)
+    {
+        if (para_index[key].addr != 0 &&
+            PARA_ADDR_SECTOR(para_index[key].addr) == sector)
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+/*
+ * The active sector was closed by a torn record. Gather every live record
+ * into a sector that holds none, which leaves all the others free of live
+ * records and the ring consistent again.
+ */
+static void para_recover(void)
+{
+    rt_uint8_t i, target;
+
+    target = (para_active + 1) % PARA_STORE_SECTOR_NUM;
+    for (i = 0; i < PARA_STORE_SECTOR_NUM && para_sector_live(target); i++)
+        target = (target + 1) % PARA_STORE_SECTOR_NUM;
+
+    para_format(target, para_seq + 1);
+    for (i = 0; i < PARA_STORE_SECTOR_NUM; i++)
+    {
+        if (i != target)
+            para_evacuate(i);
+    }
+}
+
+/* add the records of one sector to the index, return the end of its log */
+static rt_uint32_t para_scan(rt_uint8_t sector)
+{
+    struct para_record_header head;
+    rt_uint8_t value[PARA_VALUE_MAX + 1];
+    rt_uint32_t base, off;
+
+    base = PARA_SECTOR_ADDR(sector);
+    off  = PARA_HDR_SIZE;
+
+    while (off + sizeof(head) <= PARA_STORE_SECTOR_SIZE)
+    {
+        SPI_FLASH_BufferRead((u8 *)&head, base + off, sizeof(head));
+        if (head.len == 0xFF)
+            return off;
+
+        /* length is unusable, nothing after it can be trusted */
+        if (head.len > PARA_VALUE_MAX ||
+            off + PARA_REC_SIZE(head.len) > PARA_STORE_SECTOR_SIZE)
+            break;
+
+        /* a record torn by a power cut is skipped */
+        SPI_FLASH_BufferRead(value, base + off + sizeof(head), head.len + 1);
+        if (head.key < PARA_KEY_MAX && value[head.len] == PARA_COMMIT &&
+            para_record_crc(head.key, value, head.len) == head.crc)
+        {
+            para_index[head.key].addr = base + off;
+            para_index[head.key].len  = head.len;
+        }
+        off += PARA_REC_SIZE(head.len);
+    }
+
+    return PARA_STORE_SECTOR_SIZE;
+}
+
+int para_store_init(void)
+{
+    struct para_sector_header header[PARA_STORE_SECTOR_NUM];
+    rt_uint8_t i, count, next;
+    rt_uint32_t seq, end;
+
+    rt_mutex_init(&para_lock, "para", RT_IPC_FLAG_FIFO);
+    rt_memset(para_index, 0, sizeof(para_index));
+
+    count = 0;
+    for (i = 0; i < PARA_STORE_SECTOR_NUM; i++)
+    {
+        SPI_FLASH_BufferRead((u8 *)&header[i], PARA_SECTOR_ADDR(i), sizeof(header[i]));
+        if (header[i].magic == PARA_SECTOR_MAGIC)
+            count++;
+    }
+
+    if (count == 0)
+    {
+        para_format(0, 1);
+        return 0;
+    }
+
+    /* replay the sectors oldest first, newer records override older ones */
+    seq = 0;
+    while (count--)
+    {
+        next = PARA_STORE_SECTOR_NUM;
+        for (i = 0; i < PARA_STORE_SECTOR_NUM; i++)
+        {
+            if (header[i].magic != PARA_SECTOR_MAGIC || header[i].seq < seq)
+                continue;
+            if (next == PARA_STORE_SECTOR_NUM || header[i].seq < header[next].seq)
+                next = i;
+        }
+
+        end = para_scan(next);
+        para_active    = next;
+        para_seq       = header[next].seq;
+        para_write_off = end;
+
+        seq = header[next].seq + 1;
+        header[next].magic = 0;
+    }
+
+    if (para_write_off == PARA_STORE_SECTOR_SIZE)
+    {
+        para_recover();
+        return 0;
+    }
+
+    /*
+     * finish an evacuation a power cut may have interrupted, it started
+     * right after the sector was formatted so the records still fit
+     */
+    para_evacuate((para_active + 1) % PARA_STORE_SECTOR_NUM);
+
+    return 0;
+}
+
+rt_err_t para_store_write(rt_uint8_t key, const void *buf, rt_uint8_t len)
+{
+    rt_uint8_t value[PARA_VALUE_MAX];
+
+    if (key >= PARA_KEY_MAX || len > PARA_VALUE_MAX)
+        return -RT_ERROR;
+
+    rt_mutex_take(&para_lock, RT_WAITING_FOREVER);
+
+    /* unchanged, don't wear the flash */
+    if (para_index[key].addr != 0 && para_index[key].len == len)
+    {
+        SPI_FLASH_BufferRead(value, para_index[key].addr + sizeof(struct para_record_header), len);
+        if (rt_memcmp(value, buf, len) == 0)
+        {
+            rt_mutex_release(&para_lock);
+            return RT_EOK;
+        }
+    }
+
+    /* keep room for a full evacuation in every sector */
+    if (para_write_off + PARA_REC_SIZE(len) +
+        PARA_KEY_MAX * PARA_REC_SIZE(PARA_VALUE_MAX) > PARA_STORE_SECTOR_SIZE)
+        para_rotate();
+
+    para_append(key, (const rt_uint8_t *)buf, len);
+
+    rt_mutex_release(&para_lock);
+
+    return RT_EOK;
+}
+
+int para_store_read(rt_uint8_t key, void *buf, rt_uint8_t len)
+{
+    if (key >= PARA_KEY_MAX || para_index[key].addr == 0)
+        return 0;
+
+    rt_mutex_take(&para_lock, RT_WAITING_FOREVER);
+
+    if (len > para_index[key].len)
+        len = para_index[key].len;
+    SPI_FLASH_BufferRead(buf, para_index[key].addr + sizeof(struct para_record_header), len);
+
+    rt_mutex_release(&para_lock);
+
+    return len;
+}
@@ -0,0 +1,29 @@
+/*
+ * File      : para_store.h
+ * log-structured parameter store on the SPI NOR flash
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       first version
+ */
+#ifndef __PARA_STORE_H__
+#define __PARA_STORE_H__
+
+#include <rtthread.h>
+
+/* flash area, in 4KB sectors, right after the legacy parameter sector */
+#define PARA_STORE_ADDR             0x1000
+#define PARA_STORE_SECTOR_SIZE      4096
+#define PARA_STORE_SECTOR_NUM       4
+
+#define PARA_KEY_MAX                16
+#define PARA_VALUE_MAX              32
+
+/* keys */
+#define PARA_KEY_WORK_STATE         0x01    /* first six bytes of device_work_data */
+
+int  para_store_init(void);
+rt_err_t para_store_write(rt_uint8_t key, const void *buf, rt_uint8_t len);
+int  para_store_read(rt_uint8_t key, void *buf, rt_uint8_t len);
+
+#endif
@@ -552,13 +552,25 @@ void Keyboard_camera_porotocol_2(void)
 
 uchar command_analysis(void) //return 1,when received a correct command,or,return 0
 {
-	uchar value = 0;
+	//the frames are taken out of the ring a batch at a time, and analysed one per call
+	static u8 frames[QUEUE_BATCH][QUEUE_FRAME_SIZE];
+	static u8 frame_num = 0;
+	static u8 frame_pos = 0;
+	u8 i;
 
-	if (1 == delqueue(20,keyboard_data_buffer)) 
+	if (frame_pos >= frame_num)
 	{
-		PELCO_D_P_protocol_analysis_2();
-		value = 1;
+		frame_num = delqueue_batch(frames,QUEUE_BATCH);
+		frame_pos = 0;
+		if (frame_num == 0)
+			return 0;
 	}
 
-	return(value);
+	for (i=0; i<QUEUE_FRAME_SIZE; i++)
+		keyboard_data_buffer[i] = frames[frame_pos][i];
+	frame_pos++;
+
+	PELCO_D_P_protocol_analysis_2();
+
+	return 1;
 }
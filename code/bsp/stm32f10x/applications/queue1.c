@@ -3,225 +3,108 @@
 #define _QUEUE1_C_
 
 
+#include <rtthread.h>
 
-#include    <locale.h>
-#include    <stdio.h>
-#include    <string.h>
-#include    <ctype.h>
-#include    <stdlib.h>
-#include    <stdarg.h>
-
-#include "malloc.h"
 #include "queue.h"
 
 
-#define	printf_s	printf
-#define	MAX_QUEUE_LIST	15
-
-#ifndef u8
-typedef unsigned char u8;
-#endif
-	
-
-signed char QueueLenght = 0;
+struct queue_ring keyboard_queue;
 
-queue_link front = NULL;      //ʼͷָ
-queue_link rear  = NULL;      //ʼβָ
-
-//
-//Ѿ2ڴ治0շ1
+//push a frame, from the receive path
+//returns 1 when queued, 2 when the ring is full and the frame dropped
 u8 addqueue(u8 dataLen,u8 *datapointer)
 {
+	u16 head = keyboard_queue.head;
+	volatile u8 *slot;
 	u8 i;
-	
-	queue_link new_node;
-
-	new_node = (queue_link) mymalloc(sizeof(queue_list));
 
-		
-	if(new_node != NULL)
+	if((u16)(head - keyboard_queue.tail) >= QUEUE_SLOTS)
 	{
-		if(QueueLenght < MAX_QUEUE_LIST)
-		{
-			for(i=0;i<dataLen;i++)
-				new_node->data[i] = datapointer[i];    //ݴ
-				
-			new_node->next = NULL;    //óֵ
-			
-			if(rear == NULL || front == NULL) //Ϊеĵһ 
-				front = rear = new_node;    //frontָ½ڵ
-			else
-				rear = rear->next = new_node;   //rearָĽڵָ½ڵ
-			
-			QueueLenght++;
-			return 1;
-		}
-		else
-		{
-			return 2;
-		}
-		
+		keyboard_queue.overflow++;
+		return 2;
 	}
-	else
-		return 0;
-}
 
+	if(dataLen > QUEUE_FRAME_SIZE)
+		dataLen = QUEUE_FRAME_SIZE;
 
-/*------------------------------------------------------------
-Ŀģ õеĳ
-ʼ QѴ
- QԪصĸ
-
-   LinkQueue Q   Q
-ֵ
-   int     Ԫصĸ
-------------------------------------------------------------*/
-int QueueLength(queue_link Q)
-{
-	int count = 0;
-
-    queue_link p;
-    p = front; //pָͷ
-    while(p->next != NULL)
-    {
-        count++;
-        p = p->next;
-    }
-    return count;
-}
+	slot = keyboard_queue.slot[head & (QUEUE_SLOTS - 1)];
+	for(i=0;i<dataLen;i++)
+		slot[i] = datapointer[i];
+	for(;i<QUEUE_FRAME_SIZE;i++)
+		slot[i] = 0;
 
+	//the slot is complete before the consumer can see it
+	keyboard_queue.head = head + 1;
 
-//
-//ݷ1ݷ0
-//type:0,ʾʽݳȡÿζȡʱᱣǰȡڻ
-//1,ʾΪʽȡݣÿζȡݺ󣬻ͬʱձȡ
-u8 delqueue_extend(u8 type,u8 dataLen,u8 *dst)
+	return 1;
+}
+
+//frames waiting in the ring
+u8 queue_length(void)
 {
-	queue_link top;
-	u8 i;
-	
-	if(front != NULL)
-	{   
+	return (u8)(keyboard_queue.head - keyboard_queue.tail);
+}
 
-		//ǷΪ
-		top   = front;     //topָfront
+//pop up to count frames, from the protocol thread
+//returns the number of frames copied to dst
+u8 delqueue_batch(u8 (*dst)[QUEUE_FRAME_SIZE],u8 count)
+{
+	u16 tail = keyboard_queue.tail;
+	u16 num = keyboard_queue.head - tail;
+	volatile u8 *slot;
+	u8 n,i;
 
-		if(type)
-			front = front->next;   //
+	if(num > count)
+		num = count;
 
-		for(i=0;i<dataLen;i++)
-			dst[i]  = top->data[i];    //ݴ
+	for(n=0;n<num;n++)
+	{
+		slot = keyboard_queue.slot[(tail + n) & (QUEUE_SLOTS - 1)];
+		for(i=0;i<QUEUE_FRAME_SIZE;i++)
+			dst[n][i] = slot[i];
+	}
 
-		if(type)
-		{
-			myfree(top);      //ͷڵ
-			QueueLenght--;
-			if(QueueLenght < 0)
-				QueueLenght = 0;
-		}
-		return 1;
+	//the slots are copied out before the producer can reuse them
+	keyboard_queue.tail = tail + num;
 
-	}
-	else
-		return 0;
+	return (u8)num;
 }
 
-
-//
-//ݷ1ݷ0
+//pop one frame
+//returns 1 with a frame, 0 when the ring is empty
 u8 delqueue(u8 dataLen,u8 *dst)
 {
-	queue_link top;
+	u8 frame[1][QUEUE_FRAME_SIZE];
 	u8 i;
-	
-	if(front != NULL)
-	{ 
-		//ǷΪ
-		top   = front;     //topָfront
-		front = front->next;   //
-
-		for(i=0;i<dataLen;i++)
-			dst[i]  = top->data[i];    //ݴ
-		myfree(top);      //ͷڵ
-
-		QueueLenght--;
-		if(QueueLenght < 0)
-			QueueLenght = 0;
-		return 1;
 
-	}
-	else
-		rear = NULL;
-	return 0;
+	if(delqueue_batch(frame,1) == 0)
+		return 0;
+
+	if(dataLen > QUEUE_FRAME_SIZE)
+		dataLen = QUEUE_FRAME_SIZE;
+	for(i=0;i<dataLen;i++)
+		dst[i] = frame[0][i];
+
+	return 1;
 }
 
 
 void queue_init(void)
 {
-	my_mem_init();
-	front = NULL;
-	rear = NULL;
-	QueueLenght = 0;
+	keyboard_queue.head = 0;
+	keyboard_queue.tail = 0;
+	keyboard_queue.overflow = 0;
 }
 
-#if 0
-//ж룬ӡ
-int debug_main(void)
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_kbd_queue(void)
 {
- int select;        //ѡ
- int  temp;
- queue_link point;
- 
- printf_s("(1)Input a data\n");
- printf_s("(2)Output a data\n");
- printf_s("(3)Exit\n");
- printf_s("Please select:");
- scanf("%d", &select);
- printf_s("\n");
- if(select != 3){
-  do{
-   switch(select){
-    case 1: printf_s("Please input the input value == >");
-     scanf("%d", &temp);
-
-	 addqueue(temp);      //ݲ
-
-	if(Keyboard_linkqueue->QueueLenght > MAX_QUEUE_LIST)
-	 	printf("The queue is full.\n");
-
-	printf_s("The content of queue:"); //
-
-	point = Keyboard_linkqueue->front;
-	while(point != NULL){
-	printf_s("[%d]", point->data);
-	point = point->next;
-     }
-     break;
-    case 2: if((temp = delqueue()) == -1) //ж϶ǷΪ
-       printf_s("The queue is empty!!!\n");
-      else{
-       printf_s("The output value is [%d]\n", temp);
-       printf_s("The content of queue:"); //
-       point = Keyboard_linkqueue->front;
-       while(point != NULL){
-        printf_s("[%d]", point->data);
-        point = point->next;
-       }
-      }
-      break;
-   }
-   printf_s("\n(1)Input a data\n");
-   printf_s("\n(2)Output a data\n");
-   printf_s("\n(3)Exit\n");
-   printf_s("Please select:");
-   scanf("%d", &select);
-   printf_s("\n");
-  }while(select != 3);
- }
- return 0;
+	rt_kprintf("keyboard frames waiting %d of %d, %d dropped\n",
+		queue_length(), QUEUE_SLOTS, keyboard_queue.overflow);
 }
-
+FINSH_FUNCTION_EXPORT(list_kbd_queue, list the keyboard frame ring)
 #endif
 
 #endif  /* _QUEUE1_C_ */
-
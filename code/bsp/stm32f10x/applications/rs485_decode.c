@@ -169,7 +169,7 @@ void pelco_rx_isr(u8 udr0)
 				for (i=0x00; i<20; i++) 
 					Rec_keyboard_data_buffer[i] = keyboard_data_buffer1[i];
 
-				addqueue(20,keyboard_data_buffer1);
+				addqueue(QUEUE_FRAME_SIZE,keyboard_data_buffer1);
 
 				for (i=0x00; i<20; i++) 
 					keyboard_data_buffer1[i] = 0x00;
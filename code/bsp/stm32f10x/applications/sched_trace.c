@@ -0,0 +1,602 @@
+/*
+ * File      : sched_trace.c
+ * scheduler trace on the DWT cycle counter
+ *
+ * The kernel hooks time stamp the thread switches, the interrupt entries
+ * and exits, the threads blocking on an IPC object and their wake up by a
+ * put on it or by a timeout, into a ring of the last SCHED_TRACE_EVENTS
+ * events. The same hooks add up the cycles of each thread and of the
+ * interrupts, and the worst time from the wake up of a thread to its run.
+ *
+ * list_sched_trace shows the statistics, sched_trace_dump writes the ring
+ * to the console for tools/trace_decode.py, which gives the timeline.
+ *
+ * The kernel fills the stack of each thread with '#' when it is created, the
+ * bytes never written since give the deepest use of the stack, shown with
+ * the runs and the run time by list_thread_stat to size the stacks.
+ *
+ * The cycle counter stops while the core sleeps in the tickless idle, so
+ * the shares are taken against the ticks passed, not against the cycles.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       first version
+ * 2026-10-17     aclean       add the thread statistics and stack depth
+ * 2026-10-17     aclean       take the clock from dwt.h, for the simulator
+ */
+#include <rthw.h>
+#include <rtthread.h>
+#include "dwt.h"
+#include "sched_trace.h"
+
+#if (SCHED_TRACE_EVENTS & (SCHED_TRACE_EVENTS - 1)) != 0
+#error "SCHED_TRACE_EVENTS is a power of two"
+#endif
+
+#define TRACE_OBJECT_ID(object)     ((rt_uint16_t)(rt_uint32_t)(object))
+
+struct sched_trace_thread
+{
+    rt_thread_t thread;             /* RT_NULL once deleted */
+    char        name[RT_NAME_MAX];
+    rt_uint8_t  priority;           /* when it blocked */
+    rt_uint8_t  waking;             /* woken up and not run yet */
+
+    rt_object_t pending;            /* the object it tries to take */
+    rt_object_t blocked;            /* the object it waits for */
+    rt_uint32_t wake_cycles;
+
+    rt_uint32_t runs;
+    rt_uint32_t worst_response;
+    unsigned long long cycles;
+};
+
+static struct sched_trace_event trace_ring[SCHED_TRACE_EVENTS];
+static rt_uint32_t trace_head;
+static rt_uint8_t  trace_enabled;
+
+static struct sched_trace_thread trace_thread[SCHED_TRACE_THREADS];
+static rt_uint8_t  trace_thread_num;
+static rt_uint8_t  trace_idle = SCHED_TRACE_NO_THREAD;
+static rt_uint8_t  trace_current = SCHED_TRACE_NO_THREAD;
+static unsigned long long trace_other_cycles;
+
+static rt_uint8_t  trace_irq_nest;
+static rt_uint32_t trace_irq_start;
+static rt_uint32_t trace_irq_count;
+static rt_uint32_t trace_irq_worst;
+static unsigned long long trace_irq_cycles;
+
+/* the cycles of the last event, and the statistics since the reset */
+static rt_uint32_t trace_last;
+static rt_tick_t   trace_tick;
+static unsigned long long trace_busy_cycles;
+
+/* what cpu_usage_get() saw the last time */
+static rt_tick_t   cpu_usage_tick;
+static unsigned long long cpu_usage_busy;
+
+static rt_uint8_t trace_thread_find(rt_thread_t thread)
+{
+    rt_uint8_t index;
+
+    for (index = 0; index < trace_thread_num; index++)
+    {
+        if (trace_thread[index].thread == thread)
+            return index;
+    }
+
+    return SCHED_TRACE_NO_THREAD;
+}
+
+static rt_uint8_t trace_thread_index(rt_thread_t thread)
+{
+    struct sched_trace_thread *st;
+    rt_uint8_t index;
+
+    index = trace_thread_find(thread);
+    if (index != SCHED_TRACE_NO_THREAD)
+        return index;
+
+    index = trace_thread_num;
+    if (index == SCHED_TRACE_THREADS)
+        return SCHED_TRACE_NO_THREAD;
+
+    st = &trace_thread[index];
+    rt_memset(st, 0, sizeof(struct sched_trace_thread));
+    st->thread = thread;
+    rt_strncpy(st->name, thread->name, RT_NAME_MAX);
+    if (rt_strncmp(thread->name, "tidle", RT_NAME_MAX) == 0)
+        trace_idle = index;
+    trace_thread_num++;
+
+    return index;
+}
+
+/* gives the cycles since the last event to whom they belong */
+static rt_uint32_t trace_account(void)
+{
+    rt_uint32_t now, delta;
+
+    now   = DWT_CYCCNT;
+    delta = now - trace_last;
+    trace_last = now;
+
+    if (trace_irq_nest > 0)
+        trace_irq_cycles += delta;
+    else if (trace_current < trace_thread_num)
+        trace_thread[trace_current].cycles += delta;
+    else
+        trace_other_cycles += delta;
+
+    if (trace_irq_nest > 0 || trace_current != trace_idle)
+        trace_busy_cycles += delta;
+
+    return now;
+}
+
+static void trace_record(rt_uint32_t cycles, rt_uint8_t type, rt_uint8_t thread, rt_uint16_t arg)
+{
+    struct sched_trace_event *event;
+
+    event = &trace_ring[trace_head & (SCHED_TRACE_EVENTS - 1)];
+    event->cycles = cycles;
+    event->type   = type;
+    event->thread = thread;
+    event->arg    = arg;
+    trace_head++;
+}
+
+/* called with the interrupt disabled */
+static void trace_switch_hook(struct rt_thread *from, struct rt_thread *to)
+{
+    struct sched_trace_thread *st;
+    rt_uint32_t now, response;
+    rt_uint8_t from_index, to_index;
+
+    if (!trace_enabled)
+        return;
+
+    /* an exiting thread is already detached, the current index still holds */
+    now = trace_account();
+    from_index = trace_current;
+    to_index   = trace_thread_index(to);
+
+    if (from_index != SCHED_TRACE_NO_THREAD && from->stat == RT_THREAD_SUSPEND)
+    {
+        st = &trace_thread[from_index];
+        st->blocked  = st->pending;
+        st->priority = from->current_priority;
+        st->waking   = 0;
+        trace_record(now, SCHED_TRACE_BLOCK, from_index, TRACE_OBJECT_ID(st->blocked));
+    }
+
+    trace_record(now, SCHED_TRACE_SWITCH, to_index, from_index);
+
+    if (to_index != SCHED_TRACE_NO_THREAD)
+    {
+        st = &trace_thread[to_index];
+        st->runs++;
+        if (st->waking)
+        {
+            response = now - st->wake_cycles;
+            if (response > st->worst_response)
+                st->worst_response = response;
+            st->waking = 0;
+        }
+        st->pending = RT_NULL;
+        st->blocked = RT_NULL;
+    }
+
+    trace_current = to_index;
+}
+
+static void trace_irq_enter_hook(void)
+{
+    rt_uint32_t now;
+
+    if (!trace_enabled)
+        return;
+
+    now = trace_account();
+    if (trace_irq_nest++ == 0)
+        trace_irq_start = now;
+    trace_record(now, SCHED_TRACE_IRQ_ENTER, trace_current,
+                 SCB_ICSR & SCB_ICSR_VECTACTIVE);
+}
+
+static void trace_irq_leave_hook(void)
+{
+    rt_uint32_t now;
+
+    if (!trace_enabled || trace_irq_nest == 0)
+        return;
+
+    now = trace_account();
+    if (--trace_irq_nest == 0)
+    {
+        trace_irq_count++;
+        if (now - trace_irq_start > trace_irq_worst)
+            trace_irq_worst = now - trace_irq_start;
+    }
+    trace_record(now, SCHED_TRACE_IRQ_LEAVE, trace_current,
+                 SCB_ICSR & SCB_ICSR_VECTACTIVE);
+}
+
+static void trace_wake(rt_uint8_t index, rt_uint16_t arg)
+{
+    struct sched_trace_thread *st = &trace_thread[index];
+    rt_uint32_t now = DWT_CYCCNT;
+
+    if (st->waking)
+        return;
+
+    st->waking = 1;
+    st->wake_cycles = now;
+    trace_record(now, SCHED_TRACE_WAKE, index, arg);
+}
+
+static void trace_trytake_hook(struct rt_object *object)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    /* only a thread blocks */
+    if (trace_enabled && trace_irq_nest == 0 && trace_current < trace_thread_num)
+        trace_thread[trace_current].pending = object;
+    rt_hw_interrupt_enable(level);
+}
+
+static void trace_take_hook(struct rt_object *object)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (trace_enabled && trace_irq_nest == 0 && trace_current < trace_thread_num)
+        trace_thread[trace_current].pending = RT_NULL;
+    rt_hw_interrupt_enable(level);
+}
+
+static void trace_put_hook(struct rt_object *object)
+{
+    struct sched_trace_thread *st;
+    rt_uint8_t index, woken = SCHED_TRACE_NO_THREAD;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (trace_enabled)
+    {
+        /* the object wakes the waiting thread of the highest priority */
+        for (index = 0; index < trace_thread_num; index++)
+        {
+            st = &trace_thread[index];
+            if (st->blocked != object || st->waking)
+                continue;
+            if (woken == SCHED_TRACE_NO_THREAD || st->priority < trace_thread[woken].priority)
+                woken = index;
+        }
+
+        if (woken != SCHED_TRACE_NO_THREAD)
+            trace_wake(woken, TRACE_OBJECT_ID(object));
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+/* called with the interrupt disabled */
+static void trace_timeout_hook(struct rt_timer *timer)
+{
+    rt_uint8_t index;
+
+    if (!trace_enabled || timer->timeout_func != rt_thread_timeout)
+        return;
+
+    index = trace_thread_index((rt_thread_t)timer->parameter);
+    if (index != SCHED_TRACE_NO_THREAD)
+        trace_wake(index, 0);
+}
+
+/* a thread deleted keeps its statistics, but not its address */
+static void trace_detach_hook(struct rt_object *object)
+{
+    rt_uint8_t index;
+    rt_base_t level;
+
+    if ((object->type & ~RT_Object_Class_Static) != RT_Object_Class_Thread)
+        return;
+
+    level = rt_hw_interrupt_disable();
+    index = trace_thread_find((rt_thread_t)object);
+    if (index != SCHED_TRACE_NO_THREAD)
+        trace_thread[index].thread = RT_NULL;
+    rt_hw_interrupt_enable(level);
+}
+
+/* the statistics start again, the ring and the thread table are kept */
+void sched_trace_reset(void)
+{
+    struct sched_trace_thread *st;
+    rt_base_t level;
+    rt_uint8_t index;
+
+    level = rt_hw_interrupt_disable();
+
+    for (index = 0; index < trace_thread_num; index++)
+    {
+        st = &trace_thread[index];
+        st->runs = 0;
+        st->worst_response = 0;
+        st->cycles = 0;
+    }
+    trace_other_cycles = 0;
+    trace_irq_count = 0;
+    trace_irq_worst = 0;
+    trace_irq_cycles = 0;
+    trace_busy_cycles = 0;
+    trace_tick = rt_tick_get();
+    cpu_usage_tick = trace_tick;
+    cpu_usage_busy = 0;
+
+    rt_hw_interrupt_enable(level);
+}
+
+void sched_trace_init(void)
+{
+    rt_base_t level;
+
+    if (trace_enabled)
+        return;
+
+    dwt_cycles_init();
+
+    level = rt_hw_interrupt_disable();
+
+    trace_last    = DWT_CYCCNT;
+    trace_current = trace_thread_index(rt_thread_self());
+    trace_irq_nest = 0;
+
+    rt_scheduler_sethook(trace_switch_hook);
+    rt_interrupt_enter_sethook(trace_irq_enter_hook);
+    rt_interrupt_leave_sethook(trace_irq_leave_hook);
+    rt_object_trytake_sethook(trace_trytake_hook);
+    rt_object_take_sethook(trace_take_hook);
+    rt_object_put_sethook(trace_put_hook);
+    rt_timer_timeout_sethook(trace_timeout_hook);
+    rt_object_detach_sethook(trace_detach_hook);
+    trace_enabled = 1;
+
+    rt_hw_interrupt_enable(level);
+
+    sched_trace_reset();
+}
+
+/* the core cycles in a number of ticks */
+static unsigned long long trace_tick_cycles(rt_tick_t ticks)
+{
+    return (unsigned long long)ticks * (DWT_CYCCNT_HZ / RT_TICK_PER_SECOND);
+}
+
+/* the bytes of the stack below the paint, which grows down on the Cortex-M3 */
+static rt_uint32_t trace_stack_used(rt_thread_t thread)
+{
+    rt_uint8_t *ptr, *end;
+
+    ptr = (rt_uint8_t *)thread->stack_addr;
+    end = ptr + thread->stack_size;
+    while (ptr < end && *ptr == '#')
+        ptr++;
+
+    return (rt_uint32_t)(end - ptr);
+}
+
+/**
+ * This function gets the stack depth and the run statistics of a thread.
+ *
+ * @param thread the thread
+ * @param stat the statistics of the thread
+ *
+ * @return RT_EOK, or -RT_ERROR if the thread is not traced, with the stack
+ * filled in only
+ */
+rt_err_t sched_trace_stat(rt_thread_t thread, struct sched_trace_stat *stat)
+{
+    struct sched_trace_thread *st;
+    unsigned long long cycles;
+    rt_uint8_t index;
+    rt_base_t level;
+
+    RT_ASSERT(thread != RT_NULL);
+    RT_ASSERT(stat != RT_NULL);
+
+    rt_memset(stat, 0, sizeof(struct sched_trace_stat));
+    stat->stack_size     = thread->stack_size;
+    stat->stack_max_used = trace_stack_used(thread);
+
+    level = rt_hw_interrupt_disable();
+    if (trace_enabled)
+        trace_account();
+    index = trace_thread_find(thread);
+    if (index == SCHED_TRACE_NO_THREAD)
+    {
+        rt_hw_interrupt_enable(level);
+        return -RT_ERROR;
+    }
+    st = &trace_thread[index];
+    stat->runs = st->runs;
+    stat->worst_response_us = st->worst_response / (DWT_CYCCNT_HZ / 1000000);
+    cycles = st->cycles;
+    rt_hw_interrupt_enable(level);
+
+    stat->run_ms = (rt_uint32_t)(cycles / (DWT_CYCCNT_HZ / 1000));
+
+    return RT_EOK;
+}
+
+void cpu_usage_init(void)
+{
+    sched_trace_init();
+}
+
+/* the share of the time not spent in the idle thread since the last call */
+void cpu_usage_get(rt_uint8_t *major, rt_uint8_t *minor)
+{
+    unsigned long long busy, total;
+    rt_uint32_t usage;
+    rt_tick_t tick;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    trace_account();
+    tick = rt_tick_get();
+    busy  = trace_busy_cycles - cpu_usage_busy;
+    total = trace_tick_cycles(tick - cpu_usage_tick);
+    cpu_usage_busy = trace_busy_cycles;
+    cpu_usage_tick = tick;
+    rt_hw_interrupt_enable(level);
+
+    /* in hundredths of a percent */
+    usage = total ? (rt_uint32_t)(busy * 10000 / total) : 0;
+    if (usage > 10000)
+        usage = 10000;
+
+    *major = usage / 100;
+    *minor = usage % 100;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+/* per mille of the time since the reset */
+static rt_uint32_t trace_share(unsigned long long cycles, unsigned long long total)
+{
+    return total ? (rt_uint32_t)(cycles * 1000 / total) : 0;
+}
+
+void list_sched_trace(void)
+{
+    struct sched_trace_thread *st;
+    unsigned long long total;
+    rt_uint32_t share, us;
+    rt_uint8_t index;
+    rt_base_t level;
+
+    if (!trace_enabled)
+    {
+        rt_kprintf("trace not started\n");
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    trace_account();
+    rt_hw_interrupt_enable(level);
+
+    total = trace_tick_cycles(rt_tick_get() - trace_tick);
+    us    = DWT_CYCCNT_HZ / 1000000;
+
+    rt_kprintf("%d ticks, %d events\n", rt_tick_get() - trace_tick, trace_head);
+    rt_kprintf("thread     runs  share  worst wake to run us\n");
+    rt_kprintf("-------- ------ ------ --------------------\n");
+    for (index = 0; index < trace_thread_num; index++)
+    {
+        st = &trace_thread[index];
+        share = trace_share(st->cycles, total);
+        rt_kprintf("%-8.*s %6d %3d.%d%% %20d\n", RT_NAME_MAX, st->name,
+                   st->runs, share / 10, share % 10, st->worst_response / us);
+    }
+    share = trace_share(trace_other_cycles, total);
+    rt_kprintf("%-8.*s %6s %3d.%d%%\n", RT_NAME_MAX, "(others)", "",
+               share / 10, share % 10);
+    share = trace_share(trace_irq_cycles, total);
+    rt_kprintf("%-8.*s %6d %3d.%d%% %20d\n", RT_NAME_MAX, "(irq)",
+               trace_irq_count, share / 10, share % 10, trace_irq_worst / us);
+}
+FINSH_FUNCTION_EXPORT(list_sched_trace, list thread cpu share and worst response)
+FINSH_FUNCTION_EXPORT_ALIAS(sched_trace_reset, trace_reset, start the trace statistics again)
+
+void list_thread_stat(void)
+{
+    struct rt_object_information *information;
+    struct sched_trace_stat stat;
+    struct rt_list_node *node;
+    struct rt_thread *thread;
+    rt_uint32_t unused = 0;
+
+    information = rt_object_get_information(RT_Object_Class_Thread);
+
+    rt_kprintf("thread   stack  max used    runs   run ms\n");
+    rt_kprintf("-------- ----- --------- ------- --------\n");
+    rt_enter_critical();
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node = node->next)
+    {
+        thread = rt_list_entry(node, struct rt_thread, list);
+        if (sched_trace_stat(thread, &stat) == RT_EOK)
+            rt_kprintf("%-8.*s %5d %5d %2d%% %7d %8d\n", RT_NAME_MAX, thread->name,
+                       stat.stack_size, stat.stack_max_used,
+                       stat.stack_max_used * 100 / stat.stack_size, stat.runs, stat.run_ms);
+        else
+            rt_kprintf("%-8.*s %5d %5d %2d%% %7s %8s\n", RT_NAME_MAX, thread->name,
+                       stat.stack_size, stat.stack_max_used,
+                       stat.stack_max_used * 100 / stat.stack_size, "-", "-");
+        unused += stat.stack_size - stat.stack_max_used;
+    }
+    rt_exit_critical();
+    rt_kprintf("%d bytes of stack never used\n", unused);
+}
+FINSH_FUNCTION_EXPORT(list_thread_stat, list thread stack depth runs and run time)
+
+/* writes the ring for tools/trace_decode.py, the trace stops meanwhile */
+void sched_trace_dump(void)
+{
+    struct rt_object_information *information;
+    struct sched_trace_event *event;
+    struct rt_object *object;
+    struct rt_list_node *node;
+    rt_uint32_t first, index;
+    rt_base_t level;
+    int type;
+
+    if (!trace_enabled)
+    {
+        rt_kprintf("trace not started\n");
+        return;
+    }
+    trace_enabled = 0;
+
+    first = trace_head > SCHED_TRACE_EVENTS ? trace_head - SCHED_TRACE_EVENTS : 0;
+
+    rt_kprintf("#trace %d %d %d %d\n", DWT_CYCCNT_HZ, RT_TICK_PER_SECOND,
+               trace_head - first, first);
+    for (index = 0; index < trace_thread_num; index++)
+    {
+        rt_kprintf("#thread %d %.*s\n", index, RT_NAME_MAX, trace_thread[index].name);
+    }
+    for (type = 0; type < RT_Object_Class_Unknown; type++)
+    {
+        information = rt_object_get_information((enum rt_object_class_type)type);
+        for (node = information->object_list.next;
+             node != &(information->object_list);
+             node = node->next)
+        {
+            object = rt_list_entry(node, struct rt_object, list);
+            rt_kprintf("#object %04x %.*s\n", TRACE_OBJECT_ID(object),
+                       RT_NAME_MAX, object->name);
+        }
+    }
+    for (index = first; index != trace_head; index++)
+    {
+        event = &trace_ring[index & (SCHED_TRACE_EVENTS - 1)];
+        rt_kprintf("%08x %d %d %04x\n", event->cycles, event->type,
+                   event->thread, event->arg);
+    }
+    rt_kprintf("#end\n");
+
+    /* the time of the dump is not accounted */
+    level = rt_hw_interrupt_disable();
+    trace_last    = DWT_CYCCNT;
+    trace_current = trace_thread_index(rt_thread_self());
+    trace_enabled = 1;
+    rt_hw_interrupt_enable(level);
+}
+FINSH_FUNCTION_EXPORT(sched_trace_dump, write the trace ring for the host decoder)
+#endif
@@ -0,0 +1,63 @@
+/*
+ * File      : sched_trace.h
+ * scheduler trace on the DWT cycle counter
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       first version
+ * 2026-10-17     aclean       add the thread statistics and stack depth
+ */
+#ifndef __SCHED_TRACE_H__
+#define __SCHED_TRACE_H__
+
+#include <rtthread.h>
+
+/* events kept in the ring, a power of two */
+#ifndef SCHED_TRACE_EVENTS
+#define SCHED_TRACE_EVENTS          256
+#endif
+/* threads with statistics of their own, the others are counted together */
+#ifndef SCHED_TRACE_THREADS
+#define SCHED_TRACE_THREADS         20
+#endif
+
+/*
+ * The event types. The thread is an index in the thread table, the argument
+ * the low half of the object address for the IPC events, which is unique
+ * in the SRAM, and the exception number for the interrupt ones.
+ */
+#define SCHED_TRACE_SWITCH          1   /* thread switched to, arg: from */
+#define SCHED_TRACE_IRQ_ENTER       2   /* thread interrupted, arg: exception */
+#define SCHED_TRACE_IRQ_LEAVE       3   /* thread interrupted, arg: exception */
+#define SCHED_TRACE_BLOCK           4   /* arg: object waited for, 0 for none */
+#define SCHED_TRACE_WAKE            5   /* arg: object put, 0 for a timeout */
+
+/* the index of the threads out of the table */
+#define SCHED_TRACE_NO_THREAD       0xff
+
+struct sched_trace_event
+{
+    rt_uint32_t cycles;
+    rt_uint8_t  type;
+    rt_uint8_t  thread;
+    rt_uint16_t arg;
+};
+
+/* what a thread used since the reset of the trace, see sched_trace_stat() */
+struct sched_trace_stat
+{
+    rt_uint32_t stack_size;
+    rt_uint32_t stack_max_used;     /* the deepest ever, from the paint */
+    rt_uint32_t runs;
+    rt_uint32_t run_ms;
+    rt_uint32_t worst_response_us;  /* from the wake up to the run */
+};
+
+void sched_trace_init(void);
+void sched_trace_reset(void);
+rt_err_t sched_trace_stat(rt_thread_t thread, struct sched_trace_stat *stat);
+
+void cpu_usage_init(void);
+void cpu_usage_get(rt_uint8_t *major, rt_uint8_t *minor);
+
+#endif
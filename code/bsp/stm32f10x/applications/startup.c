@@ -89,6 +89,9 @@ void rtthread_startup(void)
     /* init timer thread */
     rt_system_timer_thread_init();
 
+    /* init tasklet thread */
+    rt_system_tasklet_init();
+
     /* init application */
     rt_application_init();
 
@@ -0,0 +1,585 @@
+/*
+ * File      : ts_store.c
+ * room PM2.5/CO2 history on the SPI NOR flash
+ *
+ * The room readings are averaged per minute, the minutes are rolled up
+ * into 15 minute and hourly buckets as they come. Every level is a ring of
+ * flash sectors written a page at a time: samples are collected in a RAM
+ * copy of the page and it is programmed once, when the next sample does
+ * not fit. A page holds consecutive samples, each channel stored as the
+ * zigzag varint of its change since the sample before, so a steady room
+ * costs a byte per channel and a page covers about 20 samples.
+ *
+ * The RAM pages are lost on a power cut. The rollup levels are rebuilt
+ * from the minutes at boot, so what is lost is the last page of minutes.
+ * Flash pages carry a CRC, a torn one is skipped.
+ *
+ * The levels take 352 sectors behind TS_STORE_ADDR, up to 0x165000: the
+ * full layout needs a 2MB part. The size is read from the JEDEC id at
+ * init; on a smaller part the minutes get what is left, and with less than
+ * TS_1MIN_SECTORS_MIN for them, or an unknown part, there is no history.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       first version
+ * 2026-10-17     aclean       fit the levels to the flash size
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+
+#include "bsp_spi_flash.h"
+#include "ts_store.h"
+
+#ifndef TS_MINUTE_TICKS
+#define TS_MINUTE_TICKS         (60 * RT_TICK_PER_SECOND)
+#endif
+
+/* size of the levels, in sectors: 57 days of minutes, 2 years of hours */
+#define TS_1MIN_SECTORS         256
+#define TS_15MIN_SECTORS        64
+#define TS_1H_SECTORS           32
+/* 3.5 days of minutes */
+#define TS_1MIN_SECTORS_MIN     16
+
+#define TS_TIME_NONE            0xFFFFFFFFUL
+
+struct ts_page_header
+{
+    rt_uint16_t crc;                            /* over the rest of the page header and samples */
+    rt_uint8_t  count;
+    rt_uint8_t  len;                            /* of the encoded samples */
+    rt_uint32_t time;                           /* first sample, 0xffffffff: free page */
+};
+
+#define TS_HDR_SIZE             sizeof(struct ts_page_header)
+#define TS_PAYLOAD_SIZE         (TS_STORE_PAGE_SIZE - TS_HDR_SIZE)
+/* a change of a 16 bit value takes 3 bytes at most */
+#define TS_SAMPLE_MAX           (TS_CHANNEL_NUM * 3)
+
+struct ts_level
+{
+    rt_uint32_t addr;
+    rt_uint16_t sectors;
+    rt_uint16_t period;                         /* in minutes */
+
+    rt_uint32_t head;                           /* offset of the next page to program */
+    rt_uint32_t last;                           /* newest sample, TS_TIME_NONE: empty */
+
+    /* the page being filled, header first */
+    rt_uint8_t  page[TS_STORE_PAGE_SIZE];
+    rt_uint16_t prev[TS_CHANNEL_NUM];
+
+    /* bucket being rolled up from the minutes */
+    rt_uint32_t bucket;
+    rt_uint16_t minutes;
+    rt_uint16_t cnt[TS_CHANNEL_NUM];
+    rt_uint32_t sum[TS_CHANNEL_NUM];
+};
+
+/* one after the other from TS_STORE_ADDR, placed by ts_store_init() */
+static struct ts_level ts_level[TS_LEVEL_NUM] =
+{
+    {0, TS_1MIN_SECTORS,  1},
+    {0, TS_15MIN_SECTORS, 15},
+    {0, TS_1H_SECTORS,    60},
+};
+static rt_bool_t ts_enabled = RT_FALSE;
+
+/* readings of the current minute, added to by the bus thread */
+static rt_uint32_t ts_sum[TS_CHANNEL_NUM];
+static rt_uint16_t ts_cnt[TS_CHANNEL_NUM];
+
+static rt_uint32_t ts_now;
+static struct rt_mutex ts_lock;
+/* flash pages are read in here, under the lock */
+static rt_uint8_t ts_read_buf[TS_STORE_PAGE_SIZE];
+
+#define TS_LEVEL_SIZE(lv)       ((rt_uint32_t)(lv)->sectors * TS_STORE_SECTOR_SIZE)
+#define TS_PAGE_HEADER(page)    ((struct ts_page_header *)(page))
+
+static rt_uint16_t ts_crc16(rt_uint16_t crc, const rt_uint8_t *buf, rt_size_t len)
+{
+    rt_uint8_t i;
+
+    while (len--)
+    {
+        crc ^= *buf++;
+        for (i = 0; i < 8; i++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+    }
+
+    return crc;
+}
+
+static rt_uint16_t ts_page_crc(const rt_uint8_t *page)
+{
+    return ts_crc16(ts_crc16(0xFFFF, page + sizeof(rt_uint16_t), TS_HDR_SIZE - sizeof(rt_uint16_t)),
+                    page + TS_HDR_SIZE, TS_PAGE_HEADER(page)->len);
+}
+
+static rt_bool_t ts_page_valid(const rt_uint8_t *page)
+{
+    struct ts_page_header *hdr = TS_PAGE_HEADER(page);
+
+    return hdr->time != TS_TIME_NONE && hdr->count != 0 &&
+           hdr->len <= TS_PAYLOAD_SIZE && ts_page_crc(page) == hdr->crc;
+}
+
+static rt_bool_t ts_page_erased(const rt_uint8_t *page)
+{
+    rt_uint16_t i;
+
+    for (i = 0; i < TS_STORE_PAGE_SIZE; i++)
+    {
+        if (page[i] != 0xFF)
+            return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+
+/* encode the change of every channel, return the length */
+static rt_uint8_t ts_encode(rt_uint8_t *out, const rt_uint16_t *value, const rt_uint16_t *prev)
+{
+    rt_uint8_t ch, n = 0;
+    rt_int32_t delta;
+    rt_uint32_t zz;
+
+    for (ch = 0; ch < TS_CHANNEL_NUM; ch++)
+    {
+        delta = (rt_int32_t)value[ch] - prev[ch];
+        zz = ((rt_uint32_t)delta << 1) ^ (rt_uint32_t)(delta >> 31);
+        while (zz >= 0x80)
+        {
+            out[n++] = (rt_uint8_t)zz | 0x80;
+            zz >>= 7;
+        }
+        out[n++] = (rt_uint8_t)zz;
+    }
+
+    return n;
+}
+
+/* hand the samples of a page within [from, to] to cb, RT_FALSE: stop */
+static rt_bool_t ts_page_replay(const rt_uint8_t *page, rt_uint16_t period,
+                                rt_uint32_t from, rt_uint32_t to,
+                                ts_store_cb cb, void *parameter, int *count)
+{
+    struct ts_page_header *hdr = TS_PAGE_HEADER(page);
+    rt_uint16_t value[TS_CHANNEL_NUM];
+    rt_uint16_t pos, end;
+    rt_uint32_t zz, time;
+    rt_uint8_t i, ch, byte, shift;
+
+    rt_memset(value, 0, sizeof(value));
+    pos = TS_HDR_SIZE;
+    end = TS_HDR_SIZE + hdr->len;
+
+    for (i = 0; i < hdr->count; i++)
+    {
+        for (ch = 0; ch < TS_CHANNEL_NUM; ch++)
+        {
+            zz = 0;
+            shift = 0;
+            do
+            {
+                if (pos >= end)
+                    return RT_TRUE;
+                byte = page[pos++];
+                zz |= (rt_uint32_t)(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+
+            value[ch] += (rt_uint16_t)((zz >> 1) ^ (0 - (zz & 1)));
+        }
+
+        time = hdr->time + (rt_uint32_t)i * period;
+        if (time > to)
+            return RT_FALSE;
+        if (time < from)
+            continue;
+
+        (*count)++;
+        if (!cb(time, value, parameter))
+            return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+
+/* program the RAM page, the sector is erased when the ring enters it */
+static void ts_level_flush(struct ts_level *lv)
+{
+    struct ts_page_header *hdr = TS_PAGE_HEADER(lv->page);
+
+    if (hdr->count == 0)
+        return;
+
+    hdr->crc = ts_page_crc(lv->page);
+
+    if (lv->head % TS_STORE_SECTOR_SIZE == 0)
+        SPI_FLASH_SectorErase(lv->addr + lv->head);
+    SPI_FLASH_BufferWrite(lv->page, lv->addr + lv->head, TS_HDR_SIZE + hdr->len);
+    lv->head = (lv->head + TS_STORE_PAGE_SIZE) % TS_LEVEL_SIZE(lv);
+
+    hdr->count = 0;
+    hdr->len   = 0;
+    rt_memset(lv->prev, 0, sizeof(lv->prev));
+}
+
+static void ts_level_append(struct ts_level *lv, rt_uint32_t time, const rt_uint16_t *value)
+{
+    struct ts_page_header *hdr = TS_PAGE_HEADER(lv->page);
+    rt_uint8_t sample[TS_SAMPLE_MAX];
+    rt_uint8_t n;
+
+    /* a page holds consecutive samples only */
+    if (hdr->count != 0 &&
+        (time != hdr->time + (rt_uint32_t)hdr->count * lv->period || hdr->count == 0xFF))
+        ts_level_flush(lv);
+
+    n = ts_encode(sample, value, lv->prev);
+    if (hdr->len + n > TS_PAYLOAD_SIZE)
+    {
+        ts_level_flush(lv);
+        n = ts_encode(sample, value, lv->prev);
+    }
+
+    if (hdr->count == 0)
+        hdr->time = time;
+    rt_memcpy(lv->page + TS_HDR_SIZE + hdr->len, sample, n);
+    hdr->len += n;
+    hdr->count++;
+
+    rt_memcpy(lv->prev, value, sizeof(lv->prev));
+    lv->last = time;
+}
+
+static void ts_level_close(struct ts_level *lv)
+{
+    rt_uint16_t value[TS_CHANNEL_NUM];
+    rt_uint8_t ch;
+
+    for (ch = 0; ch < TS_CHANNEL_NUM; ch++)
+    {
+        value[ch] = lv->cnt[ch] ? (lv->sum[ch] + lv->cnt[ch] / 2) / lv->cnt[ch] : TS_VALUE_NONE;
+        lv->sum[ch] = 0;
+        lv->cnt[ch] = 0;
+    }
+    lv->minutes = 0;
+
+    ts_level_append(lv, lv->bucket, value);
+}
+
+/* add a minute to the bucket, it is closed with its last minute */
+static void ts_level_rollup(struct ts_level *lv, rt_uint32_t time, const rt_uint16_t *value)
+{
+    rt_uint32_t bucket = time - time % lv->period;
+    rt_uint8_t ch;
+
+    /* the end of the bucket was lost in a power cut */
+    if (lv->minutes != 0 && bucket != lv->bucket)
+        ts_level_close(lv);
+
+    lv->bucket = bucket;
+    lv->minutes++;
+    for (ch = 0; ch < TS_CHANNEL_NUM; ch++)
+    {
+        if (value[ch] == TS_VALUE_NONE)
+            continue;
+        lv->sum[ch] += value[ch];
+        lv->cnt[ch]++;
+    }
+
+    if ((time + 1) % lv->period == 0)
+        ts_level_close(lv);
+}
+
+static int ts_level_query(struct ts_level *lv, rt_uint32_t from, rt_uint32_t to,
+                          ts_store_cb cb, void *parameter)
+{
+    struct ts_page_header *hdr = TS_PAGE_HEADER(ts_read_buf);
+    rt_uint32_t off, i;
+    int count = 0;
+
+    /* oldest page first, that is the one the ring overwrites next */
+    for (i = 0, off = lv->head; i < TS_LEVEL_SIZE(lv);
+         i += TS_STORE_PAGE_SIZE, off = (off + TS_STORE_PAGE_SIZE) % TS_LEVEL_SIZE(lv))
+    {
+        SPI_FLASH_BufferRead(ts_read_buf, lv->addr + off, TS_HDR_SIZE);
+        if (hdr->time == TS_TIME_NONE || hdr->count == 0 || hdr->time > to ||
+            hdr->time + (rt_uint32_t)(hdr->count - 1) * lv->period < from)
+            continue;
+
+        SPI_FLASH_BufferRead(ts_read_buf, lv->addr + off, TS_STORE_PAGE_SIZE);
+        if (!ts_page_valid(ts_read_buf))
+            continue;
+
+        if (!ts_page_replay(ts_read_buf, lv->period, from, to, cb, parameter, &count))
+            return count;
+    }
+
+    /* and what is not on the flash yet */
+    if (TS_PAGE_HEADER(lv->page)->count != 0)
+        ts_page_replay(lv->page, lv->period, from, to, cb, parameter, &count);
+
+    return count;
+}
+
+/* find the write position: behind the newest page of the newest sector */
+static void ts_level_scan(struct ts_level *lv)
+{
+    struct ts_page_header *hdr = TS_PAGE_HEADER(ts_read_buf);
+    rt_uint32_t off, newest = 0;
+    rt_uint16_t sector, best;
+
+    lv->head = 0;
+    lv->last = TS_TIME_NONE;
+
+    best = lv->sectors;
+    for (sector = 0; sector < lv->sectors; sector++)
+    {
+        SPI_FLASH_BufferRead(ts_read_buf, lv->addr + (rt_uint32_t)sector * TS_STORE_SECTOR_SIZE,
+                             TS_STORE_PAGE_SIZE);
+        if (ts_page_valid(ts_read_buf) && (best == lv->sectors || hdr->time > newest))
+        {
+            best = sector;
+            newest = hdr->time;
+        }
+    }
+
+    if (best == lv->sectors)
+        return;
+
+    /* a torn page is not free, the next one is */
+    for (off = (rt_uint32_t)best * TS_STORE_SECTOR_SIZE;
+         off < (rt_uint32_t)(best + 1) * TS_STORE_SECTOR_SIZE; off += TS_STORE_PAGE_SIZE)
+    {
+        SPI_FLASH_BufferRead(ts_read_buf, lv->addr + off, TS_STORE_PAGE_SIZE);
+        if (ts_page_erased(ts_read_buf))
+            break;
+        if (ts_page_valid(ts_read_buf))
+            lv->last = hdr->time + (rt_uint32_t)(hdr->count - 1) * lv->period;
+    }
+
+    lv->head = off % TS_LEVEL_SIZE(lv);
+}
+
+static rt_bool_t ts_rollup_replay(rt_uint32_t time, const rt_uint16_t *value, void *parameter)
+{
+    ts_level_rollup((struct ts_level *)parameter, time, value);
+
+    return RT_TRUE;
+}
+
+/* close the minute and roll it up */
+static void ts_store_tick(void)
+{
+    rt_uint16_t value[TS_CHANNEL_NUM];
+    rt_base_t level;
+    rt_uint8_t ch, i;
+
+    level = rt_hw_interrupt_disable();
+    for (ch = 0; ch < TS_CHANNEL_NUM; ch++)
+    {
+        value[ch] = ts_cnt[ch] ? (ts_sum[ch] + ts_cnt[ch] / 2) / ts_cnt[ch] : TS_VALUE_NONE;
+        ts_sum[ch] = 0;
+        ts_cnt[ch] = 0;
+    }
+    rt_hw_interrupt_enable(level);
+
+    rt_mutex_take(&ts_lock, RT_WAITING_FOREVER);
+
+    ts_level_append(&ts_level[TS_LEVEL_1MIN], ts_now, value);
+    for (i = TS_LEVEL_1MIN + 1; i < TS_LEVEL_NUM; i++)
+        ts_level_rollup(&ts_level[i], ts_now, value);
+    ts_now++;
+
+    rt_mutex_release(&ts_lock);
+}
+
+static void ts_store_thread_entry(void *parameter)
+{
+    rt_tick_t next = rt_tick_get();
+    rt_int32_t wait;
+
+    while (1)
+    {
+        next += TS_MINUTE_TICKS;
+        wait = (rt_int32_t)(next - rt_tick_get());
+        if (wait > 0)
+            rt_thread_delay(wait);
+
+        ts_store_tick();
+    }
+}
+
+/* lay the levels out on the flash, RT_FALSE if they don't fit */
+static rt_bool_t ts_store_layout(void)
+{
+    rt_uint32_t id, addr, sectors;
+    rt_uint8_t i;
+
+    /* the last byte of the JEDEC id is log2 of the size, 0x14 is 1MB */
+    id = SPI_FLASH_ReadID();
+    if ((id & 0xFF) < 0x10 || (id & 0xFF) > 0x18)
+    {
+        rt_kprintf("ts_store: unknown flash %06x, no history\n", id);
+        return RT_FALSE;
+    }
+
+    sectors = ((1UL << (id & 0xFF)) - TS_STORE_ADDR) / TS_STORE_SECTOR_SIZE;
+    if (sectors < TS_1MIN_SECTORS_MIN + TS_15MIN_SECTORS + TS_1H_SECTORS)
+    {
+        rt_kprintf("ts_store: flash %06x too small, no history\n", id);
+        return RT_FALSE;
+    }
+    if (sectors < TS_1MIN_SECTORS + TS_15MIN_SECTORS + TS_1H_SECTORS)
+        ts_level[TS_LEVEL_1MIN].sectors = sectors - TS_15MIN_SECTORS - TS_1H_SECTORS;
+
+    addr = TS_STORE_ADDR;
+    for (i = 0; i < TS_LEVEL_NUM; i++)
+    {
+        ts_level[i].addr = addr;
+        addr += TS_LEVEL_SIZE(&ts_level[i]);
+    }
+
+    return RT_TRUE;
+}
+
+int ts_store_init(void)
+{
+    struct ts_level *lv;
+    rt_thread_t tid;
+    rt_uint8_t i;
+
+    rt_mutex_init(&ts_lock, "tsdb", RT_IPC_FLAG_FIFO);
+
+    if (!ts_store_layout())
+        return -1;
+    ts_enabled = RT_TRUE;
+
+    for (i = 0; i < TS_LEVEL_NUM; i++)
+        ts_level_scan(&ts_level[i]);
+
+    /* rebuild the rollups the power cut took from the minutes on the flash */
+    for (i = TS_LEVEL_1MIN + 1; i < TS_LEVEL_NUM; i++)
+    {
+        lv = &ts_level[i];
+        ts_level_query(&ts_level[TS_LEVEL_1MIN],
+                       lv->last == TS_TIME_NONE ? 0 : lv->last + lv->period, TS_TIME_NONE - 1,
+                       ts_rollup_replay, lv);
+    }
+
+    /* go on behind the newest sample of any level */
+    ts_now = 0;
+    for (i = 0; i < TS_LEVEL_NUM; i++)
+    {
+        lv = &ts_level[i];
+        if (lv->last != TS_TIME_NONE && lv->last + lv->period > ts_now)
+            ts_now = lv->last + lv->period;
+    }
+
+    tid = rt_thread_create("tsdb", ts_store_thread_entry, RT_NULL, 512, 24, 20);
+    if (tid != RT_NULL)
+        rt_thread_startup(tid);
+
+    return 0;
+}
+
+/* a reading of a channel, averaged into the current minute */
+void ts_store_sample(rt_uint8_t channel, rt_uint16_t value)
+{
+    rt_base_t level;
+
+    if (!ts_enabled || channel >= TS_CHANNEL_NUM)
+        return;
+    if (value == TS_VALUE_NONE)
+        value--;
+
+    level = rt_hw_interrupt_disable();
+    ts_sum[channel] += value;
+    ts_cnt[channel]++;
+    rt_hw_interrupt_enable(level);
+}
+
+rt_uint32_t ts_store_now(void)
+{
+    return ts_now;
+}
+
+rt_uint16_t ts_store_period(rt_uint8_t level)
+{
+    if (level >= TS_LEVEL_NUM)
+        return 0;
+
+    return ts_level[level].period;
+}
+
+/* samples of a level within [from, to], oldest first, return their number */
+int ts_store_query(rt_uint8_t level, rt_uint32_t from, rt_uint32_t to,
+                   ts_store_cb cb, void *parameter)
+{
+    int count;
+
+    if (!ts_enabled || level >= TS_LEVEL_NUM || from > to)
+        return 0;
+
+    rt_mutex_take(&ts_lock, RT_WAITING_FOREVER);
+    count = ts_level_query(&ts_level[level], from, to, cb, parameter);
+    rt_mutex_release(&ts_lock);
+
+    return count;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_ts_store(void)
+{
+    struct ts_level *lv;
+    rt_uint8_t i;
+
+    if (!ts_enabled)
+    {
+        rt_kprintf("no history on this flash\n");
+        return;
+    }
+
+    rt_kprintf("now %d\n", ts_now);
+    rt_kprintf("period     addr    head     last count  len\n");
+    rt_kprintf("------ -------- ------- -------- ----- ----\n");
+    for (i = 0; i < TS_LEVEL_NUM; i++)
+    {
+        lv = &ts_level[i];
+        rt_kprintf("%6d %08x %7d %8d %5d %4d\n", lv->period, lv->addr, lv->head,
+                   lv->last == TS_TIME_NONE ? -1 : (int)lv->last,
+                   TS_PAGE_HEADER(lv->page)->count, TS_PAGE_HEADER(lv->page)->len);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_ts_store, show the room history levels)
+
+static rt_bool_t ts_dump_sample(rt_uint32_t time, const rt_uint16_t *value, void *parameter)
+{
+    rt_uint8_t ch;
+
+    rt_kprintf("%8d", time);
+    for (ch = 0; ch < TS_CHANNEL_NUM; ch++)
+    {
+        if (value[ch] == TS_VALUE_NONE)
+            rt_kprintf("     -");
+        else
+            rt_kprintf(" %5d", value[ch]);
+    }
+    rt_kprintf("\n");
+
+    return RT_TRUE;
+}
+
+void ts_dump(int level, int from, int to)
+{
+    rt_kprintf("%d samples\n", ts_store_query(level, from, to, ts_dump_sample, RT_NULL));
+}
+FINSH_FUNCTION_EXPORT(ts_dump, print the room history of a level from to)
+#endif
@@ -0,0 +1,51 @@
+/*
+ * File      : ts_store.h
+ * room PM2.5/CO2 history on the SPI NOR flash
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       first version
+ * 2026-10-17     aclean       state the flash size the levels need
+ */
+#ifndef __TS_STORE_H__
+#define __TS_STORE_H__
+
+#include <rtthread.h>
+
+/*
+ * flash area, right after the parameter store, up to 0x165000: a 2MB part
+ * (W25Q16) or larger holds all of it, on a 1MB one the minutes are shorter
+ */
+#define TS_STORE_ADDR               0x5000
+#define TS_STORE_SECTOR_SIZE        4096
+#define TS_STORE_PAGE_SIZE          256
+
+/* CO2 and PM2.5 of the five rooms */
+#define TS_CHANNEL_NUM              10
+#define TS_CH_CO2(room)             (((room) - 1) * 2)
+#define TS_CH_PM25(room)            (((room) - 1) * 2 + 1)
+
+/* no reading in the whole interval */
+#define TS_VALUE_NONE               0xFFFF
+
+/* levels, each one is a rollup of the one before */
+#define TS_LEVEL_1MIN               0
+#define TS_LEVEL_15MIN              1
+#define TS_LEVEL_1H                 2
+#define TS_LEVEL_NUM                3
+
+/*
+ * Time is counted in minutes of running time: there is no clock, the count
+ * goes on after a restart from where the history ends. ts_store_now() is
+ * what maps it to the wall time.
+ */
+typedef rt_bool_t (*ts_store_cb)(rt_uint32_t time, const rt_uint16_t *value, void *parameter);
+
+int  ts_store_init(void);
+void ts_store_sample(rt_uint8_t channel, rt_uint16_t value);
+rt_uint32_t ts_store_now(void);
+rt_uint16_t ts_store_period(rt_uint8_t level);
+int  ts_store_query(rt_uint8_t level, rt_uint32_t from, rt_uint32_t to,
+                    ts_store_cb cb, void *parameter);
+
+#endif
@@ -15,8 +15,20 @@
   ******************************************************************************
   */
   
+#include <rtthread.h>
 #include "bsp_spi_flash.h"
 
+/*
+ * The parameter store, the history store and the legacy parameter reads
+ * run in different threads. A command sequence holds CS low over several
+ * calls, so every transaction below takes the flash as a whole. The mutex
+ * is recursive: SPI_FLASH_BufferWrite keeps it over its page writes.
+ */
+static struct rt_mutex spi_flash_lock;
+
+#define SPI_FLASH_LOCK()      rt_mutex_take(&spi_flash_lock, RT_WAITING_FOREVER)
+#define SPI_FLASH_UNLOCK()    rt_mutex_release(&spi_flash_lock)
+
 /* Private typedef -----------------------------------------------------------*/
 #define SPI_FLASH_PageSize      256//4096
 //#define SPI_FLASH_PageSize      256
@@ -111,6 +123,8 @@ void SPI_FLASH_Init(void)
   /* Enable SPI1  */
   SPI_Cmd(SPI1, ENABLE);
 
+  rt_mutex_init(&spi_flash_lock, "spiflash", RT_IPC_FLAG_FIFO);
+
   
   //spi_flash_test();
 
@@ -125,6 +139,7 @@ void SPI_FLASH_Init(void)
 *******************************************************************************/
 void SPI_FLASH_SectorErase(u32 SectorAddr)
 {
+  SPI_FLASH_LOCK();
   /* Send write enable instruction */
   SPI_FLASH_WriteEnable();
   SPI_FLASH_WaitForWriteEnd();
@@ -143,11 +158,14 @@ void SPI_FLASH_SectorErase(u32 SectorAddr)
   SPI_FLASH_CS_HIGH();
   /* Wait the end of Flash writing */
   SPI_FLASH_WaitForWriteEnd();
+
+  SPI_FLASH_UNLOCK();
 }
 
 
 void SPI_FLASH_PageErase(u32 SectorAddr)
 {
+  SPI_FLASH_LOCK();
   /* Send write enable instruction */
   SPI_FLASH_WriteEnable();
   SPI_FLASH_WaitForWriteEnd();
@@ -166,6 +184,8 @@ void SPI_FLASH_PageErase(u32 SectorAddr)
   SPI_FLASH_CS_HIGH();
   /* Wait the end of Flash writing */
   SPI_FLASH_WaitForWriteEnd();
+
+  SPI_FLASH_UNLOCK();
 }
 
 
@@ -179,6 +199,7 @@ void SPI_FLASH_PageErase(u32 SectorAddr)
 *******************************************************************************/
 void SPI_FLASH_BulkErase(void)
 {
+  SPI_FLASH_LOCK();
   /* Send write enable instruction */
   SPI_FLASH_WriteEnable();
 
@@ -192,6 +213,8 @@ void SPI_FLASH_BulkErase(void)
 
   /* Wait the end of Flash writing */
   SPI_FLASH_WaitForWriteEnd();
+
+  SPI_FLASH_UNLOCK();
 }
 
 /*******************************************************************************
@@ -209,6 +232,7 @@ void SPI_FLASH_BulkErase(void)
 *******************************************************************************/
 void SPI_FLASH_PageWrite(u8* pBuffer, u32 WriteAddr, u16 NumByteToWrite)
 {
+  SPI_FLASH_LOCK();
   /* Enable the write access to the FLASH */
   SPI_FLASH_WriteEnable();
 
@@ -243,6 +267,8 @@ void SPI_FLASH_PageWrite(u8* pBuffer, u32 WriteAddr, u16 NumByteToWrite)
 
   /* Wait the end of Flash writing */
   SPI_FLASH_WaitForWriteEnd();
+
+  SPI_FLASH_UNLOCK();
 }
 
 /*******************************************************************************
@@ -260,6 +286,7 @@ void SPI_FLASH_BufferWrite(u8* pBuffer, u32 WriteAddr, u16 NumByteToWrite)
 {
   u8 NumOfPage = 0, NumOfSingle = 0, Addr = 0, count = 0, temp = 0;
 
+  SPI_FLASH_LOCK();
   Addr = WriteAddr % SPI_FLASH_PageSize;
   count = SPI_FLASH_PageSize - Addr;
   NumOfPage =  NumByteToWrite / SPI_FLASH_PageSize;
@@ -325,6 +352,8 @@ void SPI_FLASH_BufferWrite(u8* pBuffer, u32 WriteAddr, u16 NumByteToWrite)
       }
     }
   }
+
+  SPI_FLASH_UNLOCK();
 }
 
 /*******************************************************************************
@@ -339,6 +368,7 @@ void SPI_FLASH_BufferWrite(u8* pBuffer, u32 WriteAddr, u16 NumByteToWrite)
 *******************************************************************************/
 void SPI_FLASH_BufferRead(u8* pBuffer, u32 ReadAddr, u16 NumByteToRead)
 {
+  SPI_FLASH_LOCK();
   /* Select the FLASH: Chip Select low */
   SPI_FLASH_CS_LOW();
 
@@ -362,6 +392,8 @@ void SPI_FLASH_BufferRead(u8* pBuffer, u32 ReadAddr, u16 NumByteToRead)
 
   /* Deselect the FLASH: Chip Select high */
   SPI_FLASH_CS_HIGH();
+
+  SPI_FLASH_UNLOCK();
 }
 
 /*******************************************************************************
@@ -375,6 +407,7 @@ u32 SPI_FLASH_ReadID(void)
 {
   u32 Temp = 0, Temp0 = 0, Temp1 = 0, Temp2 = 0;
 
+  SPI_FLASH_LOCK();
   /* Select the FLASH: Chip Select low */
   SPI_FLASH_CS_LOW();
 
@@ -395,6 +428,8 @@ u32 SPI_FLASH_ReadID(void)
 
   Temp = (Temp0 << 16) | (Temp1 << 8) | Temp2;
 
+  SPI_FLASH_UNLOCK();
+
   return Temp;
 }
 /*******************************************************************************
@@ -408,6 +443,7 @@ u32 SPI_FLASH_ReadDeviceID(void)
 {
   u32 Temp = 0;
 
+  SPI_FLASH_LOCK();
   /* Select the FLASH: Chip Select low */
   SPI_FLASH_CS_LOW();
 
@@ -423,6 +459,8 @@ u32 SPI_FLASH_ReadDeviceID(void)
   /* Deselect the FLASH: Chip Select high */
   SPI_FLASH_CS_HIGH();
 
+  SPI_FLASH_UNLOCK();
+
   return Temp;
 }
 /*******************************************************************************
@@ -569,6 +607,7 @@ void SPI_FLASH_WaitForWriteEnd(void)
 //ģʽ
 void SPI_Flash_PowerDown(void)   
 { 
+  SPI_FLASH_LOCK();
   /* Select the FLASH: Chip Select low */
   SPI_FLASH_CS_LOW();
 
@@ -577,11 +616,14 @@ void SPI_Flash_PowerDown(void)
 
   /* Deselect the FLASH: Chip Select high */
   SPI_FLASH_CS_HIGH();
+
+  SPI_FLASH_UNLOCK();
 }   
 
 //
 void SPI_Flash_WAKEUP(void)   
 {
+  SPI_FLASH_LOCK();
   /* Select the FLASH: Chip Select low */
   SPI_FLASH_CS_LOW();
 
@@ -590,6 +632,8 @@ void SPI_Flash_WAKEUP(void)
 
   /* Deselect the FLASH: Chip Select high */
   SPI_FLASH_CS_HIGH();                   //ȴTRES1
+
+  SPI_FLASH_UNLOCK();
 }   
 
 
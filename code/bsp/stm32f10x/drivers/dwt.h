@@ -0,0 +1,36 @@
+/*
+ * File      : dwt.h
+ * cycle counter of the Cortex-M3 DWT
+ *
+ * The counter runs at the core clock, DWT_CYCCNT_HZ, and stops while the
+ * core sleeps. bsp/posix has the same header over the host clock.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       first version
+ * 2026-10-17     aclean       moved to the board drivers, add DWT_CYCCNT_HZ
+ */
+#ifndef __DWT_H__
+#define __DWT_H__
+
+#include <rtthread.h>
+#include <stm32f10x.h>
+
+#define DEMCR                   (*(volatile rt_uint32_t *)0xE000EDFC)
+#define DEMCR_TRCENA            (1UL << 24)
+#define DWT_CTRL                (*(volatile rt_uint32_t *)0xE0001000)
+#define DWT_CTRL_CYCCNTENA      (1UL << 0)
+#define DWT_CYCCNT              (*(volatile rt_uint32_t *)0xE0001004)
+#define DWT_CYCCNT_HZ           SystemCoreClock
+
+/* exception number of the running handler, 0 in thread mode */
+#define SCB_ICSR                (*(volatile rt_uint32_t *)0xE000ED04)
+#define SCB_ICSR_VECTACTIVE     0x1ff
+
+rt_inline void dwt_cycles_init(void)
+{
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+#endif
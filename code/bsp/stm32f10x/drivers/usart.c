@@ -13,6 +13,7 @@
  * 2010-03-29     Bernard      remove interrupt Tx and DMA Rx mode
  * 2013-05-13     aozima       update for kehong-lingtai.
  * 2015-01-31     armink       make sure the serial transmit complete in putc()
+ * 2026-10-16     aclean       add DMA Tx and circular DMA Rx for UART1-4
  */
 
 #include "stm32f10x.h"
@@ -44,13 +45,130 @@
 #define UART4_GPIO           GPIOC
 
 
+/* STM32 uart DMA channels */
+struct stm32_uart_dma
+{
+    DMA_Channel_TypeDef* rx_ch;
+    rt_uint32_t rx_gl_flag;
+    IRQn_Type rx_irq;
+
+    DMA_Channel_TypeDef* tx_ch;
+    rt_uint32_t tx_gl_flag;
+    IRQn_Type tx_irq;
+
+    /* Rx fifo index the DMA had reached at the last update */
+    rt_size_t last_index;
+};
+
 /* STM32 uart driver */
 struct stm32_uart
 {
     USART_TypeDef* uart_device;
     IRQn_Type irq;
+    struct stm32_uart_dma dma;
 };
 
+static void DMA_NVIC_Configuration(IRQn_Type irq)
+{
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    NVIC_InitStructure.NVIC_IRQChannel = irq;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+/* circular Rx DMA into the serial Rx fifo, with half/full and idle events */
+static void stm32_dma_rx_config(struct rt_serial_device *serial)
+{
+    struct stm32_uart* uart;
+    struct rt_serial_rx_fifo* rx_fifo;
+    DMA_InitTypeDef DMA_InitStructure;
+
+    uart = (struct stm32_uart *)serial->parent.user_data;
+    rx_fifo = (struct rt_serial_rx_fifo*)serial->serial_rx;
+    RT_ASSERT(rx_fifo != RT_NULL);
+
+    DMA_Cmd(uart->dma.rx_ch, DISABLE);
+    DMA_DeInit(uart->dma.rx_ch);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (rt_uint32_t)&(uart->uart_device->DR);
+    DMA_InitStructure.DMA_MemoryBaseAddr = (rt_uint32_t)rx_fifo->buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = serial->config.bufsz;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(uart->dma.rx_ch, &DMA_InitStructure);
+
+    uart->dma.last_index = 0;
+    DMA_ClearFlag(uart->dma.rx_gl_flag);
+    DMA_ITConfig(uart->dma.rx_ch, DMA_IT_HT | DMA_IT_TC, ENABLE);
+    DMA_NVIC_Configuration(uart->dma.rx_irq);
+    DMA_Cmd(uart->dma.rx_ch, ENABLE);
+
+    /* bytes now go to the DMA, the idle line ends a frame */
+    USART_ITConfig(uart->uart_device, USART_IT_RXNE, DISABLE);
+    USART_DMACmd(uart->uart_device, USART_DMAReq_Rx, ENABLE);
+    USART_ITConfig(uart->uart_device, USART_IT_IDLE, ENABLE);
+    UART_ENABLE_IRQ(uart->irq);
+}
+
+static void stm32_dma_tx_config(struct rt_serial_device *serial)
+{
+    struct stm32_uart* uart;
+    DMA_InitTypeDef DMA_InitStructure;
+
+    uart = (struct stm32_uart *)serial->parent.user_data;
+
+    DMA_Cmd(uart->dma.tx_ch, DISABLE);
+    DMA_DeInit(uart->dma.tx_ch);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (rt_uint32_t)&(uart->uart_device->DR);
+    DMA_InitStructure.DMA_MemoryBaseAddr = 0;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 1;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(uart->dma.tx_ch, &DMA_InitStructure);
+
+    DMA_ClearFlag(uart->dma.tx_gl_flag);
+    DMA_ITConfig(uart->dma.tx_ch, DMA_IT_TC, ENABLE);
+    DMA_NVIC_Configuration(uart->dma.tx_irq);
+
+    USART_DMACmd(uart->uart_device, USART_DMAReq_Tx, ENABLE);
+    UART_ENABLE_IRQ(uart->irq);
+}
+
+/* report what the circular Rx DMA has written since the last update */
+static void stm32_dma_rx_update(struct rt_serial_device *serial)
+{
+    struct stm32_uart* uart;
+    rt_size_t index, length;
+
+    uart = (struct stm32_uart *)serial->parent.user_data;
+
+    index = serial->config.bufsz - DMA_GetCurrDataCounter(uart->dma.rx_ch);
+    if (index >= serial->config.bufsz) index = 0;
+
+    if (index >= uart->dma.last_index)
+        length = index - uart->dma.last_index;
+    else
+        length = serial->config.bufsz - uart->dma.last_index + index;
+    uart->dma.last_index = index;
+
+    if (length)
+        rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_DMADONE | (length << 8));
+}
+
 static rt_err_t stm32_configure(struct rt_serial_device *serial, struct serial_configure *cfg)
 {
     struct stm32_uart* uart;
@@ -104,6 +222,21 @@ static rt_err_t stm32_control(struct rt_serial_device *serial, int cmd, void *ar
     {
         /* disable interrupt */
     case RT_DEVICE_CTRL_CLR_INT:
+        if ((rt_uint32_t)arg == RT_DEVICE_FLAG_DMA_RX)
+        {
+            USART_ITConfig(uart->uart_device, USART_IT_IDLE, DISABLE);
+            USART_DMACmd(uart->uart_device, USART_DMAReq_Rx, DISABLE);
+            DMA_Cmd(uart->dma.rx_ch, DISABLE);
+            UART_DISABLE_IRQ(uart->dma.rx_irq);
+            break;
+        }
+        if ((rt_uint32_t)arg == RT_DEVICE_FLAG_DMA_TX)
+        {
+            USART_DMACmd(uart->uart_device, USART_DMAReq_Tx, DISABLE);
+            DMA_Cmd(uart->dma.tx_ch, DISABLE);
+            UART_DISABLE_IRQ(uart->dma.tx_irq);
+            break;
+        }
         /* disable rx irq */
         UART_DISABLE_IRQ(uart->irq);
         /* disable interrupt */
@@ -116,6 +249,13 @@ static rt_err_t stm32_control(struct rt_serial_device *serial, int cmd, void *ar
         /* enable interrupt */
         USART_ITConfig(uart->uart_device, USART_IT_RXNE, ENABLE);
         break;
+        /* configure DMA */
+    case RT_DEVICE_CTRL_CONFIG:
+        if ((rt_uint32_t)arg == RT_DEVICE_FLAG_DMA_RX)
+            stm32_dma_rx_config(serial);
+        else if ((rt_uint32_t)arg == RT_DEVICE_FLAG_DMA_TX)
+            stm32_dma_tx_config(serial);
+        break;
     }
 
     return RT_EOK;
@@ -157,47 +297,133 @@ static int stm32_getc(struct rt_serial_device *serial)
     return ch;
 }
 
+/*
+ * One-shot Tx DMA. The DMA interrupt only means the last byte reached DR,
+ * completion is reported on USART TC once it has left the shift register,
+ * so RS485 direction can be switched right after.
+ */
+static rt_size_t stm32_dma_transmit(struct rt_serial_device *serial, const rt_uint8_t *buf, rt_size_t size, int direction)
+{
+    struct stm32_uart* uart;
+
+    RT_ASSERT(serial != RT_NULL);
+    uart = (struct stm32_uart *)serial->parent.user_data;
+
+    /* Rx DMA runs circularly from open, see stm32_dma_rx_config() */
+    if (direction != RT_SERIAL_DMA_TX) return 0;
+
+    DMA_Cmd(uart->dma.tx_ch, DISABLE);
+    uart->dma.tx_ch->CMAR = (rt_uint32_t)buf;
+    uart->dma.tx_ch->CNDTR = size;
+    DMA_Cmd(uart->dma.tx_ch, ENABLE);
+
+    return size;
+}
+
 static const struct rt_uart_ops stm32_uart_ops =
 {
     stm32_configure,
     stm32_control,
     stm32_putc,
     stm32_getc,
+    stm32_dma_transmit,
 };
 
-#if defined(RT_USING_UART1)
-/* UART1 device driver structure */
-struct stm32_uart uart1 =
-{
-    USART1,
-    USART1_IRQn,
-};
-struct rt_serial_device serial1;
-
-void USART1_IRQHandler(void)
+static void uart_isr(struct rt_serial_device *serial)
 {
     struct stm32_uart* uart;
 
-    uart = &uart1;
+    uart = (struct stm32_uart *)serial->parent.user_data;
 
-    /* enter interrupt */
-    rt_interrupt_enter();
     if(USART_GetITStatus(uart->uart_device, USART_IT_RXNE) != RESET)
     {
-        rt_hw_serial_isr(&serial1, RT_SERIAL_EVENT_RX_IND);
+        rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_IND);
         /* clear interrupt */
         USART_ClearITPendingBit(uart->uart_device, USART_IT_RXNE);
     }
-
+    if (USART_GetITStatus(uart->uart_device, USART_IT_IDLE) != RESET)
+    {
+        stm32_dma_rx_update(serial);
+        /* clear interrupt: SR was read above, now read DR */
+        USART_ReceiveData(uart->uart_device);
+    }
     if (USART_GetITStatus(uart->uart_device, USART_IT_TC) != RESET)
     {
+        /* only enabled at the end of a Tx DMA */
+        USART_ITConfig(uart->uart_device, USART_IT_TC, DISABLE);
         /* clear interrupt */
         USART_ClearITPendingBit(uart->uart_device, USART_IT_TC);
+        rt_hw_serial_isr(serial, RT_SERIAL_EVENT_TX_DMADONE);
     }
     if (USART_GetFlagStatus(uart->uart_device, USART_FLAG_ORE) == SET)
     {
-        stm32_getc(&serial1);
+        stm32_getc(serial);
     }
+}
+
+static void dma_rx_isr(struct rt_serial_device *serial)
+{
+    struct stm32_uart* uart;
+
+    uart = (struct stm32_uart *)serial->parent.user_data;
+
+    DMA_ClearFlag(uart->dma.rx_gl_flag);
+    stm32_dma_rx_update(serial);
+}
+
+static void dma_tx_isr(struct rt_serial_device *serial)
+{
+    struct stm32_uart* uart;
+
+    uart = (struct stm32_uart *)serial->parent.user_data;
+
+    DMA_ClearFlag(uart->dma.tx_gl_flag);
+    DMA_Cmd(uart->dma.tx_ch, DISABLE);
+    /* wait for the last byte to leave the shift register */
+    USART_ITConfig(uart->uart_device, USART_IT_TC, ENABLE);
+}
+
+#if defined(RT_USING_UART1)
+/* UART1 device driver structure */
+struct stm32_uart uart1 =
+{
+    USART1,
+    USART1_IRQn,
+    {
+        DMA1_Channel5,
+        DMA1_FLAG_GL5,
+        DMA1_Channel5_IRQn,
+        DMA1_Channel4,
+        DMA1_FLAG_GL4,
+        DMA1_Channel4_IRQn,
+        0,
+    },
+};
+struct rt_serial_device serial1;
+
+void USART1_IRQHandler(void)
+{
+    /* enter interrupt */
+    rt_interrupt_enter();
+    uart_isr(&serial1);
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
+
+void DMA1_Channel5_IRQHandler(void)
+{
+    /* enter interrupt */
+    rt_interrupt_enter();
+    dma_rx_isr(&serial1);
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
+
+void DMA1_Channel4_IRQHandler(void)
+{
+    /* enter interrupt */
+    rt_interrupt_enter();
+    dma_tx_isr(&serial1);
     /* leave interrupt */
     rt_interrupt_leave();
 }
@@ -209,33 +435,41 @@ struct stm32_uart uart2 =
 {
     USART2,
     USART2_IRQn,
+    {
+        DMA1_Channel6,
+        DMA1_FLAG_GL6,
+        DMA1_Channel6_IRQn,
+        DMA1_Channel7,
+        DMA1_FLAG_GL7,
+        DMA1_Channel7_IRQn,
+        0,
+    },
 };
 struct rt_serial_device serial2;
 
 void USART2_IRQHandler(void)
 {
-    struct stm32_uart* uart;
-
-    uart = &uart2;
+    /* enter interrupt */
+    rt_interrupt_enter();
+    uart_isr(&serial2);
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
 
+void DMA1_Channel6_IRQHandler(void)
+{
     /* enter interrupt */
     rt_interrupt_enter();
-    if(USART_GetITStatus(uart->uart_device, USART_IT_RXNE) != RESET)
-    {
-        rt_hw_serial_isr(&serial2, RT_SERIAL_EVENT_RX_IND);
-        /* clear interrupt */
-        USART_ClearITPendingBit(uart->uart_device, USART_IT_RXNE);
-    }
-    if (USART_GetITStatus(uart->uart_device, USART_IT_TC) != RESET)
-    {
-        /* clear interrupt */
-        USART_ClearITPendingBit(uart->uart_device, USART_IT_TC);
-    }
-    if (USART_GetFlagStatus(uart->uart_device, USART_FLAG_ORE) == SET)
-    {
-        stm32_getc(&serial2);
-    }
+    dma_rx_isr(&serial2);
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
 
+void DMA1_Channel7_IRQHandler(void)
+{
+    /* enter interrupt */
+    rt_interrupt_enter();
+    dma_tx_isr(&serial2);
     /* leave interrupt */
     rt_interrupt_leave();
 }
@@ -247,33 +481,41 @@ struct stm32_uart uart3 =
 {
     USART3,
     USART3_IRQn,
+    {
+        DMA1_Channel3,
+        DMA1_FLAG_GL3,
+        DMA1_Channel3_IRQn,
+        DMA1_Channel2,
+        DMA1_FLAG_GL2,
+        DMA1_Channel2_IRQn,
+        0,
+    },
 };
 struct rt_serial_device serial3;
 
 void USART3_IRQHandler(void)
 {
-    struct stm32_uart* uart;
-
-    uart = &uart3;
+    /* enter interrupt */
+    rt_interrupt_enter();
+    uart_isr(&serial3);
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
 
+void DMA1_Channel3_IRQHandler(void)
+{
     /* enter interrupt */
     rt_interrupt_enter();
-    if(USART_GetITStatus(uart->uart_device, USART_IT_RXNE) != RESET)
-    {
-        rt_hw_serial_isr(&serial3, RT_SERIAL_EVENT_RX_IND);
-        /* clear interrupt */
-        USART_ClearITPendingBit(uart->uart_device, USART_IT_RXNE);
-    }
-    if (USART_GetITStatus(uart->uart_device, USART_IT_TC) != RESET)
-    {
-        /* clear interrupt */
-        USART_ClearITPendingBit(uart->uart_device, USART_IT_TC);
-    }
-    if (USART_GetFlagStatus(uart->uart_device, USART_FLAG_ORE) == SET)
-    {
-        stm32_getc(&serial3);
-    }
+    dma_rx_isr(&serial3);
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
 
+void DMA1_Channel2_IRQHandler(void)
+{
+    /* enter interrupt */
+    rt_interrupt_enter();
+    dma_tx_isr(&serial3);
     /* leave interrupt */
     rt_interrupt_leave();
 }
@@ -286,33 +528,43 @@ struct stm32_uart uart4 =
 {
     UART4,
     UART4_IRQn,
+    {
+        DMA2_Channel3,
+        DMA2_FLAG_GL3,
+        DMA2_Channel3_IRQn,
+        DMA2_Channel5,
+        DMA2_FLAG_GL5,
+        DMA2_Channel4_5_IRQn,
+        0,
+    },
 };
 struct rt_serial_device serial4;
 
 void UART4_IRQHandler(void)
 {
-    struct stm32_uart* uart;
-
-    uart = &uart4;
+    /* enter interrupt */
+    rt_interrupt_enter();
+    uart_isr(&serial4);
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
 
+void DMA2_Channel3_IRQHandler(void)
+{
     /* enter interrupt */
     rt_interrupt_enter();
-    if(USART_GetITStatus(uart->uart_device, USART_IT_RXNE) != RESET)
-    {
-        rt_hw_serial_isr(&serial4, RT_SERIAL_EVENT_RX_IND);
-        /* clear interrupt */
-        USART_ClearITPendingBit(uart->uart_device, USART_IT_RXNE);
-    }
+    dma_rx_isr(&serial4);
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
 
-    if (USART_GetITStatus(uart->uart_device, USART_IT_TC) != RESET)
-    {
-        /* clear interrupt */
-        USART_ClearITPendingBit(uart->uart_device, USART_IT_TC);
-    }
-    if (USART_GetFlagStatus(uart->uart_device, USART_FLAG_ORE) == SET)
-    {
-        stm32_getc(&serial4);
-    }
+void DMA2_Channel4_5_IRQHandler(void)
+{
+    /* enter interrupt */
+    rt_interrupt_enter();
+    /* channel 4 is shared with SDIO, only serve UART4 Tx here */
+    if (DMA_GetITStatus(DMA2_IT_GL5) != RESET)
+        dma_tx_isr(&serial4);
     /* leave interrupt */
     rt_interrupt_leave();
 }
@@ -320,6 +572,9 @@ void UART4_IRQHandler(void)
 
 static void RCC_Configuration(void)
 {
+    /* UART1-3 use DMA1, UART4 uses DMA2 */
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1 | RCC_AHBPeriph_DMA2, ENABLE);
+
 #if defined(RT_USING_UART1)
     /* Enable UART GPIO clocks */
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);
@@ -458,7 +713,7 @@ void rt_hw_usart_init(void)
 
     /* register UART1 device */
     rt_hw_serial_register(&serial1, "uart1",
-                          RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX ,
+                          RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX | RT_DEVICE_FLAG_DMA_RX | RT_DEVICE_FLAG_DMA_TX,
                           uart);
 #endif /* RT_USING_UART1 */
 
@@ -473,7 +728,7 @@ void rt_hw_usart_init(void)
 
     /* register UART1 device */
     rt_hw_serial_register(&serial2, "uart2",
-                          RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX,
+                          RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX | RT_DEVICE_FLAG_DMA_RX | RT_DEVICE_FLAG_DMA_TX,
                           uart);
 #endif /* RT_USING_UART2 */
 
@@ -489,7 +744,7 @@ void rt_hw_usart_init(void)
 
     /* register UART1 device */
     rt_hw_serial_register(&serial3, "uart3",
-                          RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX,
+                          RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX | RT_DEVICE_FLAG_DMA_RX | RT_DEVICE_FLAG_DMA_TX,
                           uart);
 #endif /* RT_USING_UART3 */
 
@@ -498,13 +753,13 @@ void rt_hw_usart_init(void)
     config.baud_rate = BAUD_RATE_9600;
 
     serial4.ops    = &stm32_uart_ops;
-    serial1.config = config;
+    serial4.config = config;
 
     NVIC_Configuration(&uart4);
 
     /* register UART1 device */
     rt_hw_serial_register(&serial4, "uart4",
-                          RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX ,
+                          RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX | RT_DEVICE_FLAG_DMA_RX | RT_DEVICE_FLAG_DMA_TX,
                           uart);
 #endif /* RT_USING_UART1 */
 
@@ -12,7 +12,7 @@
 #define RT_THREAD_PRIORITY_MAX	32
 
 /* Tick per Second */
-#define RT_TICK_PER_SECOND	10000
+#define RT_TICK_PER_SECOND	1000
 
 /* SECTION: RT_DEBUG */
 /* Thread Debug */
@@ -24,12 +24,26 @@
 /* Using Hook */
 #define RT_USING_HOOK
 
+/* Using tickless idle: stop the periodic tick while idle */
+#define RT_USING_TICKLESS
+
+/* Using the Thumb-2 rt_memcpy, rt_memset and rt_memmove of libcpu */
+/* #define RT_USING_CPU_MEMFUNC */
+
+/* Using the timing wheel for the hard timers, O(1) start and stop */
+/* #define RT_USING_TIMER_WHEEL */
+
 /* Using Software Timer */
 /* #define RT_USING_TIMER_SOFT */
 #define RT_TIMER_THREAD_PRIO		4
 #define RT_TIMER_THREAD_STACK_SIZE	512
 #define RT_TIMER_TICK_PER_SECOND	10
 
+/* Using tasklets: drivers defer the work of their ISRs to a thread */
+#define RT_USING_TASKLET
+#define RT_TASKLET_THREAD_PRIO		0
+#define RT_TASKLET_THREAD_STACK_SIZE	512
+
 /* SECTION: IPC */
 /* Using Semaphore*/
 #define RT_USING_SEMAPHORE
@@ -56,6 +70,9 @@
 /* Using Small MM */
 #define RT_USING_SMALL_MEM
 
+/* Using TLSF, the O(1) heap, in place of Small MM */
+/* #define RT_USING_TLSF */
+
 // <bool name="RT_USING_COMPONENTS_INIT" description="Using RT-Thread components initialization" default="true" />
 #define RT_USING_COMPONENTS_INIT
 
@@ -154,6 +154,11 @@ struct rt_serial_device
 
 	void *serial_rx;
 	void *serial_tx;
+
+#ifdef RT_USING_TASKLET
+    /* calls rx_indicate out of the ISR */
+    struct rt_tasklet         rx_tasklet;
+#endif
 };
 typedef struct rt_serial_device rt_serial_t;
 
@@ -27,6 +27,9 @@
  *                             the size of ring buffer.
  * 2014-07-10     bernard      rewrite serial framework
  * 2014-12-31     bernard      use open_flag for poll_tx stream mode.
+ * 2026-10-16     aclean       circular DMA Rx into the Rx fifo, DMA Tx
+ *                             channel configured on open.
+ * 2026-10-17     aclean       Rx fifo indication deferred to a tasklet.
  */
 
 #include <rthw.h>
@@ -162,6 +165,11 @@ rt_inline int _serial_dma_rx(struct rt_serial_device *serial, rt_uint8_t *data,
     struct rt_serial_rx_dma *rx_dma;
 
     RT_ASSERT((serial != RT_NULL) && (data != RT_NULL));
+
+    /* circular DMA: the driver fills the Rx fifo, read it like INT Rx */
+    if (serial->config.bufsz != 0)
+        return _serial_int_rx(serial, data, length);
+
     rx_dma = (struct rt_serial_rx_dma*)serial->serial_rx;
     RT_ASSERT(rx_dma != RT_NULL);
 
@@ -260,7 +268,25 @@ static rt_err_t rt_serial_open(struct rt_device *dev, rt_uint16_t oflag)
     /* initialize the Rx/Tx structure according to open flag */
     if (serial->serial_rx == RT_NULL)
     {
-        if (oflag & RT_DEVICE_FLAG_DMA_RX)
+        if ((oflag & RT_DEVICE_FLAG_DMA_RX) && serial->config.bufsz != 0)
+        {
+            struct rt_serial_rx_fifo* rx_fifo;
+
+            /* the driver runs a circular DMA into this fifo */
+            rx_fifo = (struct rt_serial_rx_fifo*) rt_malloc (sizeof(struct rt_serial_rx_fifo) +
+                serial->config.bufsz);
+            RT_ASSERT(rx_fifo != RT_NULL);
+            rx_fifo->buffer = (rt_uint8_t*) (rx_fifo + 1);
+            rt_memset(rx_fifo->buffer, 0, serial->config.bufsz);
+            rx_fifo->put_index = 0;
+            rx_fifo->get_index = 0;
+
+            serial->serial_rx = rx_fifo;
+            dev->open_flag |= RT_DEVICE_FLAG_DMA_RX;
+            /* configure low level device */
+            serial->ops->control(serial, RT_DEVICE_CTRL_CONFIG, (void *)RT_DEVICE_FLAG_DMA_RX);
+        }
+        else if (oflag & RT_DEVICE_FLAG_DMA_RX)
         {
             struct rt_serial_rx_dma* rx_dma;
 
@@ -303,10 +329,13 @@ static rt_err_t rt_serial_open(struct rt_device *dev, rt_uint16_t oflag)
             tx_dma = (struct rt_serial_tx_dma*) rt_malloc (sizeof(struct rt_serial_tx_dma));
             RT_ASSERT(tx_dma != RT_NULL);
             
+            tx_dma->activated = RT_FALSE;
             rt_data_queue_init(&(tx_dma->data_queue), 8, 4, RT_NULL);
             serial->serial_tx = tx_dma;
 
             dev->open_flag |= RT_DEVICE_FLAG_DMA_TX;
+            /* configure low level device */
+            serial->ops->control(serial, RT_DEVICE_CTRL_CONFIG, (void *)RT_DEVICE_FLAG_DMA_TX);
         }
         else if (oflag & RT_DEVICE_FLAG_INT_TX)
         {
@@ -341,6 +370,11 @@ static rt_err_t rt_serial_close(struct rt_device *dev)
     /* this device has more reference count */
     if (dev->ref_count > 1) return RT_EOK;
     
+#ifdef RT_USING_TASKLET
+    /* no indication for a fifo that goes away */
+    rt_tasklet_cancel(&(serial->rx_tasklet));
+#endif
+
     if (dev->open_flag & RT_DEVICE_FLAG_INT_RX)
     {
         struct rt_serial_rx_fifo* rx_fifo;
@@ -356,12 +390,13 @@ static rt_err_t rt_serial_close(struct rt_device *dev)
     }
     else if (dev->open_flag & RT_DEVICE_FLAG_DMA_RX)
     {
-        struct rt_serial_rx_dma* rx_dma;
+        /* stop the DMA before its buffer goes away */
+        if (serial->config.bufsz != 0)
+            serial->ops->control(serial, RT_DEVICE_CTRL_CLR_INT, (void*)RT_DEVICE_FLAG_DMA_RX);
 
-        rx_dma = (struct rt_serial_rx_dma*)serial->serial_tx;
-        RT_ASSERT(rx_dma != RT_NULL);
+        RT_ASSERT(serial->serial_rx != RT_NULL);
 
-        rt_free(rx_dma);
+        rt_free(serial->serial_rx);
         serial->serial_rx = RT_NULL;
         dev->open_flag &= ~RT_DEVICE_FLAG_DMA_RX;
     }
@@ -386,6 +421,8 @@ static rt_err_t rt_serial_close(struct rt_device *dev)
         tx_dma = (struct rt_serial_tx_dma*)serial->serial_tx;
         RT_ASSERT(tx_dma != RT_NULL);
 
+        serial->ops->control(serial, RT_DEVICE_CTRL_CLR_INT, (void*)RT_DEVICE_FLAG_DMA_TX);
+        rt_free(tx_dma->data_queue.queue);
         rt_free(tx_dma);
         serial->serial_tx = RT_NULL;
         dev->open_flag &= ~RT_DEVICE_FLAG_DMA_TX;
@@ -479,6 +516,44 @@ static rt_err_t rt_serial_control(struct rt_device *dev,
     return RT_EOK;
 }
 
+/* bytes in the Rx fifo, with the interrupts disabled */
+rt_inline rt_size_t _serial_fifo_length(struct rt_serial_device *serial,
+                                        struct rt_serial_rx_fifo *rx_fifo)
+{
+    return (rx_fifo->put_index >= rx_fifo->get_index)? (rx_fifo->put_index - rx_fifo->get_index):
+        (serial->config.bufsz - (rx_fifo->get_index - rx_fifo->put_index));
+}
+
+/*
+ * Rx indication, from the tasklet thread when there is one: the ISR only
+ * fills the fifo, the reader is told of all that came in since.
+ */
+static void _serial_rx_indicate(void *parameter)
+{
+    rt_base_t level;
+    rt_size_t rx_length = 0;
+    struct rt_serial_device *serial = (struct rt_serial_device *)parameter;
+    struct rt_serial_rx_fifo *rx_fifo;
+
+    level = rt_hw_interrupt_disable();
+    rx_fifo = (struct rt_serial_rx_fifo*)serial->serial_rx;
+    if (rx_fifo != RT_NULL)
+        rx_length = _serial_fifo_length(serial, rx_fifo);
+    rt_hw_interrupt_enable(level);
+
+    if (serial->parent.rx_indicate != RT_NULL && rx_length)
+        serial->parent.rx_indicate(&(serial->parent), rx_length);
+}
+
+rt_inline void _serial_rx_notify(struct rt_serial_device *serial)
+{
+#ifdef RT_USING_TASKLET
+    rt_tasklet_schedule(&(serial->rx_tasklet));
+#else
+    _serial_rx_indicate(serial);
+#endif
+}
+
 /*
  * serial register
  */
@@ -504,6 +579,10 @@ rt_err_t rt_hw_serial_register(struct rt_serial_device *serial,
     device->control     = rt_serial_control;
     device->user_data   = data;
 
+#ifdef RT_USING_TASKLET
+    rt_tasklet_init(&(serial->rx_tasklet), _serial_rx_indicate, serial);
+#endif
+
     /* register a character device */
     return rt_device_register(device, name, flag);
 }
@@ -550,18 +629,7 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
             }
             
             /* invoke callback */
-            if (serial->parent.rx_indicate != RT_NULL)
-            {
-                rt_size_t rx_length;
-            
-                /* get rx length */
-                level = rt_hw_interrupt_disable();
-                rx_length = (rx_fifo->put_index >= rx_fifo->get_index)? (rx_fifo->put_index - rx_fifo->get_index):
-                    (serial->config.bufsz - (rx_fifo->get_index - rx_fifo->put_index));
-                rt_hw_interrupt_enable(level);
-
-                serial->parent.rx_indicate(&serial->parent, rx_length);
-            }
+            _serial_rx_notify(serial);
             break;
         }
         case RT_SERIAL_EVENT_TX_DONE:
@@ -603,13 +671,38 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
         case RT_SERIAL_EVENT_RX_DMADONE:
         {
             int length;
-            struct rt_serial_rx_dma* rx_dma;
 
-            rx_dma = (struct rt_serial_rx_dma*)serial->serial_rx;
             /* get DMA rx length */
             length = (event & (~0xff)) >> 8;
-            serial->parent.rx_indicate(&(serial->parent), length);
-            rx_dma->activated = RT_FALSE;
+
+            if (serial->config.bufsz == 0)
+            {
+                struct rt_serial_rx_dma* rx_dma;
+
+                rx_dma = (struct rt_serial_rx_dma*)serial->serial_rx;
+                serial->parent.rx_indicate(&(serial->parent), length);
+                rx_dma->activated = RT_FALSE;
+            }
+            else
+            {
+                rt_base_t level;
+                rt_size_t rx_length;
+                struct rt_serial_rx_fifo* rx_fifo;
+
+                rx_fifo = (struct rt_serial_rx_fifo*)serial->serial_rx;
+                RT_ASSERT(rx_fifo != RT_NULL);
+
+                /* the DMA has already written 'length' bytes at put_index */
+                level = rt_hw_interrupt_disable();
+                rx_length = _serial_fifo_length(serial, rx_fifo);
+                rx_fifo->put_index = (rx_fifo->put_index + length) % serial->config.bufsz;
+                /* reader was overtaken, drop the oldest data */
+                if (rx_length + length >= serial->config.bufsz)
+                    rx_fifo->get_index = (rx_fifo->put_index + 1) % serial->config.bufsz;
+                rt_hw_interrupt_enable(level);
+
+                _serial_rx_notify(serial);
+            }
             break;
         }
     }
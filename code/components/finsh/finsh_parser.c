@@ -26,6 +26,7 @@
  * Date           Author       Notes
  * 2010-03-22     Bernard      first version
  * 2013-10-09     Bernard      fix the command line too long issue.
+ * 2026-10-17     aclean       terminate identifiers of FINSH_NAME_MAX characters.
  */
 #include <finsh.h>
 
@@ -401,6 +402,8 @@ static int proc_identifier(struct finsh_parser* self, char* id)
 	match_token(token, &(self->token), finsh_token_type_identifier);
 
 	strncpy(id, (char*)self->token.string, FINSH_NAME_MAX);
+	/* a name of FINSH_NAME_MAX characters is not terminated by strncpy */
+	id[FINSH_NAME_MAX] = '\0';
 
 	return 0;
 }
@@ -442,6 +442,18 @@ struct rt_timer
 };
 typedef struct rt_timer *rt_timer_t;
 
+/**
+ * tasklet structure, work deferred from an ISR to the tasklet thread
+ */
+struct rt_tasklet
+{
+    rt_list_t        list;                              /**< node in the tasklet queue, empty when not queued */
+
+    void (*func)(void *parameter);                      /**< tasklet function */
+    void            *parameter;                         /**< tasklet function's parameter */
+};
+typedef struct rt_tasklet *rt_tasklet_t;
+
 /*@}*/
 
 /**
@@ -98,6 +98,13 @@ void rt_hw_show_memory(rt_uint32_t addr, rt_uint32_t size);
  */
 void rt_hw_exception_install(rt_err_t (*exception_handle)(void *context));
 
+#ifdef RT_USING_TICKLESS
+/*
+ * Tickless interfaces
+ */
+rt_tick_t rt_hw_tickless_sleep(rt_tick_t ticks);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
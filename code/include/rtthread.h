@@ -90,6 +90,7 @@ rt_tick_t rt_tick_from_millisecond(rt_uint32_t ms);
 
 void rt_system_timer_init(void);
 void rt_system_timer_thread_init(void);
+void rt_system_tasklet_init(void);
 
 void rt_timer_init(rt_timer_t  timer,
                    const char *name,
@@ -115,6 +116,14 @@ void rt_timer_check(void);
 void rt_timer_timeout_sethook(void (*hook)(struct rt_timer *timer));
 #endif
 
+#ifdef RT_USING_TASKLET
+void rt_tasklet_init(rt_tasklet_t tasklet,
+                     void (*func)(void *parameter),
+                     void *parameter);
+void rt_tasklet_schedule(rt_tasklet_t tasklet);
+void rt_tasklet_cancel(rt_tasklet_t tasklet);
+#endif
+
 /*@}*/
 
 /**
@@ -449,6 +458,10 @@ rt_err_t rt_module_destroy(rt_module_t module);
  */
 void rt_interrupt_enter(void);
 void rt_interrupt_leave(void);
+#ifdef RT_USING_HOOK
+void rt_interrupt_enter_sethook(void (*hook)(void));
+void rt_interrupt_leave_sethook(void (*hook)(void));
+#endif
 
 /*
  * the number of nested interrupts.
@@ -15,9 +15,11 @@
  * 2012-12-23   aozima      stack addr align to 8byte.
  * 2012-12-29   Bernard     Add exception hook.
  * 2013-07-09   aozima      enhancement hard fault exception handler.
+ * 2026-10-16   aclean      add tickless sleep on SysTick.
  */
 
 #include <rtthread.h>
+#include <rthw.h>
 
 struct exception_stack_frame
 {
@@ -352,6 +354,97 @@ void rt_hw_cpu_shutdown(void)
     RT_ASSERT(0);
 }
 
+#ifdef RT_USING_TICKLESS
+#define SYSTICK_CTRL            (*(volatile rt_uint32_t *)0xE000E010)
+#define SYSTICK_LOAD            (*(volatile rt_uint32_t *)0xE000E014)
+#define SYSTICK_VAL             (*(volatile rt_uint32_t *)0xE000E018)
+
+#define SCB_ICSR                (*(volatile rt_uint32_t *)0xE000ED04)
+
+#define SYSTICK_CTRL_ENABLE     (1UL << 0)
+#define SYSTICK_MAX_RELOAD      0x00FFFFFFUL
+#define SCB_ICSR_PENDSTSET      (1UL << 26)
+
+/**
+ * This function stretches the SysTick period over several ticks and waits
+ * for an interrupt. It must be called with interrupts disabled; the
+ * interrupt that ends the sleep stays pending until they are enabled again.
+ *
+ * The BSP sets up SysTick for one OS tick, its reload value gives the
+ * cycles per tick.
+ *
+ * @param ticks the number of ticks until the next timer deadline
+ *
+ * @return the number of ticks the caller must account for. When the full
+ * sleep elapsed, the last tick is left to the pending SysTick interrupt.
+ */
+rt_tick_t rt_hw_tickless_sleep(rt_tick_t ticks)
+{
+    rt_uint32_t reload, remain, elapsed, next;
+
+    reload = SYSTICK_LOAD + 1;
+    if (ticks > SYSTICK_MAX_RELOAD / reload)
+        ticks = SYSTICK_MAX_RELOAD / reload;
+
+    /* keep the phase: count what is left of the current tick first */
+    SYSTICK_CTRL &= ~SYSTICK_CTRL_ENABLE;
+    remain = SYSTICK_VAL;
+    if (remain == 0 || (SCB_ICSR & SCB_ICSR_PENDSTSET))
+    {
+        /* a tick is already pending, don't sleep on it */
+        SYSTICK_CTRL |= SYSTICK_CTRL_ENABLE;
+        return 0;
+    }
+
+    SYSTICK_LOAD = remain + (ticks - 1) * reload - 1;
+    SYSTICK_VAL = 0;
+    SYSTICK_CTRL |= SYSTICK_CTRL_ENABLE;
+
+#if defined(__CC_ARM)
+    __dsb(0xF);
+    __wfi();
+#elif defined(__IAR_SYSTEMS_ICC__)
+    __ASM("DSB");
+    __ASM("WFI");
+#elif defined(__GNUC__)
+    __asm volatile ("dsb\n wfi" ::: "memory");
+#endif
+
+    SYSTICK_CTRL &= ~SYSTICK_CTRL_ENABLE;
+    if (SCB_ICSR & SCB_ICSR_PENDSTSET)
+    {
+        /* slept the whole period, SysTick interrupt is pending */
+        SYSTICK_LOAD = reload - 1;
+        SYSTICK_VAL = 0;
+        SYSTICK_CTRL |= SYSTICK_CTRL_ENABLE;
+
+        return ticks - 1;
+    }
+
+    /* woken up early by another interrupt */
+    elapsed = (remain + (ticks - 1) * reload - 1) - SYSTICK_VAL;
+    if (elapsed < remain)
+    {
+        ticks = 0;
+        next = remain - elapsed;
+    }
+    else
+    {
+        elapsed -= remain;
+        ticks = 1 + elapsed / reload;
+        next = reload - elapsed % reload;
+    }
+
+    /* run up to the next tick boundary, then back to one tick per period */
+    SYSTICK_LOAD = next - 1;
+    SYSTICK_VAL = 0;
+    SYSTICK_CTRL |= SYSTICK_CTRL_ENABLE;
+    SYSTICK_LOAD = reload - 1;
+
+    return ticks;
+}
+#endif
+
 #ifdef RT_USING_CPU_FFS
 /**
  * This function finds the first bit set (beginning with the least significant bit)
@@ -0,0 +1,384 @@
+/*
+ * File      : memfunc.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2016, RT-Thread Development Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rt-thread.org/license/LICENSE
+ *
+ * Change Logs:
+ * Date         Author      Notes
+ * 2026-10-16   aclean      first version
+ */
+
+/*
+ * rt_memcpy, rt_memset and rt_memmove in Thumb-2, used in place of the C
+ * versions of kservice.c with RT_USING_CPU_MEMFUNC.
+ *
+ * The head is copied by bytes until the destination is word aligned. When
+ * the source is then aligned too, the body goes 32 bytes per LDM/STM pair,
+ * else by unaligned word loads, which the Cortex-M3 does in hardware for
+ * normal memory, and aligned word stores. The tail is copied by words and
+ * then by bytes. Copies shorter than 8 bytes go by bytes.
+ *
+ * The copies leave CCR.UNALIGN_TRP as it is, which must stay cleared, and
+ * are not meant for device memory.
+ */
+
+#include <rtthread.h>
+
+#ifdef RT_USING_CPU_MEMFUNC
+
+#if defined(__CC_ARM)
+__asm void *rt_memset(void *s, int c, rt_ubase_t count)
+{
+    PRESERVE8
+
+    MOV     r12, r0
+    AND     r1, r1, #0xff
+    ORR     r1, r1, r1, LSL #8
+    ORR     r1, r1, r1, LSL #16
+    CMP     r2, #8
+    BLO     set_byte
+set_head
+    TST     r0, #3
+    BEQ     set_aligned
+    STRB    r1, [r0], #1
+    SUBS    r2, r2, #1
+    B       set_head
+set_aligned
+    SUBS    r2, r2, #32
+    BLO     set_block_end
+    PUSH    {r4, r5}
+    MOV     r3, r1
+    MOV     r4, r1
+    MOV     r5, r1
+set_block
+    STMIA   r0!, {r1, r3-r5}
+    STMIA   r0!, {r1, r3-r5}
+    SUBS    r2, r2, #32
+    BHS     set_block
+    POP     {r4, r5}
+set_block_end
+    ADDS    r2, r2, #32
+set_word
+    SUBS    r2, r2, #4
+    BLO     set_word_end
+    STR     r1, [r0], #4
+    B       set_word
+set_word_end
+    ADDS    r2, r2, #4
+set_byte
+    SUBS    r2, r2, #1
+    BLO     set_done
+    STRB    r1, [r0], #1
+    B       set_byte
+set_done
+    MOV     r0, r12
+    BX      lr
+}
+
+__asm void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
+{
+    PRESERVE8
+
+    MOV     r12, r0
+    CMP     r2, #8
+    BLO     cpy_byte
+cpy_head
+    TST     r0, #3
+    BEQ     cpy_aligned
+    LDRB    r3, [r1], #1
+    STRB    r3, [r0], #1
+    SUBS    r2, r2, #1
+    B       cpy_head
+cpy_aligned
+    TST     r1, #3
+    BNE     cpy_unaligned
+    SUBS    r2, r2, #32
+    BLO     cpy_block_end
+    PUSH    {r4-r11}
+cpy_block
+    LDMIA   r1!, {r3-r10}
+    STMIA   r0!, {r3-r10}
+    SUBS    r2, r2, #32
+    BHS     cpy_block
+    POP     {r4-r11}
+cpy_block_end
+    ADDS    r2, r2, #32
+    B       cpy_word
+cpy_unaligned
+    SUBS    r2, r2, #16
+    BLO     cpy_unaligned_end
+cpy_unaligned16
+    LDR     r3, [r1], #4
+    STR     r3, [r0], #4
+    LDR     r3, [r1], #4
+    STR     r3, [r0], #4
+    LDR     r3, [r1], #4
+    STR     r3, [r0], #4
+    LDR     r3, [r1], #4
+    STR     r3, [r0], #4
+    SUBS    r2, r2, #16
+    BHS     cpy_unaligned16
+cpy_unaligned_end
+    ADDS    r2, r2, #16
+cpy_word
+    SUBS    r2, r2, #4
+    BLO     cpy_word_end
+    LDR     r3, [r1], #4
+    STR     r3, [r0], #4
+    B       cpy_word
+cpy_word_end
+    ADDS    r2, r2, #4
+cpy_byte
+    SUBS    r2, r2, #1
+    BLO     cpy_done
+    LDRB    r3, [r1], #1
+    STRB    r3, [r0], #1
+    B       cpy_byte
+cpy_done
+    MOV     r0, r12
+    BX      lr
+}
+
+__asm void *rt_memmove(void *dest, const void *src, rt_ubase_t n)
+{
+    PRESERVE8
+
+    ; dest below src, or past its end: the forward copy is safe
+    SUBS    r3, r0, r1
+    CMP     r3, r2
+    BLO     mov_backward
+    B       __cpp(rt_memcpy)
+mov_backward
+    MOV     r12, r0
+    ADD     r0, r0, r2
+    ADD     r1, r1, r2
+    CMP     r2, #8
+    BLO     mov_byte
+mov_head
+    TST     r0, #3
+    BEQ     mov_aligned
+    LDRB    r3, [r1, #-1]!
+    STRB    r3, [r0, #-1]!
+    SUBS    r2, r2, #1
+    B       mov_head
+mov_aligned
+    TST     r1, #3
+    BNE     mov_word
+    SUBS    r2, r2, #32
+    BLO     mov_block_end
+    PUSH    {r4-r11}
+mov_block
+    LDMDB   r1!, {r3-r10}
+    STMDB   r0!, {r3-r10}
+    SUBS    r2, r2, #32
+    BHS     mov_block
+    POP     {r4-r11}
+mov_block_end
+    ADDS    r2, r2, #32
+mov_word
+    SUBS    r2, r2, #4
+    BLO     mov_word_end
+    LDR     r3, [r1, #-4]!
+    STR     r3, [r0, #-4]!
+    B       mov_word
+mov_word_end
+    ADDS    r2, r2, #4
+mov_byte
+    SUBS    r2, r2, #1
+    BLO     mov_done
+    LDRB    r3, [r1, #-1]!
+    STRB    r3, [r0, #-1]!
+    B       mov_byte
+mov_done
+    MOV     r0, r12
+    BX      lr
+}
+
+#elif defined(__GNUC__)
+__attribute__((naked)) void *rt_memset(void *s, int c, rt_ubase_t count)
+{
+    __asm volatile (
+    "    mov     ip, r0                  \n"
+    "    and     r1, r1, #0xff           \n"
+    "    orr     r1, r1, r1, lsl #8      \n"
+    "    orr     r1, r1, r1, lsl #16     \n"
+    "    cmp     r2, #8                  \n"
+    "    blo     .Lset_byte              \n"
+    ".Lset_head:                         \n"
+    "    tst     r0, #3                  \n"
+    "    beq     .Lset_aligned           \n"
+    "    strb    r1, [r0], #1            \n"
+    "    subs    r2, r2, #1              \n"
+    "    b       .Lset_head              \n"
+    ".Lset_aligned:                      \n"
+    "    subs    r2, r2, #32             \n"
+    "    blo     .Lset_block_end         \n"
+    "    push    {r4, r5}                \n"
+    "    mov     r3, r1                  \n"
+    "    mov     r4, r1                  \n"
+    "    mov     r5, r1                  \n"
+    ".Lset_block:                        \n"
+    "    stmia   r0!, {r1, r3-r5}        \n"
+    "    stmia   r0!, {r1, r3-r5}        \n"
+    "    subs    r2, r2, #32             \n"
+    "    bhs     .Lset_block             \n"
+    "    pop     {r4, r5}                \n"
+    ".Lset_block_end:                    \n"
+    "    adds    r2, r2, #32             \n"
+    ".Lset_word:                         \n"
+    "    subs    r2, r2, #4              \n"
+    "    blo     .Lset_word_end          \n"
+    "    str     r1, [r0], #4            \n"
+    "    b       .Lset_word              \n"
+    ".Lset_word_end:                     \n"
+    "    adds    r2, r2, #4              \n"
+    ".Lset_byte:                         \n"
+    "    subs    r2, r2, #1              \n"
+    "    blo     .Lset_done              \n"
+    "    strb    r1, [r0], #1            \n"
+    "    b       .Lset_byte              \n"
+    ".Lset_done:                         \n"
+    "    mov     r0, ip                  \n"
+    "    bx      lr                      \n"
+    );
+}
+
+__attribute__((naked)) void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
+{
+    __asm volatile (
+    "    mov     ip, r0                  \n"
+    "    cmp     r2, #8                  \n"
+    "    blo     .Lcpy_byte              \n"
+    ".Lcpy_head:                         \n"
+    "    tst     r0, #3                  \n"
+    "    beq     .Lcpy_aligned           \n"
+    "    ldrb    r3, [r1], #1            \n"
+    "    strb    r3, [r0], #1            \n"
+    "    subs    r2, r2, #1              \n"
+    "    b       .Lcpy_head              \n"
+    ".Lcpy_aligned:                      \n"
+    "    tst     r1, #3                  \n"
+    "    bne     .Lcpy_unaligned         \n"
+    "    subs    r2, r2, #32             \n"
+    "    blo     .Lcpy_block_end         \n"
+    "    push    {r4-r11}                \n"
+    ".Lcpy_block:                        \n"
+    "    ldmia   r1!, {r3-r10}           \n"
+    "    stmia   r0!, {r3-r10}           \n"
+    "    subs    r2, r2, #32             \n"
+    "    bhs     .Lcpy_block             \n"
+    "    pop     {r4-r11}                \n"
+    ".Lcpy_block_end:                    \n"
+    "    adds    r2, r2, #32             \n"
+    "    b       .Lcpy_word              \n"
+    ".Lcpy_unaligned:                    \n"
+    "    subs    r2, r2, #16             \n"
+    "    blo     .Lcpy_unaligned_end     \n"
+    ".Lcpy_unaligned16:                  \n"
+    "    ldr     r3, [r1], #4            \n"
+    "    str     r3, [r0], #4            \n"
+    "    ldr     r3, [r1], #4            \n"
+    "    str     r3, [r0], #4            \n"
+    "    ldr     r3, [r1], #4            \n"
+    "    str     r3, [r0], #4            \n"
+    "    ldr     r3, [r1], #4            \n"
+    "    str     r3, [r0], #4            \n"
+    "    subs    r2, r2, #16             \n"
+    "    bhs     .Lcpy_unaligned16       \n"
+    ".Lcpy_unaligned_end:                \n"
+    "    adds    r2, r2, #16             \n"
+    ".Lcpy_word:                         \n"
+    "    subs    r2, r2, #4              \n"
+    "    blo     .Lcpy_word_end          \n"
+    "    ldr     r3, [r1], #4            \n"
+    "    str     r3, [r0], #4            \n"
+    "    b       .Lcpy_word              \n"
+    ".Lcpy_word_end:                     \n"
+    "    adds    r2, r2, #4              \n"
+    ".Lcpy_byte:                         \n"
+    "    subs    r2, r2, #1              \n"
+    "    blo     .Lcpy_done              \n"
+    "    ldrb    r3, [r1], #1            \n"
+    "    strb    r3, [r0], #1            \n"
+    "    b       .Lcpy_byte              \n"
+    ".Lcpy_done:                         \n"
+    "    mov     r0, ip                  \n"
+    "    bx      lr                      \n"
+    );
+}
+
+__attribute__((naked)) void *rt_memmove(void *dest, const void *src, rt_ubase_t n)
+{
+    __asm volatile (
+    /* dest below src, or past its end: the forward copy is safe */
+    "    subs    r3, r0, r1              \n"
+    "    cmp     r3, r2                  \n"
+    "    blo     .Lmov_backward          \n"
+    "    b       rt_memcpy               \n"
+    ".Lmov_backward:                     \n"
+    "    mov     ip, r0                  \n"
+    "    add     r0, r0, r2              \n"
+    "    add     r1, r1, r2              \n"
+    "    cmp     r2, #8                  \n"
+    "    blo     .Lmov_byte              \n"
+    ".Lmov_head:                         \n"
+    "    tst     r0, #3                  \n"
+    "    beq     .Lmov_aligned           \n"
+    "    ldrb    r3, [r1, #-1]!          \n"
+    "    strb    r3, [r0, #-1]!          \n"
+    "    subs    r2, r2, #1              \n"
+    "    b       .Lmov_head              \n"
+    ".Lmov_aligned:                      \n"
+    "    tst     r1, #3                  \n"
+    "    bne     .Lmov_word              \n"
+    "    subs    r2, r2, #32             \n"
+    "    blo     .Lmov_block_end         \n"
+    "    push    {r4-r11}                \n"
+    ".Lmov_block:                        \n"
+    "    ldmdb   r1!, {r3-r10}           \n"
+    "    stmdb   r0!, {r3-r10}           \n"
+    "    subs    r2, r2, #32             \n"
+    "    bhs     .Lmov_block             \n"
+    "    pop     {r4-r11}                \n"
+    ".Lmov_block_end:                    \n"
+    "    adds    r2, r2, #32             \n"
+    ".Lmov_word:                         \n"
+    "    subs    r2, r2, #4              \n"
+    "    blo     .Lmov_word_end          \n"
+    "    ldr     r3, [r1, #-4]!          \n"
+    "    str     r3, [r0, #-4]!          \n"
+    "    b       .Lmov_word              \n"
+    ".Lmov_word_end:                     \n"
+    "    adds    r2, r2, #4              \n"
+    ".Lmov_byte:                         \n"
+    "    subs    r2, r2, #1              \n"
+    "    blo     .Lmov_done              \n"
+    "    ldrb    r3, [r1, #-1]!          \n"
+    "    strb    r3, [r0, #-1]!          \n"
+    "    b       .Lmov_byte              \n"
+    ".Lmov_done:                         \n"
+    "    mov     r0, ip                  \n"
+    "    bx      lr                      \n"
+    );
+}
+
+#if !defined (RT_USING_NEWLIB) && defined (RT_USING_MINILIBC)
+#include <sys/types.h>
+void *memcpy(void *dest, const void *src, size_t n) __attribute__((weak, alias("rt_memcpy")));
+void *memset(void *s, int c, size_t n) __attribute__((weak, alias("rt_memset")));
+void *memmove(void *dest, const void *src, size_t n) __attribute__((weak, alias("rt_memmove")));
+#endif
+
+#else
+#error "RT_USING_CPU_MEMFUNC is implemented for armcc and gcc"
+#endif
+
+RTM_EXPORT(rt_memset);
+RTM_EXPORT(rt_memcpy);
+RTM_EXPORT(rt_memmove);
+
+#endif
@@ -0,0 +1,322 @@
+/*
+ * File      : cpu_port.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Development Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rt-thread.org/license/LICENSE
+ *
+ * CPU port for running RT-Thread as a single Linux/POSIX process.
+ *
+ * Every RT-Thread thread is a ucontext with its own host stack, all of
+ * them run on the one host thread, so the scheduler keeps the exact same
+ * semantic as on a MCU. Interrupts are signals: a signal installed with
+ * rt_hw_interrupt_install() is an interrupt vector, disabling interrupts
+ * blocks all of them. A context switch requested by an interrupt handler
+ * is done once the handler returns, like PendSV does on the Cortex-M3.
+ *
+ * Change Logs:
+ * Date         Author      Notes
+ * 2026-10-16   aclean      first version
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+/* host stack of a thread, the RT-Thread stack is far too small for libc */
+#ifndef POSIX_THREAD_STACK_SIZE
+#define POSIX_THREAD_STACK_SIZE     (64 * 1024)
+#endif
+
+struct posix_thread
+{
+    ucontext_t context;
+
+    void *entry;
+    void *parameter;
+    void *exit;
+
+    /* the RT-Thread stack this context was created for */
+    rt_uint8_t *stack_addr;
+    struct posix_thread *next;
+
+    rt_uint8_t stack[POSIX_THREAD_STACK_SIZE];
+};
+
+/*
+ * Contexts are never freed, the port doesn't know when a thread is gone.
+ * They are reused when a thread is created again on the same stack, which
+ * bounds the memory to the number of thread stacks ever used.
+ */
+static struct posix_thread *posix_threads = RT_NULL;
+
+static struct rt_irq_desc irq_desc[NSIG];
+static rt_uint8_t irq_masked[NSIG];
+
+/* flag in interrupt handling */
+rt_uint32_t rt_interrupt_from_thread, rt_interrupt_to_thread;
+rt_uint32_t rt_thread_switch_interrupt_flag;
+
+/* the signals which are interrupts, blocked all together */
+static void posix_irq_set(sigset_t *set)
+{
+    sigemptyset(set);
+    sigaddset(set, SIGALRM);
+    sigaddset(set, SIGIO);
+    sigaddset(set, SIGUSR1);
+    sigaddset(set, SIGUSR2);
+}
+
+static void posix_thread_entry(void)
+{
+    struct posix_thread *thread;
+
+    thread = (struct posix_thread *)rt_thread_self()->sp;
+
+    ((void (*)(void *))thread->entry)(thread->parameter);
+    ((void (*)(void))thread->exit)();
+}
+
+/**
+ * This function will initialize thread stack
+ *
+ * @param tentry the entry of thread
+ * @param parameter the parameter of entry
+ * @param stack_addr the beginning stack address
+ * @param texit the function will be called when thread exit
+ *
+ * @return the host context of the thread, kept as its stack pointer
+ */
+rt_uint8_t *rt_hw_stack_init(void       *tentry,
+                             void       *parameter,
+                             rt_uint8_t *stack_addr,
+                             void       *texit)
+{
+    struct posix_thread *thread;
+
+    for (thread = posix_threads; thread != RT_NULL; thread = thread->next)
+    {
+        if (thread->stack_addr == stack_addr)
+            break;
+    }
+
+    if (thread == RT_NULL)
+    {
+        thread = (struct posix_thread *)malloc(sizeof(struct posix_thread));
+        RT_ASSERT(thread != RT_NULL);
+
+        thread->stack_addr = stack_addr;
+        thread->next = posix_threads;
+        posix_threads = thread;
+    }
+
+    thread->entry     = tentry;
+    thread->parameter = parameter;
+    thread->exit      = texit;
+
+    getcontext(&thread->context);
+    thread->context.uc_stack.ss_sp   = thread->stack;
+    thread->context.uc_stack.ss_size = sizeof(thread->stack);
+    thread->context.uc_link          = RT_NULL;
+    /* a thread starts with interrupts enabled */
+    sigemptyset(&thread->context.uc_sigmask);
+    makecontext(&thread->context, posix_thread_entry, 0);
+
+    return (rt_uint8_t *)thread;
+}
+
+rt_base_t rt_hw_interrupt_disable(void)
+{
+    sigset_t set, old;
+
+    posix_irq_set(&set);
+    sigprocmask(SIG_BLOCK, &set, &old);
+
+    return sigismember(&old, SIGALRM);
+}
+
+void rt_hw_interrupt_enable(rt_base_t level)
+{
+    sigset_t set;
+
+    if (level)
+        return;
+
+    posix_irq_set(&set);
+    sigprocmask(SIG_UNBLOCK, &set, RT_NULL);
+}
+
+void rt_hw_context_switch(rt_uint32_t from, rt_uint32_t to)
+{
+    struct posix_thread *from_thread = *(struct posix_thread **)from;
+    struct posix_thread *to_thread   = *(struct posix_thread **)to;
+
+    swapcontext(&from_thread->context, &to_thread->context);
+}
+
+void rt_hw_context_switch_to(rt_uint32_t to)
+{
+    struct posix_thread *to_thread = *(struct posix_thread **)to;
+
+    setcontext(&to_thread->context);
+}
+
+void rt_hw_context_switch_interrupt(rt_uint32_t from, rt_uint32_t to)
+{
+    if (rt_thread_switch_interrupt_flag == 0)
+    {
+        rt_thread_switch_interrupt_flag = 1;
+        rt_interrupt_from_thread = from;
+    }
+    rt_interrupt_to_thread = to;
+}
+
+/* common entry of all the interrupt signals, runs with all of them blocked */
+static void posix_irq_entry(int sig)
+{
+    rt_interrupt_enter();
+    if (irq_desc[sig].handler != RT_NULL && !irq_masked[sig])
+        irq_desc[sig].handler(sig, irq_desc[sig].param);
+    rt_interrupt_leave();
+
+    /* the pending switch, the preempted thread resumes here later on */
+    if (rt_thread_switch_interrupt_flag)
+    {
+        rt_thread_switch_interrupt_flag = 0;
+        rt_hw_context_switch(rt_interrupt_from_thread, rt_interrupt_to_thread);
+    }
+}
+
+void rt_hw_interrupt_init(void)
+{
+    rt_memset(irq_desc, 0, sizeof(irq_desc));
+    rt_memset(irq_masked, 0, sizeof(irq_masked));
+    rt_thread_switch_interrupt_flag = 0;
+}
+
+void rt_hw_interrupt_mask(int vector)
+{
+    if (vector > 0 && vector < NSIG)
+        irq_masked[vector] = 1;
+}
+
+void rt_hw_interrupt_umask(int vector)
+{
+    if (vector > 0 && vector < NSIG)
+        irq_masked[vector] = 0;
+}
+
+/**
+ * This function installs an interrupt service routine, the vector is a
+ * signal number: SIGALRM, SIGIO, SIGUSR1 or SIGUSR2.
+ */
+rt_isr_handler_t rt_hw_interrupt_install(int              vector,
+                                         rt_isr_handler_t handler,
+                                         void            *param,
+                                         char            *name)
+{
+    rt_isr_handler_t old_handler;
+    struct sigaction action;
+    sigset_t set;
+
+    posix_irq_set(&set);
+    if (vector <= 0 || vector >= NSIG || !sigismember(&set, vector))
+        return RT_NULL;
+
+    old_handler = irq_desc[vector].handler;
+    irq_desc[vector].handler = handler;
+    irq_desc[vector].param   = param;
+#ifdef RT_USING_INTERRUPT_INFO
+    rt_strncpy(irq_desc[vector].name, name, RT_NAME_MAX);
+    irq_desc[vector].counter = 0;
+#endif
+
+    rt_memset(&action, 0, sizeof(action));
+    action.sa_handler = posix_irq_entry;
+    action.sa_mask    = set;
+    action.sa_flags   = SA_RESTART;
+    sigaction(vector, &action, RT_NULL);
+
+    return old_handler;
+}
+
+void rt_hw_cpu_reset(void)
+{
+    fflush(stdout);
+    exit(0);
+}
+
+void rt_hw_cpu_shutdown(void)
+{
+    rt_kprintf("shutdown...\n");
+    fflush(stdout);
+    exit(0);
+}
+
+#ifdef RT_USING_TICKLESS
+#define POSIX_NSEC_PER_TICK     (1000000000L / RT_TICK_PER_SECOND)
+
+static void posix_tick_timer(long usec)
+{
+    struct itimerval timer;
+
+    timer.it_interval.tv_sec  = usec / 1000000;
+    timer.it_interval.tv_usec = usec % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, RT_NULL);
+}
+
+/**
+ * The tick is the ITIMER_REAL of the process, SIGALRM, set up by the BSP.
+ * Same contract as on the MCU: called with interrupts disabled, when the
+ * full sleep elapsed the last tick is left pending to the tick handler.
+ */
+rt_tick_t rt_hw_tickless_sleep(rt_tick_t ticks)
+{
+    sigset_t set, pending;
+    struct timespec timeout, start, now;
+    siginfo_t info;
+    long elapsed;
+    int sig;
+
+    sigpending(&pending);
+    if (sigismember(&pending, SIGALRM))
+        return 0;
+
+    posix_tick_timer(0);
+
+    timeout.tv_sec  = ticks / RT_TICK_PER_SECOND;
+    timeout.tv_nsec = (ticks % RT_TICK_PER_SECOND) * POSIX_NSEC_PER_TICK;
+
+    posix_irq_set(&set);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sig = sigtimedwait(&set, &info, &timeout);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    posix_tick_timer(1000000L / RT_TICK_PER_SECOND);
+
+    /* the signal is taken again once interrupts are enabled */
+    if (sig < 0)
+        sig = SIGALRM;
+    raise(sig);
+
+    elapsed = (now.tv_sec - start.tv_sec) * RT_TICK_PER_SECOND +
+              (now.tv_nsec - start.tv_nsec) / POSIX_NSEC_PER_TICK;
+    if (elapsed < 0)
+        elapsed = 0;
+    if ((rt_tick_t)elapsed >= ticks)
+        elapsed = ticks - 1;
+
+    return elapsed;
+}
+#endif
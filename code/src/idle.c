@@ -24,6 +24,7 @@
  * 2012-12-29     Bernard      fix compiling warning.
  * 2013-12-21     Grissiom     let rt_thread_idle_excute loop until there is no
  *                             dead thread.
+ * 2026-10-16     aclean       add tickless idle.
  */
 
 #include <rthw.h>
@@ -174,6 +175,55 @@ void rt_thread_idle_excute(void)
     }
 }
 
+#ifdef RT_USING_TICKLESS
+/* no point in stopping the tick for less than this */
+#ifndef RT_TICKLESS_MIN_TICKS
+#define RT_TICKLESS_MIN_TICKS   2
+#endif
+
+/**
+ * @ingroup Thread
+ *
+ * This function sleeps the CPU until the next timer deadline or an interrupt,
+ * with the periodic tick stopped, then accounts the ticks that passed.
+ */
+static void rt_thread_idle_tickless(void)
+{
+    rt_base_t level;
+    rt_tick_t timeout, ticks;
+
+    level = rt_hw_interrupt_disable();
+
+    timeout = rt_timer_next_timeout_tick();
+    if (timeout == RT_TICK_MAX)
+        /* no timer armed, sleep as long as the port can: it clips the ticks */
+        ticks = RT_TICK_MAX / 2 - 1;
+    else
+        ticks = timeout - rt_tick_get();
+
+    /* deadline is close or already passed, keep the periodic tick */
+    if (ticks >= RT_TICK_MAX / 2 || ticks < RT_TICKLESS_MIN_TICKS)
+    {
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    /* the port clips the sleep to what its timer can count */
+    ticks = rt_hw_tickless_sleep(ticks);
+    rt_tick_set(rt_tick_get() + ticks);
+
+    /* the interrupt that woke us up is served here */
+    rt_hw_interrupt_enable(level);
+
+    if (ticks != 0)
+    {
+        extern void rt_timer_check(void);
+
+        rt_timer_check();
+    }
+}
+#endif
+
 static void rt_thread_idle_entry(void *parameter)
 {
     while (1)
@@ -184,6 +234,10 @@ static void rt_thread_idle_entry(void *parameter)
         #endif
 
         rt_thread_idle_excute();
+
+        #ifdef RT_USING_TICKLESS
+        rt_thread_idle_tickless();
+        #endif
     }
 }
 
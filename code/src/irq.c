@@ -21,6 +21,7 @@
  * Date           Author       Notes
  * 2006-02-24     Bernard      first version
  * 2006-05-03     Bernard      add IRQ_DEBUG
+ * 2026-10-17     aclean       add interrupt enter and leave hooks
  */
 
 #include <rthw.h>
@@ -36,6 +37,41 @@
 
 volatile rt_uint8_t rt_interrupt_nest;
 
+#ifdef RT_USING_HOOK
+static void (*rt_interrupt_enter_hook)(void);
+static void (*rt_interrupt_leave_hook)(void);
+
+/**
+ * @addtogroup Hook
+ */
+
+/*@{*/
+
+/**
+ * This function will set a hook function, which will be invoked when enter
+ * interrupt service routine, with the interrupt nest already increased.
+ *
+ * @param hook the hook function
+ */
+void rt_interrupt_enter_sethook(void (*hook)(void))
+{
+    rt_interrupt_enter_hook = hook;
+}
+
+/**
+ * This function will set a hook function, which will be invoked when leave
+ * interrupt service routine, with the interrupt nest already decreased.
+ *
+ * @param hook the hook function
+ */
+void rt_interrupt_leave_sethook(void (*hook)(void))
+{
+    rt_interrupt_leave_hook = hook;
+}
+
+/*@}*/
+#endif
+
 /**
  * This function will be invoked by BSP, when enter interrupt service routine
  *
@@ -52,6 +88,7 @@ void rt_interrupt_enter(void)
 
     level = rt_hw_interrupt_disable();
     rt_interrupt_nest ++;
+    RT_OBJECT_HOOK_CALL(rt_interrupt_enter_hook, ());
     rt_hw_interrupt_enable(level);
 }
 RTM_EXPORT(rt_interrupt_enter);
@@ -72,6 +109,7 @@ void rt_interrupt_leave(void)
 
     level = rt_hw_interrupt_disable();
     rt_interrupt_nest --;
+    RT_OBJECT_HOOK_CALL(rt_interrupt_leave_hook, ());
     rt_hw_interrupt_enable(level);
 }
 RTM_EXPORT(rt_interrupt_leave);
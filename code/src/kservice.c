@@ -123,6 +123,7 @@ int *_rt_errno(void)
 }
 RTM_EXPORT(_rt_errno);
 
+#ifndef RT_USING_CPU_MEMFUNC
 /**
  * This function will set the content of memory to specified value
  *
@@ -311,6 +312,7 @@ void *rt_memmove(void *dest, const void *src, rt_ubase_t n)
     return dest;
 }
 RTM_EXPORT(rt_memmove);
+#endif /* RT_USING_CPU_MEMFUNC */
 
 /**
  * This function will compare two areas of memory
@@ -1239,9 +1241,11 @@ int __rt_ffs(int value)
 
 #if !defined (RT_USING_NEWLIB) && defined (RT_USING_MINILIBC) && defined (__GNUC__)
 #include <sys/types.h>
+#ifndef RT_USING_CPU_MEMFUNC
 void *memcpy(void *dest, const void *src, size_t n) __attribute__((weak, alias("rt_memcpy")));
 void *memset(void *s, int c, size_t n) __attribute__((weak, alias("rt_memset")));
 void *memmove(void *dest, const void *src, size_t n) __attribute__((weak, alias("rt_memmove")));
+#endif
 int   memcmp(const void *s1, const void *s2, size_t n) __attribute__((weak, alias("rt_memcmp")));
 
 size_t strlen(const char *s) __attribute__((weak, alias("rt_strlen")));
@@ -0,0 +1,188 @@
+/*
+ * File      : tasklet.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2016, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     aclean       the first version
+ */
+
+/*
+ * Deferred interrupt work.
+ *
+ * An ISR does the part of its work that cannot wait, hands the rest to a
+ * tasklet with rt_tasklet_schedule() and returns. The tasklet is a node in
+ * the caller's own structure, so scheduling it takes no memory and a few
+ * instructions with the interrupts off. The tasklets run one after the other
+ * in the tasklet thread; with RT_TASKLET_THREAD_PRIO 0 the scheduler switches
+ * to it on the interrupt exit, before any other thread runs.
+ *
+ * A tasklet is queued at most once: scheduling it again before it runs does
+ * nothing, so its function must handle all the work pending at the time it
+ * runs, not one event. It is taken off the queue before its function is
+ * called, and may be scheduled again while it runs.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_TASKLET
+
+#ifndef RT_TASKLET_THREAD_STACK_SIZE
+#define RT_TASKLET_THREAD_STACK_SIZE    512
+#endif
+
+#ifndef RT_TASKLET_THREAD_PRIO
+#define RT_TASKLET_THREAD_PRIO          0
+#endif
+
+static rt_list_t rt_tasklet_list;
+static struct rt_semaphore rt_tasklet_sem;
+static struct rt_thread tasklet_thread;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t tasklet_thread_stack[RT_TASKLET_THREAD_STACK_SIZE];
+
+/**
+ * @addtogroup Clock
+ */
+
+/*@{*/
+
+/**
+ * This function will initialize a tasklet.
+ *
+ * @param tasklet the tasklet to be initialized
+ * @param func the function to run in the tasklet thread
+ * @param parameter the parameter of the function
+ */
+void rt_tasklet_init(rt_tasklet_t tasklet,
+                     void (*func)(void *parameter),
+                     void *parameter)
+{
+    RT_ASSERT(tasklet != RT_NULL);
+    RT_ASSERT(func != RT_NULL);
+
+    rt_list_init(&(tasklet->list));
+    tasklet->func      = func;
+    tasklet->parameter = parameter;
+}
+RTM_EXPORT(rt_tasklet_init);
+
+/**
+ * This function will queue a tasklet to the tasklet thread. It may be called
+ * from an ISR.
+ *
+ * @param tasklet the tasklet to be queued
+ */
+void rt_tasklet_schedule(rt_tasklet_t tasklet)
+{
+    register rt_base_t level;
+    rt_bool_t wakeup;
+
+    RT_ASSERT(tasklet != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    /* already queued */
+    if (!rt_list_isempty(&(tasklet->list)))
+    {
+        rt_hw_interrupt_enable(level);
+
+        return;
+    }
+    wakeup = rt_list_isempty(&rt_tasklet_list);
+    rt_list_insert_before(&rt_tasklet_list, &(tasklet->list));
+    rt_hw_interrupt_enable(level);
+
+    /* the thread takes the semaphore once per empty queue */
+    if (wakeup)
+        rt_sem_release(&rt_tasklet_sem);
+}
+RTM_EXPORT(rt_tasklet_schedule);
+
+/**
+ * This function will take a tasklet off the queue if it has not run yet.
+ *
+ * @param tasklet the tasklet to be cancelled
+ */
+void rt_tasklet_cancel(rt_tasklet_t tasklet)
+{
+    register rt_base_t level;
+
+    RT_ASSERT(tasklet != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    rt_list_remove(&(tasklet->list));
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_tasklet_cancel);
+
+/* system tasklet thread entry */
+static void rt_thread_tasklet_entry(void *parameter)
+{
+    register rt_base_t level;
+    rt_tasklet_t tasklet;
+
+    while (1)
+    {
+        rt_sem_take(&rt_tasklet_sem, RT_WAITING_FOREVER);
+
+        level = rt_hw_interrupt_disable();
+        while (!rt_list_isempty(&rt_tasklet_list))
+        {
+            tasklet = rt_list_entry(rt_tasklet_list.next,
+                                    struct rt_tasklet, list);
+            rt_list_remove(&(tasklet->list));
+            rt_hw_interrupt_enable(level);
+
+            tasklet->func(tasklet->parameter);
+
+            level = rt_hw_interrupt_disable();
+        }
+        rt_hw_interrupt_enable(level);
+    }
+}
+
+/*@}*/
+
+#endif
+
+/**
+ * @ingroup SystemInit
+ *
+ * This function will initialize system tasklet thread
+ */
+void rt_system_tasklet_init(void)
+{
+#ifdef RT_USING_TASKLET
+    rt_list_init(&rt_tasklet_list);
+    rt_sem_init(&rt_tasklet_sem, "tasklet", 0, RT_IPC_FLAG_FIFO);
+
+    /* start tasklet thread */
+    rt_thread_init(&tasklet_thread,
+                   "tasklet",
+                   rt_thread_tasklet_entry,
+                   RT_NULL,
+                   &tasklet_thread_stack[0],
+                   sizeof(tasklet_thread_stack),
+                   RT_TASKLET_THREAD_PRIO,
+                   10);
+
+    /* startup */
+    rt_thread_startup(&tasklet_thread);
+#endif
+}
@@ -30,13 +30,56 @@
  * 2012-12-15     Bernard      fix the next timeout issue in soft timer
  * 2014-07-12     Bernard      does not lock scheduler when invoking soft-timer 
  *                             timeout function.
+ * 2026-10-16     aclean       add the timing wheel of the hard timers
  */
 
 #include <rtthread.h>
 #include <rthw.h>
 
+#ifdef RT_USING_TIMER_WHEEL
+/*
+ * The hard timers are kept in a hierarchical timing wheel instead of the
+ * sorted list: starting and stopping a timer takes constant time, and the
+ * tick moves the timers of one slot at most down a level.
+ *
+ * A timer is in the level of the highest group of RT_TIMER_WHEEL_BITS bits
+ * in which its timeout tick differs from the tick of the wheel, in the slot
+ * given by the timeout tick bits of that group; timers further away than
+ * the levels go to the overflow list. So all the timers of a timeout tick
+ * are in the same slot, in the order they were started, and a slot moves
+ * down as a whole when the tick of the wheel enters its block.
+ */
+#ifndef RT_TIMER_WHEEL_BITS
+#define RT_TIMER_WHEEL_BITS         4
+#endif
+#ifndef RT_TIMER_WHEEL_LEVELS
+#define RT_TIMER_WHEEL_LEVELS       4
+#endif
+
+#if (1 << RT_TIMER_WHEEL_BITS) > 32 || RT_TIMER_WHEEL_BITS * RT_TIMER_WHEEL_LEVELS >= 32
+#error "the timer wheel has at most 32 slots a level and less than 32 bits"
+#endif
+
+#define TIMER_WHEEL_SLOTS           (1UL << RT_TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK            (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_SHIFT(level)    ((level) * RT_TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_INDEX(tick, level) \
+    (((tick) >> TIMER_WHEEL_SHIFT(level)) & TIMER_WHEEL_MASK)
+/* the wheel links the timers by the row of the sorted list */
+#define TIMER_WHEEL_ROW             (RT_TIMER_SKIP_LIST_LEVEL - 1)
+
+static rt_list_t rt_timer_wheel[RT_TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+/* slots that may have timers, a bit is cleared when its slot is found empty */
+static rt_uint32_t rt_timer_wheel_map[RT_TIMER_WHEEL_LEVELS];
+static rt_list_t rt_timer_wheel_overflow;
+/* timers started at the tick of the wheel or before, for the next check */
+static rt_list_t rt_timer_wheel_due;
+/* the last tick checked */
+static rt_tick_t rt_timer_wheel_tick;
+#else
 /* hard timer list */
 static rt_list_t rt_timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+#endif
 
 #ifdef RT_USING_TIMER_SOFT
 #ifndef RT_TIMER_THREAD_STACK_SIZE
@@ -106,6 +149,7 @@ static void _rt_timer_init(rt_timer_t timer,
     }
 }
 
+#if !defined(RT_USING_TIMER_WHEEL) || defined(RT_USING_TIMER_SOFT)
 /* the fist timer always in the last row */
 static rt_tick_t rt_timer_list_next_timeout(rt_list_t timer_list[])
 {
@@ -119,6 +163,7 @@ static rt_tick_t rt_timer_list_next_timeout(rt_list_t timer_list[])
 
     return timer->timeout_tick;
 }
+#endif
 
 rt_inline void _rt_timer_remove(rt_timer_t timer)
 {
@@ -130,6 +175,216 @@ rt_inline void _rt_timer_remove(rt_timer_t timer)
     }
 }
 
+#if !defined(RT_USING_TIMER_WHEEL) || defined(RT_USING_TIMER_SOFT)
+static void _rt_timer_list_insert(rt_list_t timer_list[], rt_timer_t timer)
+{
+    unsigned int row_lvl;
+    rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
+    unsigned int tst_nr;
+    static unsigned int random_nr;
+
+    row_head[0]  = &timer_list[0];
+    for (row_lvl = 0; row_lvl < RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
+    {
+        for (;row_head[row_lvl] != timer_list[row_lvl].prev;
+             row_head[row_lvl]  = row_head[row_lvl]->next)
+        {
+            struct rt_timer *t;
+            rt_list_t *p = row_head[row_lvl]->next;
+
+            /* fix up the entry pointer */
+            t = rt_list_entry(p, struct rt_timer, row[row_lvl]);
+
+            /* If we have two timers that timeout at the same time, it's
+             * preferred that the timer inserted early get called early.
+             * So insert the new timer to the end the the some-timeout timer
+             * list.
+             */
+            if ((t->timeout_tick - timer->timeout_tick) == 0)
+            {
+                continue;
+            }
+            else if ((t->timeout_tick - timer->timeout_tick) < RT_TICK_MAX / 2)
+            {
+                break;
+            }
+        }
+        if (row_lvl != RT_TIMER_SKIP_LIST_LEVEL - 1)
+            row_head[row_lvl+1] = row_head[row_lvl]+1;
+    }
+
+    /* Interestingly, this super simple timer insert counter works very very
+     * well on distributing the list height uniformly. By means of "very very
+     * well", I mean it beats the randomness of timer->timeout_tick very easily
+     * (actually, the timeout_tick is not random and easy to be attacked). */
+    random_nr++;
+    tst_nr = random_nr;
+
+    rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL-1],
+                         &(timer->row[RT_TIMER_SKIP_LIST_LEVEL-1]));
+    for (row_lvl = 2; row_lvl <= RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
+    {
+        if (!(tst_nr & RT_TIMER_SKIP_LIST_MASK))
+            rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - row_lvl],
+                                 &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - row_lvl]));
+        else
+            break;
+        /* Shift over the bits we have tested. Works well with 1 bit and 2
+         * bits. */
+        tst_nr >>= (RT_TIMER_SKIP_LIST_MASK+1)>>1;
+    }
+}
+#endif
+
+#ifdef RT_USING_TIMER_WHEEL
+static void _rt_timer_wheel_insert(rt_timer_t timer)
+{
+    rt_tick_t diff;
+    rt_ubase_t index;
+    rt_list_t *slot;
+    int level;
+
+    /* the tick of the wheel was checked, run it at the next check */
+    if ((timer->timeout_tick - rt_timer_wheel_tick - 1) >= RT_TICK_MAX / 2)
+    {
+        slot = &rt_timer_wheel_due;
+    }
+    else
+    {
+        diff = timer->timeout_tick ^ rt_timer_wheel_tick;
+        for (level = 0; level < RT_TIMER_WHEEL_LEVELS; level++)
+        {
+            if ((diff >> TIMER_WHEEL_SHIFT(level + 1)) == 0)
+                break;
+        }
+
+        if (level == RT_TIMER_WHEEL_LEVELS)
+        {
+            slot = &rt_timer_wheel_overflow;
+        }
+        else
+        {
+            index = TIMER_WHEEL_INDEX(timer->timeout_tick, level);
+            slot  = &rt_timer_wheel[level][index];
+            rt_timer_wheel_map[level] |= 1UL << index;
+        }
+    }
+
+    /* behind the timers of the same timeout tick started before */
+    rt_list_insert_before(slot, &(timer->row[TIMER_WHEEL_ROW]));
+}
+
+/* puts the timers of a slot again where they go at the tick of the wheel */
+static void _rt_timer_wheel_move(rt_list_t *slot)
+{
+    struct rt_timer *t;
+    rt_list_t list;
+
+    if (rt_list_isempty(slot))
+        return;
+
+    /* take the timers off the slot, the overflow ones may go back into it */
+    list.next = slot->next;
+    list.prev = slot->prev;
+    list.next->prev = &list;
+    list.prev->next = &list;
+    rt_list_init(slot);
+
+    while (!rt_list_isempty(&list))
+    {
+        t = rt_list_entry(list.next, struct rt_timer, row[TIMER_WHEEL_ROW]);
+        rt_list_remove(&(t->row[TIMER_WHEEL_ROW]));
+        _rt_timer_wheel_insert(t);
+    }
+}
+
+/* the tick of the wheel entered the block of a slot, move its timers down */
+static void _rt_timer_wheel_cascade(void)
+{
+    rt_ubase_t index;
+    int level;
+
+    for (level = 1; level <= RT_TIMER_WHEEL_LEVELS; level++)
+    {
+        if (rt_timer_wheel_tick & ((1UL << TIMER_WHEEL_SHIFT(level)) - 1))
+            break;
+    }
+
+    /* from the highest one, its timers may go to the slots below */
+    while (--level > 0)
+    {
+        if (level == RT_TIMER_WHEEL_LEVELS)
+        {
+            _rt_timer_wheel_move(&rt_timer_wheel_overflow);
+            continue;
+        }
+
+        index = TIMER_WHEEL_INDEX(rt_timer_wheel_tick, level);
+        if (rt_timer_wheel_map[level] & (1UL << index))
+        {
+            rt_timer_wheel_map[level] &= ~(1UL << index);
+            _rt_timer_wheel_move(&rt_timer_wheel[level][index]);
+        }
+    }
+}
+
+/* the earliest timeout tick in a slot, RT_TICK_MAX for none */
+static rt_tick_t _rt_timer_wheel_earliest(rt_list_t *slot)
+{
+    struct rt_timer *t;
+    rt_list_t *n;
+    rt_tick_t next = RT_TICK_MAX, delta = RT_TICK_MAX;
+
+    for (n = slot->next; n != slot; n = n->next)
+    {
+        t = rt_list_entry(n, struct rt_timer, row[TIMER_WHEEL_ROW]);
+        if (t->timeout_tick - rt_timer_wheel_tick < delta)
+        {
+            delta = t->timeout_tick - rt_timer_wheel_tick;
+            next  = t->timeout_tick;
+        }
+    }
+
+    return next;
+}
+
+static rt_tick_t rt_timer_wheel_next_timeout(void)
+{
+    rt_ubase_t index;
+    rt_list_t *slot;
+    int level;
+
+    if (!rt_list_isempty(&rt_timer_wheel_due))
+        return _rt_timer_wheel_earliest(&rt_timer_wheel_due);
+
+    /*
+     * the slots up to the one of the tick of the wheel are empty in each
+     * level, and a level has only timers after those of the levels below
+     */
+    for (level = 0; level < RT_TIMER_WHEEL_LEVELS; level++)
+    {
+        for (index = TIMER_WHEEL_INDEX(rt_timer_wheel_tick, level) + 1;
+             index < TIMER_WHEEL_SLOTS;
+             index++)
+        {
+            if (!(rt_timer_wheel_map[level] & (1UL << index)))
+                continue;
+
+            slot = &rt_timer_wheel[level][index];
+            if (rt_list_isempty(slot))
+            {
+                rt_timer_wheel_map[level] &= ~(1UL << index);
+                continue;
+            }
+
+            return _rt_timer_wheel_earliest(slot);
+        }
+    }
+
+    return _rt_timer_wheel_earliest(&rt_timer_wheel_overflow);
+}
+#endif
+
 #if RT_DEBUG_TIMER
 static int rt_timer_count_height(struct rt_timer *timer)
 {
@@ -293,12 +548,7 @@ RTM_EXPORT(rt_timer_delete);
  */
 rt_err_t rt_timer_start(rt_timer_t timer)
 {
-    unsigned int row_lvl;
-    rt_list_t *timer_list;
     register rt_base_t level;
-    rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
-    unsigned int tst_nr;
-    static unsigned int random_nr;
 
     /* timer check */
     RT_ASSERT(timer != RT_NULL);
@@ -327,64 +577,17 @@ rt_err_t rt_timer_start(rt_timer_t timer)
     if (timer->parent.flag & RT_TIMER_FLAG_SOFT_TIMER)
     {
         /* insert timer to soft timer list */
-        timer_list = rt_soft_timer_list;
+        _rt_timer_list_insert(rt_soft_timer_list, timer);
     }
     else
 #endif
     {
         /* insert timer to system timer list */
-        timer_list = rt_timer_list;
-    }
-
-    row_head[0]  = &timer_list[0];
-    for (row_lvl = 0; row_lvl < RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
-    {
-        for (;row_head[row_lvl] != timer_list[row_lvl].prev;
-             row_head[row_lvl]  = row_head[row_lvl]->next)
-        {
-            struct rt_timer *t;
-            rt_list_t *p = row_head[row_lvl]->next;
-
-            /* fix up the entry pointer */
-            t = rt_list_entry(p, struct rt_timer, row[row_lvl]);
-
-            /* If we have two timers that timeout at the same time, it's
-             * preferred that the timer inserted early get called early.
-             * So insert the new timer to the end the the some-timeout timer
-             * list.
-             */
-            if ((t->timeout_tick - timer->timeout_tick) == 0)
-            {
-                continue;
-            }
-            else if ((t->timeout_tick - timer->timeout_tick) < RT_TICK_MAX / 2)
-            {
-                break;
-            }
-        }
-        if (row_lvl != RT_TIMER_SKIP_LIST_LEVEL - 1)
-            row_head[row_lvl+1] = row_head[row_lvl]+1;
-    }
-
-    /* Interestingly, this super simple timer insert counter works very very
-     * well on distributing the list height uniformly. By means of "very very
-     * well", I mean it beats the randomness of timer->timeout_tick very easily
-     * (actually, the timeout_tick is not random and easy to be attacked). */
-    random_nr++;
-    tst_nr = random_nr;
-
-    rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL-1],
-                         &(timer->row[RT_TIMER_SKIP_LIST_LEVEL-1]));
-    for (row_lvl = 2; row_lvl <= RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
-    {
-        if (!(tst_nr & RT_TIMER_SKIP_LIST_MASK))
-            rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - row_lvl],
-                                 &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - row_lvl]));
-        else
-            break;
-        /* Shift over the bits we have tested. Works well with 1 bit and 2
-         * bits. */
-        tst_nr >>= (RT_TIMER_SKIP_LIST_MASK+1)>>1;
+#ifdef RT_USING_TIMER_WHEEL
+        _rt_timer_wheel_insert(timer);
+#else
+        _rt_timer_list_insert(rt_timer_list, timer);
+#endif
     }
 
     timer->parent.flag |= RT_TIMER_FLAG_ACTIVATED;
@@ -479,6 +682,109 @@ rt_err_t rt_timer_control(rt_timer_t timer, rt_uint8_t cmd, void *arg)
 }
 RTM_EXPORT(rt_timer_control);
 
+#ifdef RT_USING_TIMER_WHEEL
+/* runs the timers of a slot, which are all due */
+static void _rt_timer_wheel_run(rt_list_t *slot)
+{
+    struct rt_timer *t;
+
+    while (!rt_list_isempty(slot))
+    {
+        t = rt_list_entry(slot->next, struct rt_timer, row[TIMER_WHEEL_ROW]);
+
+        RT_OBJECT_HOOK_CALL(rt_timer_timeout_hook, (t));
+
+        /* remove timer from timer list firstly */
+        _rt_timer_remove(t);
+
+        /* call timeout function */
+        t->timeout_func(t->parameter);
+
+        RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", rt_tick_get()));
+
+        if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+            (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+        {
+            /* start it */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            rt_timer_start(t);
+        }
+        else
+        {
+            /* stop timer */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+        }
+    }
+}
+
+/**
+ * This function will check timer wheel, if a timeout event happens, the
+ * corresponding timeout function will be invoked.
+ *
+ * @note this function shall be invoked in operating system timer interrupt.
+ */
+void rt_timer_check(void)
+{
+    rt_tick_t current_tick, rest;
+    rt_ubase_t index;
+    register rt_base_t level;
+
+    RT_DEBUG_LOG(RT_DEBUG_TIMER, ("timer check enter\n"));
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    while (1)
+    {
+        _rt_timer_wheel_run(&rt_timer_wheel_due);
+
+        /* re-get tick, more than one passed after a tickless sleep */
+        current_tick = rt_tick_get();
+        if (rt_timer_wheel_tick == current_tick)
+            break;
+
+        /* no timer in the rest of the level 0 block, go to its last tick */
+        rest = (rt_timer_wheel_tick | TIMER_WHEEL_MASK) - rt_timer_wheel_tick;
+        if (rest != 0 &&
+            (rt_timer_wheel_map[0] >> (rt_timer_wheel_tick & TIMER_WHEEL_MASK) >> 1) == 0)
+        {
+            if (rest > current_tick - rt_timer_wheel_tick)
+                rest = current_tick - rt_timer_wheel_tick;
+            rt_timer_wheel_tick += rest;
+            continue;
+        }
+
+        rt_timer_wheel_tick ++;
+        _rt_timer_wheel_cascade();
+
+        index = rt_timer_wheel_tick & TIMER_WHEEL_MASK;
+        rt_timer_wheel_map[0] &= ~(1UL << index);
+        _rt_timer_wheel_run(&rt_timer_wheel[0][index]);
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    RT_DEBUG_LOG(RT_DEBUG_TIMER, ("timer check leave\n"));
+}
+
+/**
+ * This function will return the next timeout tick in the system.
+ *
+ * @return the next timeout tick in the system
+ */
+rt_tick_t rt_timer_next_timeout_tick(void)
+{
+    rt_tick_t next_timeout;
+    register rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    next_timeout = rt_timer_wheel_next_timeout();
+    rt_hw_interrupt_enable(level);
+
+    return next_timeout;
+}
+#else
 /**
  * This function will check timer list, if a timeout event happens, the
  * corresponding timeout function will be invoked.
@@ -554,6 +860,7 @@ rt_tick_t rt_timer_next_timeout_tick(void)
 {
     return rt_timer_list_next_timeout(rt_timer_list);
 }
+#endif
 
 #ifdef RT_USING_TIMER_SOFT
 /**
@@ -672,10 +979,24 @@ void rt_system_timer_init(void)
 {
     int i;
 
+#ifdef RT_USING_TIMER_WHEEL
+    int j;
+
+    for (i = 0; i < RT_TIMER_WHEEL_LEVELS; i++)
+    {
+        for (j = 0; j < TIMER_WHEEL_SLOTS; j++)
+            rt_list_init(&rt_timer_wheel[i][j]);
+        rt_timer_wheel_map[i] = 0;
+    }
+    rt_list_init(&rt_timer_wheel_overflow);
+    rt_list_init(&rt_timer_wheel_due);
+    rt_timer_wheel_tick = rt_tick_get();
+#else
     for (i = 0; i < sizeof(rt_timer_list)/sizeof(rt_timer_list[0]); i++)
     {
         rt_list_init(rt_timer_list+i);
     }
+#endif
 }
 
 /**
@@ -0,0 +1,664 @@
+/*
+ * File      : tlsf.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2016, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     aclean       the first version
+ */
+
+/*
+ * Two-level segregated fit heap, after M. Masmano, I. Ripoll, A. Crespo and
+ * J. Real, "TLSF: a new dynamic memory allocator for real-time systems".
+ *
+ * The free blocks are kept in lists by size: the first level splits the
+ * sizes by powers of two, the second level splits each power of two in
+ * TLSF_SL_COUNT ranges. Two bitmaps tell which lists are not empty, so a
+ * fitting list is found with two bit scans, and rt_malloc() and rt_free()
+ * take the same few steps whatever the heap looks like, where the small
+ * memory allocator walks the heap from its lowest free block.
+ *
+ * A block takes a header of two words, the same as the small memory
+ * allocator, and rt_malloc() rounds a request up to the lower bound of the
+ * next list, which wastes less than 1/TLSF_SL_COUNT of it.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined (RT_USING_HEAP) && defined (RT_USING_TLSF)
+
+#if defined (RT_USING_SMALL_MEM) || defined (RT_USING_SLAB) || defined (RT_USING_MEMHEAP_AS_HEAP)
+#error "RT_USING_TLSF is the system heap, select no other heap"
+#endif
+
+#define RT_MEM_STATS
+
+#ifdef RT_USING_HOOK
+static void (*rt_malloc_hook)(void *ptr, rt_size_t size);
+static void (*rt_free_hook)(void *ptr);
+
+/**
+ * @addtogroup Hook
+ */
+
+/*@{*/
+
+/**
+ * This function will set a hook function, which will be invoked when a memory
+ * block is allocated from heap memory.
+ *
+ * @param hook the hook function
+ */
+void rt_malloc_sethook(void (*hook)(void *ptr, rt_size_t size))
+{
+    rt_malloc_hook = hook;
+}
+
+/**
+ * This function will set a hook function, which will be invoked when a memory
+ * block is released to heap memory.
+ *
+ * @param hook the hook function
+ */
+void rt_free_sethook(void (*hook)(void *ptr))
+{
+    rt_free_hook = hook;
+}
+
+/*@}*/
+
+#endif
+
+#if RT_ALIGN_SIZE == 4
+#define TLSF_ALIGN_LOG2         2
+#elif RT_ALIGN_SIZE == 8
+#define TLSF_ALIGN_LOG2         3
+#else
+#error "TLSF supports an RT_ALIGN_SIZE of 4 or 8"
+#endif
+
+/* second level lists in each power of two */
+#define TLSF_SL_COUNT_LOG2      3
+#define TLSF_SL_COUNT           (1 << TLSF_SL_COUNT_LOG2)
+
+/* blocks below the small size go in the lists of first level 0 */
+#define TLSF_FL_SHIFT           (TLSF_SL_COUNT_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_SMALL_SIZE         (1UL << TLSF_FL_SHIFT)
+
+/* blocks are smaller than 1 << TLSF_FL_INDEX_MAX */
+#ifndef RT_TLSF_FL_INDEX_MAX
+#define TLSF_FL_INDEX_MAX       20
+#else
+#define TLSF_FL_INDEX_MAX       RT_TLSF_FL_INDEX_MAX
+#endif
+#define TLSF_FL_COUNT           (TLSF_FL_INDEX_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_SIZE_MAX           ((1UL << TLSF_FL_INDEX_MAX) - 1)
+
+struct tlsf_block
+{
+    /* the block before this one in memory, RT_NULL for the first */
+    struct tlsf_block *prev_phys;
+    /* the size of the data, the low bits are the flags */
+    rt_size_t size;
+
+    /* free list links, in the data of free blocks only */
+    struct tlsf_block *next_free;
+    struct tlsf_block *prev_free;
+};
+
+#define TLSF_BLOCK_FREE         0x01
+
+#define TLSF_HEADER_SIZE        RT_ALIGN(2 * sizeof(void *), RT_ALIGN_SIZE)
+/* a free block has to hold its list links */
+#define TLSF_BLOCK_SIZE_MIN     RT_ALIGN(2 * sizeof(void *), RT_ALIGN_SIZE)
+
+#define block_size(b)           ((b)->size & ~(rt_size_t)(RT_ALIGN_SIZE - 1))
+#define block_is_free(b)        ((b)->size & TLSF_BLOCK_FREE)
+#define block_data(b)           ((void *)((rt_uint8_t *)(b) + TLSF_HEADER_SIZE))
+#define block_from_data(p)      ((struct tlsf_block *)((rt_uint8_t *)(p) - TLSF_HEADER_SIZE))
+#define block_next(b)           ((struct tlsf_block *)((rt_uint8_t *)block_data(b) + block_size(b)))
+
+static rt_uint32_t fl_bitmap;
+static rt_uint32_t sl_bitmap[TLSF_FL_COUNT];
+static struct tlsf_block *free_lists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+static rt_uint8_t *heap_ptr;
+/* the last block, always used and of size 0 */
+static struct tlsf_block *heap_end;
+
+static struct rt_semaphore heap_sem;
+static rt_size_t mem_size_aligned;
+
+#ifdef RT_MEM_STATS
+static rt_size_t used_mem, max_mem;
+#endif
+
+/* the index of the highest bit set, x is not 0 */
+rt_inline int tlsf_fls(rt_uint32_t x)
+{
+#if defined(__CC_ARM)
+    return 31 - __clz(x);
+#elif defined(__GNUC__)
+    return 31 - __builtin_clz(x);
+#else
+    int bit = 31;
+
+    if (!(x & 0xffff0000UL)) { x <<= 16; bit -= 16; }
+    if (!(x & 0xff000000UL)) { x <<= 8;  bit -= 8;  }
+    if (!(x & 0xf0000000UL)) { x <<= 4;  bit -= 4;  }
+    if (!(x & 0xc0000000UL)) { x <<= 2;  bit -= 2;  }
+    if (!(x & 0x80000000UL)) { bit -= 1; }
+
+    return bit;
+#endif
+}
+
+/* the index of the lowest bit set, x is not 0 */
+rt_inline int tlsf_ffs(rt_uint32_t x)
+{
+    return tlsf_fls(x & (~x + 1));
+}
+
+/* the list a block of the size belongs to */
+static void mapping_insert(rt_size_t size, int *fl, int *sl)
+{
+    int f, s;
+
+    if (size < TLSF_SMALL_SIZE)
+    {
+        f = 0;
+        s = (int)(size >> TLSF_ALIGN_LOG2);
+    }
+    else
+    {
+        f = tlsf_fls((rt_uint32_t)size);
+        s = (int)(size >> (f - TLSF_SL_COUNT_LOG2)) ^ TLSF_SL_COUNT;
+        f -= TLSF_FL_SHIFT - 1;
+    }
+
+    *fl = f;
+    *sl = s;
+}
+
+/* the first list whose blocks all fit the size */
+static void mapping_search(rt_size_t size, int *fl, int *sl)
+{
+    if (size >= TLSF_SMALL_SIZE)
+        size += (1UL << (tlsf_fls((rt_uint32_t)size) - TLSF_SL_COUNT_LOG2)) - 1;
+
+    mapping_insert(size, fl, sl);
+}
+
+static struct tlsf_block *search_suitable_block(int *fl, int *sl)
+{
+    rt_uint32_t sl_map, fl_map;
+
+    sl_map = sl_bitmap[*fl] & (~0UL << *sl);
+    if (!sl_map)
+    {
+        /* no block in this power of two, take the next one with blocks */
+        if (*fl + 1 >= TLSF_FL_COUNT)
+            return RT_NULL;
+        fl_map = fl_bitmap & (~0UL << (*fl + 1));
+        if (!fl_map)
+            return RT_NULL;
+
+        *fl = tlsf_ffs(fl_map);
+        sl_map = sl_bitmap[*fl];
+    }
+    *sl = tlsf_ffs(sl_map);
+
+    return free_lists[*fl][*sl];
+}
+
+static void insert_free_block(struct tlsf_block *block)
+{
+    int fl, sl;
+    struct tlsf_block *head;
+
+    mapping_insert(block_size(block), &fl, &sl);
+
+    head = free_lists[fl][sl];
+    block->next_free = head;
+    block->prev_free = RT_NULL;
+    if (head != RT_NULL)
+        head->prev_free = block;
+    free_lists[fl][sl] = block;
+
+    fl_bitmap     |= 1UL << fl;
+    sl_bitmap[fl] |= 1UL << sl;
+}
+
+static void remove_free_block(struct tlsf_block *block)
+{
+    int fl, sl;
+
+    mapping_insert(block_size(block), &fl, &sl);
+
+    if (block->next_free != RT_NULL)
+        block->next_free->prev_free = block->prev_free;
+    if (block->prev_free != RT_NULL)
+        block->prev_free->next_free = block->next_free;
+    else
+    {
+        free_lists[fl][sl] = block->next_free;
+        if (block->next_free == RT_NULL)
+        {
+            sl_bitmap[fl] &= ~(1UL << sl);
+            if (!sl_bitmap[fl])
+                fl_bitmap &= ~(1UL << fl);
+        }
+    }
+}
+
+/* cut the tail beyond size off a used block and give it back as a free block */
+static void block_trim(struct tlsf_block *block, rt_size_t size)
+{
+    struct tlsf_block *rest, *next;
+
+    if (block_size(block) < size + TLSF_HEADER_SIZE + TLSF_BLOCK_SIZE_MIN)
+        return;
+
+    rest = (struct tlsf_block *)((rt_uint8_t *)block_data(block) + size);
+    rest->prev_phys = block;
+    rest->size = block_size(block) - size - TLSF_HEADER_SIZE;
+    block->size = size;
+
+    next = block_next(rest);
+    if (block_is_free(next))
+    {
+        /* a shrinking rt_realloc() leaves the rest next to a free block */
+        remove_free_block(next);
+        rest->size += TLSF_HEADER_SIZE + block_size(next);
+        next = block_next(rest);
+    }
+    next->prev_phys = rest;
+
+    rest->size |= TLSF_BLOCK_FREE;
+    insert_free_block(rest);
+}
+
+/* the size of a request as a block, 0 when it is too large */
+static rt_size_t adjust_size(rt_size_t size)
+{
+    size = RT_ALIGN(size, RT_ALIGN_SIZE);
+    if (size < TLSF_BLOCK_SIZE_MIN)
+        size = TLSF_BLOCK_SIZE_MIN;
+    if (size > mem_size_aligned || size > TLSF_SIZE_MAX)
+        return 0;
+
+    return size;
+}
+
+/**
+ * @ingroup SystemInit
+ *
+ * This function will initialize system heap memory.
+ *
+ * @param begin_addr the beginning address of system heap memory.
+ * @param end_addr the end address of system heap memory.
+ */
+void rt_system_heap_init(void *begin_addr, void *end_addr)
+{
+    struct tlsf_block *block;
+    rt_uint32_t begin_align = RT_ALIGN((rt_uint32_t)begin_addr, RT_ALIGN_SIZE);
+    rt_uint32_t end_align = RT_ALIGN_DOWN((rt_uint32_t)end_addr, RT_ALIGN_SIZE);
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* room for the first and the last block */
+    if ((end_align > (2 * TLSF_HEADER_SIZE + TLSF_BLOCK_SIZE_MIN)) &&
+        ((end_align - 2 * TLSF_HEADER_SIZE - TLSF_BLOCK_SIZE_MIN) >= begin_align))
+    {
+        mem_size_aligned = end_align - begin_align - 2 * TLSF_HEADER_SIZE;
+    }
+    else
+    {
+        rt_kprintf("mem init, error begin address 0x%x, and end address 0x%x\n",
+                   (rt_uint32_t)begin_addr, (rt_uint32_t)end_addr);
+
+        return;
+    }
+
+    if (mem_size_aligned > TLSF_SIZE_MAX)
+    {
+        rt_kprintf("mem init, heap of %d bytes cut to %d\n",
+                   mem_size_aligned, TLSF_SIZE_MAX & ~(RT_ALIGN_SIZE - 1));
+        mem_size_aligned = TLSF_SIZE_MAX & ~(RT_ALIGN_SIZE - 1);
+    }
+
+    heap_ptr = (rt_uint8_t *)begin_align;
+
+    RT_DEBUG_LOG(RT_DEBUG_MEM, ("mem init, heap begin address 0x%x, size %d\n",
+                                (rt_uint32_t)heap_ptr, mem_size_aligned));
+
+    /* the whole heap is one free block */
+    block = (struct tlsf_block *)heap_ptr;
+    block->prev_phys = RT_NULL;
+    block->size = mem_size_aligned | TLSF_BLOCK_FREE;
+
+    /* the end stub stops the merging of the last block */
+    heap_end = block_next(block);
+    heap_end->prev_phys = block;
+    heap_end->size = 0;
+
+    insert_free_block(block);
+
+    rt_sem_init(&heap_sem, "heap", 1, RT_IPC_FLAG_FIFO);
+}
+
+/**
+ * @addtogroup MM
+ */
+
+/*@{*/
+
+/**
+ * Allocate a block of memory with a minimum of 'size' bytes.
+ *
+ * @param size is the minimum size of the requested block in bytes.
+ *
+ * @return pointer to allocated memory or NULL if no free memory was found.
+ */
+void *rt_malloc(rt_size_t size)
+{
+    int fl, sl;
+    struct tlsf_block *block;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    if (size == 0)
+        return RT_NULL;
+
+    RT_DEBUG_LOG(RT_DEBUG_MEM, ("malloc size %d\n", size));
+
+    size = adjust_size(size);
+    if (size == 0)
+    {
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("no memory\n"));
+
+        return RT_NULL;
+    }
+
+    mapping_search(size, &fl, &sl);
+    if (fl >= TLSF_FL_COUNT)
+        return RT_NULL;
+
+    /* take memory semaphore */
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+
+    block = search_suitable_block(&fl, &sl);
+    if (block == RT_NULL)
+    {
+        rt_sem_release(&heap_sem);
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("no memory\n"));
+
+        return RT_NULL;
+    }
+
+    remove_free_block(block);
+    block->size &= ~(rt_size_t)TLSF_BLOCK_FREE;
+    block_trim(block, size);
+
+#ifdef RT_MEM_STATS
+    used_mem += block_size(block) + TLSF_HEADER_SIZE;
+    if (max_mem < used_mem)
+        max_mem = used_mem;
+#endif
+
+    rt_sem_release(&heap_sem);
+
+    RT_ASSERT((rt_uint32_t)block_data(block) % RT_ALIGN_SIZE == 0);
+    RT_DEBUG_LOG(RT_DEBUG_MEM,
+                 ("allocate memory at 0x%x, size: %d\n",
+                  (rt_uint32_t)block_data(block), block_size(block)));
+
+    RT_OBJECT_HOOK_CALL(rt_malloc_hook, (block_data(block), size));
+
+    return block_data(block);
+}
+RTM_EXPORT(rt_malloc);
+
+/**
+ * This function will change the previously allocated memory block.
+ *
+ * @param rmem pointer to memory allocated by rt_malloc
+ * @param newsize the required new size
+ *
+ * @return the changed memory block address
+ */
+void *rt_realloc(void *rmem, rt_size_t newsize)
+{
+    rt_size_t size;
+    struct tlsf_block *block, *next;
+    void *nmem;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* allocate a new memory block */
+    if (rmem == RT_NULL)
+        return rt_malloc(newsize);
+
+    if ((rt_uint8_t *)rmem < heap_ptr ||
+        (rt_uint8_t *)rmem >= (rt_uint8_t *)heap_end)
+    {
+        /* illegal memory */
+        return rmem;
+    }
+
+    newsize = adjust_size(newsize);
+    if (newsize == 0)
+    {
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("realloc: out of memory\n"));
+
+        return RT_NULL;
+    }
+
+    block = block_from_data(rmem);
+
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+
+    RT_ASSERT(!block_is_free(block));
+    size = block_size(block);
+
+    /* grow into the next block when it is free and large enough */
+    next = block_next(block);
+    if (newsize > size && block_is_free(next) &&
+        size + TLSF_HEADER_SIZE + block_size(next) >= newsize)
+    {
+        remove_free_block(next);
+        block->size = size + TLSF_HEADER_SIZE + block_size(next);
+        block_next(block)->prev_phys = block;
+    }
+
+    if (newsize <= block_size(block))
+    {
+        block_trim(block, newsize);
+
+#ifdef RT_MEM_STATS
+        used_mem = used_mem - size + block_size(block);
+        if (max_mem < used_mem)
+            max_mem = used_mem;
+#endif
+        rt_sem_release(&heap_sem);
+
+        return rmem;
+    }
+    rt_sem_release(&heap_sem);
+
+    /* move the memory */
+    nmem = rt_malloc(newsize);
+    if (nmem != RT_NULL)
+    {
+        rt_memcpy(nmem, rmem, size);
+        rt_free(rmem);
+    }
+
+    return nmem;
+}
+RTM_EXPORT(rt_realloc);
+
+/**
+ * This function will contiguously allocate enough space for count objects
+ * that are size bytes of memory each and returns a pointer to the allocated
+ * memory.
+ *
+ * The allocated memory is filled with bytes of value zero.
+ *
+ * @param count number of objects to allocate
+ * @param size size of the objects to allocate
+ *
+ * @return pointer to allocated memory / NULL pointer if there is an error
+ */
+void *rt_calloc(rt_size_t count, rt_size_t size)
+{
+    void *p;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* allocate 'count' objects of size 'size' */
+    p = rt_malloc(count * size);
+
+    /* zero the memory */
+    if (p)
+        rt_memset(p, 0, count * size);
+
+    return p;
+}
+RTM_EXPORT(rt_calloc);
+
+/**
+ * This function will release the previously allocated memory block by
+ * rt_malloc. The released memory block is taken back to system heap.
+ *
+ * @param rmem the address of memory which will be released
+ */
+void rt_free(void *rmem)
+{
+    struct tlsf_block *block, *prev, *next;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    if (rmem == RT_NULL)
+        return;
+    RT_ASSERT((((rt_uint32_t)rmem) & (RT_ALIGN_SIZE-1)) == 0);
+    RT_ASSERT((rt_uint8_t *)rmem >= heap_ptr &&
+              (rt_uint8_t *)rmem < (rt_uint8_t *)heap_end);
+
+    RT_OBJECT_HOOK_CALL(rt_free_hook, (rmem));
+
+    if ((rt_uint8_t *)rmem < heap_ptr ||
+        (rt_uint8_t *)rmem >= (rt_uint8_t *)heap_end)
+    {
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("illegal memory\n"));
+
+        return;
+    }
+
+    block = block_from_data(rmem);
+
+    RT_DEBUG_LOG(RT_DEBUG_MEM,
+                 ("release memory 0x%x, size: %d\n",
+                  (rt_uint32_t)rmem, block_size(block)));
+
+    /* protect the heap from concurrent access */
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+
+    RT_ASSERT(!block_is_free(block));
+
+#ifdef RT_MEM_STATS
+    used_mem -= block_size(block) + TLSF_HEADER_SIZE;
+#endif
+
+    /* merge with the free neighbours, there are never two free blocks in a row */
+    prev = block->prev_phys;
+    if (prev != RT_NULL && block_is_free(prev))
+    {
+        remove_free_block(prev);
+        prev->size += TLSF_HEADER_SIZE + block_size(block);
+        block = prev;
+    }
+
+    next = block_next(block);
+    if (block_is_free(next))
+    {
+        remove_free_block(next);
+        block->size += TLSF_HEADER_SIZE + block_size(next);
+        next = block_next(block);
+    }
+    next->prev_phys = block;
+
+    block->size |= TLSF_BLOCK_FREE;
+    insert_free_block(block);
+
+    rt_sem_release(&heap_sem);
+}
+RTM_EXPORT(rt_free);
+
+#ifdef RT_MEM_STATS
+void rt_memory_info(rt_uint32_t *total,
+                    rt_uint32_t *used,
+                    rt_uint32_t *max_used)
+{
+    if (total != RT_NULL)
+        *total = mem_size_aligned;
+    if (used  != RT_NULL)
+        *used = used_mem;
+    if (max_used != RT_NULL)
+        *max_used = max_mem;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_mem(void)
+{
+    int fl, sl;
+    rt_size_t size, largest = 0;
+    rt_uint32_t blocks = 0;
+    struct tlsf_block *block;
+
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+    for (fl = 0; fl < TLSF_FL_COUNT; fl++)
+    {
+        for (sl = 0; sl < TLSF_SL_COUNT; sl++)
+        {
+            for (block = free_lists[fl][sl]; block != RT_NULL; block = block->next_free)
+            {
+                size = block_size(block);
+                if (size > largest)
+                    largest = size;
+                blocks++;
+            }
+        }
+    }
+    rt_sem_release(&heap_sem);
+
+    rt_kprintf("total memory: %d\n", mem_size_aligned);
+    rt_kprintf("used memory : %d\n", used_mem);
+    rt_kprintf("maximum allocated memory: %d\n", max_mem);
+    rt_kprintf("free blocks : %d, largest %d\n", blocks, largest);
+}
+FINSH_FUNCTION_EXPORT(list_mem, list memory usage information)
+#endif
+#endif
+
+/*@}*/
+
+#endif /* end of RT_USING_TLSF */
@@ -0,0 +1,229 @@
+#!/usr/bin/env python
+#
+# File      : trace_decode.py
+# This file is part of RT-Thread RTOS
+# COPYRIGHT (C) 2006 - 2016, RT-Thread Development Team
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-17     aclean       first version
+#
+# Decodes the ring written by sched_trace_dump of the stm32f10x application
+# from a capture of the console, into a timeline and per thread and per
+# interrupt statistics of the captured time:
+#
+#   python trace_decode.py capture.txt
+#   python trace_decode.py --json timeline.json capture.txt
+#
+# The json file opens in chrome://tracing or in Perfetto.
+
+from __future__ import print_function
+
+import json
+import sys
+
+SWITCH, IRQ_ENTER, IRQ_LEAVE, BLOCK, WAKE = 1, 2, 3, 4, 5
+NO_THREAD = 0xff
+
+# exception numbers of the stm32f10x interrupts in use on the board
+EXCEPTIONS = {
+    14: 'PendSV', 15: 'SysTick',
+    16 + 6: 'EXTI0', 16 + 23: 'EXTI9_5', 16 + 40: 'EXTI15_10',
+    16 + 28: 'TIM2', 16 + 29: 'TIM3', 16 + 30: 'TIM4', 16 + 50: 'TIM5',
+    16 + 37: 'USART1', 16 + 38: 'USART2', 16 + 39: 'USART3',
+    16 + 52: 'UART4', 16 + 53: 'UART5',
+}
+
+
+class Trace(object):
+    def __init__(self):
+        self.clock = 72000000
+        self.tick = 1000
+        self.lost = 0
+        self.threads = {}
+        self.objects = {}
+        self.events = []
+
+    def thread(self, index):
+        if index == NO_THREAD:
+            return '(others)'
+        return self.threads.get(index, '#%d' % index)
+
+    def object(self, arg):
+        if arg == 0:
+            return '-'
+        return self.objects.get(arg, '%04x' % arg)
+
+    def us(self, cycles):
+        return cycles * 1000000.0 / self.clock
+
+
+def exception_name(number):
+    if number in EXCEPTIONS:
+        return EXCEPTIONS[number]
+    if number >= 16:
+        return 'IRQ%d' % (number - 16)
+    return 'exc%d' % number
+
+
+def parse(lines):
+    trace = None
+    high = 0
+    last = None
+
+    for line in lines:
+        line = line.strip()
+        if line.startswith('#trace'):
+            trace = Trace()
+            fields = line.split()
+            trace.clock = int(fields[1])
+            trace.tick = int(fields[2])
+            trace.lost = int(fields[4])
+            high, last = 0, None
+        elif trace is None:
+            continue
+        elif line.startswith('#thread'):
+            fields = line.split(None, 2)
+            trace.threads[int(fields[1])] = fields[2] if len(fields) > 2 else ''
+        elif line.startswith('#object'):
+            fields = line.split(None, 2)
+            trace.objects[int(fields[1], 16)] = fields[2] if len(fields) > 2 else ''
+        elif line.startswith('#end'):
+            break
+        else:
+            fields = line.split()
+            if len(fields) != 4:
+                continue
+            try:
+                cycles = int(fields[0], 16)
+                event = (int(fields[1]), int(fields[2]), int(fields[3], 16))
+            except ValueError:
+                continue
+            # the counter wraps in about a minute, the events are closer
+            if last is not None and cycles < last:
+                high += 1 << 32
+            last = cycles
+            trace.events.append((high + cycles,) + event)
+
+    return trace
+
+
+def decode(trace, out):
+    start = trace.events[0][0]
+    running = None
+    run_start = start
+    irq_stack = []
+    woken = {}
+
+    threads = {}
+    irqs = {}
+    spans = []
+
+    def thread_stat(name):
+        return threads.setdefault(name, {'runs': 0, 'cycles': 0, 'worst': 0})
+
+    def run_end(now):
+        if running is not None:
+            thread_stat(running)['cycles'] += now - run_start
+            spans.append((running, run_start, now))
+
+    for cycles, kind, index, arg in trace.events:
+        name = trace.thread(index)
+        at = '%12.1f' % trace.us(cycles - start)
+
+        if kind == SWITCH:
+            run_end(cycles)
+            thread_stat(name)['runs'] += 1
+            line = 'switch %s -> %s' % (trace.thread(arg), name)
+            if name in woken:
+                response = cycles - woken.pop(name)
+                stat = thread_stat(name)
+                stat['worst'] = max(stat['worst'], response)
+                line += ', %.1f us after wake up' % trace.us(response)
+            running, run_start = name, cycles
+        elif kind == IRQ_ENTER:
+            irq_stack.append((arg, cycles))
+            line = 'enter %s in %s' % (exception_name(arg), name)
+        elif kind == IRQ_LEAVE:
+            line = 'leave %s' % exception_name(arg)
+            if irq_stack:
+                number, entered = irq_stack.pop()
+                stat = irqs.setdefault(number, {'count': 0, 'cycles': 0, 'worst': 0})
+                stat['count'] += 1
+                stat['cycles'] += cycles - entered
+                stat['worst'] = max(stat['worst'], cycles - entered)
+                spans.append(('irq ' + exception_name(number), entered, cycles))
+                line += ' after %.1f us' % trace.us(cycles - entered)
+        elif kind == BLOCK:
+            line = '%s blocks on %s' % (name, trace.object(arg))
+        elif kind == WAKE:
+            woken.setdefault(name, cycles)
+            if arg:
+                line = '%s woken by %s' % (name, trace.object(arg))
+            else:
+                line = '%s woken by timeout' % name
+        else:
+            line = 'event %d %d %04x' % (kind, index, arg)
+
+        print('%s us  %s' % (at, line), file=out)
+
+    end = trace.events[-1][0]
+    run_end(end)
+    total = max(end - start, 1)
+
+    print('', file=out)
+    print('%.1f us captured, %d events, %d lost before' %
+          (trace.us(end - start), len(trace.events), trace.lost), file=out)
+    print('thread       runs   share   worst wake to run us', file=out)
+    for name in sorted(threads, key=lambda n: -threads[n]['cycles']):
+        stat = threads[name]
+        print('%-10s %6d %6.1f%% %22.1f' % (name, stat['runs'],
+              stat['cycles'] * 100.0 / total, trace.us(stat['worst'])), file=out)
+    print('interrupt   count   share       worst us', file=out)
+    for number in sorted(irqs):
+        stat = irqs[number]
+        print('%-10s %6d %6.1f%% %14.1f' % (exception_name(number), stat['count'],
+              stat['cycles'] * 100.0 / total, trace.us(stat['worst'])), file=out)
+
+    return spans, start
+
+
+def write_json(trace, spans, start, path):
+    events = []
+    for name, begin, end in spans:
+        events.append({'name': name, 'ph': 'X', 'pid': 0, 'tid': name,
+                       'ts': trace.us(begin - start), 'dur': trace.us(end - begin)})
+    for cycles, kind, index, arg in trace.events:
+        if kind in (BLOCK, WAKE):
+            events.append({'name': ('block %s' if kind == BLOCK else 'wake %s') % trace.object(arg),
+                           'ph': 'i', 's': 't', 'pid': 0, 'tid': trace.thread(index),
+                           'ts': trace.us(cycles - start)})
+    with open(path, 'w') as f:
+        json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, f)
+
+
+def main(argv):
+    json_path = None
+    if len(argv) > 2 and argv[1] == '--json':
+        json_path = argv[2]
+        argv = argv[:1] + argv[3:]
+
+    if len(argv) > 1:
+        with open(argv[1]) as f:
+            trace = parse(f)
+    else:
+        trace = parse(sys.stdin)
+
+    if trace is None or not trace.events:
+        print('no trace found, run sched_trace_dump() in finsh', file=sys.stderr)
+        return 1
+
+    spans, start = decode(trace, sys.stdout)
+    if json_path:
+        write_json(trace, spans, start, json_path)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -131,10 +131,10 @@ void APP_USART1_IRQHandler(void)
 
 
 
-void APP_USART2_Baudrate(u16 baudrate)
+void APP_USART2_Baudrate(u32 baudrate)
 {
 	USART_InitTypeDef USART_2_InitStructure;
-	u16 BaudrateTemp;
+	u32 BaudrateTemp;
 
     BSP_USART2_Init();
     
@@ -77,7 +77,7 @@ void APP_USART1_Baudrate(u16 baudrate);
 
 void APP_USART1_IRQHandler(void);
 
-void APP_USART2_Baudrate(u16 baudrate);
+void APP_USART2_Baudrate(u32 baudrate);
 
 void APP_USART2_IRQHandler(void);
 
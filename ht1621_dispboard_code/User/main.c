@@ -52,6 +52,36 @@ DEVICE_WORK_TYPE device_work_data;
 DEVICE_WORK_TYPE device_work_changing_data;
 
 
+//state image sync with the main board:
+//F2 F2 01 1b image chk 7E, the whole image, starts the sequence at 0
+//F3 F3 02 len seq {offset value}... chk 7E, the changed bytes only
+//both are answered with F3 F3 81 01 seq chk 7E, the sequence number applied
+#define DISP_IMAGE_SIZE         27
+#define DISP_SYNC_DELTA         0x02
+#define DISP_SYNC_ACK           0x81
+#define DISP_SYNC_REQUEST       0x80    //in the 01 frame: send the whole image
+
+u8 disp_image[DISP_IMAGE_SIZE];
+u8 disp_seq = 0;
+u8 disp_synced = 0;
+
+
+//baud rate of the line, code 1-9600 2-19200 3-38400 4-57600 5-115200:
+//F3 F3 03 01 code chk 7E is answered at the old rate with F3 F3 83 01 code chk 7E,
+//the rate switched to once the answer is out
+//nothing valid heard for DISP_BAUD_SILENCE_MS at another rate: the main board fell back, so do we
+#define DISP_BAUD_SET           0x03
+#define DISP_BAUD_ACK           0x83
+#define DISP_BAUD_BUS           9600
+#define DISP_BAUD_CODE_MAX      5
+#define DISP_BAUD_SILENCE_MS    2000
+#define DISP_BAUD_SWITCH_MS     2       //the last byte of the answer is still in the shift register
+
+const u32 disp_baud_rates[DISP_BAUD_CODE_MAX+1] = {0,9600,19200,38400,57600,115200};
+u32 disp_baud = DISP_BAUD_BUS;
+u32 disp_baud_next = 0;
+
+
 
 u8 wifi_send_packet_buf_pub[100];
 u8 wifi_send_packet_buf_pub1[7];
@@ -127,13 +157,13 @@ u8 return_current_device_state(void)
 }
 
 
-u8 com_send_packet_data_f1(u8* buf,u8 len)
+u8 com_send_packet_data_head(u8 head,u8* buf,u8 len)
 {
     u8 i;
     u8 chk = 0;
 
-    wifi_send_packet_buf_pub[0] = 0xF1;
-    wifi_send_packet_buf_pub[1] = 0xF1;
+    wifi_send_packet_buf_pub[0] = head;
+    wifi_send_packet_buf_pub[1] = head;
 
     for(i=0;i<len;i++)
     {
@@ -150,6 +180,11 @@ u8 com_send_packet_data_f1(u8* buf,u8 len)
 		return 1;
 }
 
+u8 com_send_packet_data_f1(u8* buf,u8 len)
+{
+    return com_send_packet_data_head(0xF1,buf,len);
+}
+
 
 //mode: 0,off; 1,on
 u8 return_device_power_state_change(u8 Function,u8 mode)
@@ -169,6 +204,35 @@ u8 return_device_power_state_change(u8 Function,u8 mode)
 }
 
 
+u8 return_sync_ack(u8 seq)
+{
+    u8 buftmp[4];
+
+    buftmp[0] = DISP_SYNC_ACK;
+    buftmp[1] = 0x01;
+    buftmp[2] = seq;
+
+    com_send_packet_data_head(0xF3,buftmp,3);
+
+    return 0;
+}
+
+
+
+u8 return_baud_ack(u8 code)
+{
+    u8 buftmp[4];
+
+    buftmp[0] = DISP_BAUD_ACK;
+    buftmp[1] = 0x01;
+    buftmp[2] = code;
+
+    com_send_packet_data_head(0xF3,buftmp,3);
+
+    return 0;
+}
+
+
 
 void uart2_init(void)
 {
@@ -210,7 +274,7 @@ void serial_int1_receive(u8 udr1)//receive data from USAR1
 	
     if (0x00 == Isr_j) 
     {
-        if(0xF1 !=udr1 && 0xF2 !=udr1)
+        if(0xF1 !=udr1 && 0xF2 !=udr1 && 0xF3 !=udr1)
         {
             Isr_com = 0; 
             Isr_j = 0;
@@ -219,8 +283,10 @@ void serial_int1_receive(u8 udr1)//receive data from USAR1
 
         if(0xF1 ==udr1)
             rec_data_num = 7;
-        else
+        else if(0xF2 ==udr1)
             rec_data_num = 33;
+        else
+            rec_data_num = 4;   //F3, up to the length byte
         
         rxd1_buffer[0] = udr1;
         Isr_com = 1; 
@@ -246,12 +312,29 @@ void serial_int1_receive(u8 udr1)//receive data from USAR1
             return;
 
 			}
+			else if(udr1 != 0xF3 && rxd1_buffer[0] == 0Xf3)
+			{
+				Isr_com = 0; 
+				Isr_j = 0;
+				return;
+			}
 
 		}
 		
         rxd1_buffer[Isr_com] = udr1;
         Isr_com++;
 
+        if(Isr_com == 4 && rxd1_buffer[0] == 0Xf3)
+        {
+            if(udr1 > sizeof(rxd1_buffer) - 6)
+            {
+                Isr_com = 0; 
+                Isr_j = 0;
+                return;
+            }
+            rec_data_num = udr1 + 6;
+        }
+
         if (Isr_com >= rec_data_num)
 		{
     		Isr_com = 0x00; 
@@ -304,6 +387,37 @@ void serial_int1_send(void)	   //send data to USAR1
 }
 
 
+void uart2_set_baudrate(u32 baudrate)
+{
+  USART_Cmd(USART2, DISABLE);
+  APP_USART2_Baudrate(baudrate);
+
+  USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);
+  USART_Cmd(USART2, ENABLE);
+
+  //a frame cut by the switch is lost anyway
+  Isr_com = 0;
+  Isr_j = 0;
+  disp_baud = baudrate;
+}
+
+
+void disp_baud_check(void)
+{
+	//the answer went at the old rate, switch once it is out
+	if(disp_baud_next && txd1_buff_cFlag && time_tick_cnt2 >= DISP_BAUD_SWITCH_MS)
+	{
+		uart2_set_baudrate(disp_baud_next);
+		disp_baud_next = 0;
+		time_tick_cnt2 = 0;
+	}
+	else if(disp_baud != DISP_BAUD_BUS && time_tick_cnt2 > DISP_BAUD_SILENCE_MS)
+	{
+		uart2_set_baudrate(DISP_BAUD_BUS);
+	}
+}
+
+
 
 
 /*
@@ -718,6 +832,75 @@ u8 device_power_state_pre = 0xff;
 
 u8 power_key_state_pre = 0xff;
 
+//show the image the main board sent
+void disp_image_apply(void)
+{
+	//rx_buff_f1 = 1;
+	device_work_data.para_type.house1_co2 = (u16)disp_image[8]<<8;
+	device_work_data.para_type.house1_co2 += (u16)disp_image[9];
+
+	device_work_data.para_type.house1_pm2_5 = (u16)disp_image[6]<<8;
+	device_work_data.para_type.house1_pm2_5 +=(u16)disp_image[7];
+
+	device_work_data.para_type.house2_co2 = (u16)disp_image[12]<<8;
+	device_work_data.para_type.house2_co2	+= (u16)disp_image[13];
+
+	device_work_data.para_type.house2_pm2_5 = (u16)disp_image[10]<<8;
+	device_work_data.para_type.house2_pm2_5	+= (u16)disp_image[11];
+
+	device_work_data.para_type.house3_co2 = (u16)disp_image[16]<<8;
+	device_work_data.para_type.house3_co2	+=(u16)disp_image[17];
+
+	device_work_data.para_type.house3_pm2_5 = (u16)disp_image[14]<<8;
+	device_work_data.para_type.house3_pm2_5+= (u16)disp_image[15];
+
+	device_work_data.para_type.house4_co2 = (u16)disp_image[20]<<8;
+	device_work_data.para_type.house4_co2+=(u16)disp_image[21];
+
+	device_work_data.para_type.house4_pm2_5 = (u16)disp_image[18]<<8;
+	device_work_data.para_type.house4_pm2_5+=(u16)disp_image[19];
+
+	device_work_data.para_type.house5_co2 = (u16)disp_image[24]<<8;
+	device_work_data.para_type.house5_co2+=(u16)disp_image[25];
+
+	device_work_data.para_type.house5_pm2_5 = (u16)disp_image[22]<<8;
+	device_work_data.para_type.house5_pm2_5+=(u16)disp_image[23];
+
+	device_work_data.para_type.fault_state = disp_image[26];
+
+	//ljy start 160303
+	device_work_data.para_type.device_power_state = disp_image[0];
+	device_work_data.para_type.device_mode = disp_image[1];
+	device_work_data.para_type.wind_speed_state = disp_image[2];
+	device_work_data.para_type.high_pressur_state = disp_image[3];
+	device_work_data.para_type.pht_work_state = disp_image[4];
+	//ljy end 160303
+
+#if 0
+	// ²Ϊյػ󣬽رʾȻҪԴ
+	// device_work_data.para_type.device_power_state Ϊ0ʱĻرգֱյ device_work_data.para_type.device_power_stateΪ1ſĻ
+	//ֱʾĵԴſʾ
+	if(device_power_state_pre==0xff || device_power_state_pre!= device_work_data.para_type.device_power_state)
+	{
+		if(device_work_data.para_type.device_power_state == 0)
+		{
+
+			onoff_device_set(OFF);
+
+		}
+		else
+		{
+			onoff_device_set(ON);
+		}
+
+		device_power_state_pre = device_work_data.para_type.device_power_state;
+	}
+#endif
+
+	device_work_mode_check();  //յ尴ʾ
+	fault_check();                          //յϴ
+}
+
 void cmd_uart_check(void)
 {
 	u8 rx_buff_tmp[40];
@@ -885,7 +1068,7 @@ void cmd_uart_check(void)
 		
                else if(time_tick_cnt1> TICKS_PER_SECOND1)
                	{
-                return_device_power_state_change(1,0);
+                return_device_power_state_change(1,disp_synced ? 0 : DISP_SYNC_REQUEST);
 		time_tick_cnt1=0;
                	}
 
@@ -897,81 +1080,61 @@ void cmd_uart_check(void)
 
          if(rx_buff_tmp[0] == 0xF2 && rx_buff_tmp[1] == 0xf2 )
         {
-		//rx_buff_f1 = 1;
-            device_work_data.para_type.house1_co2 = (u16)rx_buff_tmp[12]<<8;
-			device_work_data.para_type.house1_co2 += (u16)rx_buff_tmp[13];
-			
-			device_work_data.para_type.house1_pm2_5 = (u16)rx_buff_tmp[10]<<8;
-			device_work_data.para_type.house1_pm2_5 +=(u16)rx_buff_tmp[11];
-
-
-            device_work_data.para_type.house2_co2 = (u16)rx_buff_tmp[16]<<8;
-			device_work_data.para_type.house2_co2	+= (u16)rx_buff_tmp[17];
-			
-			device_work_data.para_type.house2_pm2_5 = (u16)rx_buff_tmp[14]<<8;
-			device_work_data.para_type.house2_pm2_5	+= (u16)rx_buff_tmp[15];
+			for(u8 i=0;i<DISP_IMAGE_SIZE;i++)
+				disp_image[i] = rx_buff_tmp[4+i];
 
+			disp_seq = 0;
+			disp_synced = 1;
+			return_sync_ack(disp_seq);
 
-            device_work_data.para_type.house3_co2 = (u16)rx_buff_tmp[20]<<8;
-			device_work_data.para_type.house3_co2	+=(u16)rx_buff_tmp[21];
-			
-			device_work_data.para_type.house3_pm2_5 = (u16)rx_buff_tmp[18]<<8;
-			device_work_data.para_type.house3_pm2_5+= (u16)rx_buff_tmp[19];
+			disp_image_apply();
+        }
 
-			
+         if(rx_buff_tmp[0] == 0xF3 && rx_buff_tmp[1] == 0xf3 && rx_buff_tmp[2] == DISP_SYNC_DELTA)
+        {
+			u8 len = rx_buff_tmp[3];
+			u8 chk = 0;
 
-            device_work_data.para_type.house4_co2 = (u16)rx_buff_tmp[24]<<8;
-			device_work_data.para_type.house4_co2+=(u16)rx_buff_tmp[25];
-			
-			device_work_data.para_type.house4_pm2_5 = (u16)rx_buff_tmp[22]<<8;
-			device_work_data.para_type.house4_pm2_5+=(u16)rx_buff_tmp[23];
+			for(u8 i=0;i<len+2;i++)
+				chk += rx_buff_tmp[2+i];
 
-			
+			//a delta only applies on top of the image it was made from
+			if(disp_synced && chk == rx_buff_tmp[len+4] && (len & 1) &&
+				rx_buff_tmp[4] == (u8)(disp_seq+1))
+			{
+				for(u8 i=5;i<len+4;i+=2)
+				{
+					if(rx_buff_tmp[i] < DISP_IMAGE_SIZE)
+						disp_image[rx_buff_tmp[i]] = rx_buff_tmp[i+1];
+				}
 
-            device_work_data.para_type.house5_co2 = (u16)rx_buff_tmp[28]<<8;
-			device_work_data.para_type.house5_co2+=(u16)rx_buff_tmp[29];
-			
-			device_work_data.para_type.house5_pm2_5 = (u16)rx_buff_tmp[26]<<8;
-			device_work_data.para_type.house5_pm2_5+=(u16)rx_buff_tmp[27];
+				disp_seq = rx_buff_tmp[4];
+				return_sync_ack(disp_seq);
 
-			device_work_data.para_type.fault_state = rx_buff_tmp[30];
+				disp_image_apply();
+			}
+			else
+			{
+				disp_synced = 0;
+				return_sync_ack(disp_seq);
+			}
+        }
 
-			
-                	 //ljy start 160303 
-	     		device_work_data.para_type.device_power_state = rx_buff_tmp[4];
-                     device_work_data.para_type.device_mode = rx_buff_tmp[5];
-                      device_work_data.para_type.wind_speed_state = rx_buff_tmp[6];
-                      device_work_data.para_type.high_pressur_state = rx_buff_tmp[7];
-			device_work_data.para_type.pht_work_state = rx_buff_tmp[8];
-                  //ljy end 160303
-                  
+         if(rx_buff_tmp[0] == 0xF3 && rx_buff_tmp[1] == 0xf3 && rx_buff_tmp[2] == DISP_BAUD_SET)
+        {
+			u8 code = rx_buff_tmp[4];
 
-#if 0
-// ²Ϊյػ󣬽رʾȻҪԴ
-// device_work_data.para_type.device_power_state Ϊ0ʱĻرգֱյ device_work_data.para_type.device_power_stateΪ1ſĻ
-//ֱʾĵԴſʾ
-			if(device_power_state_pre==0xff || device_power_state_pre!= device_work_data.para_type.device_power_state)
+			//the fastest we have up to the one asked for
+			if(rx_buff_tmp[3] == 1 && code != 0 &&
+				(u8)(rx_buff_tmp[2] + rx_buff_tmp[3] + code) == rx_buff_tmp[5])
 			{
-				if(device_work_data.para_type.device_power_state == 0)
-				{
-				
-					onoff_device_set(OFF);
-
-				}
-				else
-				{
-					onoff_device_set(ON);
-				}
+				if(code > DISP_BAUD_CODE_MAX)
+					code = DISP_BAUD_CODE_MAX;
 
-				device_power_state_pre = device_work_data.para_type.device_power_state;
+				return_baud_ack(code);
+				if(disp_baud_rates[code] != disp_baud)
+					disp_baud_next = disp_baud_rates[code];
 			}
-#endif
-
-			device_work_mode_check();  //յ尴ʾ
-			fault_check();                          //յϴ
-                    
-			
-     
         }
 
     }
@@ -1071,6 +1234,8 @@ int main(void)
 		
         cmd_uart_check();	
 
+        disp_baud_check();
+
         if(time_tick_cnt> TICKS_PER_SECOND )
         {
 